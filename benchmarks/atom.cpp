@@ -0,0 +1,47 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Builds many small tables sharing the same keys and compares lookups by string
+// (hashed on every call) with lookups through cached atoms
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Tables  = 10000;
+    constexpr int Lookups = 100;
+
+    const auto before = SL::Atom::report();
+
+    std::vector<SL::Table> tables(Tables);
+    for (auto& table : tables)
+    {
+        table.set("name",     SL::String("entity"));
+        table.set("value",    1.f);
+        table.set("enabled",  true);
+        table.set("position", SL::Table());
+    }
+
+    const auto after = SL::Atom::report();
+    std::cout << "atoms: " << after.count << " (" << after.bytes << " bytes, "
+              << after.bytes - before.bytes << " added by " << Tables << " tables)\n";
+    std::cout << "key bytes per entry: " << sizeof(SL::Atom) << "\n";
+
+    const auto time = [&](const char* label, auto&& get)
+    {
+        SL::Number sum = 0;
+        const auto start = Clock::now();
+        for (int l = 0; l < Lookups; l++)
+            for (const auto& table : tables) sum += get(table);
+        const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << label << ": " << ns / (Tables * Lookups) << " ns/lookup (" << sum << ")\n";
+    };
+
+    const std::string key = "value";
+    time("string key", [&](const SL::Table& t) { return t.get<SL::Number>(key); });
+    time("atom key",   [&](const SL::Table& t) { return t.get<SL::Number>(SL_ATOM("value")); });
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Scans a 64 MB log for lines holding "ERROR", reading it into a Lua string and through a
+// memory-mapped buffer
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto path = std::filesystem::temp_directory_path() / "sl-bench-buffer.log";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        for (int i = 0; out.tellp() < (64 << 20); i++)
+            out << "2024-01-01T00:00:" << i % 60 << " worker-" << i % 16 << (i % 97 ? " INFO request served in " : " ERROR request failed after ") << i % 1000 << " ms\n";
+    }
+    const auto mb = static_cast<double>(std::filesystem::file_size(path)) / (1 << 20);
+
+    auto runtime = SL::Runtime::create<SL::Lib::Buffer>(BENCH_FILE_DIR "/buffer.lua");
+    const auto time = [&](const char* label, const char* function)
+    {
+        runtime.runFunction<>("collectgarbage");
+
+        const auto start = Clock::now();
+        const auto res = runtime.runFunction<int64_t, double>(function, path.string());
+        const auto s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << label << ": " << mb / s << " MB/s, peak heap " << std::get<1>(*res) / 1024 << " MB (" << std::get<0>(*res) << " errors)\n";
+    };
+
+    time("string lines", "StringLines");
+    time("buffer lines", "BufferLines");
+    time("buffer count", "BufferCount");
+
+    std::filesystem::remove(path);
+    return 0;
+}
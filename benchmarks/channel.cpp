@@ -0,0 +1,78 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int64_t Messages = 2000000;
+
+void report(const char* name, Clock::time_point start)
+{
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << name << ": " << static_cast<uint64_t>(Messages / seconds) << " messages/s\n";
+}
+
+// Producers and consumers each on their own thread, the producers share the messages
+template<typename P, typename C>
+void run(const char* name, int producers, int consumers, P&& produce, C&& consume)
+{
+    const auto channel = SL::Channel::open(name, 1024);
+    const auto start = Clock::now();
+
+    std::vector<std::thread> threads, sinks;
+    for (int c = 0; c < consumers; c++) sinks.emplace_back([&]() { consume(name); });
+    for (int p = 0; p < producers; p++) threads.emplace_back([&]() { produce(name, Messages / producers); });
+    for (auto& t : threads) t.join();
+    channel->close();
+    for (auto& t : sinks) t.join();
+
+    report(name, start);
+}
+
+// Moves small messages between threads, from C++ and between runtimes running Lua
+int main()
+{
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    const auto cppProduce = [](const char* name, int64_t n)
+    {
+        const auto channel = SL::Channel::open(name);
+        for (int64_t i = 0; i < n; i++) channel->send(i);
+    };
+    const auto cppConsume = [](const char* name)
+    {
+        const auto channel = SL::Channel::open(name);
+        SL::Channel::Message message;
+        while (channel->recv(message)) { }
+    };
+
+    run("C++ integers 1 -> 1", 1, 1, cppProduce, cppConsume);
+    run("C++ integers 4 -> 4", 4, 4, cppProduce, cppConsume);
+
+    const auto luaProduce = [](const char* function)
+    {
+        return [function](const char* name, int64_t n)
+        {
+            auto runtime = SL::Runtime::create<SL::Lib::Channel>(BENCH_FILE_DIR "/channel.lua");
+            runtime.runFunction<>(function, std::string(name), n);
+        };
+    };
+    const auto luaConsume = [](const char* name)
+    {
+        auto runtime = SL::Runtime::create<SL::Lib::Channel>(BENCH_FILE_DIR "/channel.lua");
+        runtime.runFunction<int64_t>("Consume", std::string(name));
+    };
+
+    run("Lua integers 1 -> 1", 1, 1, luaProduce("Produce"), luaConsume);
+    run("Lua integers 4 -> 4", 4, 4, luaProduce("Produce"), luaConsume);
+    run("Lua tables 1 -> 1  ", 1, 1, luaProduce("ProduceTables"), luaConsume);
+
+    return 0;
+}
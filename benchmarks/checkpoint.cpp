@@ -0,0 +1,46 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Serves requests that each need a clean script environment, by creating a runtime
+// per request and by resetting pooled runtimes to their checkpoint
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Requests = 2000;
+
+    const auto time = [&](const char* label, auto&& serve)
+    {
+        SL::Number sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Requests; i++) sum += serve();
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::cout << label << ": " << us / Requests << " us/request (" << sum << ")\n";
+    };
+
+    const auto handle = [](SL::Runtime& runtime)
+    {
+        return std::get<0>(runtime.runFunction<SL::Number>("Handle", SL::String("item42")).value());
+    };
+
+    time("new runtime", [&]()
+    {
+        SL::Runtime runtime(BENCH_FILE_DIR "/checkpoint.lua");
+        return handle(runtime);
+    });
+
+    SL::RuntimePool pool([]() { return SL::Runtime(BENCH_FILE_DIR "/checkpoint.lua"); }, 1);
+    time("pooled reset", [&]()
+    {
+        auto runtime = pool.acquire();
+        return handle(*runtime);
+    });
+
+    return 0;
+}
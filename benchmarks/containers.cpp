@@ -0,0 +1,58 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Moves 10k element containers in and out of Lua, once through the container TypeMaps
+// and once by building or reading an SL::Table by hand
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Size       = 10000;
+    constexpr int Iterations = 50;
+
+    SL::Runtime runtime(BENCH_FILE_DIR "/containers.lua");
+    SL_ASSERT(runtime, "Failed to load benchmark script");
+
+    std::unordered_map<SL::String, SL::Number> map;
+    for (int i = 0; i < Size; i++) map["key" + std::to_string(i)] = static_cast<SL::Number>(i);
+
+    const auto time = [&](const char* label, auto&& run)
+    {
+        SL::Number sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Iterations; i++) sum += run();
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::cout << label << ": " << us / Iterations << " us (" << sum << ")\n";
+    };
+
+    time("push map via SL::Table", [&]()
+    {
+        SL::Table table;
+        for (const auto& [k, v] : map) table.set(k, v);
+        return std::get<0>(runtime.runFunction<SL::Number>("Count", std::move(table)).value());
+    });
+
+    time("push map via TypeMap", [&]()
+    {
+        return std::get<0>(runtime.runFunction<SL::Number>("Count", map).value());
+    });
+
+    time("read vector via SL::Table", [&]()
+    {
+        const auto table = runtime.getGlobal<SL::Table>("Values");
+        return static_cast<SL::Number>(table->get<SL::Number>().size());
+    });
+
+    time("read vector via TypeMap", [&]()
+    {
+        return static_cast<SL::Number>(runtime.getGlobal<std::vector<SL::Number>>("Values")->size());
+    });
+
+    return 0;
+}
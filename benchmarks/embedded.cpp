@@ -0,0 +1,35 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Starts runtimes from a script with 120 functions, read and parsed from its file and
+// from the bytecode compiled into the binary
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Runtimes = 500;
+
+    const auto time = [&](const char* label, auto&& create)
+    {
+        SL::Number sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Runtimes; i++)
+        {
+            auto runtime = create();
+            sum += std::get<0>(runtime.template runFunction<SL::Number>("Ping").value());
+        }
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::cout << label << ": " << us / Runtimes << " us/runtime (" << sum << ")\n";
+    };
+
+    time("file",     []() { return SL::Runtime(BENCH_FILE_DIR "/embedded.lua"); });
+    time("embedded", []() { return SL::Runtime::fromEmbedded("embedded"); });
+
+    return 0;
+}
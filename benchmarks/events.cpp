@@ -0,0 +1,61 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t Events = 1000000;
+constexpr std::size_t Batch  = 1000;
+
+void report(const char* name, Clock::duration time)
+{
+    const auto seconds = std::chrono::duration<double>(time).count();
+    std::cout << name << ": " << static_cast<uint64_t>(Events / seconds) << " events/s\n";
+}
+
+// Pushes every event through the queue, timing enqueueing and dispatching separately
+void batched(SL::Runtime& runtime, const char* type, const char* name)
+{
+    Clock::duration push{}, dispatch{};
+    for (std::size_t i = 0; i < Events; i += Batch)
+    {
+        const auto start = Clock::now();
+        for (std::size_t j = 0; j < Batch; j++) runtime.events().push(type, 1.f, 2.f);
+        const auto pushed = Clock::now();
+        SL_ASSERT(runtime.dispatchEvents(), "Dispatch failed");
+        push += pushed - start;
+        dispatch += Clock::now() - pushed;
+    }
+
+    std::cout << name << "\n";
+    report("  push + dispatch", push + dispatch);
+    report("  dispatch only  ", dispatch);
+}
+
+// Compares delivering events one runFunction call at a time with batched dispatch
+int main()
+{
+    SL::Runtime runtime(BENCH_FILE_DIR "/events.lua");
+    SL_ASSERT(runtime, "Failed to load benchmark script");
+    SL_ASSERT(runtime.enableEvents(Batch), "Failed to enable events");
+    SL_ASSERT(runtime.runFunction<>("Subscribe"), "Failed to subscribe");
+    SL_ASSERT(runtime.runFunction<>("SubscribeBatch"), "Failed to subscribe");
+
+    {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < Events; i++)
+            runtime.runFunction<>("OnEvent", SL::String("tick"), 1.f, 2.f);
+        std::cout << "runFunction per event\n";
+        report("  call", Clock::now() - start);
+    }
+
+    batched(runtime, "tick",  "Events.subscribe");
+    batched(runtime, "batch", "Events.subscribeBatch");
+
+    return 0;
+}
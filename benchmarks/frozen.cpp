@@ -0,0 +1,68 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Gives the same reference data (a table of 10000 items) to 64 runtimes, by copying it
+// into each of them and by sharing one frozen table, then reads it from a script
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr int Items = 10000;
+    constexpr int Runtimes = 64;
+
+    SL::Table items;
+    for (int i = 0; i < Items; i++)
+    {
+        SL::Table tags;
+        tags.set("1", SL::String("weapon"));
+        tags.set("2", SL::String("rare"));
+
+        SL::Table item;
+        item.set("name", SL::String("Item number " + std::to_string(i)));
+        item.set("damage", int64_t(i % 97));
+        item.set("weight", 0.25 * i);
+        item.set("tags", tags);
+        items.set("item" + std::to_string(i), item);
+    }
+
+    const auto start = Clock::now();
+    const SL::FrozenTable frozen(items);
+    std::cout << "freeze: " << std::chrono::duration<double>(Clock::now() - start).count() * 1000 << " ms, "
+              << frozen.bytes() / 1024 << " KB shared\n";
+
+    const auto run = [&](const char* label, auto&& give)
+    {
+        std::vector<SL::Runtime> runtimes;
+        std::size_t base = 0;
+        for (int i = 0; i < Runtimes; i++)
+        {
+            runtimes.push_back(SL::Runtime::create<>(BENCH_FILE_DIR "/frozen.lua"));
+            base += runtimes.back().memory();
+        }
+
+        const auto start = Clock::now();
+        for (auto& runtime : runtimes) give(runtime);
+        const auto s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::size_t memory = 0;
+        for (auto& runtime : runtimes) memory += runtime.memory();
+        std::cout << label << " setup of " << Runtimes << " runtimes: " << s * 1000 << " ms, "
+                  << (memory - base) / 1024 / Runtimes << " KB of Lua heap each\n";
+
+        const auto read = Clock::now();
+        const auto res = runtimes[0].runFunction<int64_t>("Read", int64_t(1000), int64_t(1000));
+        const auto r = std::chrono::duration<double>(Clock::now() - read).count();
+        std::cout << label << " 1M lookups: " << r * 1000 << " ms (" << std::get<0>(*res) << ")\n";
+    };
+
+    run("copy  ", [&](SL::Runtime& runtime) { runtime.setGlobal("Items", items); });
+    run("frozen", [&](SL::Runtime& runtime) { runtime.setGlobal("Items", frozen); });
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Decodes and encodes a document of 16000 records (about 4 MB) with the json library, with a
+// JSON library written in plain Lua, and with SL::Table from C++
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::string document = "[";
+    for (int i = 0; i < 16000; i++)
+    {
+        if (i) document += ",";
+        document += "{\"id\":" + std::to_string(i) + ",\"name\":\"user " + std::to_string(i) + "\",\"email\":\"user." + std::to_string(i)
+            + "@example.com\",\"score\":" + std::to_string(i * 0.37) + ",\"active\":" + (i % 2 ? "true" : "false")
+            + ",\"tags\":[\"alpha\",\"beta\",\"gamma\"],\"address\":{\"street\":\"" + std::to_string(i % 500) + " Main Street\",\"city\":\"Springfield\",\"zip\":\"0"
+            + std::to_string(10000 + i % 90000) + "\"},\"bio\":\"Writes \\\"short\\\" notes\\nand longer ones, sometimes in caf\\u00e9s.\"}";
+    }
+    document += "]";
+    const auto mb = static_cast<double>(document.size()) / (1 << 20);
+    std::cout << "document: " << mb << " MB\n";
+
+    auto runtime = SL::Runtime::create<SL::Lib::Json>(BENCH_FILE_DIR "/json.lua");
+    const auto time = [&](const char* label, auto&& f)
+    {
+        constexpr int N = 5;
+
+        const auto start = Clock::now();
+        f(N);
+        const auto s = std::chrono::duration<double>(Clock::now() - start).count() / N;
+        std::cout << label << ": " << mb / s << " MB/s\n";
+    };
+    const auto lua = [&](const char* function, const char* library)
+    {
+        return [=, &runtime, &document](int n)
+        {
+            runtime.runFunction<>("collectgarbage");
+            const auto res = runtime.runFunction<int64_t>(function, std::string(library), document, static_cast<int64_t>(n));
+            if (!res) std::cerr << res.error().message() << "\n";
+        };
+    };
+
+    time("decode json       ", lua("Decode", "native"));
+    time("decode plain Lua  ", lua("Decode", "lua"));
+    time("decode SL::Table  ", [&](int n) { for (int i = 0; i < n; i++) SL::Table::fromJson(document); });
+    time("encode json       ", lua("Encode", "native"));
+    time("encode plain Lua  ", lua("Encode", "lua"));
+
+    const auto table = SL::Table::fromJson(document);
+    time("encode SL::Table  ", [&](int n) { for (int i = 0; i < n; i++) table->toJson(); });
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <SL/Lua.hpp>
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Creates runtimes with 500 C++ functions spread over 10 libraries, registered one
+// function at a time (a global lookup and table insert each) and as whole function tables
+namespace
+{
+    constexpr int Libraries = 10;
+    constexpr int Functions = 50;
+
+    int identity(SL::State)
+    {
+        return 1;
+    }
+
+    template<int Index>
+    struct Names
+    {
+        static const std::array<std::string, Functions>& get()
+        {
+            static const auto names = []()
+            {
+                std::array<std::string, Functions> names;
+                for (int i = 0; i < Functions; i++) names[i] = "f" + std::to_string(i);
+                return names;
+            }();
+            return names;
+        }
+
+        static const SL::Lib::Reg* table()
+        {
+            static const auto table = []()
+            {
+                std::array<SL::Lib::Reg, Functions + 1> table{};
+                for (int i = 0; i < Functions; i++) table[i] = { get()[i].c_str(), identity };
+                return table;
+            }();
+            return table.data();
+        }
+
+        static SL::Lib::Base::Map map()
+        {
+            SL::Lib::Base::Map map;
+            for (const auto& name : get()) map.emplace(name, identity);
+            return map;
+        }
+    };
+
+    template<int Index>
+    struct TableLib : SL::Lib::Base
+    {
+        TableLib() : Base("lib" + std::to_string(Index), Names<Index>::table()) { }
+    };
+
+    template<int Index>
+    struct MapLib : SL::Lib::Base
+    {
+        MapLib() : Base("lib" + std::to_string(Index), Names<Index>::map()) { }
+    };
+
+    template<template<int> typename Lib, int... I>
+    SL::Runtime create(std::integer_sequence<int, I...>)
+    {
+        return SL::Runtime::create<Lib<I>...>(BENCH_FILE_DIR "/libraries.lua");
+    }
+
+    // What registration cost before function tables: every library is built from its map
+    // and each function is looked up and inserted on its own
+    template<int Index>
+    void registerPerFunction(SL::Runtime& runtime)
+    {
+        const MapLib<Index> lib;
+        const auto* funcs = lib.functions();
+        for (std::size_t i = 0; i < lib.count(); i++)
+            runtime.registerFunction(lib.name(), funcs[i].name, funcs[i].func);
+    }
+
+    template<int... I>
+    SL::Runtime createPerFunction(std::integer_sequence<int, I...>)
+    {
+        SL::Runtime runtime(BENCH_FILE_DIR "/libraries.lua");
+        (registerPerFunction<I>(runtime), ...);
+        return runtime;
+    }
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Runtimes = 200;
+    constexpr auto Indices = std::make_integer_sequence<int, Libraries>();
+
+    const auto time = [&](const char* label, auto&& create)
+    {
+        SL::Number sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Runtimes; i++)
+        {
+            auto runtime = create();
+            sum += std::get<0>(runtime.template runFunction<SL::Number>("Call", 1.f).value());
+        }
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::cout << label << ": " << us / Runtimes << " us/runtime (" << sum << ")\n";
+    };
+
+    std::cout << Libraries * Functions << " functions in " << Libraries << " libraries\n";
+    time("script only",    [&]() { return create<TableLib>(std::make_integer_sequence<int, 0>()); });
+    time("per function",   [&]() { return createPerFunction(Indices); });
+    time("map libraries",  [&]() { return create<MapLib>(Indices); });
+    time("function table", [&]() { return create<TableLib>(Indices); });
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+-- Each counts the lines holding "ERROR" and returns the count and the peak Lua heap in KB
+
+function StringLines(path)
+    local file = io.open(path, "rb")
+    local text = file:read("a")
+    file:close()
+
+    local count, peak, pos = 0, collectgarbage("count"), 1
+    while true do
+        local newline = string.find(text, "\n", pos, true)
+        if not newline then break end
+        local line = string.sub(text, pos, newline - 1)
+        if string.find(line, "ERROR", 1, true) then count = count + 1 end
+        pos = newline + 1
+        if count % 1024 == 0 then peak = math.max(peak, collectgarbage("count")) end
+    end
+    return count, peak
+end
+
+function BufferLines(path)
+    local buf = buffer.open(path)
+
+    local count, peak = 0, collectgarbage("count")
+    for line in buf:lines() do
+        if line:find("ERROR") then count = count + 1 end
+        if count % 1024 == 0 then peak = math.max(peak, collectgarbage("count")) end
+    end
+    return count, peak
+end
+
+function BufferCount(path)
+    local buf = buffer.open(path)
+    return buf:count("ERROR"), collectgarbage("count")
+end
@@ -0,0 +1,16 @@
+function Produce(name, n)
+    local ch = channel.open(name)
+    for i = 1, n do ch:send(i) end
+end
+
+function ProduceTables(name, n)
+    local ch = channel.open(name)
+    for i = 1, n do ch:send({ id = i, name = "event", x = 1.5, y = -2.5 }) end
+end
+
+function Consume(name)
+    local ch = channel.open(name)
+    local count = 0
+    while ch:recv() do count = count + 1 end
+    return count
+end
@@ -0,0 +1,16 @@
+-- Warm-up builds lookup tables a request handler would use
+Names = {}
+for i = 1, 20000 do
+    Names[i] = "item" .. i
+end
+
+Index = {}
+for i = 1, #Names do
+    Index[Names[i]] = i
+end
+
+function Handle(name)
+    Last = name
+    Handled = (Handled or 0) + 1
+    return Index[name] or 0
+end
@@ -0,0 +1,8 @@
+Values = { }
+for i = 1, 10000 do Values[i] = i * 0.5 end
+
+function Count(t)
+    local n = 0
+    for _ in pairs(t) do n = n + 1 end
+    return n
+end
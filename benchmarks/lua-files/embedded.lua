@@ -0,0 +1,1325 @@
+-- A script with many small functions, so loading it is mostly parsing
+
+function Handler1(entity, dt)
+    local speed = entity.speed or 1
+    if entity.health < 11 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler1" }
+end
+
+function Handler2(entity, dt)
+    local speed = entity.speed or 2
+    if entity.health < 12 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler2" }
+end
+
+function Handler3(entity, dt)
+    local speed = entity.speed or 3
+    if entity.health < 13 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler3" }
+end
+
+function Handler4(entity, dt)
+    local speed = entity.speed or 4
+    if entity.health < 14 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler4" }
+end
+
+function Handler5(entity, dt)
+    local speed = entity.speed or 5
+    if entity.health < 15 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler5" }
+end
+
+function Handler6(entity, dt)
+    local speed = entity.speed or 6
+    if entity.health < 16 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler6" }
+end
+
+function Handler7(entity, dt)
+    local speed = entity.speed or 7
+    if entity.health < 17 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler7" }
+end
+
+function Handler8(entity, dt)
+    local speed = entity.speed or 8
+    if entity.health < 18 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler8" }
+end
+
+function Handler9(entity, dt)
+    local speed = entity.speed or 9
+    if entity.health < 19 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler9" }
+end
+
+function Handler10(entity, dt)
+    local speed = entity.speed or 10
+    if entity.health < 20 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler10" }
+end
+
+function Handler11(entity, dt)
+    local speed = entity.speed or 11
+    if entity.health < 21 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler11" }
+end
+
+function Handler12(entity, dt)
+    local speed = entity.speed or 12
+    if entity.health < 22 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler12" }
+end
+
+function Handler13(entity, dt)
+    local speed = entity.speed or 13
+    if entity.health < 23 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler13" }
+end
+
+function Handler14(entity, dt)
+    local speed = entity.speed or 14
+    if entity.health < 24 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler14" }
+end
+
+function Handler15(entity, dt)
+    local speed = entity.speed or 15
+    if entity.health < 25 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler15" }
+end
+
+function Handler16(entity, dt)
+    local speed = entity.speed or 16
+    if entity.health < 26 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler16" }
+end
+
+function Handler17(entity, dt)
+    local speed = entity.speed or 17
+    if entity.health < 27 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler17" }
+end
+
+function Handler18(entity, dt)
+    local speed = entity.speed or 18
+    if entity.health < 28 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler18" }
+end
+
+function Handler19(entity, dt)
+    local speed = entity.speed or 19
+    if entity.health < 29 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler19" }
+end
+
+function Handler20(entity, dt)
+    local speed = entity.speed or 20
+    if entity.health < 30 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler20" }
+end
+
+function Handler21(entity, dt)
+    local speed = entity.speed or 21
+    if entity.health < 31 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler21" }
+end
+
+function Handler22(entity, dt)
+    local speed = entity.speed or 22
+    if entity.health < 32 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler22" }
+end
+
+function Handler23(entity, dt)
+    local speed = entity.speed or 23
+    if entity.health < 33 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler23" }
+end
+
+function Handler24(entity, dt)
+    local speed = entity.speed or 24
+    if entity.health < 34 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler24" }
+end
+
+function Handler25(entity, dt)
+    local speed = entity.speed or 25
+    if entity.health < 35 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler25" }
+end
+
+function Handler26(entity, dt)
+    local speed = entity.speed or 26
+    if entity.health < 36 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler26" }
+end
+
+function Handler27(entity, dt)
+    local speed = entity.speed or 27
+    if entity.health < 37 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler27" }
+end
+
+function Handler28(entity, dt)
+    local speed = entity.speed or 28
+    if entity.health < 38 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler28" }
+end
+
+function Handler29(entity, dt)
+    local speed = entity.speed or 29
+    if entity.health < 39 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler29" }
+end
+
+function Handler30(entity, dt)
+    local speed = entity.speed or 30
+    if entity.health < 40 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler30" }
+end
+
+function Handler31(entity, dt)
+    local speed = entity.speed or 31
+    if entity.health < 41 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler31" }
+end
+
+function Handler32(entity, dt)
+    local speed = entity.speed or 32
+    if entity.health < 42 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler32" }
+end
+
+function Handler33(entity, dt)
+    local speed = entity.speed or 33
+    if entity.health < 43 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler33" }
+end
+
+function Handler34(entity, dt)
+    local speed = entity.speed or 34
+    if entity.health < 44 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler34" }
+end
+
+function Handler35(entity, dt)
+    local speed = entity.speed or 35
+    if entity.health < 45 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler35" }
+end
+
+function Handler36(entity, dt)
+    local speed = entity.speed or 36
+    if entity.health < 46 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler36" }
+end
+
+function Handler37(entity, dt)
+    local speed = entity.speed or 37
+    if entity.health < 47 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler37" }
+end
+
+function Handler38(entity, dt)
+    local speed = entity.speed or 38
+    if entity.health < 48 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler38" }
+end
+
+function Handler39(entity, dt)
+    local speed = entity.speed or 39
+    if entity.health < 49 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler39" }
+end
+
+function Handler40(entity, dt)
+    local speed = entity.speed or 40
+    if entity.health < 50 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler40" }
+end
+
+function Handler41(entity, dt)
+    local speed = entity.speed or 41
+    if entity.health < 51 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler41" }
+end
+
+function Handler42(entity, dt)
+    local speed = entity.speed or 42
+    if entity.health < 52 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler42" }
+end
+
+function Handler43(entity, dt)
+    local speed = entity.speed or 43
+    if entity.health < 53 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler43" }
+end
+
+function Handler44(entity, dt)
+    local speed = entity.speed or 44
+    if entity.health < 54 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler44" }
+end
+
+function Handler45(entity, dt)
+    local speed = entity.speed or 45
+    if entity.health < 55 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler45" }
+end
+
+function Handler46(entity, dt)
+    local speed = entity.speed or 46
+    if entity.health < 56 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler46" }
+end
+
+function Handler47(entity, dt)
+    local speed = entity.speed or 47
+    if entity.health < 57 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler47" }
+end
+
+function Handler48(entity, dt)
+    local speed = entity.speed or 48
+    if entity.health < 58 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler48" }
+end
+
+function Handler49(entity, dt)
+    local speed = entity.speed or 49
+    if entity.health < 59 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler49" }
+end
+
+function Handler50(entity, dt)
+    local speed = entity.speed or 50
+    if entity.health < 10 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler50" }
+end
+
+function Handler51(entity, dt)
+    local speed = entity.speed or 51
+    if entity.health < 11 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler51" }
+end
+
+function Handler52(entity, dt)
+    local speed = entity.speed or 52
+    if entity.health < 12 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler52" }
+end
+
+function Handler53(entity, dt)
+    local speed = entity.speed or 53
+    if entity.health < 13 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler53" }
+end
+
+function Handler54(entity, dt)
+    local speed = entity.speed or 54
+    if entity.health < 14 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler54" }
+end
+
+function Handler55(entity, dt)
+    local speed = entity.speed or 55
+    if entity.health < 15 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler55" }
+end
+
+function Handler56(entity, dt)
+    local speed = entity.speed or 56
+    if entity.health < 16 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler56" }
+end
+
+function Handler57(entity, dt)
+    local speed = entity.speed or 57
+    if entity.health < 17 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler57" }
+end
+
+function Handler58(entity, dt)
+    local speed = entity.speed or 58
+    if entity.health < 18 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler58" }
+end
+
+function Handler59(entity, dt)
+    local speed = entity.speed or 59
+    if entity.health < 19 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler59" }
+end
+
+function Handler60(entity, dt)
+    local speed = entity.speed or 60
+    if entity.health < 20 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler60" }
+end
+
+function Handler61(entity, dt)
+    local speed = entity.speed or 61
+    if entity.health < 21 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler61" }
+end
+
+function Handler62(entity, dt)
+    local speed = entity.speed or 62
+    if entity.health < 22 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler62" }
+end
+
+function Handler63(entity, dt)
+    local speed = entity.speed or 63
+    if entity.health < 23 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler63" }
+end
+
+function Handler64(entity, dt)
+    local speed = entity.speed or 64
+    if entity.health < 24 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler64" }
+end
+
+function Handler65(entity, dt)
+    local speed = entity.speed or 65
+    if entity.health < 25 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler65" }
+end
+
+function Handler66(entity, dt)
+    local speed = entity.speed or 66
+    if entity.health < 26 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler66" }
+end
+
+function Handler67(entity, dt)
+    local speed = entity.speed or 67
+    if entity.health < 27 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler67" }
+end
+
+function Handler68(entity, dt)
+    local speed = entity.speed or 68
+    if entity.health < 28 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler68" }
+end
+
+function Handler69(entity, dt)
+    local speed = entity.speed or 69
+    if entity.health < 29 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler69" }
+end
+
+function Handler70(entity, dt)
+    local speed = entity.speed or 70
+    if entity.health < 30 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler70" }
+end
+
+function Handler71(entity, dt)
+    local speed = entity.speed or 71
+    if entity.health < 31 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler71" }
+end
+
+function Handler72(entity, dt)
+    local speed = entity.speed or 72
+    if entity.health < 32 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler72" }
+end
+
+function Handler73(entity, dt)
+    local speed = entity.speed or 73
+    if entity.health < 33 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler73" }
+end
+
+function Handler74(entity, dt)
+    local speed = entity.speed or 74
+    if entity.health < 34 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler74" }
+end
+
+function Handler75(entity, dt)
+    local speed = entity.speed or 75
+    if entity.health < 35 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler75" }
+end
+
+function Handler76(entity, dt)
+    local speed = entity.speed or 76
+    if entity.health < 36 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler76" }
+end
+
+function Handler77(entity, dt)
+    local speed = entity.speed or 77
+    if entity.health < 37 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler77" }
+end
+
+function Handler78(entity, dt)
+    local speed = entity.speed or 78
+    if entity.health < 38 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler78" }
+end
+
+function Handler79(entity, dt)
+    local speed = entity.speed or 79
+    if entity.health < 39 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler79" }
+end
+
+function Handler80(entity, dt)
+    local speed = entity.speed or 80
+    if entity.health < 40 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler80" }
+end
+
+function Handler81(entity, dt)
+    local speed = entity.speed or 81
+    if entity.health < 41 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler81" }
+end
+
+function Handler82(entity, dt)
+    local speed = entity.speed or 82
+    if entity.health < 42 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler82" }
+end
+
+function Handler83(entity, dt)
+    local speed = entity.speed or 83
+    if entity.health < 43 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler83" }
+end
+
+function Handler84(entity, dt)
+    local speed = entity.speed or 84
+    if entity.health < 44 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler84" }
+end
+
+function Handler85(entity, dt)
+    local speed = entity.speed or 85
+    if entity.health < 45 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler85" }
+end
+
+function Handler86(entity, dt)
+    local speed = entity.speed or 86
+    if entity.health < 46 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler86" }
+end
+
+function Handler87(entity, dt)
+    local speed = entity.speed or 87
+    if entity.health < 47 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler87" }
+end
+
+function Handler88(entity, dt)
+    local speed = entity.speed or 88
+    if entity.health < 48 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler88" }
+end
+
+function Handler89(entity, dt)
+    local speed = entity.speed or 89
+    if entity.health < 49 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler89" }
+end
+
+function Handler90(entity, dt)
+    local speed = entity.speed or 90
+    if entity.health < 50 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler90" }
+end
+
+function Handler91(entity, dt)
+    local speed = entity.speed or 91
+    if entity.health < 51 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler91" }
+end
+
+function Handler92(entity, dt)
+    local speed = entity.speed or 92
+    if entity.health < 52 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler92" }
+end
+
+function Handler93(entity, dt)
+    local speed = entity.speed or 93
+    if entity.health < 53 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler93" }
+end
+
+function Handler94(entity, dt)
+    local speed = entity.speed or 94
+    if entity.health < 54 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler94" }
+end
+
+function Handler95(entity, dt)
+    local speed = entity.speed or 95
+    if entity.health < 55 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler95" }
+end
+
+function Handler96(entity, dt)
+    local speed = entity.speed or 96
+    if entity.health < 56 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler96" }
+end
+
+function Handler97(entity, dt)
+    local speed = entity.speed or 97
+    if entity.health < 57 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler97" }
+end
+
+function Handler98(entity, dt)
+    local speed = entity.speed or 98
+    if entity.health < 58 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler98" }
+end
+
+function Handler99(entity, dt)
+    local speed = entity.speed or 99
+    if entity.health < 59 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler99" }
+end
+
+function Handler100(entity, dt)
+    local speed = entity.speed or 100
+    if entity.health < 10 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler100" }
+end
+
+function Handler101(entity, dt)
+    local speed = entity.speed or 101
+    if entity.health < 11 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler101" }
+end
+
+function Handler102(entity, dt)
+    local speed = entity.speed or 102
+    if entity.health < 12 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler102" }
+end
+
+function Handler103(entity, dt)
+    local speed = entity.speed or 103
+    if entity.health < 13 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler103" }
+end
+
+function Handler104(entity, dt)
+    local speed = entity.speed or 104
+    if entity.health < 14 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler104" }
+end
+
+function Handler105(entity, dt)
+    local speed = entity.speed or 105
+    if entity.health < 15 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler105" }
+end
+
+function Handler106(entity, dt)
+    local speed = entity.speed or 106
+    if entity.health < 16 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler106" }
+end
+
+function Handler107(entity, dt)
+    local speed = entity.speed or 107
+    if entity.health < 17 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler107" }
+end
+
+function Handler108(entity, dt)
+    local speed = entity.speed or 108
+    if entity.health < 18 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler108" }
+end
+
+function Handler109(entity, dt)
+    local speed = entity.speed or 109
+    if entity.health < 19 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler109" }
+end
+
+function Handler110(entity, dt)
+    local speed = entity.speed or 110
+    if entity.health < 20 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler110" }
+end
+
+function Handler111(entity, dt)
+    local speed = entity.speed or 111
+    if entity.health < 21 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler111" }
+end
+
+function Handler112(entity, dt)
+    local speed = entity.speed or 112
+    if entity.health < 22 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler112" }
+end
+
+function Handler113(entity, dt)
+    local speed = entity.speed or 113
+    if entity.health < 23 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler113" }
+end
+
+function Handler114(entity, dt)
+    local speed = entity.speed or 114
+    if entity.health < 24 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler114" }
+end
+
+function Handler115(entity, dt)
+    local speed = entity.speed or 115
+    if entity.health < 25 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler115" }
+end
+
+function Handler116(entity, dt)
+    local speed = entity.speed or 116
+    if entity.health < 26 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler116" }
+end
+
+function Handler117(entity, dt)
+    local speed = entity.speed or 117
+    if entity.health < 27 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler117" }
+end
+
+function Handler118(entity, dt)
+    local speed = entity.speed or 118
+    if entity.health < 28 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler118" }
+end
+
+function Handler119(entity, dt)
+    local speed = entity.speed or 119
+    if entity.health < 29 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler119" }
+end
+
+function Handler120(entity, dt)
+    local speed = entity.speed or 120
+    if entity.health < 30 then
+        speed = speed * 0.5
+    end
+    for k = 1, 3 do
+        entity.x = (entity.x or 0) + speed * dt * k
+    end
+    return { x = entity.x, speed = speed, tag = "handler120" }
+end
+
+function Ping()
+    return 1
+end
@@ -0,0 +1,21 @@
+Total = 0
+
+function OnEvent(kind, a, b)
+    if kind == "tick" then
+        Total = Total + a + b
+    end
+end
+
+function Subscribe()
+    Events.subscribe("tick", function(a, b)
+        Total = Total + a + b
+    end)
+end
+
+function SubscribeBatch()
+    Events.subscribeBatch("batch", function(n, a, b)
+        for i = 1, n do
+            Total = Total + a[i] + b[i]
+        end
+    end)
+end
@@ -0,0 +1,12 @@
+-- Looks up every item by name and reads a few of its fields, like a game reading its
+-- item table would
+function Read(count, rounds)
+    local total = 0
+    for _ = 1, rounds do
+        for i = 1, count do
+            local item = Items["item" .. (i % 1000)]
+            total = total + item.damage + #item.name
+        end
+    end
+    return total
+end
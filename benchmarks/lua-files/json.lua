@@ -0,0 +1,144 @@
+-- A straightforward JSON library in plain Lua, as a script would carry one, to compare with `json`
+local Reference = {}
+do
+    local escapes = { ['"'] = '\\"', ['\\'] = '\\\\', ['\b'] = '\\b', ['\f'] = '\\f', ['\n'] = '\\n', ['\r'] = '\\r', ['\t'] = '\\t' }
+    local unescapes = { ['"'] = '"', ['\\'] = '\\', ['/'] = '/', b = '\b', f = '\f', n = '\n', r = '\r', t = '\t' }
+
+    local function escape(c)
+        return escapes[c] or string.format("\\u%04x", c:byte())
+    end
+
+    local function quote(s)
+        return '"' .. s:gsub('[%c"\\]', escape) .. '"'
+    end
+
+    local function encode(v, out)
+        local kind = type(v)
+        if kind == "table" then
+            if #v > 0 then
+                out[#out + 1] = "["
+                for i = 1, #v do
+                    if i > 1 then out[#out + 1] = "," end
+                    encode(v[i], out)
+                end
+                out[#out + 1] = "]"
+            else
+                out[#out + 1] = "{"
+                local first = true
+                for k, x in pairs(v) do
+                    if not first then out[#out + 1] = "," end
+                    first = false
+                    out[#out + 1] = quote(tostring(k))
+                    out[#out + 1] = ":"
+                    encode(x, out)
+                end
+                out[#out + 1] = "}"
+            end
+        elseif kind == "string" then out[#out + 1] = quote(v)
+        elseif kind == "number" then out[#out + 1] = math.type(v) == "integer" and tostring(v) or string.format("%.17g", v)
+        elseif kind == "boolean" then out[#out + 1] = tostring(v)
+        else out[#out + 1] = "null"
+        end
+    end
+
+    function Reference.encode(v)
+        local out = {}
+        encode(v, out)
+        return table.concat(out)
+    end
+
+    local function skip(s, i)
+        return s:find("[^ \t\r\n]", i) or #s + 1
+    end
+
+    local function decodeString(s, i)
+        local parts, j = {}, i + 1
+        while true do
+            local k = s:find('["\\]', j)
+            if not k then error("unterminated string at " .. i) end
+            parts[#parts + 1] = s:sub(j, k - 1)
+            if s:byte(k) == 34 then return table.concat(parts), k + 1 end
+
+            local c = s:sub(k + 1, k + 1)
+            if c == "u" then
+                parts[#parts + 1] = utf8.char(tonumber(s:sub(k + 2, k + 5), 16))
+                j = k + 6
+            else
+                parts[#parts + 1] = unescapes[c] or error("invalid escape at " .. k)
+                j = k + 2
+            end
+        end
+    end
+
+    local decode
+
+    local function decodeContainer(s, i, close, member)
+        local t, n = {}, 0
+        i = skip(s, i + 1)
+        if s:byte(i) == close then return t, i + 1 end
+        while true do
+            n = n + 1
+            i = member(s, skip(s, i), t, n)
+            i = skip(s, i)
+            local c = s:byte(i)
+            if c == close then return t, i + 1 end
+            if c ~= 44 then error("expected ',' at " .. i) end
+            i = i + 1
+        end
+    end
+
+    local function element(s, i, t, n)
+        local v
+        v, i = decode(s, i)
+        t[n] = v
+        return i
+    end
+
+    local function member(s, i, t)
+        local key
+        key, i = decodeString(s, i)
+        i = skip(s, i)
+        if s:byte(i) ~= 58 then error("expected ':' at " .. i) end
+
+        local v
+        v, i = decode(s, skip(s, i + 1))
+        t[key] = v
+        return i
+    end
+
+    decode = function(s, i)
+        local c = s:byte(i)
+        if c == 123 then return decodeContainer(s, i, 125, member)
+        elseif c == 91 then return decodeContainer(s, i, 93, element)
+        elseif c == 34 then return decodeString(s, i)
+        elseif s:sub(i, i + 3) == "true" then return true, i + 4
+        elseif s:sub(i, i + 4) == "false" then return false, i + 5
+        elseif s:sub(i, i + 3) == "null" then return nil, i + 4
+        end
+
+        local j = s:find("[^%d%.eE+-]", i) or #s + 1
+        local number = tonumber(s:sub(i, j - 1)) or error("invalid number at " .. i)
+        return number, j
+    end
+
+    function Reference.decode(s)
+        return (decode(s, skip(s, 1)))
+    end
+end
+
+local function library(name)
+    return name == "native" and json or Reference
+end
+
+-- Each runs n times and returns the size of its last result, so the work can't be skipped
+function Decode(name, document, n)
+    local decode, value = library(name).decode, nil
+    for _ = 1, n do value = decode(document) end
+    return #value
+end
+
+function Encode(name, document, n)
+    local encode, value, text = library(name).encode, json.decode(document), nil
+    for _ = 1, n do text = encode(value) end
+    return #text
+end
@@ -0,0 +1,4 @@
+function Call(x)
+    if not lib0 then return 0 end
+    return lib0.f0(x) + lib9.f49(x)
+end
@@ -0,0 +1,7 @@
+function Score(kind, level)
+    local score = 0
+    for i = 1, 50 do
+        score = score + (#kind * i + level) % 7
+    end
+    return score
+end
@@ -0,0 +1,7 @@
+Counter = 0
+
+-- Counter, id and bitmask work typical of entity bookkeeping
+function Tick(id, flags)
+    Counter = Counter + 1
+    return ((id * 31) ~ flags) & 0xFFFFFF
+end
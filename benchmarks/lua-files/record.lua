@@ -0,0 +1,3 @@
+function Damage(kind, level, stats)
+    return level * stats.attack - stats.armor + #kind
+end
@@ -0,0 +1,8 @@
+Config = {
+    name = "archer",
+    health = 100,
+    damage = 12.5,
+    ranged = true,
+    position = { x = 1.5, y = -2, z = 0 },
+    velocity = { x = 0, y = 0, z = 1 }
+}
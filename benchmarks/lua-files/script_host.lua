@@ -0,0 +1,7 @@
+Health = 100
+Speed  = 4
+
+function Update(dt)
+    Health = math.min(Health + dt, 100)
+    return Health
+end
@@ -0,0 +1,32 @@
+local N = 100000
+
+function Setup()
+    Plain = { x = {}, v = {} }
+    for i = 1, N do
+        Plain.x[i] = i
+        Plain.v[i] = 1 / i
+    end
+
+    X = simd.from(Plain.x)
+    V = simd.from(Plain.v)
+end
+
+-- x = x + v * dt, then the total and the dot product of the two
+function PlainStep(dt)
+    local x, v = Plain.x, Plain.v
+    for i = 1, N do
+        x[i] = x[i] + v[i] * dt
+    end
+
+    local sum, dot = 0, 0
+    for i = 1, N do
+        sum = sum + x[i]
+        dot = dot + x[i] * v[i]
+    end
+    return sum + dot
+end
+
+function SimdStep(dt)
+    simd.axpy(dt, V, X)
+    return simd.sum(X) + simd.dot(X, V)
+end
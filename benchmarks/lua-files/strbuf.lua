@@ -0,0 +1,60 @@
+-- Each builds a report of the given size in MB and returns its length and the peak Lua heap in KB
+
+local function line(i)
+    return "row " .. i .. ": user" .. i % 1000 .. " served in " .. i % 97 .. " ms\n"
+end
+
+function Concat(mb)
+    local out, peak, i = "", 0, 0
+    while #out < mb * 1048576 do
+        i = i + 1
+        out = out .. line(i)
+        if i % 256 == 0 then peak = math.max(peak, collectgarbage("count")) end
+    end
+    return #out, peak
+end
+
+function TableConcat(mb)
+    local parts, size, peak, i = {}, 0, 0, 0
+    while size < mb * 1048576 do
+        i = i + 1
+        local s = line(i)
+        parts[i] = s
+        size = size + #s
+        if i % 4096 == 0 then peak = math.max(peak, collectgarbage("count")) end
+    end
+    local out = table.concat(parts)
+    return #out, math.max(peak, collectgarbage("count"))
+end
+
+function Append(mb)
+    local sb, peak, i = strbuf.new(), 0, 0
+    while #sb < mb * 1048576 do
+        i = i + 1
+        sb:append("row ", i, ": user", i % 1000, " served in ", i % 97, " ms\n")
+        if i % 4096 == 0 then peak = math.max(peak, collectgarbage("count")) end
+    end
+    local out = sb:tostring()
+    return #out, math.max(peak, collectgarbage("count"))
+end
+
+function Appendf(mb)
+    local sb, peak, i = strbuf.new(), 0, 0
+    while #sb < mb * 1048576 do
+        i = i + 1
+        sb:appendf("row %d: user%d served in %d ms\n", i, i % 1000, i % 97)
+        if i % 4096 == 0 then peak = math.max(peak, collectgarbage("count")) end
+    end
+    local out = sb:tostring()
+    return #out, math.max(peak, collectgarbage("count"))
+end
+
+-- Handed to C++ without becoming a Lua string
+function Build(mb)
+    local sb, i = strbuf.new(), 0
+    while #sb < mb * 1048576 do
+        i = i + 1
+        sb:append("row ", i, ": user", i % 1000, " served in ", i % 97, " ms\n")
+    end
+    return sb
+end
@@ -0,0 +1,3 @@
+function Tick()
+    return World["e1"]["f1"]
+end
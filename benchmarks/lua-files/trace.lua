@@ -0,0 +1,3 @@
+function Add(value)
+    return value + 1
+end
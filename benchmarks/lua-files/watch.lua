@@ -0,0 +1,12 @@
+for i = 1, 50 do
+    _G["Setting" .. i] = i
+end
+
+Frame = 0
+
+function Tick()
+    Frame = Frame + 1
+    if Frame % 100 == 0 then
+        Setting1 = Frame
+    end
+end
@@ -0,0 +1,42 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Calls a pure scoring function with arguments drawn from 64 distinct pairs, running it
+// every time and with its results memoized
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Calls = 200000;
+
+    const std::vector<SL::String> kinds = { "orc", "goblin", "troll", "dragon", "slime", "wolf", "bat", "lich" };
+
+    const auto time = [&](const char* label, bool memoize)
+    {
+        SL::Runtime runtime(BENCH_FILE_DIR "/memoize.lua");
+        if (memoize) runtime.memoize("Score", 256);
+
+        int64_t sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Calls; i++)
+            sum += std::get<0>(runtime.runFunction<int64_t>("Score", kinds[i % 8], int64_t(i / 8 % 8)).value());
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+        std::cout << label << ": " << us * 1000 / Calls << " ns/call (" << sum;
+        if (memoize) std::cout << ", hit rate " << runtime.memoStats("Score").hitRate();
+        std::cout << ")\n";
+    };
+
+    time("interpreted", false);
+    time("memoized", true);
+
+    return 0;
+}
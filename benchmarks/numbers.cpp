@@ -0,0 +1,37 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Calls an integer heavy function with SL::Number (float) arguments, which Lua has to
+// convert back to integers for its bitwise operators, and with int64_t arguments
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Calls = 1000000;
+
+    SL::Runtime runtime(BENCH_FILE_DIR "/numbers.lua");
+    SL_ASSERT(runtime, "Failed to load benchmark script");
+
+    const auto time = [&](const char* label, auto type)
+    {
+        using T = decltype(type);
+
+        T sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Calls; i++)
+            sum += std::get<0>(runtime.runFunction<T>("Tick", static_cast<T>(i & 0xFFFF), static_cast<T>(0x5A5A)).value());
+        const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << label << ": " << ns / Calls << " ns/call (" << sum << ")\n";
+    };
+
+    time("SL::Number", SL::Number());
+    time("int64_t",    int64_t());
+
+    return 0;
+}
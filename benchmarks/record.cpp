@@ -0,0 +1,50 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Calls a function taking a string, an integer and a table, without and while recording,
+// then replays the recording
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Calls = 200000;
+
+    const auto path = std::filesystem::temp_directory_path() / "sl-bench-record.slr";
+
+    SL::Table stats;
+    stats.set("attack", int64_t(12));
+    stats.set("armor", int64_t(5));
+
+    SL::Runtime runtime(BENCH_FILE_DIR "/record.lua");
+    const auto time = [&](const char* label)
+    {
+        int64_t sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Calls; i++)
+            sum += std::get<0>(runtime.runFunction<int64_t>("Damage", SL::String("orc"), int64_t(i % 50), stats).value());
+        const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << label << ": " << ns / Calls << " ns/call (" << sum << ")\n";
+    };
+
+    time("not recording");
+    runtime.record(path);
+    time("recording");
+    runtime.stopRecording();
+
+    const auto recording = SL::Recording::open(path);
+    std::cout << "recording: " << std::filesystem::file_size(path) / Calls << " bytes/call\n";
+
+    SL::Runtime other(BENCH_FILE_DIR "/record.lua");
+    const auto replay = other.replay(*recording);
+    std::cout << "replay: " << static_cast<double>(replay.total) / Calls << " ns/call, " << replay.errors << " errors\n";
+
+    std::filesystem::remove(path);
+    return 0;
+}
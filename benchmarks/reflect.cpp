@@ -0,0 +1,66 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+struct Vec3
+{
+    SL::Number x, y, z;
+};
+
+struct Config
+{
+    SL::String  name;
+    SL::Number  health, damage;
+    SL::Boolean ranged;
+    Vec3        position, velocity;
+};
+
+SL_REFLECT(Vec3, x, y, z)
+SL_REFLECT(Config, name, health, damage, ranged, position, velocity)
+
+// Decodes the same global through an intermediate SL::Table and through the reflected struct
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Iterations = 100000;
+
+    SL::Runtime runtime(BENCH_FILE_DIR "/reflect.lua");
+    SL_ASSERT(runtime, "Failed to load benchmark script");
+
+    const auto time = [&](const char* label, auto&& decode)
+    {
+        SL::Number sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Iterations; i++) sum += decode().position.x;
+        const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << label << ": " << ns / Iterations << " ns/decode (" << sum << ")\n";
+    };
+
+    const auto vec = [](const SL::Table& t)
+    {
+        return Vec3{ t.get<SL::Number>("x"), t.get<SL::Number>("y"), t.get<SL::Number>("z") };
+    };
+
+    time("SL::Table", [&]()
+    {
+        const auto res = runtime.getGlobal<SL::Table>("Config");
+        const auto& t = res.value();
+        return Config{
+            t.get<SL::String>("name"), t.get<SL::Number>("health"), t.get<SL::Number>("damage"),
+            t.get<SL::Boolean>("ranged"), vec(t.get<SL::Table>("position")), vec(t.get<SL::Table>("velocity"))
+        };
+    });
+
+    time("SL_REFLECT", [&]()
+    {
+        return runtime.getGlobal<Config>("Config").value();
+    });
+
+    return 0;
+}
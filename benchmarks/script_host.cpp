@@ -0,0 +1,63 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Loads the same small script many times, once as a Runtime each and once into a
+// shared ScriptHost, and compares the memory and time each script costs
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Scripts = 500;
+    const auto elapsed = [](Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    };
+
+    double runtime_bytes = 0, runtime_us = 0;
+    {
+        std::vector<SL::Runtime> runtimes;
+        runtimes.reserve(Scripts);
+
+        const auto start = Clock::now();
+        for (int i = 0; i < Scripts; i++) runtimes.emplace_back(BENCH_FILE_DIR "/script_host.lua");
+        runtime_us = elapsed(start);
+
+        for (auto& runtime : runtimes)
+        {
+            SL_ASSERT(runtime.runFunction<SL::Number>("Update", 1.f), "Failed to run script");
+            runtime_bytes += runtime.memory();
+        }
+    }
+
+    double host_bytes = 0, host_us = 0;
+    {
+        SL::ScriptHost host;
+        const auto empty = host.memory();
+
+        std::vector<SL::ScriptHost::Script> scripts;
+        scripts.reserve(Scripts);
+
+        const auto start = Clock::now();
+        for (int i = 0; i < Scripts; i++) scripts.push_back(host.load(BENCH_FILE_DIR "/script_host.lua").value());
+        host_us = elapsed(start);
+
+        for (auto script : scripts)
+            SL_ASSERT(host.runFunction<SL::Number>(script, "Update", 1.f), "Failed to run script");
+        host.collect();
+        host_bytes = static_cast<double>(host.memory() - empty);
+    }
+
+    std::cout << Scripts << " scripts\n";
+    std::cout << "runtime each: " << runtime_bytes / Scripts << " bytes/script, " << runtime_us / Scripts << " us/script\n";
+    std::cout << "script host:  " << host_bytes / Scripts << " bytes/script, " << host_us / Scripts << " us/script\n";
+    std::cout << "memory ratio: " << runtime_bytes / host_bytes << "x\n";
+
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Compares a particle style update written as Lua loops with the same update through simd
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Steps = 200;
+
+    auto runtime = SL::Runtime::create<SL::Lib::Simd>(BENCH_FILE_DIR "/simd.lua");
+    SL_ASSERT(runtime, "Failed to load benchmark script");
+    SL_ASSERT(runtime.runFunction<>("Setup"), "Setup failed");
+
+    std::cout << "simd kernels: " << SL::Lib::Simd::isa() << "\n";
+
+    for (const auto* function : { "PlainStep", "SimdStep" })
+    {
+        const auto start = Clock::now();
+        for (int i = 0; i < Steps; i++)
+            SL_ASSERT(runtime.runFunction<SL::Number>(function, 0.01f), "Step failed");
+        const auto ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << function << ": " << ms / Steps << " ms/step\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+// Creates runtimes for a script that only does arithmetic, opening every standard
+// library, only the base library, and every library lazily
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Runtimes = 2000;
+    constexpr const char* Script = "function Step(x) return x * 2 + 1 end";
+
+    const auto time = [&](const char* label, const SL::Runtime::Options& options)
+    {
+        std::size_t bytes = 0;
+        SL::Number sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Runtimes; i++)
+        {
+            auto runtime = SL::Runtime::fromBuffer(Script, "step", options);
+            sum += std::get<0>(runtime.runFunction<SL::Number>("Step", 1.f).value());
+            bytes += runtime.memory();
+        }
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::cout << label << ": " << bytes / Runtimes << " bytes/runtime, " << us / Runtimes << " us/runtime (" << sum << ")\n";
+    };
+
+    time("all",  { SL::StdLib::All });
+    time("base", { SL::StdLib::Base });
+    time("lazy", { SL::StdLib::All, true });
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Builds a report line by line with `..`, with table.concat and with a strbuf. `..` is
+// quadratic, so it only builds small reports, the others build 100 MB
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    // A fresh state each time, the string table of the previous run would still be shrinking
+    const auto time = [&](const char* label, const char* function, double mb)
+    {
+        auto runtime = SL::Runtime::create<SL::Lib::StrBuf>(BENCH_FILE_DIR "/strbuf.lua");
+
+        const auto start = Clock::now();
+        const auto res = runtime.runFunction<int64_t, double>(function, mb);
+        const auto s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << label << " " << mb << " MB: " << s * 1000 << " ms, " << mb / s << " MB/s, peak heap " << std::get<1>(*res) / 1024 << " MB\n";
+    };
+
+    for (const double mb : { 0.25, 0.5, 1.0 }) time("..          ", "Concat", mb);
+    for (const double mb : { 1.0, 100.0 }) time("table.concat", "TableConcat", mb);
+    for (const double mb : { 1.0, 100.0 }) time("sb:append   ", "Append", mb);
+    for (const double mb : { 1.0, 100.0 }) time("sb:appendf  ", "Appendf", mb);
+
+    auto runtime = SL::Runtime::create<SL::Lib::StrBuf>(BENCH_FILE_DIR "/strbuf.lua");
+    const auto start = Clock::now();
+    const auto res = runtime.runFunction<SL::Lib::StrBuf::View>("Build", 100.0);
+    const auto s = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "sb to C++     " << std::get<0>(*res).text.size() / double(1 << 20) << " MB: " << s * 1000 << " ms, no copy\n";
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Pushes a world of 1000 entities with 100 fields each (100k keys) into Lua every tick,
+// after changing 1% of the fields, rebuilt from scratch and synced into a bound table
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Entities = 1000;
+    constexpr int Fields   = 100;
+    constexpr int Churn    = Entities * Fields / 100;
+    constexpr int Ticks    = 50;
+
+    std::vector<SL::Atom> fields;
+    for (int f = 0; f < Fields; f++) fields.emplace_back("f" + std::to_string(f));
+
+    const auto build = [&]()
+    {
+        SL::Table world;
+        for (int e = 0; e < Entities; e++)
+        {
+            SL::Table entity;
+            for (const auto& field : fields) entity.set(field, int64_t(e));
+            world.set("e" + std::to_string(e), entity);
+        }
+        return world;
+    };
+
+    const auto time = [&](const char* label, bool bind)
+    {
+        SL::Runtime runtime(BENCH_FILE_DIR "/sync.lua");
+        auto world = build();
+        if (bind) runtime.bind(world);
+
+        std::vector<SL::Table*> entities;
+        for (int e = 0; e < Entities; e++) entities.push_back(&world.get<SL::Table>("e" + std::to_string(e)));
+
+        std::mt19937 rng(42);
+        int64_t sum = 0;
+        const auto start = Clock::now();
+        for (int tick = 0; tick < Ticks; tick++)
+        {
+            for (int i = 0; i < Churn; i++)
+                entities[rng() % Entities]->set(fields[rng() % Fields], int64_t(tick));
+
+            runtime.setGlobal("World", world);
+            sum += std::get<0>(runtime.runFunction<int64_t>("Tick").value());
+        }
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::cout << label << ": " << us / Ticks << " us/tick (" << sum << ")\n";
+
+        world.unbind();
+    };
+
+    time("rebuilt", false);
+    time("synced", true);
+
+    return 0;
+}
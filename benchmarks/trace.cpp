@@ -0,0 +1,45 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Cost of recording a span, and of a traced runFunction call with tracing stopped and started
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Spans = 1000000;
+    constexpr int Calls = 200000;
+
+    SL::Trace::start(1 << 20);
+    auto start = Clock::now();
+    for (int i = 0; i < Spans; i++)
+    {
+        SL::Trace::Scope scope("span");
+    }
+    auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    SL::Trace::stop();
+    std::cout << "span: " << ns / Spans / 2 << " ns/event\n";
+
+    SL::Runtime runtime(BENCH_FILE_DIR "/trace.lua");
+    const auto time = [&](const char* label)
+    {
+        int64_t sum = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < Calls; i++) sum += std::get<0>(runtime.runFunction<int64_t>("Add", int64_t(i)).value());
+        const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << label << ": " << ns / Calls << " ns/call (" << sum << ")\n";
+    };
+
+    time("runFunction, stopped");
+    SL::Trace::start(1 << 20);
+    time("runFunction, recording");
+    SL::Trace::stop();
+
+    if (!SL::Trace::instrumented()) std::cout << "(built without SL_TRACE, runFunction isn't instrumented)\n";
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_FILE_DIR
+#define BENCH_FILE_DIR "."
+#endif
+
+// Notices changes to 50 settings a script rarely writes (one write every 100 frames),
+// by polling every setting each frame and by watching them
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int Settings = 50;
+    constexpr int Frames   = 20000;
+
+    std::vector<std::string> names;
+    for (int i = 1; i <= Settings; i++) names.push_back("Setting" + std::to_string(i));
+
+    const auto time = [&](const char* label, auto&& frame)
+    {
+        SL::Runtime runtime(BENCH_FILE_DIR "/watch.lua");
+        std::vector<SL::Number> values(Settings);
+        frame(runtime, values, true);
+
+        const auto start = Clock::now();
+        for (int i = 0; i < Frames; i++)
+        {
+            runtime.runFunction<>("Tick");
+            frame(runtime, values, false);
+        }
+        const auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        std::cout << label << ": " << us / Frames << " us/frame (" << values[0] << ")\n";
+    };
+
+    time("polled", [&](SL::Runtime& runtime, std::vector<SL::Number>& values, bool)
+    {
+        for (int i = 0; i < Settings; i++) values[i] = runtime.getGlobal<SL::Number>(names[i]).value();
+    });
+
+    time("watched", [&](SL::Runtime& runtime, std::vector<SL::Number>& values, bool setup)
+    {
+        if (setup)
+            for (int i = 0; i < Settings; i++)
+                runtime.watch<SL::Number>(names[i], [&values, i](SL::Number value) { values[i] = value; });
+        else runtime.dispatchWatches();
+    });
+
+    return 0;
+}
@@ -2,4 +2,18 @@
 
 #include "Lua/Lib.hpp"
 #include "Lua/Runtime.hpp"
-#include "Lua/Table.hpp"
\ No newline at end of file
+#include "Lua/ScriptHost.hpp"
+#include "Lua/RuntimePool.hpp"
+#include "Lua/Table.hpp"
+#include "Lua/Reflect.hpp"
+#include "Lua/Containers.hpp"
+#include "Lua/EventQueue.hpp"
+#include "Lua/Trace.hpp"
+#include "Lua/Recording.hpp"
+#include "Lua/Channel.hpp"
+#include "Lua/FrozenTable.hpp"
+#include "Lua/Lib/Simd.hpp"
+#include "Lua/Lib/Buffer.hpp"
+#include "Lua/Lib/Json.hpp"
+#include "Lua/Lib/StrBuf.hpp"
+#include "Lua/Lib/Channel.hpp"
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../Def.hpp"
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace SL
+{
+    /**
+     * @brief An interned string used as a table key.
+     *
+     * Every distinct string is stored once in a process-wide table and identified
+     * by a small integer, so keys cost four bytes per entry and comparing or hashing
+     * them never touches the characters. Constructing an atom from a string hashes
+     * it once to find its id, cache atoms that are used often (see \ref SL_ATOM).
+     * Interning is thread-safe, and reading the string of an atom takes no lock.
+     *
+     * Strings are counted by the atoms referring to them, and the ones no atom refers
+     * to anymore are freed in batches, so keys read from data (ids, names, ...) don't
+     * pile up in a long-running process. Atoms made from string literals and \ref SL_ATOM
+     * are pinned instead: they are never freed, and copying them writes no counter.
+     * Atoms made from a `const char*` or a `char` buffer are counted, like the ones
+     * made from a `std::string`.
+     */
+    struct Atom
+    {
+        /**
+         * @brief Memory held by the atom table
+         */
+        struct Report
+        {
+            std::size_t count;  ///< Number of interned strings, including the ones waiting to be freed
+            std::size_t bytes;  ///< Bytes held by the strings and the lookup structures
+        };
+
+        /// The empty string
+        Atom() : _id(0) { }
+
+        SL_SYMBOL Atom(std::string_view name);
+        Atom(const std::string& name) : Atom(std::string_view(name)) { }
+        template<std::size_t N>
+        Atom(const char (&name)[N]) : Atom(pin(name)) { }
+        template<std::size_t N>
+        Atom(char (&name)[N]) : Atom(std::string_view(name)) { }
+        template<typename T, std::enable_if_t<std::is_pointer_v<std::remove_reference_t<T>> && std::is_convertible_v<T, const char*>, int> = 0>
+        Atom(T&& name) : Atom(std::string_view(name)) { }
+
+        Atom(const Atom& other) : _id(other._id) { if (_id) _retain(_id); }
+        Atom(Atom&& other) noexcept : _id(other._id) { other._id = 0; }
+
+        Atom& operator=(const Atom& other)
+        {
+            if (_id != other._id) Atom(other).swap(*this);
+            return *this;
+        }
+
+        Atom& operator=(Atom&& other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        ~Atom() { if (_id) _release(_id); }
+
+        void swap(Atom& other) noexcept { std::swap(_id, other._id); }
+
+        /**
+         * @brief Intern a string, failing instead of asserting when the table is full
+         * 
+         * The table holds up to 4M strings at once, constructing an atom past that is a
+         * fatal error. Readers of data use this to report it instead.
+         * 
+         * @param name The string
+         * @param atom Set to the atom of the string
+         * @return false If the table is full
+         */
+        SL_SYMBOL static bool intern(std::string_view name, Atom& atom);
+
+        /**
+         * @brief The atom of a string that is never freed
+         */
+        SL_SYMBOL static Atom pin(std::string_view name);
+
+        /**
+         * @brief Look up the atom of a string without interning it
+         * @param name The string
+         * @param atom Set to the atom of the string if it has been interned
+         * @return true If the string has been interned before
+         */
+        SL_SYMBOL static bool find(std::string_view name, Atom& atom);
+
+        SL_SYMBOL static Report report();
+
+        SL_SYMBOL std::string_view view() const;
+        std::string str() const { return std::string(view()); }
+
+        uint32_t id() const { return _id; }
+
+        bool operator==(const Atom& other) const { return _id == other._id; }
+        bool operator!=(const Atom& other) const { return _id != other._id; }
+
+    private:
+        SL_SYMBOL static void _retain(uint32_t id);
+        SL_SYMBOL static void _release(uint32_t id);
+
+        uint32_t _id;
+    };
+
+    inline std::ostream& operator<<(std::ostream& os, const Atom& atom)
+    {
+        return os << atom.view();
+    }
+}
+
+/**
+ * @brief Atom of a string literal, interned the first time the expression runs
+ */
+#define SL_ATOM(literal) ([]() -> const SL::Atom& { static const SL::Atom atom = SL::Atom::pin(literal); return atom; }())
+
+template<>
+struct std::hash<SL::Atom>
+{
+    std::size_t operator()(const SL::Atom& atom) const noexcept { return atom.id(); }
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Lua.hpp"
+
+#include "../Util.hpp"
+#include "../Def.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace SL
+{
+    struct Runtime;
+
+    /**
+     * @brief A read-only pack of Lua modules, memory-mapped from a single file.
+     *
+     * A bundle holds the modules of a directory, as source or precompiled chunks, with
+     * an index sorted by module name. Opening it maps the file and checks the index, and
+     * modules are then loaded straight from the mapping by a `package.searchers` entry
+     * (see \ref Runtime::mount), so `require` never touches the filesystem.
+     *
+     * Module names follow `require`: `ai/path.lua` is `ai.path` and `ai/init.lua` is `ai`.
+     * The runtimes a bundle is mounted in share its mapping, so the bundle itself can be
+     * moved or destroyed, but memory handed to \ref view must outlive them.
+     */
+    struct Bundle
+    {
+        enum class ErrorCode
+        {
+            None,
+            FileError,
+            InvalidBundle,
+            CompileError
+        };
+
+        template<typename T>
+        using Result = Util::Result<T, Util::Error<ErrorCode>>;
+
+        /**
+         * @brief Map a bundle file into memory
+         * @param filename Path of the bundle written by \ref pack
+         * @return Result<Bundle> The bundle or error
+         */
+        SL_SYMBOL static Result<Bundle>
+        open(const std::filesystem::path& filename);
+
+        /**
+         * @brief Use a bundle that is already in memory, it must outlive the returned bundle
+         * @param data Start of the bundle
+         * @param size Size of the bundle in bytes
+         * @return Result<Bundle> The bundle or error
+         */
+        SL_SYMBOL static Result<Bundle>
+        view(const void* data, std::size_t size);
+
+        /**
+         * @brief Pack the `.lua` files of a directory (recursively) into a bundle file
+         * @param directory  Root of the modules
+         * @param filename   Path of the bundle to write
+         * @param precompile Store the modules as bytecode, so they aren't parsed when loaded
+         * @return Result<void> Returns if an error has occured
+         */
+        SL_SYMBOL static Result<void>
+        pack(
+            const std::filesystem::path& directory,
+            const std::filesystem::path& filename,
+            bool precompile = true);
+
+        SL_SYMBOL Bundle(Bundle&& b);
+        Bundle(const Bundle&) = delete;
+
+        SL_SYMBOL ~Bundle();
+
+        /**
+         * @brief Find the chunk of a module
+         * @param name  Name of the module, e.g. `ai.path`
+         * @param chunk Set to the source or bytecode of the module if it is in the bundle
+         * @return true If the module is in the bundle
+         */
+        SL_SYMBOL bool find(std::string_view name, std::string_view& chunk) const;
+
+        /**
+         * @brief Number of modules in the bundle
+         */
+        SL_SYMBOL std::size_t size() const;
+
+    private:
+        friend struct Runtime;
+
+        Bundle(const char* data, std::size_t size, void* mapping);
+
+        SL_SYMBOL bool _valid() const;
+        SL_SYMBOL void _install(State L) const;
+
+        const char*                 _data;
+        std::size_t                 _size;
+        std::shared_ptr<const void> _mapping; ///< Unmaps the file, null for a view
+    };
+
+} // SL
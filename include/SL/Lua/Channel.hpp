@@ -0,0 +1,208 @@
+#pragma once
+
+#include "Reflect.hpp"
+#include "Lib/Buffer.hpp"
+
+#include "../Util.hpp"
+#include "../Def.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace SL
+{
+    /**
+     * @brief Bounded lock-free queue passing values between runtimes, from any thread.
+     *
+     * Values are copied out of the sending state and rebuilt in the receiving one, so
+     * states never share Lua objects: numbers, booleans, strings and tables (by their
+     * contents, like a \ref Recording holds them). \ref Lib::Buffer::View s are handed
+     * over with their owner instead, so their bytes are never copied.
+     *
+     * The `try_` functions never block. `send` waits for room and `recv` for a value,
+     * sleeping only while the queue is full or empty. Once closed, a channel takes no
+     * more values and `recv` returns the ones left before reporting it's closed.
+     *
+     * Channels are shared through `std::shared_ptr`, and \ref open finds one by name so
+     * that runtimes created apart can meet on it. Lua uses them through \ref Lib::Channel.
+     */
+    struct Channel
+    {
+        enum class ErrorCode
+        {
+            None,
+            Full,
+            Empty,
+            Closed,
+            TypeMismatch
+        };
+
+        template<typename T>
+        using Result = Util::Result<T, Util::Error<ErrorCode>>;
+
+        /**
+         * @brief A value in transit, a buffer when `value` is empty
+         */
+        struct Message
+        {
+            std::string       value;  ///< Encoded like the values of a \ref Recording
+            Lib::Buffer::View buffer;
+        };
+
+        Channel(const Channel&) = delete;
+        Channel(Channel&&) = delete;
+
+        /**
+         * @param capacity Number of values the channel holds, rounded up to a power of two
+         */
+        SL_SYMBOL explicit Channel(std::size_t capacity);
+
+        /**
+         * @brief The channel with the given name, created with the capacity if there is none
+         *
+         * Names are shared by every runtime of the process, a channel is forgotten once
+         * nothing holds it anymore.
+         */
+        SL_SYMBOL static std::shared_ptr<Channel>
+        open(const std::string& name, std::size_t capacity = 1024);
+
+        template<typename T>
+        Result<void> try_send(const T& value);
+
+        /**
+         * @brief Take the oldest value if there is one
+         * @tparam T Type of the value, a value of another type is taken and reported as TypeMismatch
+         */
+        template<typename T>
+        Result<T> try_recv();
+
+        template<typename T>
+        Result<void> send(const T& value);
+
+        template<typename T>
+        Result<T> recv();
+
+        /**
+         * @return true If the message was queued, false if the channel is full or closed
+         */
+        SL_SYMBOL bool try_send(Message&& message);
+
+        /**
+         * @return true If a message was taken, false if the channel is empty
+         */
+        SL_SYMBOL bool try_recv(Message& message);
+
+        /**
+         * @return true Once the message is queued, false if the channel is closed
+         */
+        SL_SYMBOL bool send(Message&& message);
+
+        /**
+         * @return true Once a message is taken, false if the channel is closed and empty
+         */
+        SL_SYMBOL bool recv(Message& message);
+
+        SL_SYMBOL void close();
+
+        bool closed() const { return _closed.load(std::memory_order_acquire); }
+
+        std::size_t capacity() const { return _ring.capacity(); }
+
+    private:
+        template<typename T>
+        static Message _message(const T& value);
+
+        template<typename T>
+        static Result<T> _value(const Message& message);
+
+        void _notify();
+
+        Util::Ring<Message>     _ring;
+        std::atomic<bool>       _closed;
+
+        // Only touched when a send or recv has to wait
+        std::atomic<int>        _waiting;
+        std::mutex              _mutex;
+        std::condition_variable _wake;
+    };
+
+    namespace detail
+    {
+
+    /**
+     * @brief A Lua state of the calling thread to convert C++ values in
+     */
+    SL_SYMBOL State __channelState();
+
+    /**
+     * @brief Copies the value at index into a message, or hands over its bytes if it's a buffer
+     */
+    SL_SYMBOL void __encodeMessage(State L, int index, Channel::Message& message);
+
+    SL_SYMBOL void __pushMessage(State L, const Channel::Message& message);
+
+    }
+
+    /* struct Channel */
+    template<typename T>
+    Channel::Message Channel::_message(const T& value)
+    {
+        Message message;
+        if constexpr (std::is_same_v<T, Lib::Buffer::View>) message.buffer = value;
+        else
+        {
+            const State L = detail::__channelState();
+            CompileTime::TypeMap<T>::push(L, value);
+            detail::__encodeMessage(L, -1, message);
+            Lib::detail::__pop(L, 1);
+        }
+        return message;
+    }
+
+    template<typename T>
+    Channel::Result<T> Channel::_value(const Message& message)
+    {
+        const State L = detail::__channelState();
+        detail::__pushMessage(L, message);
+
+        T value;
+        CompileTime::TypeError error;
+        if (!CompileTime::take<T>(L, value, error)) return { { ErrorCode::TypeMismatch, error.what() } };
+        return { std::move(value) };
+    }
+
+    template<typename T>
+    Channel::Result<void> Channel::try_send(const T& value)
+    {
+        if (closed()) return { ErrorCode::Closed };
+        if (!try_send(_message(value))) return { closed() ? ErrorCode::Closed : ErrorCode::Full };
+        return { };
+    }
+
+    template<typename T>
+    Channel::Result<T> Channel::try_recv()
+    {
+        Message message;
+        if (!try_recv(message)) return { closed() ? ErrorCode::Closed : ErrorCode::Empty };
+        return _value<T>(message);
+    }
+
+    template<typename T>
+    Channel::Result<void> Channel::send(const T& value)
+    {
+        if (!send(_message(value))) return { ErrorCode::Closed };
+        return { };
+    }
+
+    template<typename T>
+    Channel::Result<T> Channel::recv()
+    {
+        Message message;
+        if (!recv(message)) return { ErrorCode::Closed };
+        return _value<T>(message);
+    }
+
+} // SL
@@ -0,0 +1,548 @@
+#pragma once
+
+#include "Reflect.hpp"
+
+#include <array>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// TypeMaps for standard containers. Sequences (vectors, arrays, pairs and tuples) are Lua
+// arrays, maps are Lua tables keyed by the map's keys. Pushes presize the Lua table and
+// fill it with raw sets, constructs read the elements straight off the stack.
+
+namespace SL::CompileTime
+{
+    namespace detail
+    {
+
+    template<typename T>
+    bool checkElement(State L, std::size_t index, TypeError& error)
+    {
+        __rawGetI(L, static_cast<int64_t>(index));
+        const bool good = CompileTime::check<T>(L, error);
+        Lib::detail::__pop(L, 1);
+
+        if (!good) error.prepend(index);
+        return good;
+    }
+
+    template<typename T>
+    bool takeElement(State L, std::size_t index, T& value, TypeError& error)
+    {
+        __rawGetI(L, static_cast<int64_t>(index));
+        if (CompileTime::take<T>(L, value, error)) return true;
+
+        error.prepend(index);
+        return false;
+    }
+
+    template<typename T>
+    T constructElement(State L, std::size_t index)
+    {
+        __rawGetI(L, static_cast<int64_t>(index));
+        return CompileTime::take<T>(L);
+    }
+
+    template<typename T>
+    void pushElement(State L, std::size_t index, const T& value)
+    {
+        TypeMap<T>::push(L, value);
+        __rawSetI(L, static_cast<int64_t>(index));
+    }
+
+    template<typename K>
+    void prependKey(TypeError& error, const K& key)
+    {
+        if constexpr (std::is_convertible_v<const K&, std::string>) error.prepend(std::string(key).c_str());
+        else if constexpr (std::is_integral_v<K>) error.prepend(static_cast<std::size_t>(key));
+        else if constexpr (std::is_arithmetic_v<K>) error.prepend(std::to_string(key).c_str());
+    }
+
+    /**
+     * @brief Fixed size sequences accessed with std::get, pushed as arrays
+     */
+    template<typename T>
+    struct TupleMap
+    {
+        static constexpr std::size_t Size = std::tuple_size_v<T>;
+
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            TypeError error;
+            return check(L, error);
+        }
+
+        static bool
+        check(State L, TypeError& error)
+        {
+            if (!__expectTable(L, error)) return false;
+            return checkAll(L, error, std::make_index_sequence<Size>());
+        }
+
+        static void
+        push(State L, const T& value)
+        {
+            __createTable(L, static_cast<int>(Size), 0);
+            pushAll(L, value, std::make_index_sequence<Size>());
+        }
+
+        static T
+        construct(State L)
+        {
+            T value;
+            constructAll(L, value, std::make_index_sequence<Size>());
+            return value;
+        }
+
+        static bool
+        take(State L, T& value, TypeError& error)
+        {
+            const bool good = __expectTable(L, error) && takeAll(L, value, error, std::make_index_sequence<Size>());
+            Lib::detail::__pop(L, 1);
+            return good;
+        }
+
+    private:
+        template<std::size_t... I>
+        static bool checkAll(State L, TypeError& error, std::index_sequence<I...>)
+        {
+            return (checkElement<std::tuple_element_t<I, T>>(L, I + 1, error) && ...);
+        }
+
+        template<std::size_t... I>
+        static void pushAll(State L, const T& value, std::index_sequence<I...>)
+        {
+            (pushElement(L, I + 1, std::get<I>(value)), ...);
+        }
+
+        template<std::size_t... I>
+        static void constructAll(State L, T& value, std::index_sequence<I...>)
+        {
+            ((std::get<I>(value) = constructElement<std::tuple_element_t<I, T>>(L, I + 1)), ...);
+        }
+
+        template<std::size_t... I>
+        static bool takeAll(State L, T& value, TypeError& error, std::index_sequence<I...>)
+        {
+            return (takeElement(L, I + 1, std::get<I>(value), error) && ...);
+        }
+    };
+
+    template<typename T>
+    int TupleMap<T>::LuaType = TypeMap<SL::Table>::LuaType;
+
+    /**
+     * @brief Associative containers, pushed as tables keyed by the container's keys
+     */
+    template<typename M>
+    struct MapMap
+    {
+        using Key   = typename M::key_type;
+        using Value = typename M::mapped_type;
+
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            TypeError error;
+            return check(L, error);
+        }
+
+        static bool
+        check(State L, TypeError& error)
+        {
+            if (!__expectTable(L, error)) return false;
+
+            // Stack: table, key, value
+            __pushNil(L);
+            while (__next(L))
+            {
+                bool good = CompileTime::check<Value>(L, error);
+                Lib::detail::__pop(L, 1);
+                if (good) good = CompileTime::check<Key>(L, error);
+
+                if (!good)
+                {
+                    Lib::detail::__pop(L, 1);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void
+        push(State L, const M& value)
+        {
+            __createTable(L, 0, static_cast<int>(value.size()));
+            for (const auto& [k, v] : value)
+            {
+                TypeMap<Key>::push(L, k);
+                TypeMap<Value>::push(L, v);
+                __rawSet(L);
+            }
+        }
+
+        static M
+        construct(State L)
+        {
+            M value;
+            __pushNil(L);
+            while (__next(L))
+            {
+                __pushValue(L, -2);
+                auto k = CompileTime::take<Key>(L);
+                value.emplace(std::move(k), CompileTime::take<Value>(L));
+            }
+            return value;
+        }
+
+        static bool
+        take(State L, M& value, TypeError& error)
+        {
+            if (!__expectTable(L, error))
+            {
+                Lib::detail::__pop(L, 1);
+                return false;
+            }
+
+            value.clear();
+            __pushNil(L);
+            while (__next(L))
+            {
+                // Copy the key so the original is left for lua_next
+                Key k{};
+                __pushValue(L, -2);
+                if (!CompileTime::take<Key>(L, k, error))
+                {
+                    Lib::detail::__pop(L, 3);
+                    return false;
+                }
+
+                Value v{};
+                if (!CompileTime::take<Value>(L, v, error))
+                {
+                    prependKey(error, k);
+                    Lib::detail::__pop(L, 2);
+                    return false;
+                }
+                value.emplace(std::move(k), std::move(v));
+            }
+            Lib::detail::__pop(L, 1);
+            return true;
+        }
+    };
+
+    template<typename M>
+    int MapMap<M>::LuaType = TypeMap<SL::Table>::LuaType;
+
+    }
+
+    /**
+     * @brief Sequences, pushed as presized arrays
+     */
+    template<typename T>
+    struct TypeMap<std::vector<T>>
+    {
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            TypeError error;
+            return check(L, error);
+        }
+
+        static bool
+        check(State L, TypeError& error)
+        {
+            if (!detail::__expectTable(L, error)) return false;
+
+            const auto size = detail::__rawLen(L);
+            for (std::size_t i = 1; i <= size; i++)
+                if (!detail::checkElement<T>(L, i, error)) return false;
+            return true;
+        }
+
+        static void
+        push(State L, const std::vector<T>& value)
+        {
+            detail::__createTable(L, static_cast<int>(value.size()), 0);
+            for (std::size_t i = 0; i < value.size(); i++) detail::pushElement<T>(L, i + 1, value[i]);
+        }
+
+        static std::vector<T>
+        construct(State L)
+        {
+            std::vector<T> value;
+            const auto size = detail::__rawLen(L);
+            value.reserve(size);
+            for (std::size_t i = 1; i <= size; i++) value.push_back(detail::constructElement<T>(L, i));
+            return value;
+        }
+
+        static bool
+        take(State L, std::vector<T>& value, TypeError& error)
+        {
+            if (!detail::__expectTable(L, error))
+            {
+                Lib::detail::__pop(L, 1);
+                return false;
+            }
+
+            const auto size = detail::__rawLen(L);
+            value.clear();
+            value.resize(size);
+            for (std::size_t i = 0; i < size; i++)
+            {
+                bool good;
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    // std::vector<bool> hands out proxies instead of references
+                    bool element = false;
+                    good = detail::takeElement(L, i + 1, element, error);
+                    value[i] = element;
+                }
+                else good = detail::takeElement(L, i + 1, value[i], error);
+
+                if (!good)
+                {
+                    Lib::detail::__pop(L, 1);
+                    return false;
+                }
+            }
+            Lib::detail::__pop(L, 1);
+            return true;
+        }
+    };
+
+    template<typename T>
+    int TypeMap<std::vector<T>>::LuaType = TypeMap<SL::Table>::LuaType;
+
+    /**
+     * @brief Fixed size arrays, a Lua array of a different length doesn't match
+     */
+    template<typename T, std::size_t N>
+    struct TypeMap<std::array<T, N>>
+    {
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            TypeError error;
+            return check(L, error);
+        }
+
+        static bool
+        check(State L, TypeError& error)
+        {
+            if (!detail::__expectTable(L, error)) return false;
+            if (detail::__rawLen(L) != N)
+            {
+                error = TypeError{ {}, "expected " + std::to_string(N) + " elements, got " + std::to_string(detail::__rawLen(L)) };
+                return false;
+            }
+
+            for (std::size_t i = 1; i <= N; i++)
+                if (!detail::checkElement<T>(L, i, error)) return false;
+            return true;
+        }
+
+        static void
+        push(State L, const std::array<T, N>& value)
+        {
+            detail::__createTable(L, static_cast<int>(N), 0);
+            for (std::size_t i = 0; i < N; i++) detail::pushElement<T>(L, i + 1, value[i]);
+        }
+
+        static std::array<T, N>
+        construct(State L)
+        {
+            std::array<T, N> value;
+            for (std::size_t i = 0; i < N; i++) value[i] = detail::constructElement<T>(L, i + 1);
+            return value;
+        }
+
+        static bool
+        take(State L, std::array<T, N>& value, TypeError& error)
+        {
+            bool good = detail::__expectTable(L, error);
+            if (good && detail::__rawLen(L) != N)
+            {
+                error = TypeError{ {}, "expected " + std::to_string(N) + " elements, got " + std::to_string(detail::__rawLen(L)) };
+                good = false;
+            }
+
+            for (std::size_t i = 0; good && i < N; i++) good = detail::takeElement(L, i + 1, value[i], error);
+            Lib::detail::__pop(L, 1);
+            return good;
+        }
+    };
+
+    template<typename T, std::size_t N>
+    int TypeMap<std::array<T, N>>::LuaType = TypeMap<SL::Table>::LuaType;
+
+    template<typename A, typename B>
+    struct TypeMap<std::pair<A, B>> : detail::TupleMap<std::pair<A, B>> { };
+
+    template<typename... Ts>
+    struct TypeMap<std::tuple<Ts...>> : detail::TupleMap<std::tuple<Ts...>> { };
+
+    template<typename K, typename V, typename... Rest>
+    struct TypeMap<std::map<K, V, Rest...>> : detail::MapMap<std::map<K, V, Rest...>> { };
+
+    template<typename K, typename V, typename... Rest>
+    struct TypeMap<std::unordered_map<K, V, Rest...>> : detail::MapMap<std::unordered_map<K, V, Rest...>> { };
+
+    /**
+     * @brief Values that may be nil
+     */
+    template<typename T>
+    struct TypeMap<std::optional<T>>
+    {
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            return Lib::detail::__isNil(L) || TypeMap<T>::check(L);
+        }
+
+        static bool
+        check(State L, TypeError& error)
+        {
+            return Lib::detail::__isNil(L) || CompileTime::check<T>(L, error);
+        }
+
+        static void
+        push(State L, const std::optional<T>& value)
+        {
+            if (value) TypeMap<T>::push(L, *value);
+            else detail::__pushNil(L);
+        }
+
+        static std::optional<T>
+        construct(State L)
+        {
+            if (Lib::detail::__isNil(L)) return std::nullopt;
+            return TypeMap<T>::construct(L);
+        }
+
+        static bool
+        take(State L, std::optional<T>& value, TypeError& error)
+        {
+            if (Lib::detail::__isNil(L))
+            {
+                value.reset();
+                Lib::detail::__pop(L, 1);
+                return true;
+            }
+            return CompileTime::take<T>(L, value.emplace(), error);
+        }
+    };
+
+    template<typename T>
+    int TypeMap<std::optional<T>>::LuaType = TypeMap<T>::LuaType;
+
+    /**
+     * @brief One of several types.
+     *
+     * The first alternative whose Lua type is exactly the value's type is picked, so a
+     * numeric string still becomes an SL::String. Otherwise the first alternative that
+     * accepts the value (by conversion) is.
+     */
+    template<typename... Ts>
+    struct TypeMap<std::variant<Ts...>>
+    {
+        using Variant = std::variant<Ts...>;
+
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            return (TypeMap<Ts>::check(L) || ...);
+        }
+
+        static bool
+        check(State L, TypeError& error)
+        {
+            if (check(L)) return true;
+
+            std::string expected;
+            ((expected += (expected.empty() ? "" : " or ") + std::string(detail::__typeName(L, TypeMap<Ts>::LuaType))), ...);
+            error = TypeError{ {}, detail::__mismatch(L, expected) };
+            return false;
+        }
+
+        static void
+        push(State L, const Variant& value)
+        {
+            std::visit([L](const auto& v)
+            {
+                TypeMap<std::decay_t<decltype(v)>>::push(L, v);
+            }, value);
+        }
+
+        static Variant
+        construct(State L)
+        {
+            Variant value;
+            emplace(L, value, alternative(L));
+            return value;
+        }
+
+        static bool
+        take(State L, Variant& value, TypeError& error)
+        {
+            if (!check(L, error))
+            {
+                Lib::detail::__pop(L, 1);
+                return false;
+            }
+
+            const auto top = Lib::detail::__getTop(L);
+            emplace(L, value, alternative(L));
+            Lib::detail::__setTop(L, top - 1);
+            return true;
+        }
+
+    private:
+        static std::size_t
+        alternative(State L)
+        {
+            const auto type = detail::__type(L);
+
+            std::size_t i = 0, index = sizeof...(Ts);
+            ((index == sizeof...(Ts) && TypeMap<Ts>::LuaType == type && TypeMap<Ts>::check(L) ? index = i : 0, i++), ...);
+            if (index != sizeof...(Ts)) return index;
+
+            i = 0;
+            ((index == sizeof...(Ts) && TypeMap<Ts>::check(L) ? index = i : 0, i++), ...);
+            return index;
+        }
+
+        static void
+        emplace(State L, Variant& value, std::size_t index)
+        {
+            Util::CompileTime::static_for<sizeof...(Ts)>([&](auto n)
+            {
+                constexpr std::size_t I = n;
+                if (I == index) value.template emplace<I>(TypeMap<std::variant_alternative_t<I, Variant>>::construct(L));
+            });
+        }
+    };
+
+    template<typename... Ts>
+    int TypeMap<std::variant<Ts...>>::LuaType = TypeMap<std::variant_alternative_t<0, std::variant<Ts...>>>::LuaType;
+
+} // SL::CompileTime
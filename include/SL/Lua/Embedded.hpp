@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Lua.hpp"
+
+#include "../Def.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace SL
+{
+    /**
+     * @brief Registry of Lua scripts compiled into the binary.
+     *
+     * Scripts are added with the `sl_embed_scripts(target FILES ...)` CMake function, which
+     * compiles them to bytecode at build time and generates a translation unit that
+     * registers them when the program starts. They are then run with
+     * \ref Runtime::fromEmbedded, whose `require` calls are served from the registry too.
+     */
+    struct Embedded
+    {
+        /**
+         * @brief A compiled script, as written by `sl-embed`
+         */
+        struct Script
+        {
+            const char*          name;
+            const unsigned char* data;
+            std::size_t          size;
+        };
+
+        /**
+         * @brief Adds scripts to the registry when constructed, used by the generated code
+         */
+        struct Registration
+        {
+            SL_SYMBOL Registration(const Script* scripts, std::size_t count);
+        };
+
+        /**
+         * @brief Find an embedded script
+         * @param name  Name of the script, e.g. `ai.path` for `ai/path.lua`
+         * @param chunk Set to the bytecode of the script if it is embedded
+         * @return true If the script is embedded
+         */
+        SL_SYMBOL static bool find(std::string_view name, std::string_view& chunk);
+
+        /**
+         * @brief Number of embedded scripts
+         */
+        SL_SYMBOL static std::size_t count();
+
+        /**
+         * @brief Compile Lua source to bytecode
+         * @param source    The source
+         * @param chunkname Name of the chunk used in error messages, e.g. `@path/to/file.lua`
+         * @param bytecode  Set to the compiled chunk
+         * @param error     Set to the error message if the source doesn't compile
+         * @return true If the source compiled
+         */
+        SL_SYMBOL static bool compile(
+            std::string_view source,
+            const std::string& chunkname,
+            std::string& bytecode,
+            std::string& error);
+
+    private:
+        friend struct Runtime;
+
+        SL_SYMBOL static void _install(State L);
+    };
+
+} // SL
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "TypeMap.hpp"
+
+#include "../Util.hpp"
+#include "../Def.hpp"
+
+#include <array>
+#include <atomic>
+#include <variant>
+#include <vector>
+
+namespace SL
+{
+    struct Runtime;
+
+    /**
+     * @brief Thread-safe queue of events delivered to Lua handlers in batches.
+     *
+     * Events can be pushed from any thread. Once per tick the owning \ref SL::Runtime
+     * drains the queue and hands every event to its Lua handlers inside of a single
+     * protected call. Handlers subscribed with `Events.subscribe(type, handler)` are
+     * called once per event with the event's arguments. Handlers subscribed with
+     * `Events.subscribeBatch(type, handler)` are called once per tick as
+     * `handler(n, a, b, ...)`, where `a`, `b`, ... are reused arrays holding the first,
+     * second, ... argument of the `n` events of that type.
+     *
+     * A handler raising an error doesn't stop the dispatch: the other handlers still
+     * receive every event of the tick, and the first error is reported afterwards.
+     */
+    struct EventQueue
+    {
+        EventQueue(const EventQueue&) = delete;
+        EventQueue(EventQueue&&) = delete;
+
+        /// Maximum number of arguments an event can carry to its handlers
+        static constexpr std::size_t MaxArgs = 4;
+
+        using Value = std::variant<std::monostate, SL::Number, SL::Boolean, SL::String>;
+
+        struct Event
+        {
+            SL::String type;
+            std::array<Value, MaxArgs> args;
+            uint8_t count = 0;
+        };
+
+        SL_SYMBOL EventQueue(std::size_t capacity);
+        ~EventQueue() = default;
+
+        /**
+         * @brief Enqueue an event with the given arguments
+         * @tparam Args Types of the arguments (\ref SL::Number, \ref SL::Boolean or \ref SL::String)
+         * @param type Name of the event type handlers subscribe to
+         * @param args Values passed to the handlers
+         * @return true If the event was queued, false if the queue is full
+         */
+        template<typename... Args>
+        bool push(const SL::String& type, Args&&... args);
+
+        SL_SYMBOL bool push(Event&& event);
+
+        /**
+         * @brief The number of events rejected because the queue was full
+         */
+        SL_SYMBOL std::size_t dropped() const;
+
+        std::size_t capacity() const { return _ring.capacity(); }
+
+    private:
+        friend struct Runtime;
+
+        struct Column
+        {
+            const SL::String* type;
+            int64_t count;
+            int     slot;
+            uint8_t width;
+        };
+
+        template<typename T>
+        static Value _value(T&& value);
+
+        static int _run(State L);
+
+        SL_SYMBOL void        _install(State L);
+        SL_SYMBOL std::size_t _drain();
+
+        Util::Ring<Event>        _ring;
+        std::vector<Event>       _batch;
+        std::vector<Column>      _columns;
+        std::atomic<std::size_t> _dropped;
+        int                      _dispatch;
+    };
+
+    /* struct EventQueue */
+    template<typename T>
+    EventQueue::Value EventQueue::_value(T&& value)
+    {
+        using Type = std::decay_t<T>;
+        if constexpr (std::is_same_v<Type, SL::Boolean>)
+            return Value(std::in_place_type<SL::Boolean>, value);
+        else if constexpr (std::is_arithmetic_v<Type>)
+            return Value(std::in_place_type<SL::Number>, static_cast<SL::Number>(value));
+        else
+            return Value(std::in_place_type<SL::String>, std::forward<T>(value));
+    }
+
+    template<typename... Args>
+    bool EventQueue::push(const SL::String& type, Args&&... args)
+    {
+        static_assert(sizeof...(Args) <= MaxArgs, "Too many event arguments");
+
+        Event event;
+        event.type  = type;
+        event.count = static_cast<uint8_t>(sizeof...(Args));
+
+        std::size_t i = 0;
+        ((event.args[i++] = _value(std::forward<Args>(args))), ...);
+        (void)i;
+
+        return push(std::move(event));
+    }
+
+} // SL
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "TypeMap.hpp"
+#include "Table.hpp"
+
+#include "../Def.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace SL
+{
+    namespace detail
+    {
+        struct FrozenData;
+    }
+
+    /**
+     * @brief Read-only copy of a \ref Table shared by every runtime and thread that uses it.
+     *
+     * The entries are laid out once, in a single block, when the table is frozen and never
+     * change afterwards, so reading them takes no lock. A frozen table is a handle to that
+     * block: copying it, or pushing it into any number of states, shares the entries
+     * instead of copying them.
+     *
+     * In Lua it is a userdata that reads through to the block. `t.key`, `t[i]`, `#t` and
+     * `pairs(t)` work like on a table, and writing to it raises an error. Keys "1" to "n"
+     * form the array part, read with integer keys. Nested tables are frozen along with
+     * their parent and read through proxies too, which a state keeps in a cache of fixed
+     * size, two proxies of the same table compare equal with `==`. Strings become Lua
+     * strings when they are read. Userdata values are left out, because their pointers
+     * only mean something in the state they came from.
+     */
+    struct FrozenTable
+    {
+        /// An empty table
+        FrozenTable() = default;
+
+        SL_SYMBOL explicit FrozenTable(const Table& table);
+
+        /**
+         * @brief Length of the array part, the keys "1" to "n"
+         */
+        SL_SYMBOL std::size_t size() const;
+
+        /**
+         * @brief Number of keys, including the array part
+         */
+        SL_SYMBOL std::size_t count() const;
+
+        SL_SYMBOL bool has(std::string_view key) const;
+
+        /**
+         * @brief Read a value
+         * @tparam T Either bool, int64_t, double, std::string_view (valid while the table is
+         *           held) or FrozenTable
+         * @return The value, or nothing if there's none of that type under the key
+         */
+        template<typename T>
+        SL_SYMBOL std::optional<T> get(std::string_view key) const;
+
+        /**
+         * @brief Read a value of the array part
+         * @param index Position, from 1 like in Lua
+         */
+        template<typename T>
+        SL_SYMBOL std::optional<T> get(std::size_t index) const;
+
+        /**
+         * @brief Bytes held by the shared block, counted once however many handles use it
+         */
+        SL_SYMBOL std::size_t bytes() const;
+
+        /**
+         * @brief Whether both handles are the same table of the same block
+         */
+        bool operator==(const FrozenTable& other) const { return _data == other._data && _node == other._node; }
+        bool operator!=(const FrozenTable& other) const { return !(*this == other); }
+
+    private:
+        friend struct CompileTime::TypeMap<FrozenTable>;
+
+        FrozenTable(std::shared_ptr<const detail::FrozenData> data, uint32_t node);
+
+        std::shared_ptr<const detail::FrozenData> _data;
+        uint32_t _node = 0;
+    };
+
+namespace CompileTime
+{
+    /**
+     * @brief Frozen tables are pushed as read-only proxies sharing the frozen entries
+     */
+    template<>
+    struct TypeMap<FrozenTable>
+    {
+        static int LuaType;
+
+        SL_SYMBOL static bool
+        check(State L);
+
+        SL_SYMBOL static void
+        push(State L, const FrozenTable& val);
+
+        SL_SYMBOL static FrozenTable
+        construct(State L);
+    };
+
+} // CompileTime
+
+} // SL
@@ -5,6 +5,23 @@
 #include "../Util.hpp"
 #include "../Def.hpp"
 
+#include <vector>
+
+#define SL_STACK_CONCAT_(a, b) a##b
+#define SL_STACK_CONCAT(a, b) SL_STACK_CONCAT_(a, b)
+
+#ifdef SL_CHECK_STACK
+/**
+ * @brief Assert the Lua stack is `change` values higher when leaving the enclosing scope
+ * 
+ * Catches the paths that leave values behind (or take too many), compiled away without
+ * SL_CHECK_STACK. Leaving through a Lua error isn't checked.
+ */
+#   define SL_STACK_CHECK(L, change) const SL::Lib::detail::StackCheck SL_STACK_CONCAT(_sl_stack_, __LINE__)(L, change, __FILE__, __LINE__)
+#else
+#   define SL_STACK_CHECK(L, change) ((void)0)
+#endif
+
 namespace SL
 {
     struct Runtime;
@@ -12,6 +29,18 @@ namespace SL
 
 namespace SL::Lib
 {
+    /**
+     * @brief One entry of a library's function table, laid out like `luaL_Reg`
+     * 
+     * Tables are arrays ending with `{ nullptr, nullptr }`, so they can be declared
+     * `static constexpr` and handed to Lua without being copied.
+     */
+    struct Reg
+    {
+        const char*  name;
+        SL::Function func;
+    };
+
     /**
      * @brief Represents a base library package in a Lua script
      */
@@ -38,34 +67,142 @@ namespace SL::Lib
          */
         SL_SYMBOL void registerFunctions(SL::Runtime& runtime) const;
 
+        /**
+         * @brief Push the upvalues shared by every function of this library.
+         * 
+         * Called once each time the library is registered, the values are read back in
+         * the functions with \ref upvalue. Functions in \ref asTable have no upvalues.
+         * 
+         * @param L Lua state
+         * @return int The number of values pushed
+         */
+        virtual int pushUpvalues(State) const { return 0; }
+
+        /**
+         * @brief Set the values of this library that aren't functions, such as constants.
+         * 
+         * Called each time the library is registered, with its table on top of the stack.
+         * 
+         * @param L Lua state
+         */
+        virtual void setFields(State) const {   }
+
+        /**
+         * @brief Read an upvalue pushed by \ref pushUpvalues from inside a library function
+         * @tparam T Type of the upvalue
+         * @param L     Lua state
+         * @param index Index of the upvalue, starting at 1
+         * @return T The value
+         */
+        template<typename T>
+        static T upvalue(State L, int index);
+
         SL_SYMBOL SL::Table asTable() const;
 
+        const std::string& name() const { return _name; }
+
+        /**
+         * @brief The function table, ending with `{ nullptr, nullptr }`
+         */
+        const Reg* functions() const { return _funcs; }
+        std::size_t count() const { return _count; }
+
     protected:
         SL_SYMBOL Base(
             const std::string& name,
             const Map& funcs);
+
+        /**
+         * @brief Construct a library from a function table
+         * @param name  Name of the table in Lua
+         * @param funcs Array of functions ending with `{ nullptr, nullptr }`, it must outlive the library
+         */
+        SL_SYMBOL Base(
+            const std::string& name,
+            const Reg* funcs);
         
         virtual ~Base() = default;
 
-        std::string _name;
-        Map         _funcs;
+        std::string      _name;
+        const Reg*       _funcs;
+        std::size_t      _count;
+
+    private:
+        std::vector<std::string> _names;
+        std::vector<Reg>         _owned;
     };
 
     namespace detail
     {
     
     SL_SYMBOL std::size_t __getTop(State L);
+    SL_SYMBOL void        __setTop(State L, std::size_t top);
     SL_SYMBOL bool        __isNil(State L);
     SL_SYMBOL void        __pop(State L, uint32_t n);
+    SL_SYMBOL void        __pushUpvalue(State L, int index);
+
+    /**
+     * @brief Make room for values about to be pushed
+     * 
+     * Leaves `LUA_MINSTACK` more free slots on top of them, for the values a conversion
+     * pushes while building one.
+     * 
+     * @param count Number of values that stay on the stack
+     * @return false If the stack can't grow that much
+     */
+    SL_SYMBOL bool        __checkStack(State L, std::size_t count);
+
+    /**
+     * @brief Asserts the stack changed by the expected amount when leaving the scope, see \ref SL_STACK_CHECK
+     */
+    struct StackCheck
+    {
+        StackCheck(State L, int change, const char* file, int line) :
+            L(L), top(static_cast<std::ptrdiff_t>(__getTop(L)) + change), file(file), line(line)
+        {   }
+
+        ~StackCheck()
+        {
+            const auto now = static_cast<std::ptrdiff_t>(__getTop(L));
+            SL_ASSERT(now == top, "Lua stack left at " << now << " instead of " << top << " (" << std::filesystem::path(file).filename().string() << ":" << line << ")");
+        }
+
+        State          L;
+        std::ptrdiff_t top;
+        const char*    file;
+        int         line;
+    };
 
     }
 
+    /**
+     * @brief Puts the Lua stack back to its height at construction when leaving the scope
+     * 
+     * Values pushed on the way, early returns included, are dropped. Lua errors jump over
+     * the destructor, Lua unwinds its stack itself then.
+     */
+    struct StackGuard
+    {
+        explicit StackGuard(State L) :
+            L(L), top(detail::__getTop(L))
+        {   }
+
+        StackGuard(const StackGuard&) = delete;
+        StackGuard& operator=(const StackGuard&) = delete;
+
+        ~StackGuard() { detail::__setTop(L, top); }
+
+        State       L;
+        std::size_t top;
+    };
+
     /* struct Base */
     template<typename... Args>
     std::tuple<Args...>
     Base::extractArgs(State L)
     {
         SL_ASSERT(detail::__getTop(L) == sizeof...(Args), "Lua arguments do not match expected args.");
+        SL_STACK_CHECK(L, -static_cast<int>(sizeof...(Args)));
         std::tuple<Args...> values;
         Util::CompileTime::static_for<sizeof...(Args)>([&](auto n) {
             SL_ASSERT(!detail::__isNil(L), "Argument nil");
@@ -75,11 +212,20 @@ namespace SL::Lib
             using Type = Util::CompileTime::NthType<i, Args...>;
             SL_ASSERT(SL::CompileTime::TypeMap<Type>::check(L), "Type mismatch");
             
-            const auto count = detail::__getTop(L);
+            // Argument i sits at index i + 1, some constructs (like SL::Table's) pop it already
             std::get<i>(values) = SL::CompileTime::TypeMap<Type>::construct(L);
-            if (detail::__getTop(L) == count) detail::__pop(L, 1);
+            detail::__setTop(L, i);
         });
         return values;
     }
 
+    template<typename T>
+    T Base::upvalue(State L, int index)
+    {
+        const StackGuard guard(L);
+        detail::__pushUpvalue(L, index);
+        return SL::CompileTime::TypeMap<T>::construct(L);
+    }
+
 } // SL::Lib
+
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../Lib.hpp"
+
+#include <filesystem>
+#include <memory>
+
+namespace SL::Lib
+{
+    /**
+     * @brief Read-only byte buffers whose bytes stay out of the Lua heap, registered in Lua as `buffer`.
+     *
+     * A buffer views bytes owned elsewhere: a memory-mapped file (`buffer.open(path)`), a
+     * Lua string (`buffer.from(s)`, which isn't copied) or memory handed over from C++ as a
+     * \ref Buffer::View. Slicing makes another view of the same bytes, so a script can walk
+     * a file of any size with a constant Lua heap, and bytes only become a Lua string when
+     * asked for. Positions are 1-based, and may be negative in `sub` and `tostring` like
+     * in `string.sub`
+     *  - `#buf`, `buf:sub(i [, j])` (a view), `buf:tostring([i [, j]])` (a copy as a Lua string)
+     *  - `buf:u8(pos)` ... `buf:u64(pos)`, `buf:i8(pos)` ... `buf:i64(pos)`, `buf:f32(pos)`
+     *    and `buf:f64(pos)`, little endian unless the last argument is `"big"`
+     *  - `buf:find(s [, init])` (start and end of a plain substring, or nil) and
+     *    `buf:count(s)` (non-overlapping occurrences)
+     *  - `buf:lines()` and `buf:split(delimiter)`, iterators over views
+     *
+     * Searches run in C++, comparing 16 positions at once with SSE2 where available.
+     * `u64` values above the integer range of Lua wrap around to negative integers.
+     */
+    struct Buffer : Base
+    {
+        enum class ErrorCode
+        {
+            None,
+            FileError
+        };
+
+        template<typename T>
+        using Result = Util::Result<T, Util::Error<ErrorCode>>;
+
+        /**
+         * @brief Bytes handed to Lua as a buffer without being copied
+         */
+        struct View
+        {
+            const char*                 data = nullptr;
+            std::size_t                 size = 0;
+            std::shared_ptr<const void> owner; ///< Released once Lua no longer uses the bytes
+        };
+
+        SL_SYMBOL Buffer();
+
+        /**
+         * @brief Map a file into memory, read-only
+         * @param filename Path of the file
+         * @return Result<View> The file's bytes, unmapped when the last view of them is released
+         */
+        SL_SYMBOL static Result<View>
+        map(const std::filesystem::path& filename);
+    };
+
+} // SL::Lib
+
+namespace SL::CompileTime
+{
+    /**
+     * @brief Views are pushed as `buffer` userdata sharing the view's owner
+     */
+    template<>
+    struct TypeMap<Lib::Buffer::View>
+    {
+        static int LuaType;
+
+        SL_SYMBOL static bool
+        check(State L);
+
+        SL_SYMBOL static void
+        push(State L, const Lib::Buffer::View& val);
+
+        /**
+         * @brief The bytes of a buffer, the view doesn't keep a buffer made from a Lua string alive
+         */
+        SL_SYMBOL static Lib::Buffer::View
+        construct(State L);
+    };
+
+} // SL::CompileTime
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../Lib.hpp"
+#include "../Channel.hpp"
+
+#include <memory>
+
+namespace SL::Lib
+{
+    /**
+     * @brief \ref SL::Channel s in Lua, registered as `channel`.
+     *
+     *  - `channel.open(name [, capacity])` (shared by name with every runtime of the
+     *    process) and `channel.new([capacity])`
+     *  - `ch:try_send(v)` returns whether the value was queued, `ch:try_recv()` returns
+     *    `true` and the value, or `false`
+     *  - `ch:send(v)` and `ch:recv()` wait, returning `false` once the channel is closed
+     *  - `ch:close()`, `ch:closed()` and `ch:capacity()`
+     *
+     * Inside a coroutine `send` and `recv` yield while the channel is full or empty, and
+     * try again when resumed, so a scheduler can run other coroutines meanwhile. Outside
+     * of one they block the thread. Functions and userdata other than `buffer` arrive as nil.
+     */
+    struct Channel : Base
+    {
+        SL_SYMBOL Channel();
+    };
+
+} // SL::Lib
+
+namespace SL::CompileTime
+{
+    /**
+     * @brief Channels are passed between C++ and Lua as `channel` userdata sharing the channel
+     */
+    template<>
+    struct TypeMap<std::shared_ptr<SL::Channel>>
+    {
+        static int LuaType;
+
+        SL_SYMBOL static bool
+        check(State L);
+
+        SL_SYMBOL static void
+        push(State L, const std::shared_ptr<SL::Channel>& val);
+
+        SL_SYMBOL static std::shared_ptr<SL::Channel>
+        construct(State L);
+    };
+
+} // SL::CompileTime
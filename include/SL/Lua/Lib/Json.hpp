@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../Lib.hpp"
+
+namespace SL::Lib
+{
+    /**
+     * @brief JSON encoding and decoding in C++, registered in Lua as `json`.
+     *
+     *  - `json.decode(s)` builds the tables of a document, arrays are 1-based
+     *  - `json.encode(value)` returns the document of a value
+     *  - `json.null` stands for JSON's null, in arrays and objects alike
+     *
+     * A table is encoded as an array when its keys are exactly 1 to n, an empty table as
+     * `{}`. Other keys must be strings or integers, which become strings. Floats keep
+     * their fractional part (`1.0`), so they decode as floats again. Invalid documents,
+     * and values that can't be encoded (functions, NaN, cycles), raise an error.
+     *
+     * \ref SL::Table::fromJson and \ref SL::Table::toJson read and write documents from
+     * C++ without going through Lua.
+     */
+    struct Json : Base
+    {
+        SL_SYMBOL Json();
+
+        SL_SYMBOL void setFields(State L) const override;
+    };
+
+} // SL::Lib
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../Lib.hpp"
+
+namespace SL::Lib
+{
+    /**
+     * @brief Vector math over typed numeric buffers, registered in Lua as `simd`.
+     * 
+     * Buffers are created in Lua with `simd.new(n [, "f32" | "f64"])` or
+     * `simd.from(table [, type])`, can be indexed like arrays (1-based) and support
+     * `#buf`, `buf:type()` and `buf:totable()`. The library functions operate on whole
+     * buffers at once
+     *  - `simd.add(dst, a, b)`, `simd.mul(dst, a, b)`, `simd.fma(dst, a, b, c)` (`a * b + c`)
+     *  - `simd.axpy(alpha, x, y)` (`y = alpha * x + y`)
+     *  - `simd.dot(a, b)`, `simd.sum(a)`, `simd.min(a)`, `simd.max(a)`
+     *  - `simd.clamp(dst, a, lo, hi)`, `simd.lerp(dst, a, b, t)`
+     *  - `simd.gather(dst, src, idx)` (`dst[i] = src[idx[i]]`) and
+     *    `simd.scatter(dst, src, idx)` (`dst[idx[i]] = src[i]`)
+     * 
+     * The kernels are picked once at runtime from the instruction sets the CPU supports
+     * (AVX2/FMA, SSE2 or a scalar fallback).
+     */
+    struct Simd : Base
+    {
+        SL_SYMBOL Simd();
+
+        /**
+         * @brief Name of the instruction set the kernels were selected for
+         * @return const char* One of "avx2", "sse2" or "scalar"
+         */
+        SL_SYMBOL static const char* isa();
+    };
+    
+} // SL::Lib
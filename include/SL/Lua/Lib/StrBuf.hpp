@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../Lib.hpp"
+
+#include <memory>
+#include <string_view>
+
+namespace SL::Lib
+{
+    /**
+     * @brief Growable string buffers held in C++, registered in Lua as `strbuf`.
+     *
+     * Building a string with `..` in a loop copies everything built so far on every step.
+     * A buffer appends in place and grows geometrically, so building n bytes costs O(n)
+     * and the text becomes a Lua string once, when asked for
+     *  - `strbuf.new([capacity])`
+     *  - `sb:append(...)` (strings and numbers), `sb:appendf(format, ...)` (like `string.format`,
+     *    without `%q`), `sb:rep(s, n [, sep])` and `sb:join(t [, sep [, i [, j]]])` (like
+     *    `table.concat`), which all return the buffer so calls can be chained
+     *  - `sb:reserve(n)` (room for n more bytes), `sb:clear()` (keeps the memory), `#sb`
+     *    and `sb:tostring()`
+     *
+     * A buffer passed back to C++ as a \ref StrBuf::View is read in place, without a copy.
+     */
+    struct StrBuf : Base
+    {
+        /**
+         * @brief The text of a buffer, read in place
+         *
+         * The view stays valid while the buffer isn't written to, even once Lua has
+         * collected the buffer.
+         */
+        struct View
+        {
+            std::string_view                   text;
+            std::shared_ptr<const std::string> owner;
+        };
+
+        SL_SYMBOL StrBuf();
+    };
+
+} // SL::Lib
+
+namespace SL::CompileTime
+{
+    /**
+     * @brief Buffers are taken from Lua in place, a view pushed to Lua becomes a new buffer holding a copy
+     */
+    template<>
+    struct TypeMap<Lib::StrBuf::View>
+    {
+        static int LuaType;
+
+        SL_SYMBOL static bool
+        check(State L);
+
+        SL_SYMBOL static void
+        push(State L, const Lib::StrBuf::View& val);
+
+        SL_SYMBOL static Lib::StrBuf::View
+        construct(State L);
+    };
+
+} // SL::CompileTime
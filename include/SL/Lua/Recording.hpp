@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Lua.hpp"
+
+#include "../Util.hpp"
+#include "../Def.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SL
+{
+    struct Runtime;
+
+    /**
+     * @brief A log of the calls made into a runtime, written by \ref Runtime::record.
+     *
+     * Each entry is a `runFunction` or `setGlobal` call, with the name, the values as they
+     * were pushed to Lua (tables by their contents) and how long the call took. \ref Runtime::replay
+     * makes the same calls on another runtime, e.g. one running a changed script, and times
+     * them, `sl-replay` does so from the command line.
+     *
+     * Functions, userdata and threads can't be recorded and are replayed as nil, as are
+     * tables that contain themselves.
+     */
+    struct Recording
+    {
+        enum class ErrorCode
+        {
+            None,
+            FileError,
+            InvalidRecording
+        };
+
+        template<typename T>
+        using Result = Util::Result<T, Util::Error<ErrorCode>>;
+
+        enum class Kind : uint8_t
+        {
+            Call,      ///< Runtime::runFunction
+            SetGlobal  ///< Runtime::setGlobal
+        };
+
+        struct Entry
+        {
+            Kind        kind;
+            uint32_t    name;     ///< Index in \ref names
+            uint32_t    args;     ///< Number of values, 1 for SetGlobal
+            uint64_t    time;     ///< Nanoseconds from the start of the recording to the call
+            uint64_t    duration; ///< Nanoseconds the call took when it was recorded
+            std::size_t values;   ///< Offset of the encoded values in the recording
+        };
+
+        /**
+         * @brief Timings of a \ref Runtime::replay
+         */
+        struct Replay
+        {
+            std::vector<uint64_t> durations; ///< Nanoseconds each entry took, in order
+            std::size_t errors = 0;          ///< Calls that raised an error
+            uint64_t    total  = 0;          ///< Nanoseconds the whole replay took
+        };
+
+        /**
+         * @brief Read a recording written by \ref Runtime::record
+         * @param filename Path of the recording
+         * @return Result<Recording> The recording or error
+         */
+        SL_SYMBOL static Result<Recording>
+        open(const std::filesystem::path& filename);
+
+        /**
+         * @brief Names of the functions and globals, indexed by \ref Entry::name
+         */
+        const std::vector<std::string>& names() const { return _names; }
+
+        /**
+         * @brief The calls, in the order they were made
+         */
+        const std::vector<Entry>& entries() const { return _entries; }
+
+        /**
+         * @brief The encoded values of an entry, up to the end of the recording
+         */
+        std::string_view values(const Entry& entry) const { return std::string_view(_data).substr(entry.values); }
+
+    private:
+        Recording() = default;
+
+        std::string              _data;
+        std::vector<std::string> _names;
+        std::vector<Entry>       _entries;
+    };
+
+    namespace detail
+    {
+
+    SL_SYMBOL void __writeVarint(std::string& out, uint64_t value);
+
+    /**
+     * @brief Appends the value at index to a recording
+     */
+    SL_SYMBOL void __encodeValue(State L, int index, std::string& out);
+
+    /**
+     * @brief Pushes the next value of a recording and moves past it
+     */
+    SL_SYMBOL void __decodeValue(State L, std::string_view& in);
+
+    }
+
+} // SL
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "Lib.hpp"
+#include "TypeMap.hpp"
+
+#include <string>
+#include <tuple>
+
+namespace SL::CompileTime
+{
+    /**
+     * @brief Describes why a value on the Lua stack doesn't match a C++ type
+     */
+    struct TypeError
+    {
+        std::string path;     ///< Field path to the offending value, like `position.x` or `items[3].name`
+        std::string message;  ///< What was expected and found there
+
+        SL_SYMBOL void prepend(const char* field);
+        SL_SYMBOL void prepend(std::size_t index);
+
+        /**
+         * @brief The path and message combined, for example `position.x: expected number, got string`
+         */
+        SL_SYMBOL std::string what() const;
+    };
+
+    namespace detail
+    {
+
+    SL_SYMBOL void        __createTable(State L, int array, int record);
+    SL_SYMBOL void        __getField(State L, const char* name);
+    SL_SYMBOL void        __setField(State L, const char* name);
+    SL_SYMBOL void        __rawGetI(State L, int64_t index);
+    SL_SYMBOL void        __rawSetI(State L, int64_t index);
+    SL_SYMBOL std::size_t __rawLen(State L);
+    SL_SYMBOL void        __rawSet(State L);
+    SL_SYMBOL bool        __next(State L);
+    SL_SYMBOL void        __pushValue(State L, int index);
+    SL_SYMBOL void        __pushNil(State L);
+    SL_SYMBOL int         __type(State L);
+    SL_SYMBOL const char* __typeName(State L, int type);
+    SL_SYMBOL std::string __mismatch(State L, int expected);
+    SL_SYMBOL std::string __mismatch(State L, const std::string& expected);
+    SL_SYMBOL bool        __expectTable(State L, TypeError& error);
+
+    template<typename T, typename = void>
+    struct HasTypeError : std::false_type { };
+
+    template<typename T>
+    struct HasTypeError<T, std::void_t<decltype(TypeMap<T>::check(std::declval<State>(), std::declval<TypeError&>()))>> : std::true_type { };
+
+    template<typename T, typename = void>
+    struct HasCheckedTake : std::false_type { };
+
+    template<typename T>
+    struct HasCheckedTake<T, std::void_t<decltype(TypeMap<T>::take(std::declval<State>(), std::declval<T&>(), std::declval<TypeError&>()))>> : std::true_type { };
+
+    }
+
+    /**
+     * @brief Check the value at the top of the stack, describing the mismatch if there is one
+     * @tparam T The expected type
+     * @param L     Lua state
+     * @param error Filled in if the value doesn't match
+     * @return true If the value can be constructed as a T
+     */
+    template<typename T>
+    bool check(State L, TypeError& error)
+    {
+        if constexpr (detail::HasTypeError<T>::value) return TypeMap<T>::check(L, error);
+        else
+        {
+            if (TypeMap<T>::check(L)) return true;
+            error = TypeError{ {}, detail::__mismatch(L, TypeMap<T>::LuaType) };
+            return false;
+        }
+    }
+
+    /**
+     * @brief Construct the value at the top of the stack and remove it from the stack
+     * @tparam T Type of the value
+     * @param L Lua state
+     * @return T The value
+     */
+    template<typename T>
+    T take(State L)
+    {
+        // Some constructs (like SL::Table's) already pop their value
+        const auto top = Lib::detail::__getTop(L);
+        T value = TypeMap<T>::construct(L);
+        Lib::detail::__setTop(L, top - 1);
+        return value;
+    }
+
+    /**
+     * @brief Check and construct the value at the top of the stack in one pass, then remove it
+     * 
+     * The value is removed from the stack whether or not it matches.
+     * 
+     * @tparam T Type of the value
+     * @param L     Lua state
+     * @param value Where the value is constructed
+     * @param error Filled in if the value doesn't match
+     * @return true If the value matched
+     */
+    template<typename T>
+    bool take(State L, T& value, TypeError& error)
+    {
+        if constexpr (detail::HasCheckedTake<T>::value) return TypeMap<T>::take(L, value, error);
+        else
+        {
+            if (!CompileTime::check<T>(L, error))
+            {
+                Lib::detail::__pop(L, 1);
+                return false;
+            }
+            value = take<T>(L);
+            return true;
+        }
+    }
+
+    /**
+     * @brief A member of a reflected struct and the key it is stored under in Lua
+     */
+    template<typename S, typename F>
+    struct Field
+    {
+        using Type = F;
+
+        const char* name;
+        F S::*      member;
+    };
+
+    template<typename S, typename F>
+    constexpr Field<S, F> field(const char* name, F S::* member) { return { name, member }; }
+
+    /**
+     * @brief Specialized through \ref SL_REFLECT with the fields of a struct
+     */
+    template<typename T>
+    struct Reflect : std::false_type { };
+
+    /**
+     * @brief Structs described with \ref SL_REFLECT, read and written field by field on the Lua stack.
+     */
+    template<typename T>
+    struct TypeMap<T, std::enable_if_t<Reflect<T>::value>>
+    {
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            TypeError error;
+            return check(L, error);
+        }
+
+        static bool
+        check(State L, TypeError& error)
+        {
+            if (!detail::__expectTable(L, error)) return false;
+
+            return std::apply([&](const auto&... fields)
+            {
+                return (checkField(L, fields, error) && ...);
+            }, Reflect<T>::fields());
+        }
+
+        static void
+        push(State L, const T& value)
+        {
+            constexpr auto count = std::tuple_size_v<decltype(Reflect<T>::fields())>;
+            detail::__createTable(L, 0, static_cast<int>(count));
+            std::apply([&](const auto&... fields)
+            {
+                ((TypeMap<typename std::decay_t<decltype(fields)>::Type>::push(L, value.*fields.member), detail::__setField(L, fields.name)), ...);
+            }, Reflect<T>::fields());
+        }
+
+        static T
+        construct(State L)
+        {
+            T value{};
+            std::apply([&](const auto&... fields)
+            {
+                ((detail::__getField(L, fields.name), value.*fields.member = CompileTime::take<typename std::decay_t<decltype(fields)>::Type>(L)), ...);
+            }, Reflect<T>::fields());
+            return value;
+        }
+
+        static bool
+        take(State L, T& value, TypeError& error)
+        {
+            if (!detail::__expectTable(L, error))
+            {
+                Lib::detail::__pop(L, 1);
+                return false;
+            }
+
+            const bool good = std::apply([&](const auto&... fields)
+            {
+                return (takeField(L, value, fields, error) && ...);
+            }, Reflect<T>::fields());
+            Lib::detail::__pop(L, 1);
+            return good;
+        }
+
+    private:
+        template<typename F>
+        static bool
+        takeField(State L, T& value, const Field<T, F>& field, TypeError& error)
+        {
+            detail::__getField(L, field.name);
+            if (CompileTime::take<F>(L, value.*field.member, error)) return true;
+
+            error.prepend(field.name);
+            return false;
+        }
+
+        template<typename F>
+        static bool
+        checkField(State L, const Field<T, F>& field, TypeError& error)
+        {
+            detail::__getField(L, field.name);
+            const bool good = CompileTime::check<F>(L, error);
+            Lib::detail::__pop(L, 1);
+
+            if (!good) error.prepend(field.name);
+            return good;
+        }
+    };
+
+    template<typename T>
+    int TypeMap<T, std::enable_if_t<Reflect<T>::value>>::LuaType = TypeMap<SL::Table>::LuaType;
+
+} // SL::CompileTime
+
+/* SL_REFLECT */
+#define SL_REFLECT_EXPAND(...) __VA_ARGS__
+#define SL_REFLECT_FE_1(M, T, x) M(T, x)
+#define SL_REFLECT_FE_2(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_1(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_3(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_2(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_4(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_3(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_5(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_4(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_6(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_5(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_7(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_6(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_8(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_7(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_9(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_8(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_10(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_9(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_11(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_10(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_12(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_11(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_13(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_12(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_14(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_13(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_15(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_14(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_16(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_15(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_17(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_16(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_18(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_17(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_19(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_18(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_20(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_19(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_21(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_20(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_22(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_21(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_23(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_22(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_24(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_23(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_25(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_24(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_26(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_25(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_27(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_26(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_28(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_27(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_29(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_28(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_30(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_29(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_31(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_30(M, T, __VA_ARGS__))
+#define SL_REFLECT_FE_32(M, T, x, ...) M(T, x), SL_REFLECT_EXPAND(SL_REFLECT_FE_31(M, T, __VA_ARGS__))
+#define SL_REFLECT_PICK(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, NAME, ...) NAME
+#define SL_REFLECT_FOR_EACH(M, T, ...) \
+    SL_REFLECT_EXPAND(SL_REFLECT_PICK(__VA_ARGS__, SL_REFLECT_FE_32, SL_REFLECT_FE_31, SL_REFLECT_FE_30, SL_REFLECT_FE_29, SL_REFLECT_FE_28, SL_REFLECT_FE_27, SL_REFLECT_FE_26, SL_REFLECT_FE_25, SL_REFLECT_FE_24, SL_REFLECT_FE_23, SL_REFLECT_FE_22, SL_REFLECT_FE_21, SL_REFLECT_FE_20, SL_REFLECT_FE_19, SL_REFLECT_FE_18, SL_REFLECT_FE_17, SL_REFLECT_FE_16, SL_REFLECT_FE_15, SL_REFLECT_FE_14, SL_REFLECT_FE_13, SL_REFLECT_FE_12, SL_REFLECT_FE_11, SL_REFLECT_FE_10, SL_REFLECT_FE_9, SL_REFLECT_FE_8, SL_REFLECT_FE_7, SL_REFLECT_FE_6, SL_REFLECT_FE_5, SL_REFLECT_FE_4, SL_REFLECT_FE_3, SL_REFLECT_FE_2, SL_REFLECT_FE_1)(M, T, __VA_ARGS__))
+
+#define SL_REFLECT_FIELD(Type, member) ::SL::CompileTime::field(#member, &Type::member)
+
+/**
+ * @brief Describe the fields of a struct so it can be read from and pushed to Lua directly.
+ *
+ * Use at global scope after the struct is defined. Every field must itself be a type
+ * with a TypeMap, which includes other reflected structs and the containers of Containers.hpp.
+ * ~~~~~~{.cpp}
+ * struct Vec { SL::Number x, y; };
+ * struct Unit { SL::String name; Vec position; std::vector<SL::String> tags; std::optional<SL::Number> speed; };
+ * SL_REFLECT(Vec, x, y)
+ * SL_REFLECT(Unit, name, position, tags, speed)
+ * ~~~~~~
+ */
+#define SL_REFLECT(Type, ...) \
+    template<> \
+    struct SL::CompileTime::Reflect<Type> : std::true_type \
+    { \
+        static constexpr auto fields() \
+        { \
+            return std::make_tuple(SL_REFLECT_FOR_EACH(SL_REFLECT_FIELD, Type, __VA_ARGS__)); \
+        } \
+    };
@@ -1,15 +1,66 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <typeinfo>
 
 #include "Lib.hpp"
 #include "TypeMap.hpp"
+#include "Containers.hpp"
+#include "EventQueue.hpp"
+#include "Bundle.hpp"
+#include "Embedded.hpp"
+#include "Recording.hpp"
+#include "Trace.hpp"
 
 #define LUA_HOT_RELOAD
 
 namespace SL
 {
 
+    /**
+     * @brief Lua standard libraries, combined as a bitmask
+     */
+    enum class StdLib : uint32_t
+    {
+        None      = 0,
+        Base      = 1 << 0,   ///< `print`, `pairs`, `pcall`, ... in the global table
+        Package   = 1 << 1,   ///< `package` and `require`
+        Coroutine = 1 << 2,
+        Table     = 1 << 3,
+        IO        = 1 << 4,
+        OS        = 1 << 5,
+        String    = 1 << 6,
+        Math      = 1 << 7,
+        UTF8      = 1 << 8,
+        Debug     = 1 << 9,
+        All       = (1 << 10) - 1
+    };
+
+    constexpr StdLib operator|(StdLib a, StdLib b) { return static_cast<StdLib>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b)); }
+    constexpr StdLib operator&(StdLib a, StdLib b) { return static_cast<StdLib>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b)); }
+    constexpr StdLib operator~(StdLib a) { return static_cast<StdLib>(~static_cast<uint32_t>(a) & static_cast<uint32_t>(StdLib::All)); }
+
+    /**
+     * @brief How a \ref Runtime sets up its Lua state
+     */
+    struct RuntimeOptions
+    {
+        /// Standard libraries available to the script
+        StdLib libraries = StdLib::All;
+
+        /**
+         * @brief Open the libraries when the script first reads their global, instead of up front
+         * 
+         * The base library and the string library (used by methods on strings, which
+         * don't go through the globals) are always opened up front when requested.
+         * Reading `require` opens the package library, which can then `require` the other
+         * lazy libraries by name.
+         */
+        bool lazy = false;
+    };
+
     /**
      * @brief Represents a single Lua runtime.
      */
@@ -21,17 +72,22 @@ namespace SL
             TypeMismatch,
             VariableDoesntExist,
             NotFunction,
-            FunctionError
+            FunctionError,
+            LoadError,
+            FileError
         };
 
         template<typename T>
         using Result = Util::Result<T, Util::Error<ErrorCode>>;
 
+        using Options = RuntimeOptions;
+
         /**
          * @brief Construct a Lua runtime from a script
          * @param filename File path to the script
+         * @param options  Standard libraries to open, before the script runs
          */
-        SL_SYMBOL Runtime(const std::string& filename);
+        SL_SYMBOL Runtime(const std::string& filename, const Options& options = Options());
         
         SL_SYMBOL Runtime(Runtime&& r);
         Runtime(const Runtime&) = delete;
@@ -40,12 +96,57 @@ namespace SL
 
         /**
          * @brief Creates a runtime with the given Libraries loaded into it.
+         * 
+         * Each library is constructed once per process and registered with a single
+         * lookup in the global table.
+         * 
          * @tparam Libraries List of library types that are derived from \ref SL::Lib::Base.
          * @param filename Name of the file to load into the runtime
+         * @param options  Standard libraries to open
          * @return Runtime The created runtime 
          */
         template<typename... Libraries>
-        static Runtime create(const std::string& filename);
+        static Runtime create(const std::string& filename, const Options& options = Options());
+
+        /**
+         * @brief Creates a runtime running a module of a bundle
+         * 
+         * The bundle is mounted (see \ref mount) before the module runs, so its `require`
+         * calls are served from the bundle as well.
+         * 
+         * @param bundle  Bundle holding the modules, the runtime shares its mapping
+         * @param entry   Name of the module to run, e.g. `game.main`
+         * @param options Standard libraries to open, `require` needs \ref StdLib::Package
+         * @return Runtime The created runtime
+         */
+        SL_SYMBOL static Runtime fromBundle(const Bundle& bundle, const std::string& entry, const Options& options = Options());
+
+        /**
+         * @brief Creates a runtime from a script in memory
+         * @param buffer  Lua source or precompiled chunk
+         * @param name    Name of the script, used in error messages
+         * @param options Standard libraries to open
+         * @return Runtime The created runtime
+         */
+        SL_SYMBOL static Runtime fromBuffer(std::string_view buffer, const std::string& name, const Options& options = Options());
+
+        /**
+         * @brief Creates a runtime from a script compiled into the binary
+         * 
+         * Scripts are embedded with the `sl_embed_scripts` CMake function (see \ref Embedded),
+         * and `require` calls of the script are served from the embedded scripts first.
+         * 
+         * @param name    Name of the embedded script, e.g. `game.main` for `game/main.lua`
+         * @param options Standard libraries to open
+         * @return Runtime The created runtime
+         */
+        SL_SYMBOL static Runtime fromEmbedded(const std::string& name, const Options& options = Options());
+
+        /**
+         * @brief Serve `require` from a bundle before looking for files
+         * @param bundle Bundle holding the modules, the runtime shares its mapping
+         */
+        SL_SYMBOL void mount(const Bundle& bundle);
 
         /**
          * @brief Registers a C++ function for use in the Lua runtime
@@ -60,14 +161,30 @@ namespace SL
             const std::string& func_name,
             SL::Function function);
 
+        /**
+         * @brief Registers every function of a library in one pass
+         * 
+         * The functions are added to the global table named after the library (created
+         * with room for all of them if it doesn't exist) and share the library's upvalues.
+         * 
+         * @param library The library to register
+         * @return Result<void> Returns if an error has occured
+         */
+        SL_SYMBOL Result<void>
+        registerLibrary(const Lib::Base& library);
+
         /**
          * @brief Get a global variable by name from runtime
+         * 
+         * When the variable doesn't match the type, the error's message says which field
+         * (for reflected structs and containers) didn't match and why.
+         * 
          * @tparam T Type of the global variable (supported types in Lua namespace)
          * @param name Name of the variable in the script
          * @return Result<T> The value of the variable or error
          */
         template<typename T>
-        SL_SYMBOL Result<T>
+        Result<T>
         getGlobal(const std::string& name);
 
         // TODO: Need to load globals in datastructure so that the file can be hot-reloaded
@@ -82,7 +199,7 @@ namespace SL
          * @return Result<void> The status of the operation
          */
         template<typename T>
-        SL_SYMBOL Result<void>
+        Result<void>
         setGlobal(const std::string& name, const T& value);
 
         /**
@@ -99,6 +216,163 @@ namespace SL
             const std::string& name,
             Args&&... args);
 
+        /**
+         * @brief Hit and miss counts of a memoized function
+         */
+        struct MemoStats
+        {
+            std::size_t hits   = 0;
+            std::size_t misses = 0;
+            std::size_t size   = 0; ///< Number of cached results
+
+            double hitRate() const { return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0; }
+        };
+
+        /**
+         * @brief Cache the results of a pure Lua function called through \ref runFunction
+         * 
+         * Calls whose arguments are all numbers, strings, booleans or \ref SL::Table s are
+         * looked up by value (tables by their contents) in a least recently used cache of the
+         * given capacity, and a hit returns the cached results without entering Lua. Calls
+         * with other arguments always run. The caches are cleared when a watched global is
+         * assigned (see \ref watch), when the global is given another function and by
+         * \ref reset, other globals the function reads aren't tracked.
+         * 
+         * @param name     Name of the function
+         * @param capacity Number of argument lists to keep results for, 0 stops memoizing
+         * @return Result<void> Returns if an error has occured
+         */
+        SL_SYMBOL Result<void>
+        memoize(const std::string& name, std::size_t capacity = 1024);
+
+        /**
+         * @brief Get the cache statistics of a memoized function
+         */
+        SL_SYMBOL MemoStats memoStats(const std::string& name) const;
+
+        /**
+         * @brief Attach an \ref SL::EventQueue to this runtime
+         * 
+         * This also exposes the `Events` table to the script, where handlers are subscribed
+         * with `Events.subscribe(type, handler)` and removed with `Events.unsubscribe(type, handler)`.
+         * 
+         * @param capacity Maximum number of events buffered between two dispatches
+         * @return Result<void> Returns if an error has occured
+         */
+        SL_SYMBOL Result<void>
+        enableEvents(std::size_t capacity = 4096);
+
+        /**
+         * @brief Get the event queue attached with \ref enableEvents
+         * @return EventQueue& The queue, safe to push into from any thread
+         */
+        SL_SYMBOL EventQueue& events();
+
+        /**
+         * @brief Deliver every queued event to the subscribed Lua handlers in a single call
+         * 
+         * The events are delivered even when a handler fails, the error is the first one raised.
+         * 
+         * @return Result<std::size_t> The number of events delivered or error
+         */
+        SL_SYMBOL Result<std::size_t>
+        dispatchEvents();
+
+        /**
+         * @brief Call back when a script assigns a global, instead of polling it
+         * 
+         * The global is moved behind the metatable of the global table, so that every
+         * assignment to it is logged as it happens. With `fields` set, a table held by the
+         * global has its fields watched as well (one level deep, through a proxy metatable,
+         * a table that already has a metatable is only seen when replaced).
+         * \ref dispatchWatches then converts each changed global once and calls its
+         * callback, unchanged globals cost nothing. Watch before calling \ref checkpoint,
+         * which also remembers the watched values.
+         * 
+         * @tparam T Type the global is converted to, values that don't convert (nil included) are skipped
+         * @param name     Name of the global
+         * @param callback Called with the new value as `void(const T&)`
+         * @param fields   Also watch the fields of the table held by the global
+         * @return Result<void> Returns if an error has occured
+         */
+        template<typename T, typename F>
+        Result<void>
+        watch(const std::string& name, F&& callback, bool fields = false);
+
+        /**
+         * @brief Call the callbacks of the watched globals assigned since the last dispatch
+         * @return Result<std::size_t> The number of callbacks called or error
+         */
+        SL_SYMBOL Result<std::size_t>
+        dispatchWatches();
+
+        /**
+         * @brief Record the \ref runFunction and \ref setGlobal calls made on this runtime
+         * 
+         * The calls are appended to the file with their values and timings, until
+         * \ref stopRecording or the runtime is destroyed, and can be replayed with \ref replay.
+         * Calls made while another is running (e.g. from a library function) are left out,
+         * as replaying the outer call makes them again. Recording again starts a new file.
+         * 
+         * @param filename Path of the recording, see \ref Recording
+         * @return Result<void> Returns if an error has occured
+         */
+        SL_SYMBOL Result<void>
+        record(const std::filesystem::path& filename);
+
+        /**
+         * @brief Stop recording and write the rest of the recording
+         */
+        SL_SYMBOL void stopRecording();
+
+        /**
+         * @brief Make the calls of a recording on this runtime and time them
+         * 
+         * Functions are called with the recorded values and their results are dropped,
+         * calls that raise an error are counted and replaying goes on.
+         * 
+         * @param recording The calls to make
+         * @return Recording::Replay How long each call took
+         */
+        SL_SYMBOL Recording::Replay replay(const Recording& recording);
+
+        /**
+         * @brief Bind a table to this runtime so pushing it only writes what changed
+         * 
+         * See \ref Table::bind, the table must be unbound or destroyed before the runtime.
+         * 
+         * @param table The table to keep in step with its Lua copy
+         */
+        SL_SYMBOL void bind(Table& table);
+
+        /**
+         * @brief Bytes currently allocated by the Lua state
+         */
+        SL_SYMBOL std::size_t memory() const;
+
+        /**
+         * @brief Number of values on the Lua stack, 0 whenever no call into the runtime is running
+         */
+        SL_SYMBOL std::size_t stackSize() const;
+
+        /**
+         * @brief Remember the current globals and registry so \ref reset can return to them
+         * 
+         * Typically called once after the script has run and libraries are registered.
+         * Only the tables themselves are copied, tables they hold are shared with the
+         * checkpoint (a field changed inside a global table isn't undone).
+         */
+        SL_SYMBOL void checkpoint();
+
+        /**
+         * @brief Return the globals and registry to the last \ref checkpoint
+         * 
+         * Globals added since are removed and modified ones restored, without recreating
+         * the Lua state, so the runtime can serve another request. References into the
+         * registry (bound tables, event queues, scripts) are kept, whenever they were taken.
+         */
+        SL_SYMBOL void reset();
+
         SL_SYMBOL bool     good() const;
         SL_SYMBOL operator bool() const;
 
@@ -106,84 +380,270 @@ namespace SL
         const auto& filename() const { return _filename; }
 
     private:
+        struct Watches;
+        struct Memo;
+        struct Recorder;
+        using WatchCallback = std::function<bool(State)>;
+
+        // Ends the recorded call when it goes out of scope
+        struct RecordScope
+        {
+            Runtime* runtime;
+            ~RecordScope() { if (runtime) runtime->_record_end(); }
+        };
+
+        Runtime(State state, const std::string& name, const Options& options);
+
+        bool _run(int loaded);
+        bool _run(std::string_view chunk, const std::string& chunkname);
+
         SL_SYMBOL void _pop(std::size_t n = 1) const;
+        SL_SYMBOL void _get_global(const std::string& name) const;
+        SL_SYMBOL void _set_global(const std::string& name) const;
+        SL_SYMBOL bool _is_function() const;
         SL_SYMBOL int _call_func(uint32_t args, uint32_t ret) const;
+        SL_SYMBOL Result<void> _watch(const std::string& name, WatchCallback callback, bool fields);
+
+        template<typename... Args>
+        Runtime* _record(Recording::Kind kind, const std::string& name, const Args&... args);
+        SL_SYMBOL bool _record_begin(Recording::Kind kind, const std::string& name, uint32_t count);
+        SL_SYMBOL void _record_end();
+
+        SL_SYMBOL void*       _memo_cache(const std::string& name);
+        SL_SYMBOL const void* _memo_find(void* cache, const std::string& key, const std::type_info& type);
+        SL_SYMBOL void        _memo_store(void* cache, std::string&& key, std::shared_ptr<void> value, const std::type_info& type);
+
+        // Libraries only hold their function tables, so one instance serves every runtime
+        template<typename Library>
+        static const Library& _library()
+        {
+            static const Library library;
+            return library;
+        }
 
         State L;
         bool _good;
         std::string _filename;
+        std::unique_ptr<EventQueue> _events;
+        std::unique_ptr<Watches> _watches;
+        std::unique_ptr<Memo> _memo;
+        std::unique_ptr<Recorder> _recorder;
+        int _checkpoint;
 
 #   ifdef LUA_HOT_RELOAD
         std::filesystem::file_time_type _last_modified;
 #   endif
     };
 
+    namespace detail
+    {
+    
+    SL_SYMBOL int  __pcall(State L, uint32_t args, uint32_t ret);
+
+    /**
+     * @brief Record Lua's garbage collection cycles in the \ref Trace, when built with SL_TRACE
+     */
+    SL_SYMBOL void __traceCollections(State L);
+    SL_SYMBOL void __registerLibraries(State L, std::initializer_list<const Lib::Base*> libraries);
+
+    /**
+     * @brief Calls the function on top of the stack and takes its results off the stack
+     */
+    template<typename... Return, typename... Args>
+    Runtime::Result<std::tuple<Return...>>
+    __call(State L, Args&&... args);
+
+    /**
+     * @brief Appends the encoding of an argument to a memoization key
+     * @return false If the argument can't be compared by value
+     */
+    template<typename T>
+    bool __memoKey(std::string& key, const T& value);
+
+    }
+
     template<typename... Libraries>
-    Runtime Runtime::create(const std::string& filename)
+    Runtime Runtime::create(const std::string& filename, const Options& options)
     {
-        using namespace Util::CompileTime;
+        static_assert((std::is_base_of_v<SL::Lib::Base, Libraries> && ...));
 
-        Runtime runtime(filename);
+        Runtime runtime(filename, options);
 
-        static_for<sizeof...(Libraries)>([&](auto n) 
-        {
-            const std::size_t i = n;
-            using Library = NthType<i, Libraries...>;
-            static_assert(std::is_base_of_v<SL::Lib::Base, Library>);
-            Library().registerFunctions(runtime);
-        });
+        if constexpr (sizeof...(Libraries) > 0)
+            detail::__registerLibraries(runtime.L, { &static_cast<const Lib::Base&>(_library<Libraries>())... });
 
         return runtime;
     }
 
+    template<typename T>
+    Runtime::Result<T>
+    Runtime::getGlobal(const std::string& name)
+    {
+        SL_STACK_CHECK(L, 0);
+        _get_global(name);
+
+        T value{};
+        CompileTime::TypeError error;
+        if (!CompileTime::take<T>(L, value, error)) return { { ErrorCode::TypeMismatch, error.what() } };
+        
+        return { std::move(value) };
+    }
+
+    template<>
+    SL_SYMBOL Runtime::Result<SL::Function>
+    Runtime::getGlobal<SL::Function>(const std::string& name);
+
+    template<typename T, typename F>
+    Runtime::Result<void>
+    Runtime::watch(const std::string& name, F&& callback, bool fields)
+    {
+        return _watch(name, [callback = std::forward<F>(callback)](State L) mutable
+        {
+            T value{};
+            CompileTime::TypeError error;
+            if (!CompileTime::take<T>(L, value, error)) return false;
+
+            callback(static_cast<const T&>(value));
+            return true;
+        }, fields);
+    }
+
+    template<typename T>
+    Runtime::Result<void>
+    Runtime::setGlobal(const std::string& name, const T& value)
+    {
+        SL_STACK_CHECK(L, 0);
+        CompileTime::TypeMap<T>::push(L, value);
+
+        RecordScope recorded{ _recorder && _record_begin(Recording::Kind::SetGlobal, name, 1) ? this : nullptr };
+        _set_global(name);
+        return { };
+    }
+
     template<typename... Return, typename... Args>
     Runtime::Result<std::tuple<Return...>>
     Runtime::runFunction(
         const std::string& name,
         Args&&... args)
     {
-        const auto glob_res = getGlobal<SL::Function>(name);
-        if (!glob_res)
+        const Trace::LibraryScope trace(name);
+        SL_STACK_CHECK(L, 0);
+
+        RecordScope recorded{ _recorder ? _record(Recording::Kind::Call, name, args...) : nullptr };
+
+        _get_global(name);
+        if (!_is_function())
         {
             _pop();
-            if (glob_res.error().code() == Runtime::ErrorCode::TypeMismatch) return { Runtime::ErrorCode::NotFunction };
-            else return { glob_res.error() };
+            return { ErrorCode::NotFunction };
+        }
+
+        // Checked against the function on top of the stack, in case the global was reassigned
+        void* cache = _memo ? _memo_cache(name) : nullptr;
+
+        std::string key;
+        if (cache && !(detail::__memoKey(key, args) && ...)) cache = nullptr;
+        if (cache)
+            if (const auto* hit = _memo_find(cache, key, typeid(std::tuple<Return...>)))
+            {
+                _pop();
+                return { std::tuple<Return...>(*static_cast<const std::tuple<Return...>*>(hit)) };
+            }
+
+        if (!cache) return detail::__call<Return...>(L, std::forward<Args>(args)...);
+
+        auto res = detail::__call<Return...>(L, std::forward<Args>(args)...);
+        if (!res) return { res.error() };
+
+        _memo_store(cache, std::move(key), std::make_shared<std::tuple<Return...>>(*res), typeid(std::tuple<Return...>));
+        return { std::move(*res) };
+    }
+
+    template<typename... Args>
+    Runtime* Runtime::_record(Recording::Kind kind, const std::string& name, const Args&... args)
+    {
+        // Pushed once more to be recorded as Lua sees them
+        (CompileTime::TypeMap<std::remove_cv_t<std::remove_reference_t<Args>>>::push(L, args), ...);
+
+        const bool recorded = _record_begin(kind, name, sizeof...(Args));
+        _pop(sizeof...(Args));
+        return recorded ? this : nullptr;
+    }
+
+    template<typename T>
+    bool detail::__memoKey(std::string& key, const T& value)
+    {
+        using Type = std::decay_t<T>;
+
+        // Tagged like SL::Table::encode
+        const auto append = [&key](const auto& bytes)
+        {
+            key.append(reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+        };
+        const auto string = [&](std::string_view s)
+        {
+            key += 's';
+            append(static_cast<uint32_t>(s.size()));
+            key.append(s);
+        };
+
+        /**/ if constexpr (std::is_same_v<Type, bool>) key += value ? 'T' : 'F';
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            key += 'i';
+            append(static_cast<int64_t>(value));
         }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            key += 'd';
+            append(static_cast<double>(value));
+        }
+        else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view>) string(value);
+        else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) string(value);
+        else if constexpr (std::is_same_v<Type, SL::Table>) value.encode(key);
+        else return false;
 
-        auto args_set = std::tuple(std::forward<Args>(args)...);
-        Util::CompileTime::static_for<sizeof...(args)>([&](auto n){
+        return true;
+    }
+
+    template<typename... Return, typename... Args>
+    Runtime::Result<std::tuple<Return...>>
+    detail::__call(State L, Args&&... args)
+    {
+        // Room for the arguments, then for the results replacing them
+        constexpr std::size_t slots = sizeof...(Args) > sizeof...(Return) ? sizeof...(Args) : sizeof...(Return);
+        if (!Lib::detail::__checkStack(L, slots))
+        {
+            Lib::detail::__pop(L, 1);
+            return { { Runtime::ErrorCode::FunctionError, "stack overflow" } };
+        }
+
+        auto args_set = std::forward_as_tuple(std::forward<Args>(args)...);
+        Util::CompileTime::static_for<sizeof...(Args)>([&](auto n){
             constexpr std::size_t I = n;
-            using Type = std::remove_reference_t<Util::CompileTime::NthType<I, Args...>>;
+            using Type = std::remove_cv_t<std::remove_reference_t<Util::CompileTime::NthType<I, Args...>>>;
             CompileTime::TypeMap<Type>::push(L, std::get<I>(args_set));
         });
 
-        if (_call_func(sizeof...(Args), sizeof...(Return)) != 0) return { { ErrorCode::FunctionError, CompileTime::TypeMap<SL::String>::construct(L) } };
+        if (__pcall(L, sizeof...(Args), sizeof...(Return)) != 0) return { { Runtime::ErrorCode::FunctionError, CompileTime::take<SL::String>(L) } };
         
+        // Results are taken off the top of the stack, so the last one comes first
         bool err = false;
-        auto left = sizeof...(Return);
+        CompileTime::TypeError error;
         auto return_vals = std::tuple<Return...>();
         Util::CompileTime::static_for<sizeof...(Return)>([&](auto n) {
-            constexpr std::size_t I = n;
+            constexpr std::size_t I = sizeof...(Return) - 1 - n;
             using Type = Util::CompileTime::NthType<I, Return...>;
-            using Map  = SL::CompileTime::TypeMap<Type>;
 
-            if (!err)
+            if (err) return;
+            if (!CompileTime::take<Type>(L, std::get<I>(return_vals), error))
             {
-                if (Map::check(L))
-                {
-                    std::get<I>(return_vals) = Map::construct(L);
-                    left--;
-                }
-                else err = true;
+                err = true;
+                Lib::detail::__pop(L, I);
             }
         });
 
-        SL_ASSERT(!left, "Still arguments left.");
-        if (err)
-        {
-            _pop(left);
-            return { ErrorCode::TypeMismatch };
-        }
+        if (err) return { { Runtime::ErrorCode::TypeMismatch, error.what() } };
 
         return { std::move(return_vals) };
     }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Runtime.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SL
+{
+
+    /**
+     * @brief A pool of warmed runtimes that are reset instead of recreated.
+     *
+     * Runtimes are built by the factory, checkpointed (see \ref Runtime::checkpoint) and
+     * handed out with \ref acquire. When a lease is dropped its runtime is reset to the
+     * checkpoint and returned to the pool, so the next request starts from the same globals
+     * without reloading the script. Acquiring and releasing is thread-safe, a leased
+     * runtime is only used by the thread holding it.
+     */
+    struct RuntimePool
+    {
+        using Factory = std::function<Runtime()>;
+
+        /**
+         * @brief A runtime borrowed from the pool, returned when destroyed
+         */
+        struct Lease
+        {
+            Lease(RuntimePool* pool, std::unique_ptr<Runtime> runtime) :
+                _pool(pool), _runtime(std::move(runtime))
+            {   }
+
+            Lease(Lease&&) = default;
+            Lease(const Lease&) = delete;
+
+            ~Lease()
+            {
+                if (_runtime) _pool->_release(std::move(_runtime));
+            }
+
+            Runtime* operator->() { return _runtime.get(); }
+            Runtime& operator*()  { return *_runtime; }
+
+        private:
+            RuntimePool* _pool;
+            std::unique_ptr<Runtime> _runtime;
+        };
+
+        /**
+         * @brief Construct a pool
+         * @param factory Creates a runtime, e.g. `[]() { return SL::Runtime::create<Libs...>("script.lua"); }`
+         * @param warm    Number of runtimes to create up front
+         */
+        SL_SYMBOL RuntimePool(Factory factory, std::size_t warm = 0);
+
+        RuntimePool(const RuntimePool&) = delete;
+        RuntimePool(RuntimePool&&) = delete;
+
+        /**
+         * @brief Borrow a runtime, creating one if none is idle
+         * @return Lease The runtime, reset to its checkpoint
+         */
+        SL_SYMBOL Lease acquire();
+
+        /**
+         * @brief Number of runtimes waiting in the pool
+         */
+        SL_SYMBOL std::size_t idle() const;
+
+    private:
+        SL_SYMBOL void _release(std::unique_ptr<Runtime> runtime);
+        std::unique_ptr<Runtime> _create() const;
+
+        Factory _factory;
+        mutable std::mutex _mutex;
+        std::vector<std::unique_ptr<Runtime>> _idle;
+    };
+
+} // SL
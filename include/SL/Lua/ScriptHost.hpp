@@ -0,0 +1,186 @@
+#pragma once
+
+#include "Runtime.hpp"
+
+namespace SL
+{
+
+    /**
+     * @brief Many isolated scripts sharing a single Lua state.
+     *
+     * The standard libraries are opened once, and every script gets its own environment
+     * (`_ENV`) table. Reads that miss the environment fall through to the shared globals
+     * via a metatable shared by every script, while assignments to globals (including
+     * through `_G`, which is the script's environment) stay local to the script.
+     *
+     * Scripts only see the shared globals through read-only proxies, made once per table
+     * and shared by every script: `string.format = f` or `table.insert = nil` is an error
+     * instead of changing the library for every script, and so is writing into a table
+     * reached through them (`package.loaded`), `rawset` on a proxy, or changing the
+     * metatable of an environment. Chunks loaded without an environment (`load`,
+     * `require`) get the same view. The `debug` library, which reaches around all of
+     * it, isn't available to scripts.
+     *
+     * A host is not thread-safe, like a \ref Runtime.
+     */
+    struct ScriptHost
+    {
+        using ErrorCode = Runtime::ErrorCode;
+
+        template<typename T>
+        using Result = Runtime::Result<T>;
+
+        /**
+         * @brief Handle to a script loaded in a host
+         */
+        struct Script
+        {
+            int ref = -1;
+
+            bool operator==(const Script& other) const { return ref == other.ref; }
+            bool operator!=(const Script& other) const { return ref != other.ref; }
+        };
+
+        SL_SYMBOL ScriptHost();
+
+        SL_SYMBOL ScriptHost(ScriptHost&& h);
+        ScriptHost(const ScriptHost&) = delete;
+
+        SL_SYMBOL ~ScriptHost();
+
+        /**
+         * @brief Load and run a script in its own environment
+         * @param filename File path to the script
+         * @return Result<Script> The script or the error from loading or running it
+         */
+        SL_SYMBOL Result<Script>
+        load(const std::string& filename);
+
+        /**
+         * @brief Drop a script's environment
+         *
+         * The environment is freed by the garbage collector once nothing else references
+         * it (e.g. a function of the script stored by another one), see \ref collect.
+         *
+         * @param script The script to unload
+         */
+        SL_SYMBOL void unload(Script script);
+
+        /**
+         * @brief Registers a library in the globals shared by every script
+         * @param library The library to register
+         * @return Result<void> Returns if an error has occured
+         */
+        SL_SYMBOL Result<void>
+        registerLibrary(const Lib::Base& library);
+
+        /**
+         * @brief Get a global variable of a script
+         * @tparam T Type of the global variable (supported types in Lua namespace)
+         * @param script The script
+         * @param name   Name of the variable, looked up in the shared globals if the script doesn't define it
+         * @return Result<T> The value of the variable or error
+         */
+        template<typename T>
+        Result<T>
+        getGlobal(Script script, const std::string& name);
+
+        /**
+         * @brief Set a global variable of a script
+         * @tparam T Type of the global variable (supported types in Lua namespace)
+         * @param script The script
+         * @param name   Name of the global variable
+         * @param value  Value of the global variable
+         * @return Result<void> The status of the operation
+         */
+        template<typename T>
+        Result<void>
+        setGlobal(Script script, const std::string& name, const T& value);
+
+        /**
+         * @brief Invokes a function of a script
+         * @tparam Return Expected return types from the function
+         * @tparam Args   Arguments to pass into the function
+         * @param script The script
+         * @param name   Name of the function
+         * @param args   Values of the arguments
+         * @return Result<std::tuple<Return...>> Contains the values returned from the function or error
+         */
+        template<typename... Return, typename... Args>
+        Result<std::tuple<Return...>>
+        runFunction(
+            Script script,
+            const std::string& name,
+            Args&&... args);
+
+        /**
+         * @brief Number of scripts currently loaded
+         */
+        std::size_t scripts() const { return _scripts; }
+
+        /**
+         * @brief Bytes currently allocated by the Lua state
+         */
+        SL_SYMBOL std::size_t memory() const;
+
+        /**
+         * @brief Run a full garbage collection cycle, freeing unloaded environments
+         */
+        SL_SYMBOL void collect();
+
+    private:
+        SL_SYMBOL void _get_global(Script script, const std::string& name) const;
+        SL_SYMBOL void _set_global(Script script, const std::string& name) const;
+        SL_SYMBOL bool _is_function() const;
+
+        State L;
+        int _meta;
+        int _globals;
+        std::size_t _scripts;
+    };
+
+    template<typename T>
+    ScriptHost::Result<T>
+    ScriptHost::getGlobal(Script script, const std::string& name)
+    {
+        SL_STACK_CHECK(L, 0);
+        _get_global(script, name);
+
+        T value{};
+        CompileTime::TypeError error;
+        if (!CompileTime::take<T>(L, value, error)) return { { ErrorCode::TypeMismatch, error.what() } };
+
+        return { std::move(value) };
+    }
+
+    template<typename T>
+    ScriptHost::Result<void>
+    ScriptHost::setGlobal(Script script, const std::string& name, const T& value)
+    {
+        SL_STACK_CHECK(L, 0);
+        CompileTime::TypeMap<T>::push(L, value);
+        _set_global(script, name);
+        return { };
+    }
+
+    template<typename... Return, typename... Args>
+    ScriptHost::Result<std::tuple<Return...>>
+    ScriptHost::runFunction(
+        Script script,
+        const std::string& name,
+        Args&&... args)
+    {
+        const Trace::LibraryScope trace(name);
+        SL_STACK_CHECK(L, 0);
+
+        _get_global(script, name);
+        if (!_is_function())
+        {
+            Lib::detail::__pop(L, 1);
+            return { ErrorCode::NotFunction };
+        }
+
+        return detail::__call<Return...>(L, std::forward<Args>(args)...);
+    }
+
+} // SL
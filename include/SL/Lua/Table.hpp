@@ -2,14 +2,48 @@
 
 #include "../Def.hpp"
 #include "Lua.hpp"
+#include "Atom.hpp"
 
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <functional>
 
 namespace SL
 {
+    namespace CompileTime
+    {
+        struct TypeError;
+    }
+
+    /**
+     * @brief Bounds of a conversion from Lua into a \ref Table, going beyond them fails the conversion
+     */
+    struct TableLimits
+    {
+        uint32_t    depth   = 512; ///< Levels of nested tables, the table read being the first
+        std::size_t entries = std::numeric_limits<std::size_t>::max(); ///< Entries of all the tables read, shared tables counted once
+    };
+
+    /**
+     * @brief Copy of a Lua table held in C++.
+     *
+     * Keys are \ref SL::Atom s, every method taking a key also accepts a `std::string`,
+     * `std::string_view` or string literal. Keep the atoms of frequently used keys around
+     * (or use \ref SL_ATOM) to skip hashing the string on every access. Reading a key given
+     * as a string only looks it up, a string no table has used is never interned by a read.
+     *
+     * Numbers keep whether they were a Lua integer, and can be read as `SL::Number`,
+     * `int64_t` or `double`. A value written through one of these views is seen through the
+     * others from the next access to the entry, and is pushed back to Lua as an integer when
+     * it was written as an `int64_t`.
+     *
+     * A table can be bound to a Lua table (see \ref bind) that is then kept in step by
+     * writing only the keys changed since the last sync.
+     */
     struct Table
     {
         /**
@@ -19,6 +53,7 @@ namespace SL
         {
             std::shared_ptr<void> data;
             int type;
+            uint16_t tag = 0; ///< \ref CompileTime::TypeTag of a pointer read from Lua, pushed back with it
 
             /**
              * @brief Construct a data entry from a value
@@ -39,7 +74,31 @@ namespace SL
             SL_SYMBOL static std::shared_ptr<void> emplace(const T& value);
         };
 
-        using Map = std::unordered_map<std::string, Data>;
+        using Map = std::unordered_map<Atom, Data>;
+        using Limits = TableLimits;
+
+        /**
+         * @brief A key to read, an atom or a string that is only looked up in the atom table
+         */
+        struct Key
+        {
+            Key(const Atom& atom) : _atom(&atom) { }
+            Key(std::string_view name) : _name(name) { }
+            Key(const std::string& name) : _name(name) { }
+            Key(const char* name) : _name(name) { }
+
+            /**
+             * @brief The atom of the key
+             * @return false If the key is a string that was never interned, no table holds it
+             */
+            SL_SYMBOL bool find(Atom& atom) const;
+
+            std::string_view view() const { return _atom ? _atom->view() : _name; }
+
+        private:
+            const Atom*      _atom = nullptr;
+            std::string_view _name;
+        };
 
         Table() = default;
         SL_SYMBOL Table(const Map& map);
@@ -53,9 +112,18 @@ namespace SL
          * @param L 
          */
         SL_SYMBOL Table(State L);
-        ~Table() = default;
 
-        SL_SYMBOL const Data& getRaw(const std::string& name) const;
+        /**
+         * @brief Copies the entries, the copy isn't bound
+         */
+        SL_SYMBOL Table(const Table& table);
+        SL_SYMBOL Table(Table&& table);
+        SL_SYMBOL ~Table();
+
+        SL_SYMBOL Table& operator=(const Table& table);
+        SL_SYMBOL Table& operator=(Table&& table);
+
+        SL_SYMBOL const Data& getRaw(Key name) const;
 
         template<typename T>
         SL_SYMBOL void each(std::function<void(uint32_t, T&)> lambda);
@@ -64,10 +132,10 @@ namespace SL
         SL_SYMBOL void each(std::function<void(uint32_t, const T&)> lambda) const;
 
         template<typename T>
-        SL_SYMBOL void try_get(const std::string& name, std::function<void(T&)> lambda, std::optional<std::function<void()>> if_not = std::nullopt);
+        SL_SYMBOL void try_get(Key name, std::function<void(T&)> lambda, std::optional<std::function<void()>> if_not = std::nullopt);
 
         template<typename T>
-        SL_SYMBOL void try_get(const std::string& name, std::function<void(const T&)> lambda, std::optional<std::function<void()>> if_not = std::nullopt) const;
+        SL_SYMBOL void try_get(Key name, std::function<void(const T&)> lambda, std::optional<std::function<void()>> if_not = std::nullopt) const;
 
         /**
          * @brief Make the entries equivalent to another table
@@ -87,7 +155,7 @@ namespace SL
          */
         SL_SYMBOL void superimpose(const Map& map);
 
-        SL_SYMBOL bool hasValue(const std::string& name) const;
+        SL_SYMBOL bool hasValue(Key name) const;
 
         /**
          * @brief Get a reference to a value in the table
@@ -96,7 +164,7 @@ namespace SL
          * @return T&  The reference to the value
          */
         template<typename T>
-        SL_SYMBOL T& get(const std::string& name);
+        SL_SYMBOL T& get(Key name);
         
         template<typename T>
         SL_SYMBOL std::vector<T> get() const;
@@ -108,8 +176,8 @@ namespace SL
          * @return const T& The constant reference to the value
          */
         template<typename T>
-        SL_SYMBOL const T& get(const std::string& name) const;
-        SL_SYMBOL void* get(const std::string& name) const;
+        SL_SYMBOL const T& get(Key name) const;
+        SL_SYMBOL void* get(Key name) const;
 
         /**
          * @brief Set the value associated with a key
@@ -118,8 +186,8 @@ namespace SL
          * @param value The value
          */
         template<typename T>
-        SL_SYMBOL void set(const std::string& name, const T& value);
-        SL_SYMBOL void set(const std::string& name, void* value);
+        SL_SYMBOL void set(Atom name, const T& value);
+        SL_SYMBOL void set(Atom name, void* value);
 
         /**
          * @brief Get the raw mapping of this table
@@ -129,15 +197,129 @@ namespace SL
 
         /**
          * @brief Dump all the map information onto the given Lua stack
+         * 
+         * A nested table shared by several keys (copies of a table share their nested
+         * tables) is pushed once, and the Lua tables share it the same way.
+         * 
          * @param L The Lua state to dump the table onto
          */
         SL_SYMBOL void toStack(State L) const;
 
-        SL_SYMBOL void fromStack(State L);
+        /**
+         * @brief Add the entries of the Lua table at index -1, then pop it
+         * 
+         * Keys already in the table are kept. A Lua table reached through several keys is
+         * read once and shared by them in C++, so reading costs the number of distinct
+         * tables however they are referenced. A table holding itself, directly or through
+         * nested tables, can't be owned by its C++ copy and fails the conversion, like
+         * going beyond the limits or a key that isn't a string or a number. The table
+         * is left unchanged when the conversion fails. Functions and coroutines only
+         * exist in Lua, their keys are skipped.
+         * 
+         * @param L      The Lua state holding the table
+         * @param limits Bounds of the conversion
+         * @param error  Set to the reason, and the path of the offending table, on failure
+         * @return true If the entries were read
+         */
+        SL_SYMBOL bool fromStack(State L, const Limits& limits = Limits(), CompileTime::TypeError* error = nullptr);
+
+        /**
+         * @brief Keep a Lua table of the given state in step with this table
+         * 
+         * The entries are pushed once into a Lua table held in the registry. From then on
+         * the keys written in C++ are tracked, through `set` and the references handed out
+         * by the non-const getters (read through a const table to avoid marking keys), and
+         * nested tables report their changes to the table holding them. \ref sync writes
+         * only those keys, so it costs the number of changes rather than the size of the
+         * table. Pushing the table into the same state (`setGlobal`, `runFunction`, ...)
+         * syncs it and pushes the bound Lua table instead of building a new one.
+         * 
+         * Writes made by Lua to the bound table aren't read back, and are only overwritten
+         * when C++ changes the same key. The table must be unbound or destroyed before
+         * the state is closed.
+         * 
+         * @param L The Lua state holding the bound table
+         */
+        SL_SYMBOL void bind(State L);
+
+        /**
+         * @brief Release the bound Lua table and stop tracking changes
+         */
+        SL_SYMBOL void unbind();
+
+        SL_SYMBOL bool bound() const;
+
+        /**
+         * @brief Write the keys changed since the last sync into the bound Lua table
+         */
+        SL_SYMBOL void sync();
+
+        /**
+         * @brief Append a byte encoding of the entries to a string
+         * 
+         * Equal tables encode the same regardless of insertion order, numbers keep whether
+         * they are integers, and functions and userdata are encoded by address.
+         * 
+         * @param out String to append to
+         */
+        SL_SYMBOL void encode(std::string& out) const;
 
         SL_SYMBOL std::string toString(uint32_t indent = 0) const;
+
+        /**
+         * @brief Read a JSON document whose root is an object or an array
+         * 
+         * Array elements get the keys "1" to "n" like tables read from Lua, and nulls are
+         * left out. Reads the document without going through a Lua state.
+         * 
+         * @param json  The document
+         * @param error Set to the reason (and position) when the document is invalid
+         * @return std::optional<Table> The table, or nothing if the document is invalid
+         */
+        SL_SYMBOL static std::optional<Table> fromJson(std::string_view json, std::string* error = nullptr);
+
+        /**
+         * @brief Append the JSON document of this table to a string
+         * 
+         * A table whose keys are exactly "1" to "n" is written as an array, any other as an
+         * object. Functions, userdata, NaN and infinities are written as null.
+         * 
+         * @param out String to append to
+         */
+        SL_SYMBOL void toJson(std::string& out) const;
+        SL_SYMBOL std::string toJson() const;
     
     private:
+        Map::const_iterator _find(Key name) const;
+        void _assign(Atom name, Data data);
+        void _replace(Map map);
+        void _mark(Atom name) const;
+        void _detach(const Data& data) const;
+        void _untrack() const;
+        void _push(State L) const;
+        void _sync(State L) const;
+        void _pushBound() const;
+
         Map dictionary;
+
+        // Keys written since the last sync, only recorded once the table is in a bound tree
+        mutable std::unordered_set<Atom> _dirty;
+        mutable const Table* _parent = nullptr;
+        mutable Atom _key;
+        mutable bool _tracked = false;
+
+        State _bound = nullptr;
+        int _ref = 0;
     };
+
+    namespace detail
+    {
+
+    /**
+     * @brief The number held by an entry, the way \ref Table::toStack pushes it
+     * @return true If the number is an integer, set in `integer`, otherwise it's set in `real`
+     */
+    SL_SYMBOL bool __number(const Table::Data& data, int64_t& integer, double& real);
+
+    }
 }
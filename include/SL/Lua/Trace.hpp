@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../Def.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string_view>
+
+namespace SL
+{
+    /**
+     * @brief Timeline of the crossings between C++ and Lua, written as Chrome trace events.
+     *
+     * With the library built with `-DSL_TRACE=ON`, `runFunction` calls, library functions
+     * called from Lua, table conversions, script loads and Lua garbage collection cycles
+     * record begin and end events while \ref start is in effect. Each thread records into
+     * its own ring buffer without locks, keeping the latest events when it is full. The
+     * buffer of a thread is freed when the thread exits, or at the next \ref start if it
+     * holds events of the current recording. The
+     * events are written with \ref write as JSON that `chrome://tracing` and Perfetto open,
+     * showing which call nested in which. Without `SL_TRACE` the instrumentation compiles
+     * away, and only scopes recorded by hand end up in the trace. The `SL_TRACE_*` macros
+     * follow the `SL_TRACE` definition of the code using them.
+     */
+    struct Trace
+    {
+        /**
+         * @brief Records a begin event when constructed and the matching end event when destroyed
+         */
+        struct Scope
+        {
+            explicit Scope(std::string_view name) : _recorded(Trace::begin(name)) { }
+            ~Scope() { if (_recorded) Trace::end(); }
+
+            Scope(const Scope&) = delete;
+
+        private:
+            bool _recorded;
+        };
+
+        /**
+         * @brief A \ref Scope recorded only when the library was built with `SL_TRACE`
+         * 
+         * Used by the templates of the library's headers, which are compiled in code that
+         * doesn't see the library's definitions.
+         */
+        struct LibraryScope
+        {
+            explicit LibraryScope(std::string_view name) : _recorded(Trace::_begin_library(name)) { }
+            ~LibraryScope() { if (_recorded) Trace::end(); }
+
+            LibraryScope(const LibraryScope&) = delete;
+
+        private:
+            bool _recorded;
+        };
+
+        /**
+         * @brief Start recording, dropping the events recorded before
+         * @param capacity Number of events each thread keeps, for buffers created from now on
+         */
+        SL_SYMBOL static void start(std::size_t capacity = 65536);
+
+        /**
+         * @brief Stop recording, the recorded events are kept for \ref write
+         */
+        SL_SYMBOL static void stop();
+
+        SL_SYMBOL static bool recording();
+
+        /**
+         * @brief Whether the library was built with `SL_TRACE`, recording its crossings
+         */
+        SL_SYMBOL static bool instrumented();
+
+        /**
+         * @brief Record the beginning of a span on the calling thread
+         * @param name Name of the span, truncated to 38 characters
+         * @return true If the event was recorded, the span must then be ended with \ref end
+         */
+        SL_SYMBOL static bool begin(std::string_view name);
+
+        /**
+         * @brief Record the end of the innermost span begun on the calling thread
+         */
+        SL_SYMBOL static void end();
+
+        /**
+         * @brief Record an event without a duration
+         * @param name Name of the event, truncated to 38 characters
+         */
+        SL_SYMBOL static void instant(std::string_view name);
+
+        /**
+         * @brief Write the recorded events of every thread as Chrome trace-event JSON
+         * 
+         * Stop recording first, a thread recording while its buffer is written can tear
+         * the events being overwritten.
+         * 
+         * @param out Stream to write to
+         */
+        SL_SYMBOL static void write(std::ostream& out);
+
+        /**
+         * @brief Write the recorded events to a file
+         * @param filename Path of the `.json` file
+         * @return true If the file was written
+         */
+        SL_SYMBOL static bool write(const std::filesystem::path& filename);
+
+    private:
+        SL_SYMBOL static bool _begin_library(std::string_view name);
+    };
+
+} // SL
+
+#define SL_TRACE_CONCAT_(a, b) a##b
+#define SL_TRACE_CONCAT(a, b) SL_TRACE_CONCAT_(a, b)
+
+#ifdef SL_TRACE
+/**
+ * @brief Trace the rest of the enclosing scope as a span, compiled away without SL_TRACE
+ */
+#   define SL_TRACE_SCOPE(name) const SL::Trace::Scope SL_TRACE_CONCAT(_sl_trace_, __LINE__)(name)
+#   define SL_TRACE_INSTANT(name) SL::Trace::instant(name)
+#else
+#   define SL_TRACE_SCOPE(name) ((void)0)
+#   define SL_TRACE_INSTANT(name) ((void)0)
+#endif
@@ -3,6 +3,9 @@
 #include "Lua.hpp"
 #include "Table.hpp"
 
+#include <cstdint>
+#include <type_traits>
+
 namespace SL
 {
     /* Types */
@@ -14,7 +17,7 @@ namespace SL
 
 namespace CompileTime
 {
-    template<typename T>
+    template<typename T, typename Enable = void>
     struct SL_SYMBOL TypeMap
     {
         static int LuaType;
@@ -29,6 +32,36 @@ namespace CompileTime
         construct(State L);
     };
 
+    /**
+     * @brief Lua tables are copied into an \ref SL::Table with its default \ref SL::Table::Limits
+     */
+    template<>
+    struct TypeMap<SL::Table>
+    {
+        static int LuaType;
+
+        SL_SYMBOL static bool
+        check(State L);
+
+        SL_SYMBOL static void
+        push(State L, const SL::Table& val);
+
+        SL_SYMBOL static SL::Table
+        construct(State L);
+
+        /**
+         * @brief Tables holding themselves or going beyond the limits don't match
+         */
+        SL_SYMBOL static bool
+        take(State L, SL::Table& value, TypeError& error);
+    };
+
+    /**
+     * @brief Non-owning pointers are pushed as light userdata, which costs no allocation.
+     * 
+     * Full userdata is only read back (as the address of its block), Lua allocates those
+     * for values it owns.
+     */
     template<>
     struct TypeMap<void*>
     {
@@ -43,6 +76,74 @@ namespace CompileTime
         static void*
         construct(State L);
     };
+
+    namespace detail
+    {
+
+    SL_SYMBOL uint16_t __nextTypeTag();
+    SL_SYMBOL void     __pushTagged(State L, void* ptr, uint16_t tag);
+    SL_SYMBOL bool     __isTagged(State L, uint16_t tag);
+    SL_SYMBOL void*    __toTagged(State L);
+    SL_SYMBOL void*    __toPointer(State L, uint16_t& tag);
+
+    }
+
+    /**
+     * @brief Small integer identifying a C++ type without RTTI.
+     * 
+     * Tags are handed out on first use, so they are only stable for the lifetime of
+     * the process. 
+     * 
+     * @tparam T The type to identify
+     */
+    template<typename T>
+    struct TypeTag
+    {
+        static uint16_t value()
+        {
+            static const uint16_t tag = detail::__nextTypeTag();
+            return tag;
+        }
+    };
+
+    /**
+     * @brief Typed non-owning pointers, pushed as light userdata carrying a \ref TypeTag.
+     * 
+     * The tag is stored in the unused upper bits of the pointer, so pushing allocates
+     * nothing and a pointer can only be read back as the exact type it was pushed as.
+     * Pointers that already use those bits (tagged heaps) go in a small full userdata
+     * along with their tag instead.
+     * 
+     * @tparam T Type being pointed to, function pointers are left to \ref SL::Function
+     */
+    template<typename T>
+    struct TypeMap<T*, std::enable_if_t<std::is_object_v<T>>>
+    {
+        using Tag = TypeTag<std::remove_cv_t<T>>;
+
+        static int LuaType;
+
+        static bool
+        check(State L)
+        {
+            return detail::__isTagged(L, Tag::value());
+        }
+
+        static void
+        push(State L, T* val)
+        {
+            detail::__pushTagged(L, const_cast<std::remove_cv_t<T>*>(val), Tag::value());
+        }
+
+        static T*
+        construct(State L)
+        {
+            return static_cast<T*>(detail::__toTagged(L));
+        }
+    };
+
+    template<typename T>
+    int TypeMap<T*, std::enable_if_t<std::is_object_v<T>>>::LuaType = TypeMap<void*>::LuaType;
 } // CompileTime
 
 } // SL
@@ -1,4 +1,5 @@
 #pragma once
 
 #include "Util/CompileTime.hpp"
-#include "Util/Result.hpp"
\ No newline at end of file
+#include "Util/Result.hpp"
+#include "Util/Ring.hpp"
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <string>
 #include <cassert>
 #include <optional>
+#include <utility>
 
 namespace SL::Util
 {
@@ -96,7 +97,7 @@ namespace SL::Util
     /* struct Result */
     template<typename T, typename E>
     Result<T, E>::Result(T&& val) :
-        _val(val)
+        _val(std::move(val))
     {   }
 
     template<typename T, typename E>
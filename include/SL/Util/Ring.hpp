@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../Def.hpp"
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace SL::Util
+{
+    /**
+     * @brief Bounded lock-free multi-producer/multi-consumer queue.
+     *
+     * Every slot carries a sequence number that tells producers and consumers
+     * whether it is free to write or ready to read, so neither side ever takes
+     * a lock. The capacity is rounded up to the next power of two.
+     *
+     * @tparam T Type of the elements, must be default constructible and movable
+     */
+    template<typename T>
+    struct Ring
+    {
+        Ring(const Ring&) = delete;
+        Ring(Ring&&) = delete;
+
+        explicit Ring(std::size_t capacity);
+        ~Ring() = default;
+
+        /**
+         * @brief Attempt to move a value into the queue
+         * @param value The value to enqueue
+         * @return true If the value was enqueued, false if the queue is full
+         */
+        bool try_push(T&& value);
+
+        /**
+         * @brief Attempt to move the oldest value out of the queue
+         * @param value Where the dequeued value is moved to
+         * @return true If a value was dequeued, false if the queue is empty
+         */
+        bool try_pop(T& value);
+
+        std::size_t capacity() const { return _mask + 1; }
+
+    private:
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        static std::size_t _round(std::size_t capacity);
+
+        const std::size_t       _mask;
+        std::unique_ptr<Slot[]> _slots;
+
+        alignas(64) std::atomic<std::size_t> _head;
+        alignas(64) std::atomic<std::size_t> _tail;
+    };
+
+    /* struct Ring */
+    template<typename T>
+    std::size_t Ring<T>::_round(std::size_t capacity)
+    {
+        std::size_t r = 2;
+        while (r < capacity) r <<= 1;
+        return r;
+    }
+
+    template<typename T>
+    Ring<T>::Ring(std::size_t capacity) :
+        _mask(_round(capacity) - 1),
+        _slots(std::make_unique<Slot[]>(_mask + 1)),
+        _head(0),
+        _tail(0)
+    {
+        for (std::size_t i = 0; i <= _mask; i++)
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    bool Ring<T>::try_push(T&& value)
+    {
+        auto pos = _tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& slot = _slots[pos & _mask];
+            const auto seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) return false;
+            else pos = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    template<typename T>
+    bool Ring<T>::try_pop(T& value)
+    {
+        auto pos = _head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& slot = _slots[pos & _mask];
+            const auto seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(slot.value);
+                    slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) return false;
+            else pos = _head.load(std::memory_order_relaxed);
+        }
+    }
+
+} // SL::Util
@@ -0,0 +1,273 @@
+#include <SL/Lua/Atom.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace SL
+{
+
+namespace
+{
+    // Strings live in fixed-size chunks that never move once allocated, so the string
+    // of an atom can be read without holding the lock
+    constexpr uint32_t ChunkBits = 10;
+    constexpr uint32_t ChunkSize = 1u << ChunkBits;
+    constexpr uint32_t MaxChunks = 4096;
+
+    // Set in the count of an atom that is never freed
+    constexpr uint32_t Pinned = 1u << 31;
+
+    // Fewest unused atoms freed at once
+    constexpr std::size_t MinBatch = 1024;
+
+    struct Slot
+    {
+        std::string           name;
+        std::atomic<uint32_t> refs{ 0 };
+    };
+
+    struct AtomTable
+    {
+        AtomTable()
+        {
+            for (auto& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+
+            uint32_t empty;
+            intern(std::string_view(), true, empty);
+        }
+
+        ~AtomTable()
+        {
+            for (auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+        }
+
+        Slot& slot(uint32_t id) const
+        {
+            return chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (ChunkSize - 1)];
+        }
+
+        // An atom found under the lock is counted before the lock is released, so it
+        // can't be freed in between even if nothing referred to it anymore
+        bool intern(std::string_view name, bool pin, uint32_t& id)
+        {
+            const auto hash = std::hash<std::string_view>()(name);
+            {
+                std::shared_lock lock(mutex);
+                if (const auto it = ids.find(name, hash); it != ids.end())
+                {
+                    hold(it->second, pin);
+                    id = it->second;
+                    return true;
+                }
+            }
+
+            std::unique_lock lock(mutex);
+            if (const auto it = ids.find(name, hash); it != ids.end())
+            {
+                hold(it->second, pin);
+                id = it->second;
+                return true;
+            }
+
+            if (unused.empty() && count == MaxChunks * ChunkSize) collect();
+            if (unused.empty() && count == MaxChunks * ChunkSize) return false;
+
+            if (!unused.empty())
+            {
+                id = unused.back();
+                unused.pop_back();
+            }
+            else
+            {
+                id = count++;
+                if (!chunks[id >> ChunkBits].load(std::memory_order_relaxed))
+                    chunks[id >> ChunkBits].store(new Slot[ChunkSize], std::memory_order_release);
+            }
+
+            auto& stored = slot(id);
+            stored.name = name;
+            stored.refs.store(pin ? Pinned : 1, std::memory_order_relaxed);
+            bytes += stored.name.capacity() + 1;
+            ids.emplace(Key{ stored.name, hash }, id);
+            return true;
+        }
+
+        bool find(std::string_view name, uint32_t& id)
+        {
+            std::shared_lock lock(mutex);
+            const auto it = ids.find(name, std::hash<std::string_view>()(name));
+            if (it == ids.end()) return false;
+            hold(it->second, false);
+            id = it->second;
+            return true;
+        }
+
+        void hold(uint32_t id, bool pin)
+        {
+            if (pin) slot(id).refs.fetch_or(Pinned, std::memory_order_relaxed);
+            else retain(id);
+        }
+
+        // Pinned atoms are only read, so copying them doesn't bounce a shared counter
+        // between the threads using them
+        void retain(uint32_t id)
+        {
+            auto& refs = slot(id).refs;
+            if (!(refs.load(std::memory_order_relaxed) & Pinned)) refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Unused atoms are freed in batches, so a key dropped and interned again right
+        // after (like a lookup of a missing key) isn't freed every time
+        void release(uint32_t id)
+        {
+            auto& refs = slot(id).refs;
+            if (refs.load(std::memory_order_relaxed) & Pinned) return;
+            if (refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            if (released.fetch_add(1, std::memory_order_relaxed) + 1 < threshold.load(std::memory_order_relaxed)) return;
+
+            std::unique_lock lock(mutex);
+            collect();
+        }
+
+        // Called with the lock held, an atom counted again since it was released is kept
+        void collect()
+        {
+            for (auto it = ids.begin(); it != ids.end();)
+            {
+                auto& stored = slot(it->second);
+                if (stored.refs.load(std::memory_order_acquire) != 0)
+                {
+                    ++it;
+                    continue;
+                }
+
+                unused.push_back(it->second);
+                it = ids.erase(it);
+                bytes -= stored.name.capacity() + 1;
+                std::string().swap(stored.name);
+            }
+
+            released.store(0, std::memory_order_relaxed);
+            threshold.store(std::max(MinBatch, ids.size() / 2), std::memory_order_relaxed);
+        }
+
+        std::string_view view(uint32_t id) const
+        {
+            return slot(id).name;
+        }
+
+        Atom::Report report()
+        {
+            std::shared_lock lock(mutex);
+
+            std::size_t chunk_count = 0;
+            for (const auto& chunk : chunks) if (chunk.load(std::memory_order_relaxed)) chunk_count++;
+
+            return Atom::Report{
+                ids.size(),
+                bytes
+                    + chunk_count * ChunkSize * sizeof(Slot)
+                    + unused.capacity() * sizeof(uint32_t)
+                    + ids.bucket_count() * sizeof(void*)
+                    + ids.size() * (sizeof(Ids::value_type) + 2 * sizeof(void*))
+            };
+        }
+
+        // The hash is computed once per lookup and stored with the key, so rehashing
+        // the map never touches the strings again
+        struct Key
+        {
+            std::string_view name;
+            std::size_t hash;
+
+            bool operator==(const Key& other) const { return name == other.name; }
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const { return key.hash; }
+        };
+
+        struct Ids : std::unordered_map<Key, uint32_t, KeyHash>
+        {
+            iterator find(std::string_view name, std::size_t hash)
+            {
+                return std::unordered_map<Key, uint32_t, KeyHash>::find(Key{ name, hash });
+            }
+        };
+
+        std::array<std::atomic<Slot*>, MaxChunks> chunks;
+        Ids                      ids;
+        std::vector<uint32_t>    unused; // Freed ids, reused before new ones
+        std::shared_mutex        mutex;
+        uint32_t                 count = 0;
+        std::size_t              bytes = 0;
+        std::atomic<std::size_t> released{ 0 };
+        std::atomic<std::size_t> threshold{ MinBatch };
+    };
+
+    AtomTable& table()
+    {
+        static AtomTable atoms;
+        return atoms;
+    }
+}
+
+/* struct Atom */
+Atom::Atom(std::string_view name)
+{
+    const bool interned = table().intern(name, false, _id);
+    SL_ASSERT(interned, "Too many atoms");
+}
+
+bool Atom::intern(std::string_view name, Atom& atom)
+{
+    Atom interned;
+    if (!table().intern(name, false, interned._id)) return false;
+    atom = std::move(interned);
+    return true;
+}
+
+Atom Atom::pin(std::string_view name)
+{
+    Atom atom;
+    const bool interned = table().intern(name, true, atom._id);
+    SL_ASSERT(interned, "Too many atoms");
+    return atom;
+}
+
+bool Atom::find(std::string_view name, Atom& atom)
+{
+    Atom found;
+    if (!table().find(name, found._id)) return false;
+    atom = std::move(found);
+    return true;
+}
+
+Atom::Report Atom::report()
+{
+    return table().report();
+}
+
+std::string_view Atom::view() const
+{
+    return table().view(_id);
+}
+
+void Atom::_retain(uint32_t id)
+{
+    table().retain(id);
+}
+
+void Atom::_release(uint32_t id)
+{
+    table().release(id);
+}
+
+} // SL
@@ -0,0 +1,353 @@
+#include <SL/Lua/Bundle.hpp>
+
+#include "Lua.cpp"
+#include "Loader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace
+{
+    // Layout: Header, Entry[count] sorted by name, then the names and the chunks.
+    // Offsets are from the start of the bundle
+    constexpr char Magic[4] = { 'S', 'L', 'B', '1' };
+
+    struct Header
+    {
+        char     magic[4];
+        uint32_t count;
+    };
+
+    struct Entry
+    {
+        uint32_t name_offset;
+        uint32_t name_size;
+        uint32_t data_offset;
+        uint32_t data_size;
+    };
+
+    // The bundle may come from anywhere in memory, so entries are copied out rather
+    // than read in place
+    Entry entry(const char* data, std::size_t index)
+    {
+        Entry e;
+        std::memcpy(&e, data + sizeof(Header) + index * sizeof(Entry), sizeof(Entry));
+        return e;
+    }
+
+    std::string_view name(const char* data, const Entry& e)
+    {
+        return std::string_view(data + e.name_offset, e.name_size);
+    }
+
+    std::size_t count(const char* data)
+    {
+        Header header;
+        std::memcpy(&header, data, sizeof(Header));
+        return header.count;
+    }
+
+    bool find(const char* data, std::string_view module, std::string_view& chunk)
+    {
+        std::size_t lo = 0, hi = count(data);
+        while (lo < hi)
+        {
+            const auto mid = lo + (hi - lo) / 2;
+            const auto e = entry(data, mid);
+            const auto cmp = name(data, e).compare(module);
+            if (cmp == 0)
+            {
+                chunk = std::string_view(data + e.data_offset, e.data_size);
+                return true;
+            }
+            if (cmp < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        return false;
+    }
+
+    // The upvalue of the searcher, sharing the mapping so that the Bundle can be moved
+    // or destroyed once mounted
+    constexpr const char* MountedMetatable = "SL.bundle";
+
+    struct Mounted
+    {
+        const char*                 data;
+        std::shared_ptr<const void> mapping;
+    };
+
+    // Only drops the reference, so that running it twice is harmless
+    int mountedGc(lua_State* L)
+    {
+        auto* mounted = static_cast<Mounted*>(luaL_checkudata(L, 1, MountedMetatable));
+        mounted->mapping.reset();
+        mounted->data = nullptr;
+        return 0;
+    }
+
+    int searcher(lua_State* L)
+    {
+        const auto* mounted = static_cast<const Mounted*>(lua_touserdata(L, lua_upvalueindex(1)));
+
+        std::size_t size;
+        const char* module = luaL_checklstring(L, 1, &size);
+
+        std::string_view chunk;
+        if (!mounted->data || !find(mounted->data, std::string_view(module, size), chunk))
+        {
+            lua_pushfstring(L, "no module '%s' in bundle", module);
+            return 1;
+        }
+
+        const char* chunkname = lua_pushfstring(L, "@%s", module);
+        if (luaL_loadbuffer(L, chunk.data(), chunk.size(), chunkname) != LUA_OK)
+            return luaL_error(L, "error loading module '%s' from bundle:\n\t%s", module, lua_tostring(L, -1));
+
+        // The loader, then the extra value require passes to it
+        lua_insert(L, -2);
+        return 2;
+    }
+}
+
+namespace SL
+{
+
+/* struct Bundle */
+Bundle::Result<Bundle>
+Bundle::open(const std::filesystem::path& filename)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return { { ErrorCode::FileError, "Could not open " + filename.string() } };
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = size.QuadPart ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (!mapping) return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+
+    const auto* data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        CloseHandle(mapping);
+        return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+    }
+
+    Bundle bundle(data, static_cast<std::size_t>(size.QuadPart), mapping);
+#else
+    const int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0) return { { ErrorCode::FileError, "Could not open " + filename.string() } };
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        ::close(file);
+        return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+    }
+
+    void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+
+    Bundle bundle(static_cast<const char*>(data), static_cast<std::size_t>(info.st_size), data);
+#endif
+
+    if (!bundle._valid()) return { { ErrorCode::InvalidBundle, filename.string() + " is not a valid bundle" } };
+    return { std::move(bundle) };
+}
+
+Bundle::Result<Bundle>
+Bundle::view(const void* data, std::size_t size)
+{
+    Bundle bundle(static_cast<const char*>(data), size, nullptr);
+    if (!bundle._valid()) return { { ErrorCode::InvalidBundle, "Not a valid bundle" } };
+    return { std::move(bundle) };
+}
+
+Bundle::Result<void>
+Bundle::pack(
+    const std::filesystem::path& directory,
+    const std::filesystem::path& filename,
+    bool precompile)
+{
+    namespace fs = std::filesystem;
+
+    struct Module
+    {
+        std::string name;
+        std::string chunk;
+    };
+
+    std::error_code ec;
+    std::vector<Module> modules;
+    for (fs::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (!it->is_regular_file() || it->path().extension() != ".lua") continue;
+
+        auto relative = it->path().lexically_relative(directory);
+        relative.replace_extension();
+
+        std::string name;
+        for (const auto& part : relative)
+        {
+            if (!name.empty()) name += '.';
+            name += part.string();
+        }
+        if (name.size() > 5 && name.compare(name.size() - 5, 5, ".init") == 0) name.resize(name.size() - 5);
+
+        std::ifstream file(it->path(), std::ios::binary);
+        if (!file) return { { ErrorCode::FileError, "Could not read " + it->path().string() } };
+        modules.push_back({ name, std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()) });
+    }
+    if (ec) return { { ErrorCode::FileError, "Could not read " + directory.string() + ": " + ec.message() } };
+
+    std::sort(modules.begin(), modules.end(), [](const Module& a, const Module& b) { return a.name < b.name; });
+    for (std::size_t i = 1; i < modules.size(); i++)
+        if (modules[i].name == modules[i - 1].name)
+            return { { ErrorCode::InvalidBundle, "Module " + modules[i].name + " is defined twice" } };
+
+    if (precompile)
+    {
+        lua_State* L = luaL_newstate();
+        for (auto& module : modules)
+        {
+            const auto chunkname = "@" + module.name;
+            if (luaL_loadbuffer(L, module.chunk.data(), module.chunk.size(), chunkname.c_str()) != LUA_OK)
+            {
+                std::string message = lua_tostring(L, -1);
+                lua_close(L);
+                return { { ErrorCode::CompileError, message } };
+            }
+
+            std::string bytecode;
+            lua_dump(L, SL::detail::__dumpWriter, &bytecode, 0);
+            lua_pop(L, 1);
+            module.chunk = std::move(bytecode);
+        }
+        lua_close(L);
+    }
+
+    std::vector<Entry> entries(modules.size());
+    std::size_t offset = sizeof(Header) + entries.size() * sizeof(Entry);
+    for (std::size_t i = 0; i < modules.size(); i++)
+    {
+        entries[i].name_offset = static_cast<uint32_t>(offset);
+        entries[i].name_size = static_cast<uint32_t>(modules[i].name.size());
+        offset += modules[i].name.size();
+    }
+    for (std::size_t i = 0; i < modules.size(); i++)
+    {
+        entries[i].data_offset = static_cast<uint32_t>(offset);
+        entries[i].data_size = static_cast<uint32_t>(modules[i].chunk.size());
+        offset += modules[i].chunk.size();
+    }
+    if (offset > UINT32_MAX) return { { ErrorCode::InvalidBundle, "Bundle is larger than 4 GB" } };
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return { { ErrorCode::FileError, "Could not write " + filename.string() } };
+
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.count = static_cast<uint32_t>(modules.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    for (const auto& module : modules) out.write(module.name.data(), static_cast<std::streamsize>(module.name.size()));
+    for (const auto& module : modules) out.write(module.chunk.data(), static_cast<std::streamsize>(module.chunk.size()));
+
+    if (!out) return { { ErrorCode::FileError, "Could not write " + filename.string() } };
+    return { };
+}
+
+Bundle::Bundle(const char* data, std::size_t size, void* mapping) :
+    _data(data),
+    _size(size)
+{
+    if (!mapping) return;
+    _mapping = std::shared_ptr<const void>(mapping, [data, size](const void* mapping)
+    {
+#ifdef _WIN32
+        (void)size;
+        UnmapViewOfFile(data);
+        CloseHandle(const_cast<HANDLE>(mapping));
+#else
+        (void)data;
+        munmap(const_cast<void*>(mapping), size);
+#endif
+    });
+}
+
+Bundle::Bundle(Bundle&& b) :
+    _data(b._data),
+    _size(b._size),
+    _mapping(std::move(b._mapping))
+{   }
+
+Bundle::~Bundle() = default;
+
+bool Bundle::find(std::string_view module, std::string_view& chunk) const
+{
+    return ::find(_data, module, chunk);
+}
+
+std::size_t Bundle::size() const
+{
+    return count(_data);
+}
+
+bool Bundle::_valid() const
+{
+    if (!_data || _size < sizeof(Header)) return false;
+
+    Header header;
+    std::memcpy(&header, _data, sizeof(Header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) return false;
+    if (header.count > (_size - sizeof(Header)) / sizeof(Entry)) return false;
+
+    std::string_view previous;
+    for (std::size_t i = 0; i < header.count; i++)
+    {
+        const auto e = entry(_data, i);
+        if (static_cast<uint64_t>(e.name_offset) + e.name_size > _size) return false;
+        if (static_cast<uint64_t>(e.data_offset) + e.data_size > _size) return false;
+
+        // Lookups are a binary search over the names
+        const auto current = name(_data, e);
+        if (i > 0 && !(previous < current)) return false;
+        previous = current;
+    }
+    return true;
+}
+
+void Bundle::_install(State L) const
+{
+    new (lua_newuserdatauv(STATE, sizeof(Mounted), 0)) Mounted{ _data, _mapping };
+    if (luaL_newmetatable(STATE, MountedMetatable))
+    {
+        lua_pushcfunction(STATE, mountedGc);
+        lua_setfield(STATE, -2, "__gc");
+        lua_pushliteral(STATE, "bundle");
+        lua_setfield(STATE, -2, "__metatable");
+    }
+    lua_setmetatable(STATE, -2);
+
+    lua_pushcclosure(STATE, searcher, 1);
+    detail::__insertSearcher(STATE);
+}
+
+} // SL
@@ -0,0 +1,181 @@
+#include <SL/Lua/Channel.hpp>
+#include <SL/Lua/Recording.hpp>
+
+#include "Lua.cpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+
+namespace SL
+{
+
+namespace
+{
+    // Owns the conversion state of a thread, closed when the thread exits
+    struct ScratchState
+    {
+        ~ScratchState()
+        {
+            if (L) lua_close(L);
+        }
+
+        lua_State* L = nullptr;
+    };
+}
+
+/* struct Channel */
+Channel::Channel(std::size_t capacity) :
+    _ring(capacity),
+    _closed(false),
+    _waiting(0)
+{   }
+
+std::shared_ptr<Channel> Channel::open(const std::string& name, std::size_t capacity)
+{
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<Channel>> channels;
+    static std::size_t sweep = 16;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = channels[name];
+    if (auto channel = entry.lock()) return channel;
+
+    auto channel = std::make_shared<Channel>(capacity);
+    entry = channel;
+
+    // Names of channels nothing holds anymore are erased once the map has doubled since
+    // the last sweep, so that unique names don't pile up
+    if (channels.size() >= sweep)
+    {
+        for (auto it = channels.begin(); it != channels.end();)
+        {
+            if (it->second.expired()) it = channels.erase(it);
+            else ++it;
+        }
+        sweep = std::max<std::size_t>(16, channels.size() * 2);
+    }
+    return channel;
+}
+
+bool Channel::try_send(Message&& message)
+{
+    if (closed() || !_ring.try_push(std::move(message))) return false;
+    _notify();
+    return true;
+}
+
+bool Channel::try_recv(Message& message)
+{
+    if (!_ring.try_pop(message)) return false;
+    _notify();
+    return true;
+}
+
+bool Channel::send(Message&& message)
+{
+    while (!try_send(std::move(message)))
+    {
+        if (closed()) return false;
+
+        // Registered as waiting before trying again, so a recv that frees a slot after
+        // the attempt sees the waiter and wakes it. The timeout covers a close racing this
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting.fetch_add(1);
+        if (!closed() && _ring.try_push(std::move(message)))
+        {
+            _waiting.fetch_sub(1);
+            lock.unlock();
+            _notify();
+            return true;
+        }
+        _wake.wait_for(lock, std::chrono::milliseconds(1));
+        _waiting.fetch_sub(1);
+    }
+    return true;
+}
+
+bool Channel::recv(Message& message)
+{
+    while (!try_recv(message))
+    {
+        // Values sent before the close are still taken
+        if (closed()) return try_recv(message);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting.fetch_add(1);
+        if (_ring.try_pop(message))
+        {
+            _waiting.fetch_sub(1);
+            lock.unlock();
+            _notify();
+            return true;
+        }
+        _wake.wait_for(lock, std::chrono::milliseconds(1));
+        _waiting.fetch_sub(1);
+    }
+    return true;
+}
+
+void Channel::close()
+{
+    _closed.store(true, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _wake.notify_all();
+}
+
+void Channel::_notify()
+{
+    // Orders the push or pop before reading the waiter count, pairing with the waiter's
+    // increment before it tries again
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiting.load(std::memory_order_relaxed) == 0) return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _wake.notify_all();
+}
+
+namespace detail
+{
+    State __channelState()
+    {
+        thread_local ScratchState scratch;
+        if (!scratch.L) scratch.L = luaL_newstate();
+        return reinterpret_cast<State>(scratch.L);
+    }
+
+    void __encodeMessage(State L, int index, Channel::Message& message)
+    {
+        message.value.clear();
+        lua_pushvalue(STATE, index);
+        if (CompileTime::TypeMap<Lib::Buffer::View>::check(L))
+        {
+            message.buffer = CompileTime::TypeMap<Lib::Buffer::View>::construct(L);
+
+            // Bytes held by a Lua string can't leave its state, they're copied once
+            if (!message.buffer.owner && message.buffer.size)
+            {
+                auto bytes = std::make_shared<std::string>(message.buffer.data, message.buffer.size);
+                message.buffer = { bytes->data(), bytes->size(), bytes };
+            }
+        }
+        else __encodeValue(L, -1, message.value);
+        lua_pop(STATE, 1);
+    }
+
+    void __pushMessage(State L, const Channel::Message& message)
+    {
+        if (message.value.empty())
+        {
+            CompileTime::TypeMap<Lib::Buffer::View>::push(L, message.buffer);
+            return;
+        }
+
+        std::string_view in = message.value;
+        __decodeValue(L, in);
+    }
+}
+
+} // SL
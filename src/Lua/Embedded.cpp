@@ -0,0 +1,102 @@
+#include <SL/Lua/Embedded.hpp>
+
+#include "Lua.cpp"
+#include "Loader.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    struct Registry
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, std::string_view> scripts;
+    };
+
+    // Filled by static initializers of the generated code, so it is created on first use
+    Registry& registry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    int searcher(lua_State* L)
+    {
+        std::size_t size;
+        const char* module = luaL_checklstring(L, 1, &size);
+
+        std::string_view chunk;
+        if (!SL::Embedded::find(std::string_view(module, size), chunk))
+        {
+            lua_pushfstring(L, "no embedded module '%s'", module);
+            return 1;
+        }
+
+        const char* chunkname = lua_pushfstring(L, "@%s", module);
+        if (luaL_loadbuffer(L, chunk.data(), chunk.size(), chunkname) != LUA_OK)
+            return luaL_error(L, "error loading embedded module '%s':\n\t%s", module, lua_tostring(L, -1));
+
+        lua_insert(L, -2);
+        return 2;
+    }
+}
+
+namespace SL
+{
+
+/* struct Embedded */
+Embedded::Registration::Registration(const Script* scripts, std::size_t count)
+{
+    auto& r = registry();
+    std::lock_guard lock(r.mutex);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const auto [ it, added ] = r.scripts.emplace(scripts[i].name,
+            std::string_view(reinterpret_cast<const char*>(scripts[i].data), scripts[i].size));
+        SL_ASSERT(added, "Script " << scripts[i].name << " is embedded twice");
+    }
+}
+
+bool Embedded::find(std::string_view name, std::string_view& chunk)
+{
+    auto& r = registry();
+    std::lock_guard lock(r.mutex);
+    const auto it = r.scripts.find(name);
+    if (it == r.scripts.end()) return false;
+    chunk = it->second;
+    return true;
+}
+
+std::size_t Embedded::count()
+{
+    auto& r = registry();
+    std::lock_guard lock(r.mutex);
+    return r.scripts.size();
+}
+
+bool Embedded::compile(
+    std::string_view source,
+    const std::string& chunkname,
+    std::string& bytecode,
+    std::string& error)
+{
+    lua_State* L = luaL_newstate();
+    const bool ok = luaL_loadbuffer(L, source.data(), source.size(), chunkname.c_str()) == LUA_OK;
+    if (ok)
+    {
+        bytecode.clear();
+        lua_dump(L, SL::detail::__dumpWriter, &bytecode, 0);
+    }
+    else error = lua_tostring(L, -1);
+    lua_close(L);
+    return ok;
+}
+
+void Embedded::_install(State L)
+{
+    lua_pushcfunction(STATE, searcher);
+    detail::__insertSearcher(STATE);
+}
+
+} // SL
@@ -0,0 +1,312 @@
+#include <SL/Lua/EventQueue.hpp>
+
+#include "Lua.cpp"
+
+namespace SL
+{
+
+namespace
+{
+    constexpr int Handlers      = lua_upvalueindex(1);
+    constexpr int BatchHandlers = lua_upvalueindex(2);
+    constexpr int Columns       = lua_upvalueindex(3);
+
+    void pushValue(lua_State* L, const EventQueue::Value& value)
+    {
+        using namespace CompileTime;
+
+        switch (value.index())
+        {
+        case 1:  TypeMap<SL::Number> ::push(L, std::get<SL::Number> (value)); break;
+        case 2:  TypeMap<SL::Boolean>::push(L, std::get<SL::Boolean>(value)); break;
+        case 3:  TypeMap<SL::String> ::push(L, std::get<SL::String> (value)); break;
+        default: lua_pushnil(L); break;
+        }
+    }
+
+    // Appends the function at index 2 to list[type], type being at index 1
+    int subscribeTo(lua_State* L, int list)
+    {
+        luaL_checkstring(L, 1);
+        luaL_checktype(L, 2, LUA_TFUNCTION);
+        lua_settop(L, 2);
+
+        lua_pushvalue(L, 1);
+        if (lua_rawget(L, list) != LUA_TTABLE)
+        {
+            lua_pop(L, 1);
+            lua_createtable(L, 1, 0);
+            lua_pushvalue(L, 1);
+            lua_pushvalue(L, -2);
+            lua_rawset(L, list);
+        }
+
+        lua_pushvalue(L, 2);
+        lua_rawseti(L, 3, static_cast<lua_Integer>(lua_rawlen(L, 3)) + 1);
+        return 0;
+    }
+
+    // Removes the function at index 2 from list[type], type being at index 1
+    bool unsubscribeFrom(lua_State* L, int list)
+    {
+        lua_settop(L, 2);
+        lua_pushvalue(L, 1);
+        if (lua_rawget(L, list) != LUA_TTABLE) return false;
+
+        const auto n = static_cast<lua_Integer>(lua_rawlen(L, 3));
+        for (lua_Integer i = 1; i <= n; i++)
+        {
+            lua_rawgeti(L, 3, i);
+            const bool found = lua_rawequal(L, -1, 2);
+            lua_pop(L, 1);
+            if (!found) continue;
+
+            for (lua_Integer j = i; j < n; j++)
+            {
+                lua_rawgeti(L, 3, j + 1);
+                lua_rawseti(L, 3, j);
+            }
+            lua_pushnil(L);
+            lua_rawseti(L, 3, n);
+            return true;
+        }
+        return false;
+    }
+
+    // Events.subscribe(type, handler)
+    int subscribe(lua_State* L)
+    {
+        return subscribeTo(L, Handlers);
+    }
+
+    // Events.subscribeBatch(type, handler)
+    int subscribeBatch(lua_State* L)
+    {
+        return subscribeTo(L, BatchHandlers);
+    }
+
+    // Events.unsubscribe(type, handler), returns whether the handler was found
+    int unsubscribe(lua_State* L)
+    {
+        luaL_checkstring(L, 1);
+        luaL_checktype(L, 2, LUA_TFUNCTION);
+
+        const bool found = unsubscribeFrom(L, Handlers) || unsubscribeFrom(L, BatchHandlers);
+        lua_pushboolean(L, found);
+        return 1;
+    }
+
+    // A failed handler doesn't stop the dispatch, the first error is raised once every
+    // event was delivered
+    void keepError(lua_State* L)
+    {
+        if (lua_isnil(L, 3)) lua_replace(L, 3);
+        else lua_pop(L, 1);
+    }
+
+    // Pushes the MaxArgs reused column arrays of the type at the top of the stack, replacing it
+    void pushColumns(lua_State* L)
+    {
+        constexpr auto Width = static_cast<int>(EventQueue::MaxArgs);
+
+        luaL_checkstack(L, Width + 2, "dispatching events");
+        lua_pushvalue(L, -1);
+        if (lua_rawget(L, Columns) != LUA_TTABLE)
+        {
+            lua_pop(L, 1);
+            lua_createtable(L, Width, 0);
+            for (int i = 1; i <= Width; i++)
+            {
+                lua_newtable(L);
+                lua_rawseti(L, -2, i);
+            }
+            lua_pushvalue(L, -2);
+            lua_pushvalue(L, -2);
+            lua_rawset(L, Columns);
+        }
+        lua_remove(L, -2);
+
+        for (int i = 1; i <= Width; i++) lua_rawgeti(L, -i, i);
+        lua_remove(L, -Width - 1);
+    }
+}
+
+/* struct EventQueue */
+EventQueue::EventQueue(std::size_t capacity) :
+    _ring(capacity),
+    _dropped(0),
+    _dispatch(LUA_NOREF)
+{
+    _batch.resize(_ring.capacity());
+}
+
+bool EventQueue::push(Event&& event)
+{
+    if (_ring.try_push(std::move(event))) return true;
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+std::size_t EventQueue::dropped() const
+{
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+int EventQueue::_run(State L)
+{
+    // Stack layout: [1] per-event handlers of the current type, [2] batch handlers of
+    // the current type, [3] the first error raised by a handler, followed by MaxArgs
+    // column arrays for every type with batch handlers
+    auto& queue = *static_cast<EventQueue*>(lua_touserdata(STATE, 1));
+    const auto count = static_cast<std::size_t>(lua_tointeger(STATE, 2));
+    lua_settop(STATE, 3);
+
+    // The columns of every batched type stay on the stack, so room is made before each
+    // push sequence rather than once: a handler and its arguments, or a batch handler
+    // table, the handler, the count and the columns
+    constexpr int HandlerPushes = static_cast<int>(MaxArgs) + 1;
+    constexpr int BatchPushes   = static_cast<int>(MaxArgs) + 3;
+
+    queue._columns.clear();
+
+    const SL::String* previous = nullptr;
+    Column* column = nullptr;
+    for (std::size_t e = 0; e < count; e++)
+    {
+        const auto& event = queue._batch[e];
+        if (!previous || *previous != event.type)
+        {
+            luaL_checkstack(STATE, 2, "dispatching events");
+            lua_pushlstring(STATE, event.type.data(), event.type.size());
+            lua_pushvalue(STATE, -1);
+            lua_rawget(STATE, Handlers);
+            lua_replace(STATE, 1);
+
+            lua_pushvalue(STATE, -1);
+            lua_rawget(STATE, BatchHandlers);
+            const bool batched = lua_istable(STATE, -1) && lua_rawlen(STATE, -1);
+            lua_replace(STATE, 2);
+
+            column = nullptr;
+            if (batched)
+            {
+                for (auto& c : queue._columns)
+                    if (*c.type == event.type) { column = &c; break; }
+
+                if (!column)
+                {
+                    pushColumns(STATE);
+                    queue._columns.push_back(Column{ &event.type, 0, lua_gettop(STATE) - static_cast<int>(MaxArgs) + 1, 0 });
+                    column = &queue._columns.back();
+                }
+                else lua_pop(STATE, 1);
+            }
+            else lua_pop(STATE, 1);
+
+            previous = &event.type;
+        }
+
+        if (column)
+        {
+            // The arrays are reused, so the slots of arguments an event doesn't have are
+            // cleared instead of keeping the values of an earlier event or tick
+            column->count++;
+            for (uint8_t a = column->width; a < event.count; a++)
+                for (int64_t row = 1; row < column->count; row++)
+                {
+                    lua_pushnil(STATE);
+                    lua_rawseti(STATE, column->slot + a, row);
+                }
+            column->width = std::max(column->width, event.count);
+
+            for (uint8_t a = 0; a < column->width; a++)
+            {
+                if (a < event.count) pushValue(STATE, event.args[a]);
+                else lua_pushnil(STATE);
+                lua_rawseti(STATE, column->slot + a, column->count);
+            }
+        }
+
+        if (!lua_istable(STATE, 1)) continue;
+
+        luaL_checkstack(STATE, HandlerPushes, "dispatching events");
+        const auto n = static_cast<lua_Integer>(lua_rawlen(STATE, 1));
+        for (lua_Integer i = 1; i <= n; i++)
+        {
+            lua_rawgeti(STATE, 1, i);
+            for (uint8_t a = 0; a < event.count; a++) pushValue(STATE, event.args[a]);
+            if (lua_pcall(STATE, event.count, 0, 0) != LUA_OK) keepError(STATE);
+        }
+    }
+
+    // Rows left from a larger batch of an earlier tick are cleared, and so are the arrays
+    // of arguments the events of this tick don't have
+    for (const auto& c : queue._columns)
+        for (int a = 0; a < static_cast<int>(MaxArgs); a++)
+        {
+            const auto rows = a < c.width ? c.count : 0;
+            for (auto row = static_cast<int64_t>(lua_rawlen(STATE, c.slot + a)); row > rows; row--)
+            {
+                lua_pushnil(STATE);
+                lua_rawseti(STATE, c.slot + a, row);
+            }
+        }
+
+    for (const auto& c : queue._columns)
+    {
+        luaL_checkstack(STATE, BatchPushes, "dispatching events");
+        lua_pushlstring(STATE, c.type->data(), c.type->size());
+        lua_rawget(STATE, BatchHandlers);
+
+        const auto n = static_cast<lua_Integer>(lua_rawlen(STATE, -1));
+        for (lua_Integer i = 1; i <= n; i++)
+        {
+            lua_rawgeti(STATE, -1, i);
+            lua_pushinteger(STATE, c.count);
+            for (uint8_t a = 0; a < c.width; a++) lua_pushvalue(STATE, c.slot + a);
+            if (lua_pcall(STATE, c.width + 1, 0, 0) != LUA_OK) keepError(STATE);
+        }
+        lua_pop(STATE, 1);
+    }
+
+    if (lua_isnil(STATE, 3)) return 0;
+    lua_pushvalue(STATE, 3);
+    return lua_error(STATE);
+}
+
+void EventQueue::_install(State L)
+{
+    // Handler and column tables shared by the Lua functions through upvalues
+    lua_newtable(STATE);
+    lua_newtable(STATE);
+    lua_newtable(STATE);
+
+    lua_createtable(STATE, 0, 3);
+    const auto functions = std::initializer_list<std::pair<const char*, lua_CFunction>>{
+        { "subscribe",      subscribe      },
+        { "subscribeBatch", subscribeBatch },
+        { "unsubscribe",    unsubscribe    }
+    };
+    for (const auto& f : functions)
+    {
+        lua_pushvalue(STATE, -4);
+        lua_pushvalue(STATE, -4);
+        lua_pushvalue(STATE, -4);
+        lua_pushcclosure(STATE, f.second, 3);
+        lua_setfield(STATE, -2, f.first);
+    }
+    lua_setglobal(STATE, "Events");
+
+    lua_pushcclosure(STATE, reinterpret_cast<lua_CFunction>(_run), 3);
+    _dispatch = luaL_ref(STATE, LUA_REGISTRYINDEX);
+}
+
+std::size_t EventQueue::_drain()
+{
+    // Pop straight into the reused batch, at most one queue worth so busy producers can't stall the tick
+    std::size_t count = 0;
+    while (count < _batch.size() && _ring.try_pop(_batch[count])) count++;
+    return count;
+}
+
+} // SL
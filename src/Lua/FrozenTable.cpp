@@ -0,0 +1,723 @@
+#include <SL/Lua/FrozenTable.hpp>
+
+#include "Lua.cpp"
+
+#include <charconv>
+#include <functional>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace SL
+{
+
+namespace detail
+{
+    // Every table of a frozen tree, laid out in flat arrays indexed by position so that the
+    // whole tree is a handful of allocations
+    struct FrozenData
+    {
+        enum Type : uint8_t
+        {
+            Nil,
+            Boolean,
+            Integer,
+            Number,
+            String,
+            Function,
+            Table
+        };
+
+        struct Value
+        {
+            union
+            {
+                int64_t      integer; // Also a boolean, or the offset of a string in `strings`
+                double       number;
+                SL::Function function;
+                uint32_t     node;
+            };
+            uint32_t size; // Length of a string
+            Type     type;
+        };
+
+        struct Entry
+        {
+            uint32_t    key;  // Offset of the key in `strings`
+            uint32_t    key_size;
+            std::size_t hash;
+            Value       value;
+            bool        integer_key; // Pushed to Lua as an integer
+        };
+
+        struct Node
+        {
+            uint32_t array;   // First value of the array part
+            uint32_t size;
+            uint32_t entries; // First entry of the other keys
+            uint32_t count;
+            uint32_t slots;   // First slot of the entries' hash index
+            uint32_t mask;    // Number of slots minus one
+        };
+
+        std::vector<Node>     nodes;
+        std::vector<Value>    values;
+        std::vector<Entry>    entries;
+        std::vector<uint32_t> slots; // Position of an entry in its node plus one, 0 when free
+        std::string           strings;
+
+        std::string_view string(uint32_t offset, uint32_t size) const
+        {
+            return std::string_view(strings.data() + offset, size);
+        }
+
+        std::string_view key(const Entry& entry) const
+        {
+            return string(entry.key, entry.key_size);
+        }
+
+        const Value* array(const Node& node, int64_t index) const
+        {
+            if (index < 1 || static_cast<uint64_t>(index) > node.size) return nullptr;
+            return &values[node.array + static_cast<std::size_t>(index) - 1];
+        }
+
+        const Value* find(const Node& node, std::string_view name, std::size_t hash) const
+        {
+            if (!node.count) return nullptr;
+
+            for (auto i = hash & node.mask;; i = (i + 1) & node.mask)
+            {
+                const auto slot = slots[node.slots + i];
+                if (!slot) return nullptr;
+
+                const auto& entry = entries[node.entries + slot - 1];
+                if (entry.hash == hash && key(entry) == name) return &entry.value;
+            }
+        }
+
+        const Value* find(const Node& node, std::string_view name) const
+        {
+            int64_t index;
+            if (integer(name, index) && index >= 1 && static_cast<uint64_t>(index) <= node.size) return array(node, index);
+            return find(node, name, std::hash<std::string_view>()(name));
+        }
+
+        const Value* find(const Node& node, int64_t index) const
+        {
+            if (const auto* value = array(node, index)) return value;
+
+            char digits[24];
+            const auto res = std::to_chars(digits, digits + sizeof(digits), index);
+            return find(node, std::string_view(digits, static_cast<std::size_t>(res.ptr - digits)));
+        }
+
+        // Whether a key is the string of an integer, the way Table stores integer keys
+        static bool integer(std::string_view name, int64_t& value)
+        {
+            if (name.empty() || name.size() > 20 || !(name[0] == '-' || (name[0] >= '0' && name[0] <= '9'))) return false;
+
+            const auto res = std::from_chars(name.data(), name.data() + name.size(), value);
+            if (res.ec != std::errc() || res.ptr != name.data() + name.size()) return false;
+
+            char digits[24];
+            const auto back = std::to_chars(digits, digits + sizeof(digits), value);
+            return std::string_view(digits, static_cast<std::size_t>(back.ptr - digits)) == name;
+        }
+
+        uint32_t intern(std::string_view s)
+        {
+            const auto offset = static_cast<uint32_t>(strings.size());
+            strings.append(s.data(), s.size());
+            return offset;
+        }
+
+        // Nodes already made for the tables of one tree, by address
+        using Frozen = std::unordered_map<const SL::Table*, uint32_t>;
+
+        uint32_t freeze(const SL::Table& table)
+        {
+            Frozen frozen;
+            return freeze(table, frozen);
+        }
+
+        Value freeze(const SL::Table::Data& data, Frozen& frozen)
+        {
+            Value value{};
+            switch (data.type)
+            {
+            case LUA_TNUMBER:
+            {
+                double real = 0;
+                value.type = __number(data, value.integer, real) ? Integer : Number;
+                if (value.type == Number) value.number = real;
+                break;
+            }
+            case LUA_TSTRING:
+            {
+                const auto& s = *static_cast<const SL::String*>(data.data.get());
+                value.integer = intern(s);
+                value.size = static_cast<uint32_t>(s.size());
+                value.type = String;
+                break;
+            }
+            case LUA_TBOOLEAN:
+                value.integer = *static_cast<const SL::Boolean*>(data.data.get());
+                value.type = Boolean;
+                break;
+            case LUA_TFUNCTION:
+                value.function = *static_cast<const SL::Function*>(data.data.get());
+                value.type = Function;
+                break;
+            case LUA_TTABLE:
+                value.node = freeze(*static_cast<const SL::Table*>(data.data.get()), frozen);
+                value.type = Table;
+                break;
+            default:
+                value.type = Nil;
+            }
+            return value;
+        }
+
+        // A table reachable from several keys, as Lua tables read with aliases are, becomes
+        // one node that all of them point to
+        uint32_t freeze(const SL::Table& table, Frozen& frozen)
+        {
+            if (const auto found = frozen.find(&table); found != frozen.end()) return found->second;
+
+            const auto& map = table.getMap();
+            const auto id = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            frozen.emplace(&table, id);
+
+            // The array part runs from "1" up to the first missing index
+            using Key = std::pair<std::string_view, const SL::Table::Data*>;
+            std::vector<Key> positions(map.size(), Key{ {}, nullptr });
+            std::vector<Key> others;
+            for (const auto& [key, data] : map)
+            {
+                // An entry without a value has nothing to freeze, whatever its type says
+                if (!data.data) continue;
+                if (data.type != LUA_TNUMBER && data.type != LUA_TSTRING && data.type != LUA_TBOOLEAN &&
+                    data.type != LUA_TFUNCTION && data.type != LUA_TTABLE) continue;
+
+                const auto name = key.view();
+                int64_t index;
+                if (integer(name, index) && index >= 1 && static_cast<uint64_t>(index) <= map.size()) positions[index - 1] = { name, &data };
+                else others.emplace_back(name, &data);
+            }
+
+            uint32_t size = 0;
+            while (size < positions.size() && positions[size].second) size++;
+            for (auto i = size; i < positions.size(); i++)
+                if (positions[i].second) others.push_back(positions[i]);
+
+            Node node{};
+            node.array = static_cast<uint32_t>(values.size());
+            node.size = size;
+            node.entries = static_cast<uint32_t>(entries.size());
+            node.count = static_cast<uint32_t>(others.size());
+            values.resize(values.size() + size);
+            entries.resize(entries.size() + others.size());
+
+            // Nested tables append to the arrays, so values are stored by position
+            for (uint32_t i = 0; i < size; i++)
+            {
+                const auto value = freeze(*positions[i].second, frozen);
+                values[node.array + i] = value;
+            }
+            for (uint32_t i = 0; i < node.count; i++)
+            {
+                const auto [name, data] = others[i];
+                int64_t index;
+
+                Entry entry{};
+                entry.key = intern(name);
+                entry.key_size = static_cast<uint32_t>(name.size());
+                entry.hash = std::hash<std::string_view>()(name);
+                entry.integer_key = integer(name, index);
+                entry.value = freeze(*data, frozen);
+                entries[node.entries + i] = entry;
+            }
+
+            // Open addressing at most half full
+            uint32_t capacity = node.count ? 2 : 0;
+            while (capacity && capacity < node.count * 2) capacity *= 2;
+            node.slots = static_cast<uint32_t>(slots.size());
+            node.mask = capacity ? capacity - 1 : 0;
+            slots.resize(slots.size() + capacity, 0);
+            for (uint32_t i = 0; i < node.count; i++)
+            {
+                auto slot = entries[node.entries + i].hash & node.mask;
+                while (slots[node.slots + slot]) slot = (slot + 1) & node.mask;
+                slots[node.slots + slot] = i + 1;
+            }
+
+            nodes[id] = node;
+            return id;
+        }
+    };
+}
+
+namespace
+{
+    using Data  = detail::FrozenData;
+    using Value = Data::Value;
+
+    constexpr const char* Metatable       = "SL.frozen";
+    constexpr const char* AnchorMetatable = "SL.frozen.block";
+
+    // The proxies last pushed by a state, in a fixed number of slots picked by their node so
+    // that the cache costs the same whatever the size of the tables. Values are weak, a proxy
+    // only in the cache doesn't keep its block alive. The anchors are kept apart, weak too
+    // and keyed by the address of their block
+    constexpr int CacheSlots = 2048;
+    const char CacheKey  = 0;
+    const char AnchorKey = 0;
+
+    // Proxies own nothing, so they cost no finalizer when they come and go. The block is held
+    // by an anchor, one per state, that every proxy of the block keeps as its user value
+    struct Proxy
+    {
+        const Data* data;
+        uint32_t    node;
+
+        const Data::Node& get() const { return data->nodes[node]; }
+    };
+
+    struct Anchor
+    {
+        std::shared_ptr<const Data> data;
+    };
+
+    // Only drops the reference, so that running it twice is harmless
+    int anchorGc(lua_State* L)
+    {
+        static_cast<Anchor*>(luaL_checkudata(L, 1, AnchorMetatable))->data.reset();
+        return 0;
+    }
+
+    void pushAnchor(lua_State* L, const std::shared_ptr<const Data>& data)
+    {
+        if (lua_rawgetp(L, LUA_REGISTRYINDEX, &AnchorKey) != LUA_TTABLE)
+        {
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_createtable(L, 0, 1);
+            lua_pushliteral(L, "v");
+            lua_setfield(L, -2, "__mode");
+            lua_setmetatable(L, -2);
+
+            lua_pushvalue(L, -1);
+            lua_rawsetp(L, LUA_REGISTRYINDEX, &AnchorKey);
+        }
+        const int anchors = lua_gettop(L);
+
+        if (lua_rawgetp(L, anchors, data.get()) != LUA_TNIL)
+        {
+            lua_remove(L, anchors);
+            return;
+        }
+        lua_pop(L, 1);
+
+        new (lua_newuserdatauv(L, sizeof(Anchor), 0)) Anchor{ data };
+        if (luaL_newmetatable(L, AnchorMetatable))
+        {
+            lua_pushcfunction(L, anchorGc);
+            lua_setfield(L, -2, "__gc");
+
+            // Keeps __gc out of the reach of scripts
+            lua_pushliteral(L, "frozen block");
+            lua_setfield(L, -2, "__metatable");
+        }
+        lua_setmetatable(L, -2);
+
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, anchors, data.get());
+        lua_remove(L, anchors);
+    }
+
+    lua_Integer slot(const Data* data, uint32_t node)
+    {
+        const auto address = reinterpret_cast<uintptr_t>(&data->nodes[node]) / sizeof(Data::Node);
+        return static_cast<lua_Integer>(address % CacheSlots) + 1;
+    }
+
+    // Pushes the cached proxy of a node and returns true, or returns false
+    bool pushCached(lua_State* L, const Data* data, uint32_t node, int cache)
+    {
+        if (lua_rawgeti(L, cache, slot(data, node)) == LUA_TUSERDATA)
+        {
+            const auto* proxy = static_cast<const Proxy*>(lua_touserdata(L, -1));
+            if (proxy->data == data && proxy->node == node) return true;
+        }
+        lua_pop(L, 1);
+        return false;
+    }
+
+    // Replaces the anchor on top of the stack with a proxy of one of the block's tables
+    void pushProxy(lua_State* L, const Data* data, uint32_t node, int cache, int metatable)
+    {
+        if (pushCached(L, data, node, cache))
+        {
+            lua_replace(L, -2);
+            return;
+        }
+
+        new (lua_newuserdatauv(L, sizeof(Proxy), 1)) Proxy{ data, node };
+        lua_pushvalue(L, metatable);
+        lua_setmetatable(L, -2);
+        lua_pushvalue(L, -2);
+        lua_setiuservalue(L, -2, 1);
+
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, cache, slot(data, node));
+        lua_replace(L, -2);
+    }
+
+    // Values of the proxy at index self, with the cache and metatable at the given indices
+    void pushValue(lua_State* L, int self, const Value* value, int cache, int metatable)
+    {
+        if (!value)
+        {
+            lua_pushnil(L);
+            return;
+        }
+
+        const auto& proxy = *static_cast<const Proxy*>(lua_touserdata(L, self));
+        switch (value->type)
+        {
+        case Data::Boolean:  lua_pushboolean(L, static_cast<int>(value->integer)); break;
+        case Data::Integer:  lua_pushinteger(L, static_cast<lua_Integer>(value->integer)); break;
+        case Data::Number:   lua_pushnumber(L, value->number); break;
+        case Data::Function: lua_pushcfunction(L, reinterpret_cast<lua_CFunction>(value->function)); break;
+        case Data::Table:
+            if (pushCached(L, proxy.data, value->node, cache)) break;
+            lua_getiuservalue(L, self, 1);
+            pushProxy(L, proxy.data, value->node, cache, metatable);
+            break;
+        case Data::String:
+        {
+            const auto s = proxy.data->string(static_cast<uint32_t>(value->integer), value->size);
+            lua_pushlstring(L, s.data(), s.size());
+            break;
+        }
+        default: lua_pushnil(L);
+        }
+    }
+
+    // Metamethods can still be handed something else through the debug library
+    const Proxy& self(lua_State* L)
+    {
+        return *static_cast<const Proxy*>(luaL_checkudata(L, 1, Metatable));
+    }
+
+    // t[key], with the cache and the metatable as upvalues
+    int frozenIndex(lua_State* L)
+    {
+        const auto& proxy = self(L);
+        const auto& data = *proxy.data;
+        const auto& node = proxy.get();
+
+        const Value* value = nullptr;
+        switch (lua_type(L, 2))
+        {
+        case LUA_TSTRING:
+        {
+            std::size_t size;
+            const char* name = lua_tolstring(L, 2, &size);
+            value = data.find(node, std::string_view(name, size));
+            break;
+        }
+        case LUA_TNUMBER:
+        {
+            int exact;
+            const auto index = lua_tointegerx(L, 2, &exact);
+            if (exact) value = data.find(node, static_cast<int64_t>(index));
+            break;
+        }
+        }
+
+        pushValue(L, 1, value, lua_upvalueindex(1), lua_upvalueindex(2));
+        return 1;
+    }
+
+    int frozenNewIndex(lua_State* L)
+    {
+        return luaL_error(L, "attempt to modify a frozen table");
+    }
+
+    int frozenLen(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(self(L).get().size));
+        return 1;
+    }
+
+    // The array part in order, then the other keys. Upvalues are the cache, the metatable,
+    // the proxy and the position, so the arguments are never trusted
+    int frozenNext(lua_State* L)
+    {
+        const int self = lua_upvalueindex(3);
+        const auto& proxy = *static_cast<const Proxy*>(lua_touserdata(L, self));
+        const auto& data = *proxy.data;
+        const auto& node = proxy.get();
+
+        const auto position = static_cast<uint32_t>(lua_tointeger(L, lua_upvalueindex(4)));
+        if (position >= node.size + node.count) return 0;
+
+        lua_pushinteger(L, static_cast<lua_Integer>(position) + 1);
+        lua_replace(L, lua_upvalueindex(4));
+
+        if (position < node.size)
+        {
+            lua_pushinteger(L, static_cast<lua_Integer>(position) + 1);
+            pushValue(L, self, &data.values[node.array + position], lua_upvalueindex(1), lua_upvalueindex(2));
+            return 2;
+        }
+
+        const auto& entry = data.entries[node.entries + position - node.size];
+        const auto key = data.key(entry);
+        int64_t index;
+        if (entry.integer_key && Data::integer(key, index)) lua_pushinteger(L, static_cast<lua_Integer>(index));
+        else lua_pushlstring(L, key.data(), key.size());
+
+        pushValue(L, self, &entry.value, lua_upvalueindex(1), lua_upvalueindex(2));
+        return 2;
+    }
+
+    int frozenPairs(lua_State* L)
+    {
+        self(L);
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_pushvalue(L, lua_upvalueindex(2));
+        lua_pushvalue(L, 1);
+        lua_pushinteger(L, 0);
+        lua_pushcclosure(L, frozenNext, 4);
+        lua_pushvalue(L, 1);
+        lua_pushnil(L);
+        return 3;
+    }
+
+    // Proxies dropped from the cache are made again, they still compare equal
+    int frozenEq(lua_State* L)
+    {
+        const auto* a = static_cast<const Proxy*>(luaL_testudata(L, 1, Metatable));
+        const auto* b = static_cast<const Proxy*>(luaL_testudata(L, 2, Metatable));
+        lua_pushboolean(L, a && b && a->data == b->data && a->node == b->node);
+        return 1;
+    }
+
+    int frozenToString(lua_State* L)
+    {
+        lua_pushfstring(L, "frozen table: %p", lua_topointer(L, 1));
+        return 1;
+    }
+
+    void pushCache(lua_State* L)
+    {
+        if (lua_rawgetp(L, LUA_REGISTRYINDEX, &CacheKey) == LUA_TTABLE) return;
+        lua_pop(L, 1);
+
+        // Sized up front, the slots stay in the array part however they are filled
+        lua_createtable(L, CacheSlots, 0);
+        lua_createtable(L, 0, 1);
+        lua_pushliteral(L, "v");
+        lua_setfield(L, -2, "__mode");
+        lua_setmetatable(L, -2);
+
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, LUA_REGISTRYINDEX, &CacheKey);
+    }
+
+    void pushMetatable(lua_State* L)
+    {
+        if (!luaL_newmetatable(L, Metatable)) return;
+
+        const luaL_Reg cached[] = {
+            { "__index", frozenIndex },
+            { "__pairs", frozenPairs },
+            { nullptr,   nullptr }
+        };
+        pushCache(L);
+        lua_pushvalue(L, -2);
+        luaL_setfuncs(L, cached, 2);
+
+        const luaL_Reg methods[] = {
+            { "__newindex", frozenNewIndex },
+            { "__len",      frozenLen },
+            { "__eq",       frozenEq },
+            { "__tostring", frozenToString },
+            { nullptr,      nullptr }
+        };
+        luaL_setfuncs(L, methods, 0);
+
+        lua_pushliteral(L, "frozen table");
+        lua_setfield(L, -2, "__metatable");
+    }
+
+    template<typename T>
+    std::optional<T> read(const std::shared_ptr<const Data>& data, const Value* value)
+    {
+        if (!value) return std::nullopt;
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            if (value->type == Data::Boolean) return value->integer != 0;
+        }
+        else if constexpr (std::is_same_v<T, int64_t>)
+        {
+            if (value->type == Data::Integer) return value->integer;
+            if (value->type == Data::Number && static_cast<double>(static_cast<int64_t>(value->number)) == value->number) return static_cast<int64_t>(value->number);
+        }
+        else if constexpr (std::is_same_v<T, double>)
+        {
+            if (value->type == Data::Number)  return value->number;
+            if (value->type == Data::Integer) return static_cast<double>(value->integer);
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            if (value->type == Data::String) return data->string(static_cast<uint32_t>(value->integer), value->size);
+        }
+        else if constexpr (std::is_same_v<T, SL::Function>)
+        {
+            if (value->type == Data::Function) return value->function;
+        }
+        return std::nullopt;
+    }
+}
+
+/* struct FrozenTable */
+FrozenTable::FrozenTable(const Table& table)
+{
+    auto data = std::make_shared<Data>();
+    _node = data->freeze(table);
+
+    data->nodes.shrink_to_fit();
+    data->values.shrink_to_fit();
+    data->entries.shrink_to_fit();
+    data->slots.shrink_to_fit();
+    data->strings.shrink_to_fit();
+    _data = std::move(data);
+}
+
+FrozenTable::FrozenTable(std::shared_ptr<const detail::FrozenData> data, uint32_t node) :
+    _data(std::move(data)),
+    _node(node)
+{   }
+
+std::size_t FrozenTable::size() const
+{
+    return _data ? _data->nodes[_node].size : 0;
+}
+
+std::size_t FrozenTable::count() const
+{
+    if (!_data) return 0;
+    const auto& node = _data->nodes[_node];
+    return node.size + node.count;
+}
+
+bool FrozenTable::has(std::string_view key) const
+{
+    return _data && _data->find(_data->nodes[_node], key);
+}
+
+template<typename T>
+std::optional<T> FrozenTable::get(std::string_view key) const
+{
+    if (!_data) return std::nullopt;
+    const auto* value = _data->find(_data->nodes[_node], key);
+
+    if constexpr (std::is_same_v<T, FrozenTable>)
+    {
+        if (!value || value->type != Data::Table) return std::nullopt;
+        return FrozenTable(_data, value->node);
+    }
+    else return read<T>(_data, value);
+}
+
+template<typename T>
+std::optional<T> FrozenTable::get(std::size_t index) const
+{
+    if (!_data) return std::nullopt;
+    const auto* value = _data->array(_data->nodes[_node], static_cast<int64_t>(index));
+
+    if constexpr (std::is_same_v<T, FrozenTable>)
+    {
+        if (!value || value->type != Data::Table) return std::nullopt;
+        return FrozenTable(_data, value->node);
+    }
+    else return read<T>(_data, value);
+}
+
+template SL_SYMBOL std::optional<bool>             FrozenTable::get(std::string_view) const;
+template SL_SYMBOL std::optional<int64_t>          FrozenTable::get(std::string_view) const;
+template SL_SYMBOL std::optional<double>           FrozenTable::get(std::string_view) const;
+template SL_SYMBOL std::optional<std::string_view> FrozenTable::get(std::string_view) const;
+template SL_SYMBOL std::optional<SL::Function>     FrozenTable::get(std::string_view) const;
+template SL_SYMBOL std::optional<FrozenTable>      FrozenTable::get(std::string_view) const;
+
+template SL_SYMBOL std::optional<bool>             FrozenTable::get(std::size_t) const;
+template SL_SYMBOL std::optional<int64_t>          FrozenTable::get(std::size_t) const;
+template SL_SYMBOL std::optional<double>           FrozenTable::get(std::size_t) const;
+template SL_SYMBOL std::optional<std::string_view> FrozenTable::get(std::size_t) const;
+template SL_SYMBOL std::optional<SL::Function>     FrozenTable::get(std::size_t) const;
+template SL_SYMBOL std::optional<FrozenTable>      FrozenTable::get(std::size_t) const;
+
+std::size_t FrozenTable::bytes() const
+{
+    if (!_data) return 0;
+    return sizeof(Data)
+        + _data->nodes.capacity()   * sizeof(Data::Node)
+        + _data->values.capacity()  * sizeof(Data::Value)
+        + _data->entries.capacity() * sizeof(Data::Entry)
+        + _data->slots.capacity()   * sizeof(uint32_t)
+        + _data->strings.capacity();
+}
+
+namespace CompileTime
+{
+    int TypeMap<FrozenTable>::LuaType = LUA_TUSERDATA;
+
+    bool
+    TypeMap<FrozenTable>::check(State L)
+    {
+        return luaL_testudata(STATE, -1, Metatable) != nullptr;
+    }
+
+    void
+    TypeMap<FrozenTable>::push(State L, const FrozenTable& val)
+    {
+        // An empty handle gets an empty block of its own
+        static const auto empty = []()
+        {
+            auto data = std::make_shared<Data>();
+            data->freeze(Table());
+            return std::shared_ptr<const Data>(std::move(data));
+        }();
+        const auto& data = val._data ? val._data : empty;
+
+        pushCache(STATE);
+        const int cache = lua_gettop(STATE);
+        pushMetatable(STATE);
+        pushAnchor(STATE, data);
+        pushProxy(STATE, data.get(), val._node, cache, cache + 1);
+
+        lua_replace(STATE, cache);
+        lua_settop(STATE, cache);
+    }
+
+    FrozenTable
+    TypeMap<FrozenTable>::construct(State L)
+    {
+        const auto node = static_cast<const Proxy*>(lua_touserdata(STATE, -1))->node;
+
+        lua_getiuservalue(STATE, -1, 1);
+        auto data = static_cast<const Anchor*>(lua_touserdata(STATE, -1))->data;
+        lua_pop(STATE, 1);
+        return FrozenTable(std::move(data), node);
+    }
+
+} // CompileTime
+
+} // SL
@@ -0,0 +1,440 @@
+#pragma once
+
+// JSON reading and writing shared by the json library and SL::Table, which build and walk
+// their own values through a handler
+
+#include <charconv>
+#include <clocale>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SL_JSON_SSE2
+#   include <emmintrin.h>
+#endif
+
+namespace SL::detail::json
+{
+    // Containers nested deeper are rejected, which also stops cycles when writing
+    constexpr int MaxDepth = 512;
+
+    // Length of the prefix of [p, p + size) holding no '"', '\\' or control character,
+    // the only bytes that need attention inside a string
+    inline std::size_t plain(const char* p, std::size_t size)
+    {
+        std::size_t i = 0;
+#ifdef SL_JSON_SSE2
+        const __m128i quote     = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control   = _mm_set1_epi8(0x1f);
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+
+            if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special)))
+            {
+#   ifdef _MSC_VER
+                unsigned long bit;
+                _BitScanForward(&bit, mask);
+                return i + bit;
+#   else
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+#   endif
+            }
+        }
+#endif
+        for (; i < size; i++)
+        {
+            const auto c = static_cast<unsigned char>(p[i]);
+            if (c == '"' || c == '\\' || c < 0x20) break;
+        }
+        return i;
+    }
+
+    /* Writing */
+
+    inline void writeString(std::string& out, std::string_view s)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        out += '"';
+        while (!s.empty())
+        {
+            const auto run = plain(s.data(), s.size());
+            out.append(s.data(), run);
+            if (run == s.size()) break;
+
+            const auto c = static_cast<unsigned char>(s[run]);
+            switch (c)
+            {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b";  break;
+            case '\f': out += "\\f";  break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+            }
+            s.remove_prefix(run + 1);
+        }
+        out += '"';
+    }
+
+    inline void writeInteger(std::string& out, int64_t value)
+    {
+        char digits[24];
+        const auto res = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, res.ptr);
+    }
+
+    // strtod and snprintf follow the C locale, which may use ',' as its decimal point.
+    // JSON always uses '.', so the point is swapped on the way in and out
+    inline char localePoint()
+    {
+        const char* point = std::localeconv()->decimal_point;
+        return (point && point[0]) ? point[0] : '.';
+    }
+
+    // Reads a number already validated against the JSON grammar
+    inline double readDouble(const char* start, const char* end)
+    {
+        std::string text(start, end);
+        const char point = localePoint();
+        if (point != '.')
+            for (auto& c : text) if (c == '.') c = point;
+        return std::strtod(text.c_str(), nullptr);
+    }
+
+    // The shortest form that reads back the same, with ".0" kept on whole numbers so that
+    // they decode as floats again. Infinities and NaN have no JSON form and return false
+    inline bool writeNumber(std::string& out, double value)
+    {
+        if (!(value - value == 0.0)) return false;
+
+        const char point = localePoint();
+        char digits[32];
+        int length = 0;
+        for (int precision = 15; precision <= 17; precision++)
+        {
+            length = std::snprintf(digits, sizeof(digits), "%.*g", precision, value);
+            if (point != '.')
+                for (int i = 0; i < length; i++) if (digits[i] == point) digits[i] = '.';
+            if (readDouble(digits, digits + length) == value) break;
+        }
+
+        const std::string_view text(digits, static_cast<std::size_t>(length));
+        out.append(text);
+        if (text.find_first_of(".e") == std::string_view::npos) out += ".0";
+        return true;
+    }
+
+    /* Reading */
+
+    /**
+     * Reads a document into a handler, which provides
+     *   null(), boolean(bool), integer(int64_t), number(double), string(std::string_view)
+     *   Frame beginArray(), element(Frame&), endArray(Frame&)
+     *   Frame beginObject(), key(std::string_view), member(Frame&), endObject(Frame&)
+     * where element and member are called after each value of the container. Reading
+     * stops when the handler returns false.
+     */
+    struct Parser
+    {
+        Parser(std::string_view json) :
+            begin(json.data()), p(json.data()), end(json.data() + json.size())
+        {   }
+
+        template<typename Handler>
+        bool parse(Handler& handler)
+        {
+            skip();
+            if (!value(handler, 0)) return false;
+
+            skip();
+            if (p != end) return fail("unexpected trailing characters");
+            return true;
+        }
+
+        const char* begin;
+        const char* p;
+        const char* end;
+
+        std::string error;
+
+    private:
+        bool fail(const char* what)
+        {
+            error = std::string(what) + " at position " + std::to_string(p - begin + 1);
+            return false;
+        }
+
+        void skip()
+        {
+            while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+        }
+
+        bool literal(const char* word, std::size_t size)
+        {
+            if (static_cast<std::size_t>(end - p) < size || std::memcmp(p, word, size) != 0) return fail("invalid literal");
+            p += size;
+            return true;
+        }
+
+        template<typename Handler>
+        bool value(Handler& handler, int depth)
+        {
+            if (p == end) return fail("unexpected end of document");
+
+            switch (*p)
+            {
+            case '{': return object(handler, depth + 1);
+            case '[': return array(handler, depth + 1);
+            case '"':
+            {
+                std::string_view s;
+                return string(s) && handler.string(s);
+            }
+            case 't': return literal("true", 4) && handler.boolean(true);
+            case 'f': return literal("false", 5) && handler.boolean(false);
+            case 'n': return literal("null", 4) && handler.null();
+            default:  return number(handler);
+            }
+        }
+
+        template<typename Handler>
+        bool array(Handler& handler, int depth)
+        {
+            if (depth > MaxDepth) return fail("nested too deep");
+            p++;
+
+            auto frame = handler.beginArray();
+            skip();
+            if (p != end && *p == ']')
+            {
+                p++;
+                return handler.endArray(frame);
+            }
+
+            while (true)
+            {
+                skip();
+                if (!value(handler, depth) || !handler.element(frame)) return false;
+
+                skip();
+                if (p == end) return fail("unexpected end of document");
+                if (*p == ']') break;
+                if (*p != ',') return fail("expected ',' or ']'");
+                p++;
+            }
+            p++;
+            return handler.endArray(frame);
+        }
+
+        template<typename Handler>
+        bool object(Handler& handler, int depth)
+        {
+            if (depth > MaxDepth) return fail("nested too deep");
+            p++;
+
+            auto frame = handler.beginObject();
+            skip();
+            if (p != end && *p == '}')
+            {
+                p++;
+                return handler.endObject(frame);
+            }
+
+            while (true)
+            {
+                skip();
+                if (p == end || *p != '"') return fail("expected a key");
+
+                std::string_view key;
+                if (!string(key) || !handler.key(key)) return false;
+
+                skip();
+                if (p == end || *p != ':') return fail("expected ':'");
+                p++;
+
+                skip();
+                if (!value(handler, depth) || !handler.member(frame)) return false;
+
+                skip();
+                if (p == end) return fail("unexpected end of document");
+                if (*p == '}') break;
+                if (*p != ',') return fail("expected ',' or '}'");
+                p++;
+            }
+            p++;
+            return handler.endObject(frame);
+        }
+
+        static int hexDigit(char c)
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        bool codeUnit(uint32_t& unit)
+        {
+            if (end - p < 4) return fail("invalid escape");
+
+            unit = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                const int digit = hexDigit(p[i]);
+                if (digit < 0) return fail("invalid escape");
+                unit = unit << 4 | static_cast<uint32_t>(digit);
+            }
+            p += 4;
+            return true;
+        }
+
+        void utf8(uint32_t c)
+        {
+            if (c < 0x80) scratch += static_cast<char>(c);
+            else if (c < 0x800)
+            {
+                scratch += static_cast<char>(0xc0 | c >> 6);
+                scratch += static_cast<char>(0x80 | (c & 0x3f));
+            }
+            else if (c < 0x10000)
+            {
+                scratch += static_cast<char>(0xe0 | c >> 12);
+                scratch += static_cast<char>(0x80 | (c >> 6 & 0x3f));
+                scratch += static_cast<char>(0x80 | (c & 0x3f));
+            }
+            else
+            {
+                scratch += static_cast<char>(0xf0 | c >> 18);
+                scratch += static_cast<char>(0x80 | (c >> 12 & 0x3f));
+                scratch += static_cast<char>(0x80 | (c >> 6 & 0x3f));
+                scratch += static_cast<char>(0x80 | (c & 0x3f));
+            }
+        }
+
+        // A string without escapes is viewed in place, others are unescaped into scratch
+        bool string(std::string_view& out)
+        {
+            const char* start = ++p;
+            p += plain(p, static_cast<std::size_t>(end - p));
+            if (p != end && *p == '"')
+            {
+                out = std::string_view(start, static_cast<std::size_t>(p - start));
+                p++;
+                return true;
+            }
+
+            scratch.assign(start, p);
+            while (true)
+            {
+                if (p == end) return fail("unterminated string");
+
+                const char c = *p;
+                if (c == '"') break;
+                if (static_cast<unsigned char>(c) < 0x20) return fail("control character in string");
+
+                p++;
+                if (c == '\\')
+                {
+                    if (p == end) return fail("unterminated string");
+                    switch (*p++)
+                    {
+                    case '"':  scratch += '"';  break;
+                    case '\\': scratch += '\\'; break;
+                    case '/':  scratch += '/';  break;
+                    case 'b':  scratch += '\b'; break;
+                    case 'f':  scratch += '\f'; break;
+                    case 'n':  scratch += '\n'; break;
+                    case 'r':  scratch += '\r'; break;
+                    case 't':  scratch += '\t'; break;
+                    case 'u':
+                    {
+                        uint32_t unit = 0;
+                        if (!codeUnit(unit)) return false;
+
+                        // A high surrogate followed by a low one is a single code point
+                        if (unit >= 0xd800 && unit < 0xdc00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+                        {
+                            const char* pair = p;
+                            p += 2;
+                            uint32_t low = 0;
+                            if (!codeUnit(low)) return false;
+                            if (low >= 0xdc00 && low < 0xe000) unit = 0x10000 + ((unit - 0xd800) << 10) + (low - 0xdc00);
+                            else p = pair;
+                        }
+                        utf8(unit);
+                        break;
+                    }
+                    default:
+                        p--;
+                        return fail("invalid escape");
+                    }
+                    continue;
+                }
+
+                const auto run = plain(p - 1, static_cast<std::size_t>(end - p + 1));
+                scratch.append(p - 1, run);
+                p += run - 1;
+            }
+            p++;
+            out = scratch;
+            return true;
+        }
+
+        template<typename Handler>
+        bool number(Handler& handler)
+        {
+            const char* start = p;
+            bool real = false;
+
+            if (p != end && *p == '-') p++;
+            if (p == end || !(*p >= '0' && *p <= '9')) return fail("unexpected character");
+            if (*p == '0') p++;
+            else while (p != end && *p >= '0' && *p <= '9') p++;
+
+            if (p != end && *p == '.')
+            {
+                real = true;
+                p++;
+                if (p == end || !(*p >= '0' && *p <= '9')) return fail("invalid number");
+                while (p != end && *p >= '0' && *p <= '9') p++;
+            }
+            if (p != end && (*p == 'e' || *p == 'E'))
+            {
+                real = true;
+                p++;
+                if (p != end && (*p == '+' || *p == '-')) p++;
+                if (p == end || !(*p >= '0' && *p <= '9')) return fail("invalid number");
+                while (p != end && *p >= '0' && *p <= '9') p++;
+            }
+
+            if (!real)
+            {
+                int64_t integer;
+                const auto res = std::from_chars(start, p, integer);
+                if (res.ec == std::errc() && res.ptr == p) return handler.integer(integer);
+            }
+
+            // Integers out of range are read as floats, like Lua does. Overflows go to
+            // infinity and underflows to zero
+            const double number = readDouble(start, p);
+            return handler.number(number);
+        }
+
+        std::string scratch;
+    };
+}
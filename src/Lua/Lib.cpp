@@ -8,16 +8,15 @@ namespace SL::Lib
 
 void Base::registerFunctions(SL::Runtime& runtime) const
 {
-    for (auto& p : _funcs)
-        runtime.registerFunction(_name, p.first, p.second);
+    runtime.registerLibrary(*this);
 }
 
 SL::Table Base::asTable() const
 {
     SL::Table table;
 
-    for (auto& p : _funcs)
-        table.set(p.first, p.second);
+    for (std::size_t i = 0; i < _count; i++)
+        table.set(_funcs[i].name, _funcs[i].func);
 
     return table;
 }
@@ -25,9 +24,32 @@ SL::Table Base::asTable() const
 Base::Base(
     const std::string& name,
     const Base::Map& funcs) :
+        _name(name)
+{
+    // Names are copied so the entries can point into storage owned by the library,
+    // the vector is never resized after this so the pointers stay valid
+    _names.reserve(funcs.size());
+    _owned.reserve(funcs.size() + 1);
+    for (auto& p : funcs)
+    {
+        _names.push_back(p.first);
+        _owned.push_back({ _names.back().c_str(), p.second });
+    }
+    _owned.push_back({ nullptr, nullptr });
+
+    _funcs = _owned.data();
+    _count = funcs.size();
+}
+
+Base::Base(
+    const std::string& name,
+    const Reg* funcs) :
         _name(name),
-        _funcs(funcs)
-{   }
+        _funcs(funcs),
+        _count(0)
+{
+    while (_funcs[_count].name) _count++;
+}
 
 namespace detail
 {
@@ -36,6 +58,16 @@ namespace detail
         return lua_gettop(STATE);
     }
 
+    void __setTop(State L, std::size_t top)
+    {
+        lua_settop(STATE, static_cast<int>(top));
+    }
+
+    bool __checkStack(State L, std::size_t count)
+    {
+        return lua_checkstack(STATE, static_cast<int>(count) + LUA_MINSTACK);
+    }
+
     bool __isNil(State L)
     {
         return lua_isnil(STATE, -1);
@@ -45,6 +77,15 @@ namespace detail
     {
         lua_pop(STATE, static_cast<int32_t>(n));
     }
+
+    void __pushUpvalue(State L, int index)
+    {
+#   ifdef SL_TRACE
+        // Traced functions are called through a closure holding the function and its name first
+        index += 2;
+#   endif
+        lua_pushvalue(STATE, lua_upvalueindex(index));
+    }
 }
 
 } // SL::Lib
\ No newline at end of file
@@ -0,0 +1,551 @@
+#include <SL/Lua/Lib/Buffer.hpp>
+
+#include "../Lua.cpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SL_BUFFER_SSE2
+#   include <emmintrin.h>
+#endif
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace
+{
+    using View = SL::Lib::Buffer::View;
+
+    /* Searching */
+
+#ifdef SL_BUFFER_SSE2
+    int lowestBit(unsigned mask)
+    {
+#   ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanForward(&bit, mask);
+        return static_cast<int>(bit);
+#   else
+        return __builtin_ctz(mask);
+#   endif
+    }
+#endif
+
+    // First occurrence of needle in [data, data + size), or nullptr
+    const char* search(const char* data, std::size_t size, const char* needle, std::size_t length)
+    {
+        if (length == 0) return data;
+        if (length > size) return nullptr;
+        if (length == 1) return static_cast<const char*>(std::memchr(data, needle[0], size));
+
+        const auto last = size - length;
+        std::size_t i = 0;
+
+#ifdef SL_BUFFER_SSE2
+        // Compares the first and last bytes of the needle at 16 positions at once, the
+        // rest is only compared where both match
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i final = _mm_set1_epi8(needle[length - 1]);
+        for (; i + 16 <= last + 1; i += 16)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + length - 1));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, final))));
+            while (mask)
+            {
+                const auto at = i + static_cast<std::size_t>(lowestBit(mask));
+                if (std::memcmp(data + at + 1, needle + 1, length - 2) == 0) return data + at;
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        while (i <= last)
+        {
+            const auto* candidate = static_cast<const char*>(std::memchr(data + i, needle[0], last - i + 1));
+            if (!candidate) return nullptr;
+
+            if (std::memcmp(candidate + 1, needle + 1, length - 1) == 0) return candidate;
+            i = static_cast<std::size_t>(candidate - data) + 1;
+        }
+        return nullptr;
+    }
+
+    /* Mapped files */
+
+    struct Mapping
+    {
+        Mapping(const char* data, std::size_t size, void* handle) :
+            data(data), size(size), handle(handle)
+        {   }
+
+        Mapping(const Mapping&) = delete;
+
+        ~Mapping()
+        {
+            if (!handle) return;
+#ifdef _WIN32
+            UnmapViewOfFile(data);
+            CloseHandle(static_cast<HANDLE>(handle));
+#else
+            munmap(handle, size);
+#endif
+        }
+
+        const char* data;
+        std::size_t size;
+        void*       handle;
+    };
+
+    /* Buffers */
+
+    // Views hold no C++ object, so they need no finalizer and are freed in a single
+    // collection, their user value is the owner or the Lua string holding the bytes
+    constexpr const char* Metatable = "SL.buffer";
+    constexpr const char* OwnerMetatable = "SL.buffer.owner";
+
+    struct Data
+    {
+        const char* data;
+        std::size_t size;
+    };
+
+    // A buffer keeping bytes owned by C++ alive
+    struct Owner : Data
+    {
+        std::shared_ptr<const void> owner;
+    };
+
+    Data* test(lua_State* L, int index)
+    {
+        if (auto* buffer = luaL_testudata(L, index, Metatable)) return static_cast<Data*>(buffer);
+        return static_cast<Data*>(luaL_testudata(L, index, OwnerMetatable));
+    }
+
+    Data* check(lua_State* L, int index)
+    {
+        if (auto* owner = static_cast<Owner*>(luaL_testudata(L, index, OwnerMetatable)))
+        {
+            if (!owner->owner) luaL_error(L, "attempt to use a finalized buffer");
+            return owner;
+        }
+
+        auto* buffer = test(L, index);
+        if (!buffer) luaL_typeerror(L, index, "buffer");
+        return buffer;
+    }
+
+    void pushMetatable(lua_State* L, const char* name);
+
+    void create(lua_State* L, const char* data, std::size_t size, std::shared_ptr<const void> owner)
+    {
+        if (!owner)
+        {
+            new (lua_newuserdatauv(L, sizeof(Data), 1)) Data{ data, size };
+            pushMetatable(L, Metatable);
+        }
+        else
+        {
+            new (lua_newuserdatauv(L, sizeof(Owner), 0)) Owner{ { data, size }, std::move(owner) };
+            pushMetatable(L, OwnerMetatable);
+        }
+        lua_setmetatable(L, -2);
+    }
+
+    // Pushes what keeps the bytes of the buffer at index alive
+    void pushAnchor(lua_State* L, int index)
+    {
+        if (luaL_testudata(L, index, OwnerMetatable)) lua_pushvalue(L, index);
+        else lua_getiuservalue(L, index, 1);
+    }
+
+    // A view of [begin, end) of the buffer at index, sharing its bytes
+    void pushView(lua_State* L, int index, std::size_t begin, std::size_t end)
+    {
+        index = lua_absindex(L, index);
+        const auto* parent = static_cast<const Data*>(lua_touserdata(L, index));
+        create(L, parent->data + begin, end - begin, nullptr);
+
+        pushAnchor(L, index);
+        lua_setiuservalue(L, -2, 1);
+    }
+
+    // Positions like string.sub, giving the 0-based range [begin, end)
+    void range(lua_State* L, const Data* buffer, int index, std::size_t& begin, std::size_t& end)
+    {
+        const auto size = static_cast<lua_Integer>(buffer->size);
+        auto i = luaL_optinteger(L, index, 1);
+        auto j = luaL_optinteger(L, index + 1, -1);
+
+        if (i < 0) i = std::max<lua_Integer>(size + i + 1, 1);
+        else if (i == 0) i = 1;
+        if (j < 0) j = size + j + 1;
+        else if (j > size) j = size;
+
+        begin = static_cast<std::size_t>(std::min(i - 1, size));
+        end = i <= j ? static_cast<std::size_t>(j) : begin;
+    }
+
+    std::string_view checkNeedle(lua_State* L, int index)
+    {
+        std::size_t length;
+        const char* needle = luaL_checklstring(L, index, &length);
+        return std::string_view(needle, length);
+    }
+
+    // Only drops the reference, so that running it twice is harmless
+    int ownerGc(lua_State* L)
+    {
+        auto* owner = static_cast<Owner*>(luaL_checkudata(L, 1, OwnerMetatable));
+        owner->owner.reset();
+        owner->data = nullptr;
+        owner->size = 0;
+        return 0;
+    }
+
+    int bufferLen(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(check(L, 1)->size));
+        return 1;
+    }
+
+    // buf:sub([i [, j]])
+    int bufferSub(lua_State* L)
+    {
+        std::size_t begin, end;
+        range(L, check(L, 1), 2, begin, end);
+        pushView(L, 1, begin, end);
+        return 1;
+    }
+
+    // buf:tostring([i [, j]])
+    int bufferToString(lua_State* L)
+    {
+        const auto* buffer = check(L, 1);
+
+        std::size_t begin, end;
+        range(L, buffer, 2, begin, end);
+        lua_pushlstring(L, buffer->data + begin, end - begin);
+        return 1;
+    }
+
+    bool bigEndianHost()
+    {
+        const uint16_t one = 1;
+        return *reinterpret_cast<const unsigned char*>(&one) == 0;
+    }
+
+    // buf:u32(pos [, "big"]) and the other typed reads
+    template<typename T>
+    int bufferRead(lua_State* L)
+    {
+        static const char* const orders[] = { "little", "big", nullptr };
+
+        const auto* buffer = check(L, 1);
+        const auto pos = luaL_checkinteger(L, 2);
+        const bool big = luaL_checkoption(L, 3, "little", orders) == 1;
+        luaL_argcheck(L, pos >= 1 && static_cast<lua_Unsigned>(pos) - 1 + sizeof(T) <= buffer->size, 2, "position out of range");
+
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, buffer->data + pos - 1, sizeof(T));
+        if (big != bigEndianHost()) std::reverse(bytes, bytes + sizeof(T));
+
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        if constexpr (std::is_floating_point_v<T>) lua_pushnumber(L, static_cast<lua_Number>(value));
+        else lua_pushinteger(L, static_cast<lua_Integer>(value));
+        return 1;
+    }
+
+    // buf:find(s [, init])
+    int bufferFind(lua_State* L)
+    {
+        const auto* buffer = check(L, 1);
+        const auto needle = checkNeedle(L, 2);
+
+        auto init = luaL_optinteger(L, 3, 1);
+        if (init < 0) init = std::max<lua_Integer>(static_cast<lua_Integer>(buffer->size) + init + 1, 1);
+        else if (init == 0) init = 1;
+        if (init - 1 > static_cast<lua_Integer>(buffer->size)) return 0;
+
+        const auto offset = static_cast<std::size_t>(init - 1);
+        const auto* found = search(buffer->data + offset, buffer->size - offset, needle.data(), needle.size());
+        if (!found) return 0;
+
+        const auto start = static_cast<lua_Integer>(found - buffer->data) + 1;
+        lua_pushinteger(L, start);
+        lua_pushinteger(L, start + static_cast<lua_Integer>(needle.size()) - 1);
+        return 2;
+    }
+
+    // buf:count(s)
+    int bufferCount(lua_State* L)
+    {
+        const auto* buffer = check(L, 1);
+        const auto needle = checkNeedle(L, 2);
+        luaL_argcheck(L, !needle.empty(), 2, "empty string");
+
+        lua_Integer count = 0;
+        const char* at = buffer->data;
+        const char* end = buffer->data + buffer->size;
+        while ((at = search(at, static_cast<std::size_t>(end - at), needle.data(), needle.size())))
+        {
+            count++;
+            at += needle.size();
+        }
+
+        lua_pushinteger(L, count);
+        return 1;
+    }
+
+    // Upvalues are the buffer, the offset of the next field (-1 once done) and the delimiter
+    int splitNext(lua_State* L)
+    {
+        const auto* buffer = static_cast<const Data*>(lua_touserdata(L, lua_upvalueindex(1)));
+        const auto offset = lua_tointeger(L, lua_upvalueindex(2));
+        if (offset < 0) return 0;
+
+        std::size_t length;
+        const char* delimiter = lua_tolstring(L, lua_upvalueindex(3), &length);
+
+        const auto begin = static_cast<std::size_t>(offset);
+        const auto* found = search(buffer->data + begin, buffer->size - begin, delimiter, length);
+        const auto end = found ? static_cast<std::size_t>(found - buffer->data) : buffer->size;
+
+        lua_pushinteger(L, found ? static_cast<lua_Integer>(end + length) : -1);
+        lua_replace(L, lua_upvalueindex(2));
+
+        pushView(L, lua_upvalueindex(1), begin, end);
+        return 1;
+    }
+
+    // Upvalues are the buffer and the offset of the next line
+    int linesNext(lua_State* L)
+    {
+        const auto* buffer = static_cast<const Data*>(lua_touserdata(L, lua_upvalueindex(1)));
+        const auto begin = static_cast<std::size_t>(lua_tointeger(L, lua_upvalueindex(2)));
+        if (begin >= buffer->size) return 0;
+
+        const auto* found = static_cast<const char*>(std::memchr(buffer->data + begin, '\n', buffer->size - begin));
+        auto end = found ? static_cast<std::size_t>(found - buffer->data) : buffer->size;
+
+        lua_pushinteger(L, static_cast<lua_Integer>(end + 1));
+        lua_replace(L, lua_upvalueindex(2));
+
+        if (end > begin && buffer->data[end - 1] == '\r') end--;
+        pushView(L, lua_upvalueindex(1), begin, end);
+        return 1;
+    }
+
+    // buf:split(delimiter), an empty field follows a trailing delimiter
+    int bufferSplit(lua_State* L)
+    {
+        check(L, 1);
+        luaL_argcheck(L, !checkNeedle(L, 2).empty(), 2, "empty delimiter");
+
+        lua_settop(L, 2);
+        lua_pushinteger(L, 0);
+        lua_insert(L, 2);
+        lua_pushcclosure(L, splitNext, 3);
+        return 1;
+    }
+
+    // buf:lines(), without their "\n" or "\r\n"
+    int bufferLines(lua_State* L)
+    {
+        check(L, 1);
+
+        lua_settop(L, 1);
+        lua_pushinteger(L, 0);
+        lua_pushcclosure(L, linesNext, 2);
+        return 1;
+    }
+
+    void pushMetatable(lua_State* L, const char* name)
+    {
+        if (luaL_newmetatable(L, name))
+        {
+            const luaL_Reg meta[] = {
+                { "__len",      bufferLen      },
+                { "__tostring", bufferToString },
+                { nullptr, nullptr }
+            };
+            luaL_setfuncs(L, meta, 0);
+            if (name == OwnerMetatable)
+            {
+                lua_pushcfunction(L, ownerGc);
+                lua_setfield(L, -2, "__gc");
+            }
+
+            const luaL_Reg methods[] = {
+                { "sub",      bufferSub                },
+                { "tostring", bufferToString           },
+                { "u8",       bufferRead<uint8_t>      },
+                { "u16",      bufferRead<uint16_t>     },
+                { "u32",      bufferRead<uint32_t>     },
+                { "u64",      bufferRead<uint64_t>     },
+                { "i8",       bufferRead<int8_t>       },
+                { "i16",      bufferRead<int16_t>      },
+                { "i32",      bufferRead<int32_t>      },
+                { "i64",      bufferRead<int64_t>      },
+                { "f32",      bufferRead<float>        },
+                { "f64",      bufferRead<double>       },
+                { "find",     bufferFind               },
+                { "count",    bufferCount              },
+                { "split",    bufferSplit              },
+                { "lines",    bufferLines              },
+                { nullptr, nullptr }
+            };
+            luaL_newlib(L, methods);
+            lua_setfield(L, -2, "__index");
+
+            // Keeps __gc out of the reach of scripts
+            lua_pushliteral(L, "buffer");
+            lua_setfield(L, -2, "__metatable");
+        }
+    }
+
+    /* Library functions */
+
+    // buffer.open(path), nil and a message if the file can't be mapped
+    int openFile(lua_State* L)
+    {
+        const auto res = SL::Lib::Buffer::map(luaL_checkstring(L, 1));
+        if (!res)
+        {
+            lua_pushnil(L);
+            lua_pushstring(L, res.error().message().c_str());
+            return 2;
+        }
+
+        create(L, res->data, res->size, res->owner);
+        return 1;
+    }
+
+    // buffer.from(s), the string is kept alive by the buffer instead of being copied
+    int fromString(lua_State* L)
+    {
+        std::size_t size;
+        const char* data = luaL_checklstring(L, 1, &size);
+
+        create(L, data, size, nullptr);
+        lua_pushvalue(L, 1);
+        lua_setiuservalue(L, -2, 1);
+        return 1;
+    }
+}
+
+namespace SL::Lib
+{
+
+namespace
+{
+    const Reg Functions[] = {
+        { "open",  bind(openFile) },
+        { "from",  bind(fromString) },
+        { nullptr, nullptr }
+    };
+}
+
+Buffer::Buffer() : Base("buffer", Functions)
+{   }
+
+Buffer::Result<Buffer::View>
+Buffer::map(const std::filesystem::path& filename)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return { { ErrorCode::FileError, "Could not open " + filename.string() } };
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    if (size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return { View{} };
+    }
+
+    HANDLE handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!handle) return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+
+    const auto* data = static_cast<const char*>(MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        CloseHandle(handle);
+        return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+    }
+
+    auto mapping = std::make_shared<const Mapping>(data, static_cast<std::size_t>(size.QuadPart), handle);
+#else
+    const int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0) return { { ErrorCode::FileError, "Could not open " + filename.string() } };
+
+    struct stat info;
+    if (fstat(file, &info) != 0)
+    {
+        ::close(file);
+        return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+    }
+    if (info.st_size == 0)
+    {
+        ::close(file);
+        return { View{} };
+    }
+
+    void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) return { { ErrorCode::FileError, "Could not map " + filename.string() } };
+
+    // Buffers are mostly scanned front to back
+    madvise(data, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    auto mapping = std::make_shared<const Mapping>(static_cast<const char*>(data), static_cast<std::size_t>(info.st_size), data);
+#endif
+
+    return { View{ mapping->data, mapping->size, mapping } };
+}
+
+} // SL::Lib
+
+namespace SL::CompileTime
+{
+    int TypeMap<Lib::Buffer::View>::LuaType = LUA_TUSERDATA;
+
+    bool
+    TypeMap<Lib::Buffer::View>::check(State L)
+    {
+        if (const auto* owner = static_cast<const Owner*>(luaL_testudata(STATE, -1, OwnerMetatable))) return owner->owner != nullptr;
+        return test(STATE, -1) != nullptr;
+    }
+
+    void
+    TypeMap<Lib::Buffer::View>::push(State L, const Lib::Buffer::View& val)
+    {
+        create(STATE, val.data, val.size, val.owner);
+    }
+
+    Lib::Buffer::View
+    TypeMap<Lib::Buffer::View>::construct(State L)
+    {
+        const auto* buffer = static_cast<const Data*>(lua_touserdata(STATE, -1));
+
+        std::shared_ptr<const void> owner;
+        pushAnchor(STATE, -1);
+        if (auto* anchor = luaL_testudata(STATE, -1, OwnerMetatable)) owner = static_cast<const Owner*>(anchor)->owner;
+        lua_pop(STATE, 1);
+
+        return { buffer->data, buffer->size, std::move(owner) };
+    }
+
+} // SL::CompileTime
@@ -0,0 +1,240 @@
+#include <SL/Lua/Lib/Channel.hpp>
+
+#include "../Lua.cpp"
+
+#include <new>
+
+namespace
+{
+    constexpr const char* Metatable = "SL.channel";
+
+    struct Data
+    {
+        std::shared_ptr<SL::Channel> channel;
+    };
+
+    void pushMetatable(lua_State* L);
+
+    void create(lua_State* L, std::shared_ptr<SL::Channel> channel)
+    {
+        new (lua_newuserdatauv(L, sizeof(Data), 0)) Data{ std::move(channel) };
+        pushMetatable(L);
+        lua_setmetatable(L, -2);
+    }
+
+    SL::Channel& check(lua_State* L, int index)
+    {
+        auto* data = static_cast<Data*>(luaL_checkudata(L, index, Metatable));
+        if (!data->channel) luaL_error(L, "attempt to use a finalized channel");
+        return *data->channel;
+    }
+
+    std::size_t checkCapacity(lua_State* L, int index)
+    {
+        const auto capacity = luaL_optinteger(L, index, 1024);
+        luaL_argcheck(L, capacity > 0 && capacity <= (lua_Integer(1) << 30), index, "invalid capacity");
+        return static_cast<std::size_t>(capacity);
+    }
+
+    // Only drops the reference, so that running it twice is harmless
+    int channelGc(lua_State* L)
+    {
+        static_cast<Data*>(luaL_checkudata(L, 1, Metatable))->channel.reset();
+        return 0;
+    }
+
+    // ch:try_send(v)
+    int channelTrySend(lua_State* L)
+    {
+        auto& channel = check(L, 1);
+        luaL_checkany(L, 2);
+
+        bool sent;
+        {
+            SL::Channel::Message message;
+            SL::detail::__encodeMessage(reinterpret_cast<SL::State>(L), 2, message);
+            sent = channel.try_send(std::move(message));
+        }
+        lua_pushboolean(L, sent);
+        return 1;
+    }
+
+    // Pushes true and the value, or false when the channel is empty
+    int receive(lua_State* L, SL::Channel& channel, bool wait)
+    {
+        bool received;
+        {
+            SL::Channel::Message message;
+            received = wait ? channel.recv(message) : channel.try_recv(message);
+            if (received)
+            {
+                lua_pushboolean(L, 1);
+                SL::detail::__pushMessage(reinterpret_cast<SL::State>(L), message);
+            }
+        }
+        if (received) return 2;
+
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    // ch:try_recv()
+    int channelTryRecv(lua_State* L)
+    {
+        return receive(L, check(L, 1), false);
+    }
+
+    // Tried again each time the coroutine is resumed
+    int sendContinue(lua_State* L, int, lua_KContext)
+    {
+        auto& channel = check(L, 1);
+
+        int state; // 1 sent, 0 closed, -1 full
+        {
+            SL::Channel::Message message;
+            SL::detail::__encodeMessage(reinterpret_cast<SL::State>(L), 2, message);
+            if (channel.try_send(std::move(message))) state = 1;
+            else if (channel.closed()) state = 0;
+            else if (!lua_isyieldable(L)) state = channel.send(std::move(message)) ? 1 : 0;
+            else state = -1;
+        }
+
+        if (state < 0) return lua_yieldk(L, 0, 0, sendContinue);
+        lua_pushboolean(L, state);
+        return 1;
+    }
+
+    // ch:send(v)
+    int channelSend(lua_State* L)
+    {
+        check(L, 1);
+        luaL_checkany(L, 2);
+        lua_settop(L, 2);
+        return sendContinue(L, LUA_OK, 0);
+    }
+
+    int recvContinue(lua_State* L, int, lua_KContext)
+    {
+        auto& channel = check(L, 1);
+        const bool wait = !lua_isyieldable(L);
+
+        const int results = receive(L, channel, wait);
+        if (results == 2 || wait) return results;
+
+        // Closed after the attempt, the values sent before the close are still taken
+        lua_pop(L, 1);
+        if (channel.closed()) return receive(L, channel, false);
+        return lua_yieldk(L, 0, 0, recvContinue);
+    }
+
+    // ch:recv()
+    int channelRecv(lua_State* L)
+    {
+        check(L, 1);
+        lua_settop(L, 1);
+        return recvContinue(L, LUA_OK, 0);
+    }
+
+    int channelClose(lua_State* L)
+    {
+        check(L, 1).close();
+        return 0;
+    }
+
+    int channelClosed(lua_State* L)
+    {
+        lua_pushboolean(L, check(L, 1).closed());
+        return 1;
+    }
+
+    int channelCapacity(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(check(L, 1).capacity()));
+        return 1;
+    }
+
+    void pushMetatable(lua_State* L)
+    {
+        if (luaL_newmetatable(L, Metatable))
+        {
+            lua_pushcfunction(L, channelGc);
+            lua_setfield(L, -2, "__gc");
+
+            const luaL_Reg methods[] = {
+                { "try_send", channelTrySend  },
+                { "try_recv", channelTryRecv  },
+                { "send",     channelSend     },
+                { "recv",     channelRecv     },
+                { "close",    channelClose    },
+                { "closed",   channelClosed   },
+                { "capacity", channelCapacity },
+                { nullptr, nullptr }
+            };
+            luaL_newlib(L, methods);
+            lua_setfield(L, -2, "__index");
+
+            // Keeps __gc out of the reach of scripts
+            lua_pushliteral(L, "channel");
+            lua_setfield(L, -2, "__metatable");
+        }
+    }
+
+    /* Library functions */
+
+    // channel.open(name [, capacity])
+    int channelOpen(lua_State* L)
+    {
+        const char* name = luaL_checkstring(L, 1);
+        create(L, SL::Channel::open(name, checkCapacity(L, 2)));
+        return 1;
+    }
+
+    // channel.new([capacity])
+    int channelNew(lua_State* L)
+    {
+        create(L, std::make_shared<SL::Channel>(checkCapacity(L, 1)));
+        return 1;
+    }
+}
+
+namespace SL::Lib
+{
+
+namespace
+{
+    const Reg Functions[] = {
+        { "open",  bind(channelOpen) },
+        { "new",   bind(channelNew) },
+        { nullptr, nullptr }
+    };
+}
+
+Channel::Channel() : Base("channel", Functions)
+{   }
+
+} // SL::Lib
+
+namespace SL::CompileTime
+{
+    int TypeMap<std::shared_ptr<SL::Channel>>::LuaType = LUA_TUSERDATA;
+
+    bool
+    TypeMap<std::shared_ptr<SL::Channel>>::check(State L)
+    {
+        const auto* data = static_cast<const Data*>(luaL_testudata(STATE, -1, Metatable));
+        return data && data->channel;
+    }
+
+    void
+    TypeMap<std::shared_ptr<SL::Channel>>::push(State L, const std::shared_ptr<SL::Channel>& val)
+    {
+        create(STATE, val);
+    }
+
+    std::shared_ptr<SL::Channel>
+    TypeMap<std::shared_ptr<SL::Channel>>::construct(State L)
+    {
+        return static_cast<const Data*>(lua_touserdata(STATE, -1))->channel;
+    }
+
+} // SL::CompileTime
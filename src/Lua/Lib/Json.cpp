@@ -0,0 +1,284 @@
+#include <SL/Lua/Lib/Json.hpp>
+
+#include "../Lua.cpp"
+#include "../Json.hpp"
+
+namespace
+{
+    namespace json = SL::detail::json;
+
+    // Builds the values on the stack. The elements of a container are pushed above it and
+    // moved into its table in batches, so a small container gets an exactly presized table
+    struct Builder
+    {
+        static constexpr int Batch = 64;
+
+        struct Frame
+        {
+            int         base;    // Stack index of the container's table
+            int         pending; // Elements (or key and value pairs) above the table
+            lua_Integer count;   // Elements already in the table
+            bool        created;
+        };
+
+        lua_State* L;
+
+        bool null()                   { lua_pushlightuserdata(L, nullptr); return true; }
+        bool boolean(bool value)      { lua_pushboolean(L, value); return true; }
+        bool integer(int64_t value)   { lua_pushinteger(L, static_cast<lua_Integer>(value)); return true; }
+        bool number(double value)     { lua_pushnumber(L, value); return true; }
+        bool string(std::string_view s) { lua_pushlstring(L, s.data(), s.size()); return true; }
+        bool key(std::string_view s)    { return string(s); }
+
+        Frame begin()
+        {
+            luaL_checkstack(L, 2 * Batch + 4, "json nested too deep");
+            return { lua_gettop(L) + 1, 0, 0, false };
+        }
+
+        void create(Frame& frame, bool array, int size)
+        {
+            lua_createtable(L, array ? size : 0, array ? 0 : size);
+            lua_insert(L, frame.base);
+            frame.created = true;
+        }
+
+        Frame beginArray() { return begin(); }
+
+        bool element(Frame& frame)
+        {
+            if (++frame.pending == Batch) flushArray(frame, Batch * 4);
+            return true;
+        }
+
+        bool endArray(Frame& frame)
+        {
+            flushArray(frame, frame.pending);
+            return true;
+        }
+
+        void flushArray(Frame& frame, int size)
+        {
+            if (!frame.created) create(frame, true, size);
+            for (int i = frame.pending; i > 0; i--) lua_rawseti(L, frame.base, frame.count + i);
+
+            frame.count += frame.pending;
+            frame.pending = 0;
+        }
+
+        Frame beginObject() { return begin(); }
+
+        bool member(Frame& frame)
+        {
+            if (++frame.pending == Batch) flushObject(frame, Batch * 4);
+            return true;
+        }
+
+        bool endObject(Frame& frame)
+        {
+            flushObject(frame, frame.pending);
+            return true;
+        }
+
+        // Set in document order, so the last of repeated keys wins
+        void flushObject(Frame& frame, int size)
+        {
+            if (!frame.created) create(frame, false, size);
+            for (int i = 0; i < frame.pending; i++)
+            {
+                lua_pushvalue(L, frame.base + 1 + 2 * i);
+                lua_pushvalue(L, frame.base + 2 + 2 * i);
+                lua_rawset(L, frame.base);
+            }
+
+            lua_settop(L, frame.base);
+            frame.pending = 0;
+        }
+    };
+
+    // Pushes the error message and returns false when the value can't be encoded
+    bool encode(lua_State* L, int index, std::string& out, int depth);
+
+    // Keys exactly 1 to n, where n is the length of the table
+    bool isArray(lua_State* L, int index)
+    {
+        const auto size = lua_rawlen(L, index);
+        if (size == 0) return false;
+
+        lua_Unsigned keys = 0;
+        lua_pushnil(L);
+        while (lua_next(L, index))
+        {
+            lua_pop(L, 1);
+            const auto key = lua_isinteger(L, -1) ? lua_tointeger(L, -1) : 0;
+            if (key < 1 || static_cast<lua_Unsigned>(key) > size || ++keys > size)
+            {
+                lua_pop(L, 1);
+                return false;
+            }
+        }
+        return keys == size;
+    }
+
+    bool encodeTable(lua_State* L, int index, std::string& out, int depth)
+    {
+        if (depth > json::MaxDepth || !lua_checkstack(L, 4))
+        {
+            lua_pushstring(L, "json can't encode tables nested this deep (or holding themselves)");
+            return false;
+        }
+
+        if (isArray(L, index))
+        {
+            const auto size = static_cast<lua_Integer>(lua_rawlen(L, index));
+            out += '[';
+            for (lua_Integer i = 1; i <= size; i++)
+            {
+                if (i > 1) out += ',';
+                lua_rawgeti(L, index, i);
+                if (!encode(L, -1, out, depth + 1)) return false;
+                lua_pop(L, 1);
+            }
+            out += ']';
+            return true;
+        }
+
+        out += '{';
+        bool first = true;
+        lua_pushnil(L);
+        while (lua_next(L, index))
+        {
+            if (!first) out += ',';
+            first = false;
+
+            if (lua_type(L, -2) == LUA_TSTRING)
+            {
+                std::size_t size;
+                const char* key = lua_tolstring(L, -2, &size);
+                json::writeString(out, std::string_view(key, size));
+            }
+            else if (lua_isinteger(L, -2))
+            {
+                out += '"';
+                json::writeInteger(out, lua_tointeger(L, -2));
+                out += '"';
+            }
+            else
+            {
+                lua_pushfstring(L, "json can't encode a key of type %s", luaL_typename(L, -2));
+                return false;
+            }
+
+            out += ':';
+            if (!encode(L, -1, out, depth + 1)) return false;
+            lua_pop(L, 1);
+        }
+        out += '}';
+        return true;
+    }
+
+    bool encode(lua_State* L, int index, std::string& out, int depth)
+    {
+        index = lua_absindex(L, index);
+        switch (lua_type(L, index))
+        {
+        case LUA_TNIL:
+            out += "null";
+            return true;
+        case LUA_TBOOLEAN:
+            out += lua_toboolean(L, index) ? "true" : "false";
+            return true;
+        case LUA_TNUMBER:
+            if (lua_isinteger(L, index))
+            {
+                json::writeInteger(out, lua_tointeger(L, index));
+                return true;
+            }
+            if (json::writeNumber(out, lua_tonumber(L, index))) return true;
+
+            lua_pushstring(L, "json can't encode NaN or infinity");
+            return false;
+        case LUA_TSTRING:
+        {
+            std::size_t size;
+            const char* s = lua_tolstring(L, index, &size);
+            json::writeString(out, std::string_view(s, size));
+            return true;
+        }
+        case LUA_TTABLE:
+            return encodeTable(L, index, out, depth);
+        case LUA_TLIGHTUSERDATA:
+            if (!lua_touserdata(L, index))
+            {
+                out += "null";
+                return true;
+            }
+            break;
+        }
+
+        lua_pushfstring(L, "json can't encode a %s", luaL_typename(L, index));
+        return false;
+    }
+
+    /* Library functions */
+
+    // json.decode(s)
+    int decode(lua_State* L)
+    {
+        std::size_t size;
+        const char* document = luaL_checklstring(L, 1, &size);
+        lua_settop(L, 1);
+
+        bool good;
+        {
+            json::Parser parser(std::string_view(document, size));
+            Builder builder{ L };
+            good = parser.parse(builder);
+            if (!good)
+            {
+                lua_settop(L, 1);
+                lua_pushfstring(L, "invalid json: %s", parser.error.c_str());
+            }
+        }
+        return good ? 1 : lua_error(L);
+    }
+
+    // json.encode(value)
+    int encodeValue(lua_State* L)
+    {
+        luaL_checkany(L, 1);
+        lua_settop(L, 1);
+
+        // Written into the same buffer every time, it only grows to the largest document
+        thread_local std::string out;
+        out.clear();
+
+        if (!encode(L, 1, out, 0)) return lua_error(L);
+        lua_pushlstring(L, out.data(), out.size());
+        return 1;
+    }
+}
+
+namespace SL::Lib
+{
+
+namespace
+{
+    const Reg Functions[] = {
+        { "decode", bind(decode) },
+        { "encode", bind(encodeValue) },
+        { nullptr,  nullptr }
+    };
+
+}
+
+Json::Json() : Base("json", Functions)
+{   }
+
+void Json::setFields(State L) const
+{
+    lua_pushlightuserdata(STATE, nullptr);
+    lua_setfield(STATE, -2, "null");
+}
+
+} // SL::Lib
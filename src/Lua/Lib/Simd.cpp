@@ -0,0 +1,473 @@
+#include <SL/Lua/Lib/Simd.hpp>
+
+#include "SimdKernels.hpp"
+#include "../Lua.cpp"
+
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SL_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+
+#if defined(SL_SIMD_AVX2) && defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+namespace
+{
+#ifdef SL_SIMD_SSE2
+    struct Sse2F32
+    {
+        using T = float;
+        using R = __m128;
+        static constexpr std::size_t W = 4;
+
+        static R load(const T* p)           { return _mm_loadu_ps(p); }
+        static void store(T* p, R v)        { _mm_storeu_ps(p, v); }
+        static R set1(T v)                  { return _mm_set1_ps(v); }
+        static R add(R a, R b)              { return _mm_add_ps(a, b); }
+        static R sub(R a, R b)              { return _mm_sub_ps(a, b); }
+        static R mul(R a, R b)              { return _mm_mul_ps(a, b); }
+        static R fma(R a, R b, R c)         { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static R min(R a, R b)              { return _mm_min_ps(a, b); }
+        static R max(R a, R b)              { return _mm_max_ps(a, b); }
+
+        template<typename Op>
+        static T reduce(R v, Op op)
+        {
+            v = op(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(op(v, _mm_shuffle_ps(v, v, 0x55)));
+        }
+
+        static T hsum(R v) { return reduce(v, [](R a, R b) { return _mm_add_ps(a, b); }); }
+        static T hmin(R v) { return reduce(v, [](R a, R b) { return _mm_min_ps(a, b); }); }
+        static T hmax(R v) { return reduce(v, [](R a, R b) { return _mm_max_ps(a, b); }); }
+    };
+
+    struct Sse2F64
+    {
+        using T = double;
+        using R = __m128d;
+        static constexpr std::size_t W = 2;
+
+        static R load(const T* p)           { return _mm_loadu_pd(p); }
+        static void store(T* p, R v)        { _mm_storeu_pd(p, v); }
+        static R set1(T v)                  { return _mm_set1_pd(v); }
+        static R add(R a, R b)              { return _mm_add_pd(a, b); }
+        static R sub(R a, R b)              { return _mm_sub_pd(a, b); }
+        static R mul(R a, R b)              { return _mm_mul_pd(a, b); }
+        static R fma(R a, R b, R c)         { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+        static R min(R a, R b)              { return _mm_min_pd(a, b); }
+        static R max(R a, R b)              { return _mm_max_pd(a, b); }
+
+        template<typename Op>
+        static T reduce(R v, Op op) { return _mm_cvtsd_f64(op(v, _mm_unpackhi_pd(v, v))); }
+
+        static T hsum(R v) { return reduce(v, [](R a, R b) { return _mm_add_pd(a, b); }); }
+        static T hmin(R v) { return reduce(v, [](R a, R b) { return _mm_min_pd(a, b); }); }
+        static T hmax(R v) { return reduce(v, [](R a, R b) { return _mm_max_pd(a, b); }); }
+    };
+#endif
+
+#ifdef SL_SIMD_AVX2
+    bool hasAvx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        __cpuid(info, 1);
+        const bool fma     = info[2] & (1 << 12);
+        const bool osxsave = info[2] & (1 << 27);
+        if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return info[1] & (1 << 5);
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+#endif
+
+    const SL::Lib::detail::SimdKernelSet& kernels()
+    {
+        static const auto& selected = []() -> const SL::Lib::detail::SimdKernelSet&
+        {
+#ifdef SL_SIMD_AVX2
+            if (hasAvx2()) return SL::Lib::detail::simdAvx2();
+#endif
+#ifdef SL_SIMD_SSE2
+            static const SL::Lib::detail::SimdKernelSet sse2 = { "sse2", makeKernels<Sse2F32>(), makeKernels<Sse2F64>() };
+            return sse2;
+#else
+            static const SL::Lib::detail::SimdKernelSet scalar = { "scalar", makeKernels<Scalar<float>>(), makeKernels<Scalar<double>>() };
+            return scalar;
+#endif
+        }();
+        return selected;
+    }
+
+    /* Buffers */
+
+    constexpr const char* Metatable = "SL.simd.buffer";
+
+    enum class Type : uint32_t { F32, F64 };
+
+    // Header of the userdata, the elements follow it directly
+    struct Buffer
+    {
+        Type        type;
+        std::size_t size;
+
+        void* data() { return reinterpret_cast<char*>(this) + sizeof(Buffer); }
+
+        template<typename T>
+        T* as() { return static_cast<T*>(data()); }
+
+        double get(std::size_t i)
+        {
+            return type == Type::F32 ? static_cast<double>(as<float>()[i]) : as<double>()[i];
+        }
+
+        void set(std::size_t i, double v)
+        {
+            if (type == Type::F32) as<float>()[i] = static_cast<float>(v);
+            else as<double>()[i] = v;
+        }
+    };
+
+    Buffer* check(lua_State* L, int index)
+    {
+        return static_cast<Buffer*>(luaL_checkudata(L, index, Metatable));
+    }
+
+    Type checkType(lua_State* L, int index)
+    {
+        static const char* const names[] = { "f32", "f64", nullptr };
+        return static_cast<Type>(luaL_checkoption(L, index, "f64", names));
+    }
+
+    std::size_t checkIndex(lua_State* L, const Buffer* buffer, int index)
+    {
+        const auto i = luaL_checkinteger(L, index);
+        luaL_argcheck(L, i >= 1 && static_cast<lua_Unsigned>(i) <= buffer->size, index, "index out of range");
+        return static_cast<std::size_t>(i - 1);
+    }
+
+    // Checks that the buffer has the type and size of the first buffer argument
+    Buffer* checkLike(lua_State* L, int index, const Buffer* like)
+    {
+        auto* buffer = check(L, index);
+        luaL_argcheck(L, buffer->type == like->type, index, "buffer types differ");
+        luaL_argcheck(L, buffer->size == like->size, index, "buffer sizes differ");
+        return buffer;
+    }
+
+    Buffer* create(lua_State* L, Type type, std::size_t size)
+    {
+        const auto element = type == Type::F32 ? sizeof(float) : sizeof(double);
+        if (size > (std::numeric_limits<std::size_t>::max() - sizeof(Buffer)) / element) luaL_error(L, "buffer too large");
+
+        auto* buffer = static_cast<Buffer*>(lua_newuserdatauv(L, sizeof(Buffer) + element * size, 0));
+        buffer->type = type;
+        buffer->size = size;
+        std::memset(buffer->data(), 0, element * size);
+        luaL_setmetatable(L, Metatable);
+        return buffer;
+    }
+
+    // Calls f with the kernels matching the buffer's element type
+    template<typename F>
+    auto withKernels(const Buffer* buffer, F&& f)
+    {
+        if (buffer->type == Type::F32) return f(kernels().f32, static_cast<float*>(nullptr));
+        return f(kernels().f64, static_cast<double*>(nullptr));
+    }
+
+    int bufferIndex(lua_State* L)
+    {
+        auto* buffer = check(L, 1);
+        if (lua_type(L, 2) == LUA_TNUMBER)
+        {
+            const auto i = lua_tointeger(L, 2);
+            if (i < 1 || static_cast<lua_Unsigned>(i) > buffer->size) return 0;
+            lua_pushnumber(L, buffer->get(static_cast<std::size_t>(i - 1)));
+            return 1;
+        }
+
+        lua_getmetatable(L, 1);
+        lua_pushvalue(L, 2);
+        lua_rawget(L, -2);
+        return 1;
+    }
+
+    int bufferNewIndex(lua_State* L)
+    {
+        auto* buffer = check(L, 1);
+        buffer->set(checkIndex(L, buffer, 2), luaL_checknumber(L, 3));
+        return 0;
+    }
+
+    int bufferLen(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(check(L, 1)->size));
+        return 1;
+    }
+
+    int bufferType(lua_State* L)
+    {
+        lua_pushstring(L, check(L, 1)->type == Type::F32 ? "f32" : "f64");
+        return 1;
+    }
+
+    int bufferToTable(lua_State* L)
+    {
+        auto* buffer = check(L, 1);
+        lua_createtable(L, static_cast<int>(buffer->size), 0);
+        for (std::size_t i = 0; i < buffer->size; i++)
+        {
+            lua_pushnumber(L, buffer->get(i));
+            lua_rawseti(L, -2, static_cast<lua_Integer>(i + 1));
+        }
+        return 1;
+    }
+
+    void pushMetatable(lua_State* L)
+    {
+        if (luaL_newmetatable(L, Metatable))
+        {
+            const luaL_Reg methods[] = {
+                { "__index",    bufferIndex    },
+                { "__newindex", bufferNewIndex },
+                { "__len",      bufferLen      },
+                { "type",       bufferType     },
+                { "totable",    bufferToTable  },
+                { nullptr, nullptr }
+            };
+            luaL_setfuncs(L, methods, 0);
+        }
+    }
+
+    /* Library functions */
+
+    // simd.new(n [, type])
+    int newBuffer(lua_State* L)
+    {
+        const auto n = luaL_checkinteger(L, 1);
+        luaL_argcheck(L, n >= 0, 1, "size must be non-negative");
+        const auto type = checkType(L, 2);
+
+        pushMetatable(L);
+        lua_pop(L, 1);
+        create(L, type, static_cast<std::size_t>(n));
+        return 1;
+    }
+
+    // simd.from(table [, type])
+    int from(lua_State* L)
+    {
+        luaL_checktype(L, 1, LUA_TTABLE);
+        const auto type = checkType(L, 2);
+        const auto n = static_cast<std::size_t>(lua_rawlen(L, 1));
+
+        pushMetatable(L);
+        lua_pop(L, 1);
+        auto* buffer = create(L, type, n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            lua_rawgeti(L, 1, static_cast<lua_Integer>(i + 1));
+            int isnum = 0;
+            const auto v = lua_tonumberx(L, -1, &isnum);
+            if (!isnum) return luaL_error(L, "element %d is not a number", static_cast<int>(i + 1));
+            buffer->set(i, v);
+            lua_pop(L, 1);
+        }
+        return 1;
+    }
+
+    // simd.add(dst, a, b) and simd.mul(dst, a, b)
+    template<bool Add>
+    int binary(lua_State* L)
+    {
+        auto* dst = check(L, 1);
+        auto* a = checkLike(L, 2, dst);
+        auto* b = checkLike(L, 3, dst);
+        withKernels(dst, [&](const auto& k, auto* t)
+        {
+            using T = std::remove_pointer_t<decltype(t)>;
+            (Add ? k.add : k.mul)(dst->as<T>(), a->as<T>(), b->as<T>(), dst->size);
+        });
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // simd.fma(dst, a, b, c)
+    int multiplyAdd(lua_State* L)
+    {
+        auto* dst = check(L, 1);
+        auto* a = checkLike(L, 2, dst);
+        auto* b = checkLike(L, 3, dst);
+        auto* c = checkLike(L, 4, dst);
+        withKernels(dst, [&](const auto& k, auto* t)
+        {
+            using T = std::remove_pointer_t<decltype(t)>;
+            k.fma(dst->as<T>(), a->as<T>(), b->as<T>(), c->as<T>(), dst->size);
+        });
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // simd.axpy(alpha, x, y)
+    int axpy(lua_State* L)
+    {
+        const auto alpha = luaL_checknumber(L, 1);
+        auto* y = check(L, 3);
+        auto* x = checkLike(L, 2, y);
+        withKernels(y, [&](const auto& k, auto* t)
+        {
+            using T = std::remove_pointer_t<decltype(t)>;
+            k.axpy(static_cast<T>(alpha), x->as<T>(), y->as<T>(), y->size);
+        });
+        lua_settop(L, 3);
+        return 1;
+    }
+
+    // simd.dot(a, b)
+    int dot(lua_State* L)
+    {
+        auto* a = check(L, 1);
+        auto* b = checkLike(L, 2, a);
+        const double r = withKernels(a, [&](const auto& k, auto* t) -> double
+        {
+            using T = std::remove_pointer_t<decltype(t)>;
+            return k.dot(a->as<T>(), b->as<T>(), a->size);
+        });
+        lua_pushnumber(L, r);
+        return 1;
+    }
+
+    enum class Reduce { Sum, Min, Max };
+
+    // simd.sum(a), simd.min(a) and simd.max(a), min and max of an empty buffer are nil
+    template<Reduce Op>
+    int reduce(lua_State* L)
+    {
+        auto* a = check(L, 1);
+        if (Op != Reduce::Sum && !a->size) return 0;
+
+        const double r = withKernels(a, [&](const auto& k, auto* t) -> double
+        {
+            using T = std::remove_pointer_t<decltype(t)>;
+            switch (Op)
+            {
+            case Reduce::Min: return k.min(a->as<T>(), a->size);
+            case Reduce::Max: return k.max(a->as<T>(), a->size);
+            default:          return k.sum(a->as<T>(), a->size);
+            }
+        });
+        lua_pushnumber(L, r);
+        return 1;
+    }
+
+    // simd.clamp(dst, a, lo, hi)
+    int clamp(lua_State* L)
+    {
+        auto* dst = check(L, 1);
+        auto* a = checkLike(L, 2, dst);
+        const auto lo = luaL_checknumber(L, 3);
+        const auto hi = luaL_checknumber(L, 4);
+        withKernels(dst, [&](const auto& k, auto* t)
+        {
+            using T = std::remove_pointer_t<decltype(t)>;
+            k.clamp(dst->as<T>(), a->as<T>(), static_cast<T>(lo), static_cast<T>(hi), dst->size);
+        });
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // simd.lerp(dst, a, b, t)
+    int lerp(lua_State* L)
+    {
+        auto* dst = check(L, 1);
+        auto* a = checkLike(L, 2, dst);
+        auto* b = checkLike(L, 3, dst);
+        const auto factor = luaL_checknumber(L, 4);
+        withKernels(dst, [&](const auto& k, auto* t)
+        {
+            using T = std::remove_pointer_t<decltype(t)>;
+            k.lerp(dst->as<T>(), a->as<T>(), b->as<T>(), static_cast<T>(factor), dst->size);
+        });
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // simd.gather(dst, src, idx) and simd.scatter(dst, src, idx), indices are 1-based
+    template<bool Gather>
+    int permute(lua_State* L)
+    {
+        auto* dst = check(L, 1);
+        auto* src = check(L, 2);
+        auto* idx = check(L, 3);
+        luaL_argcheck(L, src->type == dst->type, 2, "buffer types differ");
+        luaL_argcheck(L, idx->size == (Gather ? dst->size : src->size), 3, "index count differs from buffer size");
+
+        auto* target = Gather ? src : dst;
+        for (std::size_t i = 0; i < idx->size; i++)
+        {
+            const auto j = idx->get(i);
+            if (!(j >= 1 && j <= static_cast<double>(target->size)))
+                return luaL_error(L, "index %f at position %d is out of range", j, static_cast<int>(i + 1));
+
+            const auto k = static_cast<std::size_t>(j) - 1;
+            if (Gather) dst->set(i, src->get(k));
+            else dst->set(k, src->get(i));
+        }
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    int isaName(lua_State* L)
+    {
+        lua_pushstring(L, kernels().name);
+        return 1;
+    }
+}
+
+namespace SL::Lib
+{
+
+namespace
+{
+    const Reg Functions[] = {
+        { "new",     bind(newBuffer) },
+        { "from",    bind(from) },
+        { "add",     bind(binary<true>) },
+        { "mul",     bind(binary<false>) },
+        { "fma",     bind(multiplyAdd) },
+        { "axpy",    bind(axpy) },
+        { "dot",     bind(dot) },
+        { "sum",     bind(reduce<Reduce::Sum>) },
+        { "min",     bind(reduce<Reduce::Min>) },
+        { "max",     bind(reduce<Reduce::Max>) },
+        { "clamp",   bind(clamp) },
+        { "lerp",    bind(lerp) },
+        { "gather",  bind(permute<true>) },
+        { "scatter", bind(permute<false>) },
+        { "isa",     bind(isaName) },
+        { nullptr,   nullptr }
+    };
+}
+
+Simd::Simd() : Base("simd", Functions)
+{   }
+
+const char* Simd::isa()
+{
+    return kernels().name;
+}
+
+} // SL::Lib
@@ -0,0 +1,71 @@
+// Compiled with AVX2 and FMA enabled, only called after the CPU was checked for both
+#include "SimdKernels.hpp"
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2F32
+    {
+        using T = float;
+        using R = __m256;
+        static constexpr std::size_t W = 8;
+
+        static R load(const T* p)           { return _mm256_loadu_ps(p); }
+        static void store(T* p, R v)        { _mm256_storeu_ps(p, v); }
+        static R set1(T v)                  { return _mm256_set1_ps(v); }
+        static R add(R a, R b)              { return _mm256_add_ps(a, b); }
+        static R sub(R a, R b)              { return _mm256_sub_ps(a, b); }
+        static R mul(R a, R b)              { return _mm256_mul_ps(a, b); }
+        static R fma(R a, R b, R c)         { return _mm256_fmadd_ps(a, b, c); }
+        static R min(R a, R b)              { return _mm256_min_ps(a, b); }
+        static R max(R a, R b)              { return _mm256_max_ps(a, b); }
+
+        static __m128 half(R v, __m128 (*op)(__m128, __m128))
+        {
+            auto r = op(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            r = op(r, _mm_movehl_ps(r, r));
+            return op(r, _mm_shuffle_ps(r, r, 0x55));
+        }
+
+        static T hsum(R v) { return _mm_cvtss_f32(half(v, [](__m128 a, __m128 b) { return _mm_add_ps(a, b); })); }
+        static T hmin(R v) { return _mm_cvtss_f32(half(v, [](__m128 a, __m128 b) { return _mm_min_ps(a, b); })); }
+        static T hmax(R v) { return _mm_cvtss_f32(half(v, [](__m128 a, __m128 b) { return _mm_max_ps(a, b); })); }
+    };
+
+    struct Avx2F64
+    {
+        using T = double;
+        using R = __m256d;
+        static constexpr std::size_t W = 4;
+
+        static R load(const T* p)           { return _mm256_loadu_pd(p); }
+        static void store(T* p, R v)        { _mm256_storeu_pd(p, v); }
+        static R set1(T v)                  { return _mm256_set1_pd(v); }
+        static R add(R a, R b)              { return _mm256_add_pd(a, b); }
+        static R sub(R a, R b)              { return _mm256_sub_pd(a, b); }
+        static R mul(R a, R b)              { return _mm256_mul_pd(a, b); }
+        static R fma(R a, R b, R c)         { return _mm256_fmadd_pd(a, b, c); }
+        static R min(R a, R b)              { return _mm256_min_pd(a, b); }
+        static R max(R a, R b)              { return _mm256_max_pd(a, b); }
+
+        static __m128d half(R v, __m128d (*op)(__m128d, __m128d))
+        {
+            const auto r = op(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+            return op(r, _mm_unpackhi_pd(r, r));
+        }
+
+        static T hsum(R v) { return _mm_cvtsd_f64(half(v, [](__m128d a, __m128d b) { return _mm_add_pd(a, b); })); }
+        static T hmin(R v) { return _mm_cvtsd_f64(half(v, [](__m128d a, __m128d b) { return _mm_min_pd(a, b); })); }
+        static T hmax(R v) { return _mm_cvtsd_f64(half(v, [](__m128d a, __m128d b) { return _mm_max_pd(a, b); })); }
+    };
+}
+
+namespace SL::Lib::detail
+{
+    const SimdKernelSet& simdAvx2()
+    {
+        static const SimdKernelSet kernels = { "avx2", makeKernels<Avx2F32>(), makeKernels<Avx2F64>() };
+        return kernels;
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+
+// Shared by the translation units that build the kernels for one instruction set each.
+// The templates live in an anonymous namespace so that copies compiled with different
+// target flags can never be merged by the linker. For the same reason the scalar tails use
+// Scalar::min and Scalar::max rather than std::min and std::max, which would be shared.
+
+namespace SL::Lib::detail
+{
+    template<typename T>
+    struct SimdKernels
+    {
+        void (*add)  (T* dst, const T* a, const T* b, std::size_t n);
+        void (*mul)  (T* dst, const T* a, const T* b, std::size_t n);
+        void (*fma)  (T* dst, const T* a, const T* b, const T* c, std::size_t n);
+        void (*axpy) (T alpha, const T* x, T* y, std::size_t n);
+        T    (*dot)  (const T* a, const T* b, std::size_t n);
+        T    (*sum)  (const T* a, std::size_t n);
+        T    (*min)  (const T* a, std::size_t n);
+        T    (*max)  (const T* a, std::size_t n);
+        void (*clamp)(T* dst, const T* a, T lo, T hi, std::size_t n);
+        void (*lerp) (T* dst, const T* a, const T* b, T t, std::size_t n);
+    };
+
+    struct SimdKernelSet
+    {
+        const char* name;
+        SimdKernels<float>  f32;
+        SimdKernels<double> f64;
+    };
+
+    const SimdKernelSet& simdAvx2();
+
+} // SL::Lib::detail
+
+namespace
+{
+    /**
+     * Each instruction set provides a traits struct V with
+     *  - `T` the element type, `R` the register type and `W` the lane count
+     *  - `load`, `store`, `set1`, `add`, `sub`, `mul`, `fma`, `min`, `max`
+     *  - `hsum`, `hmin`, `hmax` horizontal reductions of a register
+     */
+
+    template<typename E>
+    struct Scalar
+    {
+        using T = E;
+        using R = E;
+        static constexpr std::size_t W = 1;
+
+        static R load(const T* p)           { return *p; }
+        static void store(T* p, R v)        { *p = v; }
+        static R set1(T v)                  { return v; }
+        static R add(R a, R b)              { return a + b; }
+        static R sub(R a, R b)              { return a - b; }
+        static R mul(R a, R b)              { return a * b; }
+        static R fma(R a, R b, R c)         { return a * b + c; }
+        static R min(R a, R b)              { return b < a ? b : a; }
+        static R max(R a, R b)              { return a < b ? b : a; }
+        static T hsum(R v)                  { return v; }
+        static T hmin(R v)                  { return v; }
+        static T hmax(R v)                  { return v; }
+    };
+
+    template<typename V>
+    void kernelAdd(typename V::T* dst, const typename V::T* a, const typename V::T* b, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W) V::store(dst + i, V::add(V::load(a + i), V::load(b + i)));
+        for (; i < n; i++) dst[i] = a[i] + b[i];
+    }
+
+    template<typename V>
+    void kernelMul(typename V::T* dst, const typename V::T* a, const typename V::T* b, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W) V::store(dst + i, V::mul(V::load(a + i), V::load(b + i)));
+        for (; i < n; i++) dst[i] = a[i] * b[i];
+    }
+
+    template<typename V>
+    void kernelFma(typename V::T* dst, const typename V::T* a, const typename V::T* b, const typename V::T* c, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W) V::store(dst + i, V::fma(V::load(a + i), V::load(b + i), V::load(c + i)));
+        for (; i < n; i++) dst[i] = a[i] * b[i] + c[i];
+    }
+
+    template<typename V>
+    void kernelAxpy(typename V::T alpha, const typename V::T* x, typename V::T* y, std::size_t n)
+    {
+        const auto va = V::set1(alpha);
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W) V::store(y + i, V::fma(va, V::load(x + i), V::load(y + i)));
+        for (; i < n; i++) y[i] = alpha * x[i] + y[i];
+    }
+
+    template<typename V>
+    typename V::T kernelDot(const typename V::T* a, const typename V::T* b, std::size_t n)
+    {
+        auto acc = V::set1(0);
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W) acc = V::fma(V::load(a + i), V::load(b + i), acc);
+        auto r = V::hsum(acc);
+        for (; i < n; i++) r += a[i] * b[i];
+        return r;
+    }
+
+    template<typename V>
+    typename V::T kernelSum(const typename V::T* a, std::size_t n)
+    {
+        auto acc = V::set1(0);
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W) acc = V::add(acc, V::load(a + i));
+        auto r = V::hsum(acc);
+        for (; i < n; i++) r += a[i];
+        return r;
+    }
+
+    // Both reductions expect n > 0
+    template<typename V>
+    typename V::T kernelMin(const typename V::T* a, std::size_t n)
+    {
+        auto r = a[0];
+        std::size_t i = 0;
+        if (n >= V::W)
+        {
+            auto acc = V::load(a);
+            for (i = V::W; i + V::W <= n; i += V::W) acc = V::min(acc, V::load(a + i));
+            r = V::hmin(acc);
+        }
+        for (; i < n; i++) r = Scalar<typename V::T>::min(r, a[i]);
+        return r;
+    }
+
+    template<typename V>
+    typename V::T kernelMax(const typename V::T* a, std::size_t n)
+    {
+        auto r = a[0];
+        std::size_t i = 0;
+        if (n >= V::W)
+        {
+            auto acc = V::load(a);
+            for (i = V::W; i + V::W <= n; i += V::W) acc = V::max(acc, V::load(a + i));
+            r = V::hmax(acc);
+        }
+        for (; i < n; i++) r = Scalar<typename V::T>::max(r, a[i]);
+        return r;
+    }
+
+    template<typename V>
+    void kernelClamp(typename V::T* dst, const typename V::T* a, typename V::T lo, typename V::T hi, std::size_t n)
+    {
+        using S = Scalar<typename V::T>;
+        const auto vlo = V::set1(lo), vhi = V::set1(hi);
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W) V::store(dst + i, V::min(V::max(V::load(a + i), vlo), vhi));
+        for (; i < n; i++) dst[i] = S::min(S::max(a[i], lo), hi);
+    }
+
+    template<typename V>
+    void kernelLerp(typename V::T* dst, const typename V::T* a, const typename V::T* b, typename V::T t, std::size_t n)
+    {
+        const auto vt = V::set1(t);
+        std::size_t i = 0;
+        for (; i + V::W <= n; i += V::W)
+        {
+            const auto va = V::load(a + i);
+            V::store(dst + i, V::fma(V::sub(V::load(b + i), va), vt, va));
+        }
+        for (; i < n; i++) dst[i] = a[i] + (b[i] - a[i]) * t;
+    }
+
+    template<typename V>
+    SL::Lib::detail::SimdKernels<typename V::T> makeKernels()
+    {
+        return {
+            kernelAdd<V>, kernelMul<V>, kernelFma<V>, kernelAxpy<V>,
+            kernelDot<V>, kernelSum<V>, kernelMin<V>, kernelMax<V>,
+            kernelClamp<V>, kernelLerp<V>
+        };
+    }
+
+} // anonymous
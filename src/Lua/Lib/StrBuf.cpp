@@ -0,0 +1,370 @@
+#include <SL/Lua/Lib/StrBuf.hpp>
+
+#include "../Lua.cpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <new>
+
+namespace
+{
+    constexpr const char* Metatable = "SL.strbuf";
+
+    // Shared so that C++ can keep reading a buffer Lua has collected
+    struct Data
+    {
+        std::shared_ptr<std::string> text;
+    };
+
+    void pushMetatable(lua_State* L);
+
+    // std::string throws when it can't allocate, and exceptions can't cross the C frames of
+    // Lua. Every allocation goes through here, and the error is raised once out of the catch
+    // block, with the message of string.rep
+    template<typename F>
+    void guarded(lua_State* L, F&& grow)
+    {
+        bool failed = false;
+        try { grow(); }
+        catch (const std::exception&) { failed = true; }
+        if (failed) luaL_error(L, "not enough memory");
+    }
+
+    void reserve(lua_State* L, std::string& text, std::size_t size)
+    {
+        guarded(L, [&] { text.reserve(size); });
+    }
+
+    void append(lua_State* L, std::string& text, const char* s, std::size_t size)
+    {
+        guarded(L, [&] { text.append(s, size); });
+    }
+
+    // The metatable is set before the string is allocated, so a failed allocation leaves a
+    // finalized buffer behind for the collector
+    std::string& create(lua_State* L)
+    {
+        auto* buffer = new (lua_newuserdatauv(L, sizeof(Data), 0)) Data{};
+        pushMetatable(L);
+        lua_setmetatable(L, -2);
+        guarded(L, [&] { buffer->text = std::make_shared<std::string>(); });
+        return *buffer->text;
+    }
+
+    std::string& check(lua_State* L, int index)
+    {
+        auto* buffer = static_cast<Data*>(luaL_checkudata(L, index, Metatable));
+        if (!buffer->text) luaL_error(L, "attempt to use a finalized string buffer");
+        return *buffer->text;
+    }
+
+    // Strings and numbers, like table.concat. Integers are written without going through a Lua string
+    void appendValue(lua_State* L, std::string& text, int index)
+    {
+        if (lua_isinteger(L, index))
+        {
+            char digits[24];
+            const auto res = std::to_chars(digits, digits + sizeof(digits), lua_tointeger(L, index));
+            append(L, text, digits, static_cast<std::size_t>(res.ptr - digits));
+            return;
+        }
+
+        std::size_t size;
+        const char* s = luaL_checklstring(L, index, &size);
+        append(L, text, s, size);
+    }
+
+    template<typename... T>
+    void print(lua_State* L, std::string& text, const char* spec, T... values)
+    {
+        char small[128];
+        const int size = std::snprintf(small, sizeof(small), spec, values...);
+        if (size < 0) return;
+        if (static_cast<std::size_t>(size) < sizeof(small))
+        {
+            append(L, text, small, static_cast<std::size_t>(size));
+            return;
+        }
+
+        const auto at = text.size();
+        guarded(L, [&] { text.resize(at + static_cast<std::size_t>(size) + 1); });
+        std::snprintf(text.data() + at, static_cast<std::size_t>(size) + 1, spec, values...);
+        text.resize(at + static_cast<std::size_t>(size));
+    }
+
+    // Only drops the reference, so that running it twice is harmless
+    int strbufGc(lua_State* L)
+    {
+        static_cast<Data*>(luaL_checkudata(L, 1, Metatable))->text.reset();
+        return 0;
+    }
+
+    int strbufLen(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(check(L, 1).size()));
+        return 1;
+    }
+
+    int strbufToString(lua_State* L)
+    {
+        const auto& text = check(L, 1);
+        lua_pushlstring(L, text.data(), text.size());
+        return 1;
+    }
+
+    // sb:append(...)
+    int strbufAppend(lua_State* L)
+    {
+        auto& text = check(L, 1);
+        const int top = lua_gettop(L);
+        for (int i = 2; i <= top; i++) appendValue(L, text, i);
+
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // sb:appendf(format, ...), flags, width and precision are handed to snprintf with the conversion
+    int strbufAppendf(lua_State* L)
+    {
+        auto& text = check(L, 1);
+
+        std::size_t length;
+        const char* format = luaL_checklstring(L, 2, &length);
+        const char* end = format + length;
+        int arg = 2;
+
+        while (format < end)
+        {
+            const auto* percent = static_cast<const char*>(std::memchr(format, '%', static_cast<std::size_t>(end - format)));
+            if (!percent)
+            {
+                append(L, text, format, static_cast<std::size_t>(end - format));
+                break;
+            }
+
+            append(L, text, format, static_cast<std::size_t>(percent - format));
+            format = percent + 1;
+            if (format < end && *format == '%')
+            {
+                append(L, text, "%", 1);
+                format++;
+                continue;
+            }
+
+            const char* start = format;
+            while (format < end && *format && std::strchr("-+ #0", *format) && format - start < 5) format++;
+            for (int i = 0; i < 2 && format < end && *format >= '0' && *format <= '9'; i++) format++;
+            if (format < end && *format == '.')
+            {
+                format++;
+                for (int i = 0; i < 2 && format < end && *format >= '0' && *format <= '9'; i++) format++;
+            }
+            if (format == end) return luaL_error(L, "invalid conversion '%%%s' to 'appendf'", start);
+
+            // Flags, width and precision, then room for the "ll" length modifier and the conversion
+            char spec[32] = "%";
+            const auto flags = static_cast<std::size_t>(format - start);
+            std::memcpy(spec + 1, start, flags);
+            char* conversion = spec + 1 + flags;
+
+            arg++;
+            switch (*format++)
+            {
+            case 'c':
+                conversion[0] = 'c';
+                print(L, text, spec, static_cast<int>(luaL_checkinteger(L, arg)));
+                break;
+            case 'd': case 'i': case 'o': case 'x': case 'X':
+                conversion[0] = 'l';
+                conversion[1] = 'l';
+                conversion[2] = format[-1];
+                print(L, text, spec, static_cast<long long>(luaL_checkinteger(L, arg)));
+                break;
+            case 'a': case 'A': case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
+                conversion[0] = format[-1];
+                print(L, text, spec, static_cast<double>(luaL_checknumber(L, arg)));
+                break;
+            case 's':
+            {
+                std::size_t size;
+                const char* s = luaL_tolstring(L, arg, &size);
+                if (flags == 0) append(L, text, s, size);
+                else
+                {
+                    conversion[0] = 's';
+                    print(L, text, spec, s);
+                }
+                lua_pop(L, 1);
+                break;
+            }
+            default:
+                return luaL_error(L, "invalid conversion '%%%c' to 'appendf'", format[-1]);
+            }
+        }
+
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // sb:rep(s, n [, sep])
+    int strbufRep(lua_State* L)
+    {
+        auto& text = check(L, 1);
+
+        std::size_t size, separator_size;
+        const char* s = luaL_checklstring(L, 2, &size);
+        const auto n = luaL_checkinteger(L, 3);
+        const char* separator = luaL_optlstring(L, 4, "", &separator_size);
+
+        if (n > 0)
+        {
+            const auto count = static_cast<std::size_t>(n);
+            luaL_argcheck(L, size + separator_size == 0 || count <= (text.max_size() - text.size()) / (size + separator_size), 3, "resulting string too large");
+
+            reserve(L, text, text.size() + count * size + (count - 1) * separator_size);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                if (i) append(L, text, separator, separator_size);
+                append(L, text, s, size);
+            }
+        }
+
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // sb:join(t [, sep [, i [, j]]])
+    int strbufJoin(lua_State* L)
+    {
+        auto& text = check(L, 1);
+        luaL_checktype(L, 2, LUA_TTABLE);
+
+        std::size_t separator_size;
+        const char* separator = luaL_optlstring(L, 3, "", &separator_size);
+        const auto first = luaL_optinteger(L, 4, 1);
+        const auto last = lua_isnoneornil(L, 5) ? static_cast<lua_Integer>(lua_rawlen(L, 2)) : luaL_checkinteger(L, 5);
+
+        for (auto i = first; i <= last; i++)
+        {
+            if (i > first) append(L, text, separator, separator_size);
+
+            lua_geti(L, 2, i);
+            if (!lua_isstring(L, -1)) return luaL_error(L, "invalid value (at index %I) in table for 'join'", i);
+            appendValue(L, text, -1);
+            lua_pop(L, 1);
+
+            if (i == last) break; // last may be the largest integer
+        }
+
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // sb:reserve(n), room for n more bytes
+    int strbufReserve(lua_State* L)
+    {
+        auto& text = check(L, 1);
+        const auto n = luaL_checkinteger(L, 2);
+        luaL_argcheck(L, n >= 0 && static_cast<lua_Unsigned>(n) <= text.max_size() - text.size(), 2, "invalid size");
+
+        reserve(L, text, text.size() + static_cast<std::size_t>(n));
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    // sb:clear()
+    int strbufClear(lua_State* L)
+    {
+        check(L, 1).clear();
+        lua_settop(L, 1);
+        return 1;
+    }
+
+    void pushMetatable(lua_State* L)
+    {
+        if (luaL_newmetatable(L, Metatable))
+        {
+            const luaL_Reg meta[] = {
+                { "__gc",       strbufGc       },
+                { "__len",      strbufLen      },
+                { "__tostring", strbufToString },
+                { nullptr, nullptr }
+            };
+            luaL_setfuncs(L, meta, 0);
+
+            const luaL_Reg methods[] = {
+                { "append",   strbufAppend   },
+                { "appendf",  strbufAppendf  },
+                { "rep",      strbufRep      },
+                { "join",     strbufJoin     },
+                { "reserve",  strbufReserve  },
+                { "clear",    strbufClear    },
+                { "tostring", strbufToString },
+                { nullptr, nullptr }
+            };
+            luaL_newlib(L, methods);
+            lua_setfield(L, -2, "__index");
+
+            // Keeps __gc out of the reach of scripts
+            lua_pushliteral(L, "strbuf");
+            lua_setfield(L, -2, "__metatable");
+        }
+    }
+
+    /* Library functions */
+
+    // strbuf.new([capacity])
+    int strbufNew(lua_State* L)
+    {
+        const auto capacity = luaL_optinteger(L, 1, 0);
+        luaL_argcheck(L, capacity >= 0, 1, "invalid capacity");
+
+        reserve(L, create(L), static_cast<std::size_t>(capacity));
+        return 1;
+    }
+}
+
+namespace SL::Lib
+{
+
+namespace
+{
+    const Reg Functions[] = {
+        { "new",   bind(strbufNew) },
+        { nullptr, nullptr }
+    };
+}
+
+StrBuf::StrBuf() : Base("strbuf", Functions)
+{   }
+
+} // SL::Lib
+
+namespace SL::CompileTime
+{
+    int TypeMap<Lib::StrBuf::View>::LuaType = LUA_TUSERDATA;
+
+    bool
+    TypeMap<Lib::StrBuf::View>::check(State L)
+    {
+        const auto* buffer = static_cast<const Data*>(luaL_testudata(STATE, -1, Metatable));
+        return buffer && buffer->text;
+    }
+
+    void
+    TypeMap<Lib::StrBuf::View>::push(State L, const Lib::StrBuf::View& val)
+    {
+        auto& text = create(STATE);
+        append(STATE, text, val.text.data(), val.text.size());
+    }
+
+    Lib::StrBuf::View
+    TypeMap<Lib::StrBuf::View>::construct(State L)
+    {
+        const auto& text = static_cast<const Data*>(lua_touserdata(STATE, -1))->text;
+        return { std::string_view(*text), text };
+    }
+
+} // SL::CompileTime
@@ -0,0 +1,37 @@
+#pragma once
+
+// Helpers shared by the sources that load chunks from memory, included after Lua.cpp
+
+#include <string>
+
+namespace SL::detail
+{
+    // lua_Writer appending a dumped chunk to a std::string
+    inline int __dumpWriter(lua_State*, const void* p, std::size_t size, void* out)
+    {
+        static_cast<std::string*>(out)->append(static_cast<const char*>(p), size);
+        return 0;
+    }
+
+    // Inserts the searcher on top of the stack (with its upvalues already set) into
+    // package.searchers right after the preload searcher, so its modules win over files
+    inline void __insertSearcher(lua_State* L)
+    {
+        const int top = lua_gettop(L);
+        if (lua_getglobal(L, LUA_LOADLIBNAME) != LUA_TTABLE || lua_getfield(L, -1, "searchers") != LUA_TTABLE)
+        {
+            lua_settop(L, top - 1);
+            return;
+        }
+
+        const auto count = static_cast<lua_Integer>(lua_rawlen(L, -1));
+        for (lua_Integer i = count; i >= 2; i--)
+        {
+            lua_rawgeti(L, -1, i);
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_rotate(L, -3, -1);
+        lua_rawseti(L, -2, count >= 1 ? 2 : 1);
+        lua_pop(L, 2);
+    }
+}
@@ -1,3 +1,5 @@
+#include <SL/Lua/TypeMap.hpp>
+
 extern "C"
 {
 #include "../extern/lua/lua-5.4.6/include/lua.h"
@@ -5,4 +7,14 @@ extern "C"
 #include "../extern/lua/lua-5.4.6/include/lualib.h"
 }
 
-#define STATE reinterpret_cast<lua_State*>(L)
\ No newline at end of file
+#define STATE reinterpret_cast<lua_State*>(L)
+
+namespace
+{
+    // Lib::Reg holds SL::Function, the libraries written against the Lua API register their
+    // lua_CFunctions through this
+    inline SL::Function bind(lua_CFunction function)
+    {
+        return reinterpret_cast<SL::Function>(function);
+    }
+}
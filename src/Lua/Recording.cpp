@@ -0,0 +1,268 @@
+#include <SL/Lua/Recording.hpp>
+
+#include "Lua.cpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    // Layout: the magic, then records tagged with a byte
+    //   N <size> <bytes>                               Next name
+    //   C <name> <time> <duration> <args> <value>...   runFunction
+    //   S <name> <time> <duration> <value>             setGlobal
+    // Numbers are varints, time is from the start of the previous call.
+    // Values are tagged: n, T, F, i <zigzag varint>, d <8 bytes>, s <size> <bytes>,
+    // t <key> <value>... e
+    constexpr char Magic[4] = { 'S', 'L', 'R', '1' };
+
+    // Nesting of the tables a recording may hold
+    constexpr int MaxDepth = 200;
+
+    bool readVarint(std::string_view& in, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && !in.empty(); shift += 7)
+        {
+            const auto byte = static_cast<uint8_t>(in.front());
+            in.remove_prefix(1);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void encode(lua_State* L, int index, std::string& out, std::vector<const void*>& path)
+    {
+        switch (lua_type(L, index))
+        {
+        case LUA_TBOOLEAN:
+            out += lua_toboolean(L, index) ? 'T' : 'F';
+            return;
+
+        case LUA_TNUMBER:
+            if (lua_isinteger(L, index))
+            {
+                out += 'i';
+                SL::detail::__writeVarint(out, zigzag(lua_tointeger(L, index)));
+            }
+            else
+            {
+                const double number = lua_tonumber(L, index);
+                out += 'd';
+                out.append(reinterpret_cast<const char*>(&number), sizeof(number));
+            }
+            return;
+
+        case LUA_TSTRING:
+        {
+            std::size_t size;
+            const char* string = lua_tolstring(L, index, &size);
+            out += 's';
+            SL::detail::__writeVarint(out, size);
+            out.append(string, size);
+            return;
+        }
+
+        case LUA_TTABLE:
+        {
+            const void* table = lua_topointer(L, index);
+            if (path.size() >= MaxDepth || std::find(path.begin(), path.end(), table) != path.end()) break;
+            if (!lua_checkstack(L, 2)) break;
+
+            path.push_back(table);
+            index = lua_absindex(L, index);
+
+            out += 't';
+            lua_pushnil(L);
+            while (lua_next(L, index))
+            {
+                encode(L, -2, out, path);
+                encode(L, -1, out, path);
+                lua_pop(L, 1);
+            }
+            out += 'e';
+
+            path.pop_back();
+            return;
+        }
+        }
+
+        out += 'n';
+    }
+
+    // Checks a value without Lua, so replaying can trust the recording
+    bool skip(std::string_view& in, int depth)
+    {
+        if (in.empty()) return false;
+
+        const char tag = in.front();
+        in.remove_prefix(1);
+
+        uint64_t value;
+        switch (tag)
+        {
+        case 'n': case 'T': case 'F':
+            return true;
+        case 'i':
+            return readVarint(in, value);
+        case 'd':
+            if (in.size() < sizeof(double)) return false;
+            in.remove_prefix(sizeof(double));
+            return true;
+        case 's':
+            if (!readVarint(in, value) || value > in.size()) return false;
+            in.remove_prefix(static_cast<std::size_t>(value));
+            return true;
+        case 't':
+            if (depth >= MaxDepth) return false;
+            while (!in.empty() && in.front() != 'e')
+                if (!skip(in, depth + 1) || !skip(in, depth + 1)) return false;
+            if (in.empty()) return false;
+            in.remove_prefix(1);
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+namespace SL
+{
+
+/* struct Recording */
+Recording::Result<Recording>
+Recording::open(const std::filesystem::path& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return { { ErrorCode::FileError, "Could not open " + filename.string() } };
+
+    Recording recording;
+    recording._data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    const auto invalid = [&]() -> Result<Recording> { return { { ErrorCode::InvalidRecording, filename.string() + " is not a valid recording" } }; };
+
+    std::string_view in(recording._data);
+    if (in.size() < sizeof(Magic) || std::memcmp(in.data(), Magic, sizeof(Magic)) != 0) return invalid();
+    in.remove_prefix(sizeof(Magic));
+
+    uint64_t time = 0;
+    while (!in.empty())
+    {
+        const char tag = in.front();
+        in.remove_prefix(1);
+
+        uint64_t name, delta, duration, args = 1;
+        if (tag == 'N')
+        {
+            if (!readVarint(in, name) || name > in.size()) return invalid();
+            recording._names.emplace_back(in.substr(0, static_cast<std::size_t>(name)));
+            in.remove_prefix(static_cast<std::size_t>(name));
+            continue;
+        }
+        if (tag != 'C' && tag != 'S') return invalid();
+
+        if (!readVarint(in, name) || name >= recording._names.size()) return invalid();
+        if (!readVarint(in, delta) || !readVarint(in, duration)) return invalid();
+        if (tag == 'C' && (!readVarint(in, args) || args > in.size())) return invalid();
+
+        time += delta;
+        recording._entries.push_back({
+            tag == 'C' ? Kind::Call : Kind::SetGlobal,
+            static_cast<uint32_t>(name),
+            static_cast<uint32_t>(args),
+            time,
+            duration,
+            static_cast<std::size_t>(in.data() - recording._data.data())
+        });
+
+        for (uint64_t i = 0; i < args; i++)
+            if (!skip(in, 0)) return invalid();
+    }
+
+    return { std::move(recording) };
+}
+
+namespace detail
+{
+    void __writeVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    void __encodeValue(State L, int index, std::string& out)
+    {
+        std::vector<const void*> path;
+        encode(STATE, index, out, path);
+    }
+
+    void __decodeValue(State L, std::string_view& in)
+    {
+        const char tag = in.front();
+        in.remove_prefix(1);
+
+        uint64_t value;
+        switch (tag)
+        {
+        case 'T':
+            lua_pushboolean(STATE, 1);
+            return;
+        case 'F':
+            lua_pushboolean(STATE, 0);
+            return;
+        case 'i':
+            readVarint(in, value);
+            lua_pushinteger(STATE, unzigzag(value));
+            return;
+        case 'd':
+        {
+            double number;
+            std::memcpy(&number, in.data(), sizeof(number));
+            in.remove_prefix(sizeof(number));
+            lua_pushnumber(STATE, number);
+            return;
+        }
+        case 's':
+            readVarint(in, value);
+            lua_pushlstring(STATE, in.data(), static_cast<std::size_t>(value));
+            in.remove_prefix(static_cast<std::size_t>(value));
+            return;
+        case 't':
+            luaL_checkstack(STATE, 3, "recording nested too deep");
+            lua_newtable(STATE);
+            while (in.front() != 'e')
+            {
+                __decodeValue(L, in);
+                __decodeValue(L, in);
+
+                // Keys that couldn't be recorded
+                if (lua_isnil(STATE, -2)) lua_pop(STATE, 2);
+                else lua_rawset(STATE, -3);
+            }
+            in.remove_prefix(1);
+            return;
+        default:
+            lua_pushnil(STATE);
+            return;
+        }
+    }
+}
+
+} // SL
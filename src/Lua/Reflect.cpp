@@ -0,0 +1,108 @@
+#include <SL/Lua/Reflect.hpp>
+
+#include "Lua.cpp"
+
+namespace SL::CompileTime
+{
+
+/* struct TypeError */
+void TypeError::prepend(const char* field)
+{
+    if (path.empty() || path.front() == '[') path = field + path;
+    else path = std::string(field) + "." + path;
+}
+
+void TypeError::prepend(std::size_t index)
+{
+    const auto segment = "[" + std::to_string(index) + "]";
+    if (path.empty() || path.front() == '[') path = segment + path;
+    else path = segment + "." + path;
+}
+
+std::string TypeError::what() const
+{
+    if (path.empty()) return message;
+    return path + ": " + message;
+}
+
+namespace detail
+{
+    void __createTable(State L, int array, int record)
+    {
+        lua_createtable(STATE, array, record);
+    }
+
+    void __getField(State L, const char* name)
+    {
+        lua_getfield(STATE, -1, name);
+    }
+
+    void __setField(State L, const char* name)
+    {
+        lua_setfield(STATE, -2, name);
+    }
+
+    void __rawGetI(State L, int64_t index)
+    {
+        lua_rawgeti(STATE, -1, static_cast<lua_Integer>(index));
+    }
+
+    void __rawSetI(State L, int64_t index)
+    {
+        lua_rawseti(STATE, -2, static_cast<lua_Integer>(index));
+    }
+
+    std::size_t __rawLen(State L)
+    {
+        return lua_rawlen(STATE, -1);
+    }
+
+    void __rawSet(State L)
+    {
+        lua_rawset(STATE, -3);
+    }
+
+    bool __next(State L)
+    {
+        return lua_next(STATE, -2);
+    }
+
+    void __pushValue(State L, int index)
+    {
+        lua_pushvalue(STATE, index);
+    }
+
+    void __pushNil(State L)
+    {
+        lua_pushnil(STATE);
+    }
+
+    int __type(State L)
+    {
+        return lua_type(STATE, -1);
+    }
+
+    const char* __typeName(State L, int type)
+    {
+        return lua_typename(STATE, type);
+    }
+
+    std::string __mismatch(State L, int expected)
+    {
+        return __mismatch(L, lua_typename(STATE, expected));
+    }
+
+    std::string __mismatch(State L, const std::string& expected)
+    {
+        return "expected " + expected + ", got " + luaL_typename(STATE, -1);
+    }
+
+    bool __expectTable(State L, TypeError& error)
+    {
+        if (lua_istable(STATE, -1)) return true;
+        error = TypeError{ {}, __mismatch(L, LUA_TTABLE) };
+        return false;
+    }
+}
+
+} // SL::CompileTime
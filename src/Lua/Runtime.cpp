@@ -2,7 +2,14 @@
 
 #include "Lua.cpp"
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <list>
+#include <unordered_map>
 
 bool lua_check(lua_State* L, int r, std::optional<int> line = std::nullopt)
 {
@@ -26,22 +33,492 @@ extern template int TypeMap<SL::Number>::LuaType;
 extern template int TypeMap<SL::String>::LuaType;
 extern template int TypeMap<SL::Function>::LuaType;
 extern template int TypeMap<SL::Boolean>::LuaType;
-extern template int TypeMap<SL::Table>::LuaType;
 }
 
-Runtime::Runtime(const std::string& filename) :
-    L(luaL_newstate()),
-    _good(lua_check(STATE, luaL_dofile(STATE, filename.c_str()))),
-    _filename(std::filesystem::path(filename).filename().string()),
-    _last_modified(std::filesystem::last_write_time(std::filesystem::path(filename)))
+namespace
 {
-    if (good()) luaL_openlibs(STATE);
+    struct StdLibrary
+    {
+        StdLib        lib;
+        const char*   name;
+        lua_CFunction open;
+    };
+
+    // In the order luaL_openlibs opens them
+    constexpr StdLibrary StdLibraries[] = {
+        { StdLib::Base,      LUA_GNAME,       luaopen_base },
+        { StdLib::Package,   LUA_LOADLIBNAME, luaopen_package },
+        { StdLib::Coroutine, LUA_COLIBNAME,   luaopen_coroutine },
+        { StdLib::Table,     LUA_TABLIBNAME,  luaopen_table },
+        { StdLib::IO,        LUA_IOLIBNAME,   luaopen_io },
+        { StdLib::OS,        LUA_OSLIBNAME,   luaopen_os },
+        { StdLib::String,    LUA_STRLIBNAME,  luaopen_string },
+        { StdLib::Math,      LUA_MATHLIBNAME, luaopen_math },
+        { StdLib::UTF8,      LUA_UTF8LIBNAME, luaopen_utf8 },
+        { StdLib::Debug,     LUA_DBLIBNAME,   luaopen_debug }
+    };
+
+    constexpr StdLib Eager = StdLib::Base | StdLib::String;
+
+    void openLazy(lua_State* L, const StdLibrary& library, StdLib lazy);
+
+    // package.preload loader of a lazy library, the upvalues are its index in StdLibraries
+    // and the mask of libraries opened on access
+    int openPreloaded(lua_State* L)
+    {
+        const auto& library = StdLibraries[lua_tointeger(L, lua_upvalueindex(1))];
+        openLazy(L, library, static_cast<StdLib>(lua_tointeger(L, lua_upvalueindex(2))));
+        return 1;
+    }
+
+    // Opens a lazy library, sets its global and leaves it on the stack. The package library
+    // comes with preload loaders for the other lazy libraries, so that require finds the ones
+    // whose global hasn't been read yet
+    void openLazy(lua_State* L, const StdLibrary& library, StdLib lazy)
+    {
+        luaL_requiref(L, library.name, library.open, 1);
+        if (library.lib != StdLib::Package) return;
+
+        lua_getfield(L, -1, "preload");
+        for (const auto& other : StdLibraries)
+        {
+            if ((lazy & other.lib) == StdLib::None || other.lib == StdLib::Package) continue;
+
+            lua_pushinteger(L, static_cast<lua_Integer>(&other - StdLibraries));
+            lua_pushinteger(L, static_cast<lua_Integer>(lazy));
+            lua_pushcclosure(L, openPreloaded, 2);
+            lua_setfield(L, -2, other.name);
+        }
+        lua_pop(L, 1);
+    }
+
+    // __index of the global table in lazy mode, the upvalue is the mask of libraries
+    // opened on access. Once opened, a library's global is set and this isn't called for
+    // it again, luaL_requiref reuses the loaded library if the global was removed since
+    int openOnAccess(lua_State* L)
+    {
+        if (lua_type(L, 2) != LUA_TSTRING) return 0;
+
+        const char* key = lua_tostring(L, 2);
+        const bool require = std::strcmp(key, "require") == 0;
+        const auto lazy = static_cast<StdLib>(lua_tointeger(L, lua_upvalueindex(1)));
+
+        for (const auto& library : StdLibraries)
+        {
+            if ((lazy & library.lib) == StdLib::None) continue;
+            if (std::strcmp(key, library.name) != 0 && !(require && library.lib == StdLib::Package)) continue;
+
+            openLazy(L, library, lazy);
+            if (require)
+            {
+                lua_pop(L, 1);
+                lua_rawget(L, 1);
+            }
+            return 1;
+        }
+        return 0;
+    }
+
+#ifdef SL_TRACE
+    // Library functions are wrapped so that each call is a span named Library.function
+    int traced(lua_State* L)
+    {
+        const auto func = reinterpret_cast<SL::Function>(lua_touserdata(L, lua_upvalueindex(1)));
+
+        SL_TRACE_SCOPE(lua_tostring(L, lua_upvalueindex(2)));
+        return func(L);
+    }
+
+    int collected(lua_State* L);
+
+    // An unreachable object whose finalizer runs once per collection cycle
+    void sentinel(lua_State* L)
+    {
+        lua_newuserdatauv(L, 0, 0);
+        if (luaL_newmetatable(L, "SL.Trace.Sentinel"))
+        {
+            lua_pushcfunction(L, collected);
+            lua_setfield(L, -2, "__gc");
+        }
+        lua_setmetatable(L, -2);
+        lua_pop(L, 1);
+    }
+
+    // Records the cycle and makes the next sentinel, Lua doesn't finalize objects made
+    // while the state is closing
+    int collected(lua_State* L)
+    {
+        SL_TRACE_INSTANT("Lua GC cycle");
+        sentinel(L);
+        return 0;
+    }
+#endif
+
+    void openLibraries(lua_State* L, const RuntimeOptions& options)
+    {
+        if (options.libraries == StdLib::All && !options.lazy)
+        {
+            luaL_openlibs(L);
+            return;
+        }
+
+        const auto eager = options.lazy ? (options.libraries & Eager) : options.libraries;
+        for (const auto& library : StdLibraries)
+        {
+            if ((eager & library.lib) == StdLib::None) continue;
+            luaL_requiref(L, library.name, library.open, 1);
+            lua_pop(L, 1);
+        }
+
+        const auto lazy = options.libraries & ~eager;
+        if (lazy == StdLib::None) return;
+
+        lua_pushglobaltable(L);
+        lua_createtable(L, 0, 1);
+        lua_pushinteger(L, static_cast<lua_Integer>(lazy));
+        lua_pushcclosure(L, openOnAccess, 1);
+        lua_setfield(L, -2, "__index");
+        lua_setmetatable(L, -2);
+        lua_pop(L, 1);
+    }
+}
+
+namespace
+{
+    // Watched globals assigned since the last dispatch, each logged once
+    struct WatchLog
+    {
+        std::vector<uint32_t> log;
+        std::vector<char>     changed;
+        uint64_t              generation = 0; // Counts every assignment, for memoized functions
+
+        void mark(uint32_t watch)
+        {
+            generation++;
+            if (changed[watch]) return;
+            changed[watch] = 1;
+            log.push_back(watch);
+        }
+    };
+
+    // A watched table keeps its fields in a storage table (upvalue 1 of its metamethods)
+    // so that every assignment reaches __newindex
+    int fieldNewIndex(lua_State* L)
+    {
+        lua_settop(L, 3);
+        lua_rawset(L, lua_upvalueindex(1));
+
+        auto* log = static_cast<WatchLog*>(lua_touserdata(L, lua_upvalueindex(2)));
+        log->mark(static_cast<uint32_t>(lua_tointeger(L, lua_upvalueindex(3)) - 1));
+        return 0;
+    }
+
+    int fieldNext(lua_State* L)
+    {
+        lua_settop(L, 2);
+        return lua_next(L, lua_upvalueindex(1)) ? 2 : 0;
+    }
+
+    int fieldPairs(lua_State* L)
+    {
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_pushvalue(L, 1);
+        lua_pushnil(L);
+        return 3;
+    }
+
+    int fieldLen(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(lua_rawlen(L, lua_upvalueindex(1))));
+        return 1;
+    }
+
+    // Moves the fields of the table at index into a storage table behind its metatable,
+    // tables that already have a metatable are left alone
+    void proxy(lua_State* L, int table, WatchLog* log, lua_Integer watch, int proxies)
+    {
+        table = lua_absindex(L, table);
+        proxies = lua_absindex(L, proxies);
+        if (lua_getmetatable(L, table))
+        {
+            lua_pop(L, 1);
+            return;
+        }
+
+        lua_newtable(L);
+        const int storage = lua_gettop(L);
+
+        // Clearing existing fields during a traversal is allowed by lua_next
+        lua_pushnil(L);
+        while (lua_next(L, table))
+        {
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, storage);
+            lua_pushvalue(L, -1);
+            lua_pushnil(L);
+            lua_rawset(L, table);
+        }
+
+        lua_createtable(L, 0, 4);
+        lua_pushvalue(L, storage);
+        lua_setfield(L, -2, "__index");
+        lua_pushvalue(L, storage);
+        lua_pushlightuserdata(L, log);
+        lua_pushinteger(L, watch);
+        lua_pushcclosure(L, fieldNewIndex, 3);
+        lua_setfield(L, -2, "__newindex");
+        lua_pushvalue(L, storage);
+        lua_pushcclosure(L, fieldNext, 1);
+        lua_pushcclosure(L, fieldPairs, 1);
+        lua_setfield(L, -2, "__pairs");
+        lua_pushvalue(L, storage);
+        lua_pushcclosure(L, fieldLen, 1);
+        lua_setfield(L, -2, "__len");
+        lua_setmetatable(L, table);
+
+        lua_pushvalue(L, table);
+        lua_insert(L, -2);
+        lua_rawset(L, proxies);
+    }
+
+    // __index of the global table once a global is watched, upvalues are the values of
+    // the watched globals, their watch ids and the __index it replaced
+    int globalIndex(lua_State* L)
+    {
+        lua_settop(L, 2);
+        lua_pushvalue(L, 2);
+        if (lua_rawget(L, lua_upvalueindex(2)) != LUA_TNIL)
+        {
+            lua_pushvalue(L, 2);
+            lua_rawget(L, lua_upvalueindex(1));
+            return 1;
+        }
+        lua_pop(L, 1);
+
+        switch (lua_type(L, lua_upvalueindex(3)))
+        {
+        case LUA_TFUNCTION:
+            lua_pushvalue(L, lua_upvalueindex(3));
+            lua_insert(L, 1);
+            lua_call(L, 2, 1);
+            return 1;
+        case LUA_TTABLE:
+            lua_gettable(L, lua_upvalueindex(3));
+            return 1;
+        default:
+            return 0;
+        }
+    }
+
+    // __newindex of the global table, upvalues are the same as globalIndex's followed by
+    // the log and the storage of the proxied tables. Watch ids are negative when the
+    // fields of the global are watched too
+    int globalNewIndex(lua_State* L)
+    {
+        lua_settop(L, 3);
+        lua_pushvalue(L, 2);
+        if (lua_rawget(L, lua_upvalueindex(2)) == LUA_TNUMBER)
+        {
+            const auto watch = lua_tointeger(L, -1);
+            lua_pop(L, 1);
+
+            auto* log = static_cast<WatchLog*>(lua_touserdata(L, lua_upvalueindex(4)));
+            if (watch < 0 && lua_istable(L, 3)) proxy(L, 3, log, -watch, lua_upvalueindex(5));
+
+            lua_rawset(L, lua_upvalueindex(1));
+            log->mark(static_cast<uint32_t>(std::abs(watch) - 1));
+            return 0;
+        }
+        lua_pop(L, 1);
+
+        switch (lua_type(L, lua_upvalueindex(3)))
+        {
+        case LUA_TFUNCTION:
+            lua_pushvalue(L, lua_upvalueindex(3));
+            lua_insert(L, 1);
+            lua_call(L, 3, 0);
+            return 0;
+        case LUA_TTABLE:
+            lua_settable(L, lua_upvalueindex(3));
+            return 0;
+        default:
+            lua_rawset(L, 1);
+            return 0;
+        }
+    }
+}
+
+struct Runtime::Watches : WatchLog
+{
+    struct Watch
+    {
+        std::string   name;
+        WatchCallback callback;
+    };
+
+    std::deque<Watch>     watches;
+    std::vector<uint32_t> batch;
+    int shadow;  // Values of the watched globals
+    int ids;     // Watch id of each watched global
+    int proxies; // Storage of each watched table, weak keys
+};
+
+struct Runtime::Memo
+{
+    struct Entry
+    {
+        std::string           key;
+        std::shared_ptr<void> value;
+        const std::type_info* type;
+    };
+
+    // Most recently used first, indexed by the keys held in the list
+    struct Cache
+    {
+        std::size_t capacity;
+        std::list<Entry> entries;
+        const void* function  = nullptr;    // The function the results are from,
+        int         reference = LUA_NOREF;  // kept alive so that its address isn't reused
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+        std::size_t hits   = 0;
+        std::size_t misses = 0;
+
+        void clear()
+        {
+            index.clear();
+            entries.clear();
+        }
+    };
+
+    std::unordered_map<std::string, Cache> caches;
+    uint64_t generation = 0;
+
+    void clear()
+    {
+        for (auto& p : caches) p.second.clear();
+    }
+};
+
+struct Runtime::Recorder
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::ofstream out;
+    std::string   buffer; // Records not written yet
+    std::string   values; // Values of the call in progress
+    std::unordered_map<std::string, uint32_t> names;
+
+    Clock::time_point last;  // Start of the previous call
+    Clock::time_point start; // Start of the call in progress
+    Recording::Kind   kind;
+    uint32_t          name;
+    uint32_t          count;
+    bool              active = false;
+
+    ~Recorder()
+    {
+        flush();
+    }
+
+    void flush()
+    {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        buffer.clear();
+    }
+
+    static uint64_t nanoseconds(Clock::duration duration)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+};
+
+Runtime::Runtime(const std::string& filename, const Options& options) :
+    Runtime(luaL_newstate(), std::filesystem::path(filename).filename().string(), options)
+{
+    SL_TRACE_SCOPE("load " + _filename);
+
+    std::error_code ec;
+    _last_modified = std::filesystem::last_write_time(std::filesystem::path(filename), ec);
+    _good = _run(luaL_loadfile(STATE, filename.c_str()));
+}
+
+Runtime::Runtime(State state, const std::string& name, const Options& options) :
+    L(state),
+    _good(false),
+    _filename(name),
+    _checkpoint(LUA_NOREF)
+{
+    openLibraries(STATE, options);
+    detail::__traceCollections(L);
+}
+
+Runtime Runtime::fromBundle(const Bundle& bundle, const std::string& entry, const Options& options)
+{
+    Runtime runtime(luaL_newstate(), entry, options);
+    runtime.mount(bundle);
+
+    SL_TRACE_SCOPE("load " + entry);
+    std::string_view chunk;
+    if (bundle.find(entry, chunk)) runtime._good = runtime._run(chunk, "@" + entry);
+    else std::cout << "Message: no module '" << entry << "' in bundle\n";
+
+    return runtime;
+}
+
+Runtime Runtime::fromBuffer(std::string_view buffer, const std::string& name, const Options& options)
+{
+    Runtime runtime(luaL_newstate(), name, options);
+
+    SL_TRACE_SCOPE("load " + name);
+    runtime._good = runtime._run(buffer, "=" + name);
+    return runtime;
+}
+
+Runtime Runtime::fromEmbedded(const std::string& name, const Options& options)
+{
+    Runtime runtime(luaL_newstate(), name, options);
+    Embedded::_install(runtime.L);
+
+    SL_TRACE_SCOPE("load " + name);
+    std::string_view chunk;
+    if (Embedded::find(name, chunk)) runtime._good = runtime._run(chunk, "@" + name);
+    else std::cout << "Message: no embedded script '" << name << "'\n";
+
+    return runtime;
+}
+
+void Runtime::mount(const Bundle& bundle)
+{
+    bundle._install(L);
+}
+
+bool Runtime::_run(int loaded)
+{
+    if (lua_check(STATE, loaded == LUA_OK ? lua_pcall(STATE, 0, 0, 0) : loaded)) return true;
+
+    _pop();
+    return false;
+}
+
+bool Runtime::_run(std::string_view chunk, const std::string& chunkname)
+{
+    return _run(luaL_loadbuffer(STATE, chunk.data(), chunk.size(), chunkname.c_str()));
 }
 
 Runtime::Runtime(Runtime&& r) :
     L(r.L),
     _good(r._good),
-    _filename(r._filename)
+    _filename(std::move(r._filename)),
+    _events(std::move(r._events)),
+    _watches(std::move(r._watches)),
+    _memo(std::move(r._memo)),
+    _recorder(std::move(r._recorder)),
+    _checkpoint(r._checkpoint)
+#   ifdef LUA_HOT_RELOAD
+    , _last_modified(r._last_modified)
+#   endif
 {
     r.L = nullptr;
 }
@@ -58,64 +535,569 @@ Runtime::registerFunction(
     const std::string& func_name,
     SL::Function func)
 {
-    lua_getglobal(STATE, table_name.c_str());
-    if (!lua_istable(STATE, -1))
+    const Lib::StackGuard guard(L);
+
+    if (lua_getglobal(STATE, table_name.c_str()) != LUA_TTABLE)
     {
+        lua_pop(STATE, 1);
         lua_createtable(STATE, 0, 1);
         lua_setglobal(STATE, table_name.c_str());
-        lua_getglobal(STATE, table_name.c_str());
-        if (!lua_istable(STATE, -1)) return { ErrorCode::VariableDoesntExist };
+        if (lua_getglobal(STATE, table_name.c_str()) != LUA_TTABLE) return { ErrorCode::VariableDoesntExist };
     }
     lua_pushstring(STATE, func_name.c_str());
     lua_pushcfunction(STATE, reinterpret_cast<lua_CFunction>(func));
     lua_settable(STATE, -3);
 
-    lua_pop(STATE, 1);
-
     return { };
 }
 
-template<typename T>
-Runtime::Result<T>
-Runtime::getGlobal(const std::string& name)
+Runtime::Result<void>
+Runtime::registerLibrary(const Lib::Base& library)
 {
-    lua_getglobal(STATE, name.c_str());
-    const auto t = lua_type(STATE, -1);
-    if (t != CompileTime::TypeMap<T>::LuaType)
-        return { ErrorCode::TypeMismatch };
-    
-    return { CompileTime::TypeMap<T>::construct(L) };
+    detail::__registerLibraries(L, { &library });
+    return { };
 }
-template SL_SYMBOL Runtime::Result<Number>       Runtime::getGlobal(const std::string&);
-template SL_SYMBOL Runtime::Result<String>       Runtime::getGlobal(const std::string&);
-template SL_SYMBOL Runtime::Result<Boolean>      Runtime::getGlobal(const std::string&);
-template SL_SYMBOL Runtime::Result<Table>        Runtime::getGlobal(const std::string&);
 
 template<>
 SL_SYMBOL Runtime::Result<SL::Function>
 Runtime::getGlobal<SL::Function>(const std::string& name)
 {
-    lua_getglobal(STATE, name.c_str());
-    const auto t = lua_type(STATE, -1);
-    if (t != LUA_TFUNCTION)
+    const Lib::StackGuard guard(L);
+
+    if (lua_getglobal(STATE, name.c_str()) != LUA_TFUNCTION)
         return { ErrorCode::TypeMismatch };
     
     return { CompileTime::TypeMap<SL::Function>::construct(L) };
 }
 
-template<typename T>
 Runtime::Result<void>
-Runtime::setGlobal(const std::string& name, const T& value)
+Runtime::enableEvents(std::size_t capacity)
 {
-    SL::CompileTime::TypeMap<T>::push(L, value);
-    lua_setglobal(STATE, name.c_str());
+    if (_events) return { };
+
+    _events = std::make_unique<EventQueue>(capacity);
+    _events->_install(L);
+
     return { };
 }
-template SL_SYMBOL Runtime::Result<void> Runtime::setGlobal(const std::string&, const SL::Number&);
-template SL_SYMBOL Runtime::Result<void> Runtime::setGlobal(const std::string&, const SL::String&);
-template SL_SYMBOL Runtime::Result<void> Runtime::setGlobal(const std::string&, const SL::Boolean&);
-template SL_SYMBOL Runtime::Result<void> Runtime::setGlobal(const std::string&, const SL::Table&);
-template SL_SYMBOL Runtime::Result<void> Runtime::setGlobal(const std::string&, const SL::Function&);
+
+EventQueue& Runtime::events()
+{
+    SL_ASSERT(_events, "Events are not enabled for this runtime");
+    return *_events;
+}
+
+Runtime::Result<std::size_t>
+Runtime::dispatchEvents()
+{
+    SL_ASSERT(_events, "Events are not enabled for this runtime");
+    SL_STACK_CHECK(L, 0);
+
+    std::size_t count = _events->_drain();
+    if (!count) return { std::move(count) };
+
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, _events->_dispatch);
+    lua_pushlightuserdata(STATE, _events.get());
+    lua_pushinteger(STATE, static_cast<lua_Integer>(count));
+    if (_call_func(2, 0) != 0)
+    {
+        auto message = CompileTime::TypeMap<SL::String>::construct(L);
+        _pop();
+        return { { ErrorCode::FunctionError, message } };
+    }
+
+    return { std::move(count) };
+}
+
+Runtime::Result<void>
+Runtime::_watch(const std::string& name, WatchCallback callback, bool fields)
+{
+    const Lib::StackGuard guard(L);
+    const int top = lua_gettop(STATE);
+
+    if (!_watches)
+    {
+        _watches = std::make_unique<Watches>();
+
+        lua_newtable(STATE);
+        lua_pushvalue(STATE, -1);
+        _watches->shadow = luaL_ref(STATE, LUA_REGISTRYINDEX);
+
+        lua_newtable(STATE);
+        lua_pushvalue(STATE, -1);
+        _watches->ids = luaL_ref(STATE, LUA_REGISTRYINDEX);
+
+        lua_newtable(STATE);
+        lua_createtable(STATE, 0, 1);
+        lua_pushliteral(STATE, "k");
+        lua_setfield(STATE, -2, "__mode");
+        lua_setmetatable(STATE, -2);
+        lua_pushvalue(STATE, -1);
+        _watches->proxies = luaL_ref(STATE, LUA_REGISTRYINDEX);
+
+        // Chained to the metatable already there, the lazy standard libraries use one
+        lua_pushglobaltable(STATE);
+        if (!lua_getmetatable(STATE, -1))
+        {
+            lua_newtable(STATE);
+            lua_pushvalue(STATE, -1);
+            lua_setmetatable(STATE, -3);
+        }
+        const int meta = lua_gettop(STATE);
+
+        lua_pushvalue(STATE, top + 1);
+        lua_pushvalue(STATE, top + 2);
+        lua_getfield(STATE, meta, "__index");
+        lua_pushcclosure(STATE, globalIndex, 3);
+        lua_setfield(STATE, meta, "__index");
+
+        lua_pushvalue(STATE, top + 1);
+        lua_pushvalue(STATE, top + 2);
+        lua_getfield(STATE, meta, "__newindex");
+        lua_pushlightuserdata(STATE, static_cast<WatchLog*>(_watches.get()));
+        lua_pushvalue(STATE, top + 3);
+        lua_pushcclosure(STATE, globalNewIndex, 5);
+        lua_setfield(STATE, meta, "__newindex");
+
+        lua_settop(STATE, top);
+    }
+
+    auto& watches = *_watches;
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, watches.ids);
+    if (lua_getfield(STATE, -1, name.c_str()) == LUA_TNUMBER)
+    {
+        watches.watches[std::abs(lua_tointeger(STATE, -1)) - 1].callback = std::move(callback);
+        return { };
+    }
+    lua_pop(STATE, 1);
+
+    const auto id = static_cast<lua_Integer>(watches.watches.size() + 1);
+    watches.watches.push_back({ name, std::move(callback) });
+    watches.changed.push_back(0);
+    lua_pushinteger(STATE, fields ? -id : id);
+    lua_setfield(STATE, -2, name.c_str());
+
+    // The value moves out of the global table, so that assigning it goes through __newindex
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, watches.shadow);
+    lua_pushglobaltable(STATE);
+    lua_pushstring(STATE, name.c_str());
+    lua_rawget(STATE, -2);
+    if (fields && lua_istable(STATE, -1))
+    {
+        lua_rawgeti(STATE, LUA_REGISTRYINDEX, watches.proxies);
+        proxy(STATE, -2, &watches, id, -1);
+        lua_pop(STATE, 1);
+    }
+    lua_setfield(STATE, -3, name.c_str());
+
+    lua_pushstring(STATE, name.c_str());
+    lua_pushnil(STATE);
+    lua_rawset(STATE, -3);
+
+    return { };
+}
+
+Runtime::Result<std::size_t>
+Runtime::dispatchWatches()
+{
+    SL_STACK_CHECK(L, 0);
+
+    std::size_t count = 0;
+    if (!_watches || _watches->log.empty()) return { std::move(count) };
+
+    // Globals assigned by the callbacks are left for the next dispatch
+    auto& batch = _watches->batch;
+    batch.swap(_watches->log);
+    for (const auto watch : batch) _watches->changed[watch] = 0;
+
+    for (const auto watch : batch)
+    {
+        auto& entry = _watches->watches[watch];
+        _get_global(entry.name);
+        if (entry.callback(L)) count++;
+    }
+    batch.clear();
+
+    return { std::move(count) };
+}
+
+Runtime::Result<void>
+Runtime::memoize(const std::string& name, std::size_t capacity)
+{
+    if (!capacity)
+    {
+        if (!_memo) return { };
+
+        const auto it = _memo->caches.find(name);
+        if (it == _memo->caches.end()) return { };
+
+        luaL_unref(STATE, LUA_REGISTRYINDEX, it->second.reference);
+        _memo->caches.erase(it);
+        return { };
+    }
+
+    _get_global(name);
+    const bool function = lua_isfunction(STATE, -1);
+    _pop();
+    if (!function) return { { ErrorCode::NotFunction, name + " is not a function" } };
+
+    if (!_memo)
+    {
+        _memo = std::make_unique<Memo>();
+        if (_watches) _memo->generation = _watches->generation;
+    }
+
+    auto& cache = _memo->caches[name];
+    cache.capacity = capacity;
+    while (cache.entries.size() > capacity)
+    {
+        cache.index.erase(cache.entries.back().key);
+        cache.entries.pop_back();
+    }
+    return { };
+}
+
+Runtime::MemoStats Runtime::memoStats(const std::string& name) const
+{
+    MemoStats stats;
+    if (!_memo) return stats;
+
+    const auto it = _memo->caches.find(name);
+    if (it == _memo->caches.end()) return stats;
+
+    stats.hits   = it->second.hits;
+    stats.misses = it->second.misses;
+    stats.size   = it->second.entries.size();
+    return stats;
+}
+
+void* Runtime::_memo_cache(const std::string& name)
+{
+    if (_memo->caches.empty()) return nullptr;
+
+    // Any watched global may be read by a memoized function
+    if (_watches && _watches->generation != _memo->generation)
+    {
+        _memo->clear();
+        _memo->generation = _watches->generation;
+    }
+
+    const auto it = _memo->caches.find(name);
+    if (it == _memo->caches.end()) return nullptr;
+
+    // The results of the function the global held before are of no use
+    auto& cache = it->second;
+    const void* function = lua_topointer(STATE, -1);
+    if (cache.function != function)
+    {
+        cache.clear();
+        cache.function = function;
+
+        lua_pushvalue(STATE, -1);
+        if (cache.reference == LUA_NOREF) cache.reference = luaL_ref(STATE, LUA_REGISTRYINDEX);
+        else lua_rawseti(STATE, LUA_REGISTRYINDEX, cache.reference);
+    }
+    return &cache;
+}
+
+const void* Runtime::_memo_find(void* cache, const std::string& key, const std::type_info& type)
+{
+    auto& c = *static_cast<Memo::Cache*>(cache);
+
+    const auto it = c.index.find(key);
+    if (it == c.index.end() || *it->second->type != type)
+    {
+        c.misses++;
+        return nullptr;
+    }
+
+    c.hits++;
+    c.entries.splice(c.entries.begin(), c.entries, it->second);
+    return it->second->value.get();
+}
+
+void Runtime::_memo_store(void* cache, std::string&& key, std::shared_ptr<void> value, const std::type_info& type)
+{
+    auto& c = *static_cast<Memo::Cache*>(cache);
+
+    // Called with other return types before
+    const auto it = c.index.find(key);
+    if (it != c.index.end())
+    {
+        it->second->value = std::move(value);
+        it->second->type  = &type;
+        return;
+    }
+
+    if (c.entries.size() == c.capacity)
+    {
+        c.index.erase(c.entries.back().key);
+        c.entries.pop_back();
+    }
+
+    c.entries.push_front({ std::move(key), std::move(value), &type });
+    c.index.emplace(c.entries.front().key, c.entries.begin());
+}
+
+Runtime::Result<void>
+Runtime::record(const std::filesystem::path& filename)
+{
+    _recorder.reset();
+
+    auto recorder = std::make_unique<Recorder>();
+    recorder->out.open(filename, std::ios::binary | std::ios::trunc);
+    if (!recorder->out) return { { ErrorCode::FileError, "Could not write " + filename.string() } };
+
+    recorder->buffer.assign("SLR1");
+    recorder->last = Recorder::Clock::now();
+    _recorder = std::move(recorder);
+    return { };
+}
+
+void Runtime::stopRecording()
+{
+    _recorder.reset();
+}
+
+Recording::Replay Runtime::replay(const Recording& recording)
+{
+    using Clock = Recorder::Clock;
+
+    Recording::Replay replay;
+    replay.durations.reserve(recording.entries().size());
+
+    const auto start = Clock::now();
+    for (const auto& entry : recording.entries())
+    {
+        const auto& name = recording.names()[entry.name];
+        auto values = recording.values(entry);
+
+        const auto begin = Clock::now();
+        {
+            // Results and errors are dropped with the guard
+            const Lib::StackGuard guard(L);
+            if (entry.kind == Recording::Kind::Call)
+            {
+                _get_global(name);
+                if (!Lib::detail::__checkStack(L, entry.args)) replay.errors++;
+                else
+                {
+                    for (uint32_t i = 0; i < entry.args; i++) detail::__decodeValue(L, values);
+                    if (lua_pcall(STATE, static_cast<int>(entry.args), LUA_MULTRET, 0) != LUA_OK) replay.errors++;
+                }
+            }
+            else
+            {
+                detail::__decodeValue(L, values);
+                _set_global(name);
+            }
+        }
+        replay.durations.push_back(Recorder::nanoseconds(Clock::now() - begin));
+    }
+    replay.total = Recorder::nanoseconds(Clock::now() - start);
+
+    return replay;
+}
+
+bool Runtime::_record_begin(Recording::Kind kind, const std::string& name, uint32_t count)
+{
+    auto& recorder = *_recorder;
+    if (recorder.active) return false;
+
+    recorder.values.clear();
+    for (uint32_t i = count; i > 0; i--) detail::__encodeValue(L, -static_cast<int>(i), recorder.values);
+
+    auto [it, added] = recorder.names.try_emplace(name, static_cast<uint32_t>(recorder.names.size()));
+    if (added)
+    {
+        recorder.buffer += 'N';
+        detail::__writeVarint(recorder.buffer, name.size());
+        recorder.buffer += name;
+    }
+
+    recorder.kind   = kind;
+    recorder.name   = it->second;
+    recorder.count  = count;
+    recorder.active = true;
+    recorder.start  = Recorder::Clock::now();
+    return true;
+}
+
+void Runtime::_record_end()
+{
+    auto& recorder = *_recorder;
+    const auto end = Recorder::Clock::now();
+
+    recorder.buffer += recorder.kind == Recording::Kind::Call ? 'C' : 'S';
+    detail::__writeVarint(recorder.buffer, recorder.name);
+    detail::__writeVarint(recorder.buffer, Recorder::nanoseconds(recorder.start - recorder.last));
+    detail::__writeVarint(recorder.buffer, Recorder::nanoseconds(end - recorder.start));
+    if (recorder.kind == Recording::Kind::Call) detail::__writeVarint(recorder.buffer, recorder.count);
+    recorder.buffer += recorder.values;
+
+    recorder.last   = recorder.start;
+    recorder.active = false;
+    if (recorder.buffer.size() >= 65536) recorder.flush();
+}
+
+void Runtime::bind(Table& table)
+{
+    table.bind(L);
+}
+
+std::size_t Runtime::memory() const
+{
+    return static_cast<std::size_t>(lua_gc(STATE, LUA_GCCOUNT)) * 1024 + lua_gc(STATE, LUA_GCCOUNTB);
+}
+
+std::size_t Runtime::stackSize() const
+{
+    return static_cast<std::size_t>(lua_gettop(STATE));
+}
+
+namespace
+{
+    enum Snapshot
+    {
+        Globals = 1,
+        Registry,
+        Loaded,
+        Watched
+    };
+
+    // Copies the fields of the table at index into a new table pushed on the stack
+    void copyTable(lua_State* L, int index)
+    {
+        index = lua_absindex(L, index);
+        lua_newtable(L);
+        lua_pushnil(L);
+        while (lua_next(L, index))
+        {
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, -4);
+        }
+    }
+
+    // Removes the fields of the table at target missing from the snapshot table on top
+    // of the stack and writes back the ones that changed, then pops the snapshot.
+    // With keep_refs, integer keys are left alone: in the registry they are the
+    // references of luaL_ref and its free list, still held by the C++ side
+    void restoreTable(lua_State* L, int target, bool keep_refs = false)
+    {
+        target = lua_absindex(L, target);
+        const int snapshot = lua_gettop(L);
+
+        // Clearing existing fields during a traversal is allowed by lua_next
+        lua_pushnil(L);
+        while (lua_next(L, target))
+        {
+            lua_pop(L, 1);
+            if (keep_refs && lua_isinteger(L, -1)) continue;
+
+            lua_pushvalue(L, -1);
+            if (lua_rawget(L, snapshot) == LUA_TNIL)
+            {
+                lua_pushvalue(L, -2);
+                lua_pushnil(L);
+                lua_rawset(L, target);
+            }
+            lua_pop(L, 1);
+        }
+
+        lua_pushnil(L);
+        while (lua_next(L, snapshot))
+        {
+            if (keep_refs && lua_isinteger(L, -2))
+            {
+                lua_pop(L, 1);
+                continue;
+            }
+
+            lua_pushvalue(L, -2);
+            lua_rawget(L, target);
+            const bool same = lua_rawequal(L, -1, -2);
+            lua_pop(L, 1);
+
+            if (same) lua_pop(L, 1);
+            else
+            {
+                lua_pushvalue(L, -2);
+                lua_insert(L, -2);
+                lua_rawset(L, target);
+            }
+        }
+        lua_pop(L, 1);
+    }
+}
+
+void Runtime::checkpoint()
+{
+    SL_STACK_CHECK(L, 0);
+
+    if (_checkpoint != LUA_NOREF) luaL_unref(STATE, LUA_REGISTRYINDEX, _checkpoint);
+
+    // Referenced first so that the snapshot of the registry keeps it
+    lua_createtable(STATE, 4, 0);
+    lua_pushvalue(STATE, -1);
+    _checkpoint = luaL_ref(STATE, LUA_REGISTRYINDEX);
+
+    lua_pushglobaltable(STATE);
+    copyTable(STATE, -1);
+    lua_rawseti(STATE, -3, Globals);
+    lua_pop(STATE, 1);
+
+    copyTable(STATE, LUA_REGISTRYINDEX);
+    lua_rawseti(STATE, -2, Registry);
+
+    // Watched globals live outside of the global table
+    if (_watches)
+    {
+        lua_rawgeti(STATE, LUA_REGISTRYINDEX, _watches->shadow);
+        copyTable(STATE, -1);
+        lua_rawseti(STATE, -3, Watched);
+        lua_pop(STATE, 1);
+    }
+
+    if (lua_getfield(STATE, LUA_REGISTRYINDEX, LUA_LOADED_TABLE) == LUA_TTABLE)
+    {
+        copyTable(STATE, -1);
+        lua_rawseti(STATE, -3, Loaded);
+    }
+    lua_pop(STATE, 2);
+}
+
+void Runtime::reset()
+{
+    SL_ASSERT(_checkpoint != LUA_NOREF, "Resetting a runtime without a checkpoint");
+
+    lua_settop(STATE, 0);
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, _checkpoint);
+
+    lua_pushglobaltable(STATE);
+    lua_rawgeti(STATE, 1, Globals);
+    restoreTable(STATE, 2);
+    lua_pop(STATE, 1);
+
+    lua_rawgeti(STATE, 1, Registry);
+    restoreTable(STATE, LUA_REGISTRYINDEX, true);
+
+    if (lua_getfield(STATE, LUA_REGISTRYINDEX, LUA_LOADED_TABLE) == LUA_TTABLE && lua_rawgeti(STATE, 1, Loaded) == LUA_TTABLE)
+        restoreTable(STATE, 2);
+    lua_settop(STATE, 1);
+
+    if (_watches)
+    {
+        lua_rawgeti(STATE, LUA_REGISTRYINDEX, _watches->shadow);
+        if (lua_rawgeti(STATE, 1, Watched) == LUA_TTABLE) restoreTable(STATE, 2);
+
+        for (const auto watch : _watches->log) _watches->changed[watch] = 0;
+        _watches->log.clear();
+    }
+    lua_settop(STATE, 0);
+
+    if (_memo) _memo->clear();
+}
 
 bool Runtime::good() const
 { return _good; }
@@ -128,9 +1110,88 @@ void Runtime::_pop(std::size_t n) const
     lua_pop(STATE, static_cast<int>(n));
 }
 
+void Runtime::_get_global(const std::string& name) const
+{
+    lua_getglobal(STATE, name.c_str());
+
+    // Conversions walk tables with lua_next, which sees a watched table's storage only
+    if (_watches && lua_istable(STATE, -1) && lua_getmetatable(STATE, -1))
+    {
+        lua_pop(STATE, 1);
+        lua_rawgeti(STATE, LUA_REGISTRYINDEX, _watches->proxies);
+        lua_pushvalue(STATE, -2);
+        if (lua_rawget(STATE, -2) == LUA_TTABLE) lua_replace(STATE, -3);
+        else lua_pop(STATE, 1);
+        lua_pop(STATE, 1);
+    }
+}
+
+void Runtime::_set_global(const std::string& name) const
+{
+    lua_setglobal(STATE, name.c_str());
+}
+
+bool Runtime::_is_function() const
+{
+    return lua_isfunction(STATE, -1);
+}
+
 int Runtime::_call_func(uint32_t args, uint32_t ret) const
 {
     return lua_pcall(STATE, args, ret, 0);
 }
 
+namespace detail
+{
+    void __traceCollections(State L)
+    {
+#   ifdef SL_TRACE
+        sentinel(STATE);
+#   else
+        (void)L;
+#   endif
+    }
+
+    int __pcall(State L, uint32_t args, uint32_t ret)
+    {
+        return lua_pcall(STATE, args, ret, 0);
+    }
+
+    void __registerLibraries(State L, std::initializer_list<const Lib::Base*> libraries)
+    {
+        static_assert(sizeof(Lib::Reg) == sizeof(luaL_Reg) && alignof(Lib::Reg) == alignof(luaL_Reg));
+
+        lua_pushglobaltable(STATE);
+        for (const auto* library : libraries)
+        {
+            const auto& name = library->name();
+            if (lua_getfield(STATE, -1, name.c_str()) != LUA_TTABLE)
+            {
+                lua_pop(STATE, 1);
+                lua_createtable(STATE, 0, static_cast<int>(library->count()));
+                lua_pushvalue(STATE, -1);
+                lua_setfield(STATE, -3, name.c_str());
+            }
+
+            library->setFields(L);
+            const int upvalues = library->pushUpvalues(L);
+#       ifdef SL_TRACE
+            for (const auto* reg = library->functions(); reg->name; reg++)
+            {
+                lua_pushlightuserdata(STATE, reinterpret_cast<void*>(reg->func));
+                lua_pushfstring(STATE, "%s.%s", name.c_str(), reg->name);
+                for (int i = 0; i < upvalues; i++) lua_pushvalue(STATE, -upvalues - 2);
+                lua_pushcclosure(STATE, traced, upvalues + 2);
+                lua_setfield(STATE, -upvalues - 2, reg->name);
+            }
+            lua_pop(STATE, upvalues + 1);
+#       else
+            luaL_setfuncs(STATE, reinterpret_cast<const luaL_Reg*>(library->functions()), upvalues);
+            lua_pop(STATE, 1);
+#       endif
+        }
+        lua_pop(STATE, 1);
+    }
+}
+
 } // SL
@@ -0,0 +1,51 @@
+#include <SL/Lua/RuntimePool.hpp>
+
+namespace SL
+{
+
+RuntimePool::RuntimePool(Factory factory, std::size_t warm) :
+    _factory(std::move(factory))
+{
+    _idle.reserve(warm);
+    for (std::size_t i = 0; i < warm; i++)
+        _idle.push_back(_create());
+}
+
+RuntimePool::Lease RuntimePool::acquire()
+{
+    {
+        std::lock_guard lock(_mutex);
+        if (!_idle.empty())
+        {
+            auto runtime = std::move(_idle.back());
+            _idle.pop_back();
+            return Lease(this, std::move(runtime));
+        }
+    }
+
+    // Created outside the lock, loading a script is the slow part
+    return Lease(this, _create());
+}
+
+std::size_t RuntimePool::idle() const
+{
+    std::lock_guard lock(_mutex);
+    return _idle.size();
+}
+
+void RuntimePool::_release(std::unique_ptr<Runtime> runtime)
+{
+    runtime->reset();
+
+    std::lock_guard lock(_mutex);
+    _idle.push_back(std::move(runtime));
+}
+
+std::unique_ptr<Runtime> RuntimePool::_create() const
+{
+    auto runtime = std::make_unique<Runtime>(_factory());
+    runtime->checkpoint();
+    return runtime;
+}
+
+} // SL
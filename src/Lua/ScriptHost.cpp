@@ -0,0 +1,294 @@
+#include <SL/Lua/ScriptHost.hpp>
+
+#include "Lua.cpp"
+
+namespace
+{
+    // Registry table mapping each table shown read-only, and each proxy, to its proxy
+    constexpr const char* ReadOnly = "SL.ScriptHost.readonly";
+
+    void pushReadOnly(lua_State* L, int index);
+
+    int readOnlyError(lua_State* L)
+    {
+        return luaL_error(L, "attempt to modify a read-only table");
+    }
+
+    // The proxy shows the table in its first upvalue, and tables read through it are
+    // shown read-only too (package.loaded.string is the same proxy as string)
+    int readOnlyIndex(lua_State* L)
+    {
+        lua_settop(L, 2);
+        lua_gettable(L, lua_upvalueindex(1));
+        if (lua_istable(L, -1)) pushReadOnly(L, -1);
+        return 1;
+    }
+
+    int readOnlyLen(lua_State* L)
+    {
+        lua_pushinteger(L, luaL_len(L, lua_upvalueindex(1)));
+        return 1;
+    }
+
+    int readOnlyNext(lua_State* L)
+    {
+        lua_settop(L, 2);
+        if (!lua_next(L, lua_upvalueindex(1))) return 0;
+        if (lua_istable(L, -1))
+        {
+            pushReadOnly(L, -1);
+            lua_replace(L, -2);
+        }
+        return 2;
+    }
+
+    int readOnlyPairs(lua_State* L)
+    {
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_pushcclosure(L, readOnlyNext, 1);
+        lua_pushvalue(L, 1);
+        lua_pushnil(L);
+        return 3;
+    }
+
+    // Pushes the proxy of the table at index, made once per table and shared by every script
+    void pushReadOnly(lua_State* L, int index)
+    {
+        index = lua_absindex(L, index);
+        lua_getfield(L, LUA_REGISTRYINDEX, ReadOnly);
+        lua_pushvalue(L, index);
+        if (lua_rawget(L, -2) == LUA_TTABLE)
+        {
+            lua_remove(L, -2);
+            return;
+        }
+        lua_pop(L, 1);
+
+        lua_newtable(L);
+        lua_createtable(L, 0, 5);
+        lua_pushvalue(L, index);
+        lua_pushcclosure(L, readOnlyIndex, 1);
+        lua_setfield(L, -2, "__index");
+        lua_pushcfunction(L, readOnlyError);
+        lua_setfield(L, -2, "__newindex");
+        lua_pushvalue(L, index);
+        lua_pushcclosure(L, readOnlyLen, 1);
+        lua_setfield(L, -2, "__len");
+        lua_pushvalue(L, index);
+        lua_pushcclosure(L, readOnlyPairs, 1);
+        lua_setfield(L, -2, "__pairs");
+        lua_pushboolean(L, false);
+        lua_setfield(L, -2, "__metatable");
+        lua_setmetatable(L, -2);
+
+        lua_pushvalue(L, index);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, -4);
+        lua_pushvalue(L, -1);
+        lua_pushvalue(L, -1);
+        lua_rawset(L, -4);
+        lua_remove(L, -2);
+    }
+
+    // rawset skips __newindex, it would write into a proxy every script shares
+    int guardedRawset(lua_State* L)
+    {
+        lua_getfield(L, LUA_REGISTRYINDEX, ReadOnly);
+        lua_pushvalue(L, 1);
+        const bool proxy = lua_rawget(L, -2) != LUA_TNIL;
+        lua_pop(L, 2);
+        if (proxy) return readOnlyError(L);
+
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_insert(L, 1);
+        lua_call(L, lua_gettop(L) - 1, LUA_MULTRET);
+        return lua_gettop(L);
+    }
+
+    // Modules are shared through package.loaded, scripts get their proxy
+    int readOnlyRequire(lua_State* L)
+    {
+        lua_settop(L, 1);
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_insert(L, 1);
+        lua_call(L, 1, 2);
+        if (lua_istable(L, 1))
+        {
+            pushReadOnly(L, 1);
+            lua_replace(L, 1);
+        }
+        return 2;
+    }
+
+    // Wraps the function global name of the table on top of the stack in a closure of f
+    void wrap(lua_State* L, const char* name, lua_CFunction f)
+    {
+        lua_getfield(L, -1, name);
+        lua_pushcclosure(L, f, 1);
+        lua_setfield(L, -2, name);
+    }
+
+    // Makes what scripts share unwritable through them, and pushes the read-only view of
+    // the globals. The debug library reaches around any of it, so scripts don't get it
+    void isolate(lua_State* L)
+    {
+        lua_newtable(L);
+        lua_createtable(L, 0, 1);
+        lua_pushliteral(L, "k");
+        lua_setfield(L, -2, "__mode");
+        lua_setmetatable(L, -2);
+        lua_setfield(L, LUA_REGISTRYINDEX, ReadOnly);
+
+        lua_pushglobaltable(L);
+        lua_pushnil(L);
+        lua_setfield(L, -2, LUA_DBLIBNAME);
+        lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+        lua_pushnil(L);
+        lua_setfield(L, -2, LUA_DBLIBNAME);
+        lua_pop(L, 1);
+
+        wrap(L, "rawset", guardedRawset);
+        wrap(L, "require", readOnlyRequire);
+
+        // The metatables of strings and of io files ("FILE*") hold the library tables themselves
+        lua_pushliteral(L, "");
+        lua_getmetatable(L, -1);
+        lua_pushboolean(L, false);
+        lua_setfield(L, -2, "__metatable");
+        lua_pop(L, 2);
+        if (luaL_getmetatable(L, "FILE*") == LUA_TTABLE)
+        {
+            lua_pushboolean(L, false);
+            lua_setfield(L, -2, "__metatable");
+        }
+        lua_pop(L, 1);
+
+        pushReadOnly(L, -1);
+        lua_remove(L, -2);
+    }
+}
+
+namespace SL
+{
+
+ScriptHost::ScriptHost() :
+    L(luaL_newstate()),
+    _scripts(0)
+{
+    luaL_openlibs(STATE);
+    detail::__traceCollections(L);
+
+    lua_pushglobaltable(STATE);
+    _globals = luaL_ref(STATE, LUA_REGISTRYINDEX);
+
+    // Chunks loaded without an environment (load, require, ...) see the read-only view too
+    isolate(STATE);
+    lua_pushvalue(STATE, -1);
+    lua_rawseti(STATE, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+
+    // Shared by every environment, so a script only costs its own table
+    lua_createtable(STATE, 0, 2);
+    lua_insert(STATE, -2);
+    lua_setfield(STATE, -2, "__index");
+    lua_pushboolean(STATE, false);
+    lua_setfield(STATE, -2, "__metatable");
+    _meta = luaL_ref(STATE, LUA_REGISTRYINDEX);
+}
+
+ScriptHost::ScriptHost(ScriptHost&& h) :
+    L(h.L),
+    _meta(h._meta),
+    _globals(h._globals),
+    _scripts(h._scripts)
+{
+    h.L = nullptr;
+    h._scripts = 0;
+}
+
+ScriptHost::~ScriptHost()
+{
+    if (L) lua_close(STATE);
+    L = nullptr;
+}
+
+ScriptHost::Result<ScriptHost::Script>
+ScriptHost::load(const std::string& filename)
+{
+    SL_TRACE_SCOPE("load " + std::filesystem::path(filename).filename().string());
+
+    if (luaL_loadfile(STATE, filename.c_str()) != LUA_OK)
+        return { { ErrorCode::LoadError, CompileTime::take<SL::String>(L) } };
+
+    lua_createtable(STATE, 0, 4);
+    lua_pushvalue(STATE, -1);
+    lua_setfield(STATE, -2, "_G");
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, _meta);
+    lua_setmetatable(STATE, -2);
+
+    lua_pushvalue(STATE, -1);
+    Script script{ luaL_ref(STATE, LUA_REGISTRYINDEX) };
+
+    // The first upvalue of a main chunk is always its _ENV
+    lua_setupvalue(STATE, -2, 1);
+    if (lua_pcall(STATE, 0, 0, 0) != LUA_OK)
+    {
+        luaL_unref(STATE, LUA_REGISTRYINDEX, script.ref);
+        return { { ErrorCode::LoadError, CompileTime::take<SL::String>(L) } };
+    }
+
+    _scripts++;
+    return { std::move(script) };
+}
+
+void ScriptHost::unload(Script script)
+{
+    SL_ASSERT(script.ref != LUA_NOREF && script.ref != LUA_REFNIL, "Unloading a script that isn't loaded");
+    luaL_unref(STATE, LUA_REGISTRYINDEX, script.ref);
+    _scripts--;
+}
+
+ScriptHost::Result<void>
+ScriptHost::registerLibrary(const Lib::Base& library)
+{
+    SL_STACK_CHECK(L, 0);
+
+    // Written into the globals themselves, scripts read them through the view
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, _globals);
+    lua_rawseti(STATE, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+    detail::__registerLibraries(L, { &library });
+    lua_rawseti(STATE, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+    return { };
+}
+
+std::size_t ScriptHost::memory() const
+{
+    return static_cast<std::size_t>(lua_gc(STATE, LUA_GCCOUNT)) * 1024 + lua_gc(STATE, LUA_GCCOUNTB);
+}
+
+void ScriptHost::collect()
+{
+    lua_gc(STATE, LUA_GCCOLLECT);
+}
+
+void ScriptHost::_get_global(Script script, const std::string& name) const
+{
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, script.ref);
+    lua_getfield(STATE, -1, name.c_str());
+    lua_remove(STATE, -2);
+}
+
+void ScriptHost::_set_global(Script script, const std::string& name) const
+{
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, script.ref);
+    lua_insert(STATE, -2);
+    lua_setfield(STATE, -2, name.c_str());
+    lua_pop(STATE, 1);
+}
+
+bool ScriptHost::_is_function() const
+{
+    return lua_isfunction(STATE, -1);
+}
+
+} // SL
@@ -1,11 +1,17 @@
 #include <SL/Lua/Table.hpp>
 #include <SL/Lua/TypeMap.hpp>
+#include <SL/Lua/Reflect.hpp>
 #include <SL/Def.hpp>
 
 #include "Lua.cpp"
+#include "Json.hpp"
 
+#include <algorithm>
+#include <charconv>
 #include <vector>
 #include <sstream>
+#include <cmath>
+#include <cstring>
 
 namespace SL
 {
@@ -16,7 +22,125 @@ extern template int TypeMap<SL::Number>::LuaType;
 extern template int TypeMap<SL::String>::LuaType;
 extern template int TypeMap<SL::Function>::LuaType;
 extern template int TypeMap<SL::Boolean>::LuaType;
-extern template int TypeMap<SL::Table>::LuaType;
+extern template int TypeMap<int64_t>::LuaType;
+extern template int TypeMap<double>::LuaType;
+}
+
+namespace
+{
+    // Out of range (and NaN) doubles have no integer view
+    int64_t truncate(double value)
+    {
+        if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0)) return 0;
+        return static_cast<int64_t>(value);
+    }
+
+    // Numbers are stored with a view for every C++ number type that get() hands out references
+    // to. The views are compared with their values as of the last access, so that a write
+    // through one of them is carried over to the others (and decides whether the number is an
+    // integer) the next time the entry is read. Should several views be written in between,
+    // the integer wins over the double, which wins over the SL::Number.
+    struct Numeric
+    {
+        mutable SL::Number number; // First, the cell's address is also the address of its SL::Number
+        mutable double     real;
+        mutable int64_t    integer;
+        mutable SL::Number synced_number;
+        mutable double     synced_real;
+        mutable int64_t    synced_integer;
+        mutable bool       is_integer;
+
+        static Numeric fromInteger(int64_t value)
+        {
+            Numeric numeric;
+            numeric.assign(value);
+            return numeric;
+        }
+
+        static Numeric fromReal(double value)
+        {
+            Numeric numeric;
+            numeric.assign(value);
+            return numeric;
+        }
+
+        void sync() const
+        {
+            const auto changed = [](double value, double synced)
+            {
+                return value != synced && !(std::isnan(value) && std::isnan(synced));
+            };
+
+            /**/ if (integer != synced_integer) assign(integer);
+            else if (changed(real, synced_real)) assign(real);
+            else if (changed(number, synced_number)) assign(static_cast<double>(number));
+        }
+
+        template<typename F>
+        void visit(F&& f) const
+        {
+            sync();
+            if (is_integer) f(integer);
+            else f(real);
+        }
+
+    private:
+        void assign(int64_t value) const
+        {
+            integer = synced_integer = value;
+            real = synced_real = static_cast<double>(value);
+            number = synced_number = static_cast<SL::Number>(real);
+            is_integer = true;
+        }
+
+        void assign(double value) const
+        {
+            real = synced_real = value;
+            integer = synced_integer = truncate(value);
+            number = synced_number = static_cast<SL::Number>(value);
+            is_integer = false;
+        }
+    };
+
+    template<typename T>
+    T& view(void* data)
+    {
+        if constexpr (std::is_same_v<T, double> || std::is_same_v<T, int64_t> || std::is_same_v<T, SL::Number>)
+        {
+            auto* numeric = static_cast<Numeric*>(data);
+            numeric->sync();
+            /**/ if constexpr (std::is_same_v<T, double>)  return numeric->real;
+            else if constexpr (std::is_same_v<T, int64_t>) return numeric->integer;
+            else return numeric->number;
+        }
+        else return *static_cast<T*>(data);
+    }
+
+    // Nested tables are left to the caller, which either copies or tracks them
+    template<typename F>
+    void pushValue(SL::State L, const SL::Table::Data& data, F&& table)
+    {
+        using namespace SL::CompileTime;
+
+        switch (data.type)
+        {
+        case LUA_TNUMBER:
+            static_cast<const Numeric*>(data.data.get())->visit([L](auto value)
+            {
+                if constexpr (std::is_same_v<decltype(value), int64_t>) lua_pushinteger(STATE, value);
+                else lua_pushnumber(STATE, value);
+            });
+            break;
+        case LUA_TSTRING:   TypeMap<SL::String> ::push(L, view<SL::String> (data.data.get())); break;
+        case LUA_TBOOLEAN:  TypeMap<SL::Boolean>::push(L, view<SL::Boolean>(data.data.get())); break;
+        case LUA_TTABLE:    table(view<SL::Table>(data.data.get()));                           break;
+        case LUA_TFUNCTION: TypeMap<SL::Function>::push(L, view<SL::Function>(data.data.get())); break;
+        default:
+            if (data.tag) CompileTime::detail::__pushTagged(L, view<void*>(data.data.get()), data.tag);
+            else TypeMap<void*>::push(L, view<void*>(data.data.get())); // Worried about this... everywhere else needs void** so why does void* work?
+            break;
+        }
+    }
 }
 
 /* Table::Data */
@@ -34,6 +158,8 @@ template SL_SYMBOL Table::Data Table::Data::fromValue(const SL::String&);
 template SL_SYMBOL Table::Data Table::Data::fromValue(const SL::Boolean&);
 template SL_SYMBOL Table::Data Table::Data::fromValue(const SL::Function&);
 template SL_SYMBOL Table::Data Table::Data::fromValue(const SL::Table&);
+template SL_SYMBOL Table::Data Table::Data::fromValue(const int64_t&);
+template SL_SYMBOL Table::Data Table::Data::fromValue(const double&);
 template SL_SYMBOL Table::Data Table::Data::fromValue(void* const&);
 
 template<typename T>
@@ -47,12 +173,225 @@ Table::Data::emplace(const T& value)
     *static_cast<T*>(ptr.get()) = value;
     return ptr;
 }
-template SL_SYMBOL std::shared_ptr<void> Table::Data::emplace(const SL::Number&);
 template SL_SYMBOL std::shared_ptr<void> Table::Data::emplace(const SL::String&);
 template SL_SYMBOL std::shared_ptr<void> Table::Data::emplace(const SL::Boolean&);
 template SL_SYMBOL std::shared_ptr<void> Table::Data::emplace(const SL::Function&);
 template SL_SYMBOL std::shared_ptr<void> Table::Data::emplace(const SL::Table&);
 
+template<>
+SL_SYMBOL std::shared_ptr<void>
+Table::Data::emplace(const SL::Number& value)
+{
+    return std::make_shared<Numeric>(Numeric::fromReal(value));
+}
+
+template<>
+SL_SYMBOL std::shared_ptr<void>
+Table::Data::emplace(const double& value)
+{
+    return std::make_shared<Numeric>(Numeric::fromReal(value));
+}
+
+template<>
+SL_SYMBOL std::shared_ptr<void>
+Table::Data::emplace(const int64_t& value)
+{
+    return std::make_shared<Numeric>(Numeric::fromInteger(value));
+}
+
+namespace
+{
+    // Reads every Lua table once, the tables reached again share the copy made the first time
+    struct Reader
+    {
+        Reader(lua_State* L, const SL::Table::Limits& limits) :
+            L(L), limits(limits)
+        {   }
+
+        lua_State*                      L;
+        const SL::Table::Limits&        limits;
+        SL::CompileTime::TypeError      error;
+        std::size_t                     entries = 0;
+
+        // Null while the table is being read, reaching it then means it holds itself
+        std::unordered_map<const void*, std::shared_ptr<SL::Table>> tables;
+
+        bool fail(std::string message)
+        {
+            error = SL::CompileTime::TypeError{ {}, std::move(message) };
+            return false;
+        }
+
+        // Reads the table at the top of the stack, and leaves it there
+        bool read(SL::Table::Map& map, uint32_t depth)
+        {
+            if (!lua_checkstack(L, 4)) return fail("table nested too deep for the Lua stack");
+
+            lua_pushnil(L);
+            while (lua_next(L, -2) != 0)
+            {
+                SL::Atom key;
+                lua_Integer index = 0; // Positive integer keys show as [i] in error paths
+                bool interned = true;
+                switch (lua_type(L, -2))
+                {
+                case LUA_TSTRING:
+                {
+                    std::size_t length;
+                    const char* string = lua_tolstring(L, -2, &length);
+                    interned = SL::Atom::intern(std::string_view(string, length), key);
+                    break;
+                }
+                case LUA_TNUMBER:
+                    if (lua_isinteger(L, -2))
+                    {
+                        index = lua_tointeger(L, -2);
+                        interned = SL::Atom::intern(std::to_string(index), key);
+                    }
+                    else interned = SL::Atom::intern(std::to_string((int)lua_tonumber(L, -2)), key);
+                    break;
+                default:
+                {
+                    std::string message = std::string("key of type ") + luaL_typename(L, -2);
+                    lua_pop(L, 2);
+                    return fail(std::move(message));
+                }
+                }
+
+                if (!interned)
+                {
+                    lua_pop(L, 2);
+                    return fail("too many distinct keys");
+                }
+
+                if (++entries > limits.entries)
+                {
+                    lua_pop(L, 2);
+                    return fail("more than " + std::to_string(limits.entries) + " entries");
+                }
+
+                std::shared_ptr<void> value;
+                uint16_t tag = 0;
+                const auto type = lua_type(L, -1);
+                switch (type)
+                {
+                case LUA_TNUMBER:
+                    value = lua_isinteger(L, -1)
+                        ? SL::Table::Data::emplace(static_cast<int64_t>(lua_tointeger(L, -1)))
+                        : SL::Table::Data::emplace(static_cast<double>(lua_tonumber(L, -1)));
+                    break;
+                case LUA_TSTRING:   value = SL::Table::Data::emplace(SL::String(lua_tostring(L, -1)));  break;
+                case LUA_TBOOLEAN:  value = SL::Table::Data::emplace(lua_toboolean(L, -1));             break;
+                // Stored untagged like TypeMap<void*> reads it, the tag is kept next to it so
+                // that the pointer reaches Lua unchanged again through toStack
+                case LUA_TUSERDATA:
+                case LUA_TLIGHTUSERDATA:
+                    value = SL::Table::Data::emplace(SL::CompileTime::detail::__toPointer(L, tag));
+                    break;
+                case LUA_TTABLE:
+                {
+                    const void* id = lua_topointer(L, -1);
+                    const auto found = tables.find(id);
+                    if (found != tables.end())
+                    {
+                        if (!found->second)
+                        {
+                            lua_pop(L, 2);
+                            fail("table holds itself");
+                            prepend(key, index);
+                            return false;
+                        }
+                        value = found->second;
+                        break;
+                    }
+
+                    if (depth >= limits.depth)
+                    {
+                        lua_pop(L, 2);
+                        fail("tables nested deeper than " + std::to_string(limits.depth) + " levels");
+                        prepend(key, index);
+                        return false;
+                    }
+
+                    tables.emplace(id, nullptr);
+                    SL::Table::Map nested;
+                    if (!read(nested, depth + 1))
+                    {
+                        lua_pop(L, 2);
+                        prepend(key, index);
+                        return false;
+                    }
+
+                    auto table = std::make_shared<SL::Table>(std::move(nested));
+                    tables[id] = table;
+                    value = std::move(table);
+                    break;
+                }
+                // Functions and threads have no copy outside of Lua, the key is left out
+                default:
+                    lua_pop(L, 1);
+                    continue;
+                }
+
+                map.insert(std::pair(key, SL::Table::Data{ std::move(value), type, tag }));
+                lua_pop(L, 1);
+            }
+            return true;
+        }
+
+        void prepend(SL::Atom key, lua_Integer index)
+        {
+            if (index > 0) error.prepend(static_cast<std::size_t>(index));
+            else error.prepend(key.str().c_str());
+        }
+    };
+
+    // Pushes the tables shared by several keys once, they are kept in a Lua table at index
+    // shared, inserted at base the first time one is met
+    struct Writer
+    {
+        lua_State* L;
+        int        base;
+        int        shared = 0;
+
+        // Remembered before its entries are pushed when shared, so a table reached again
+        // from inside itself is the same Lua table
+        void push(const SL::Table& table, bool remember = false)
+        {
+            luaL_checkstack(L, 4, "table nested too deep");
+            lua_createtable(L, 0, static_cast<int>(table.getMap().size()));
+            if (remember)
+            {
+                lua_pushvalue(L, -1);
+                lua_rawsetp(L, shared, &table);
+            }
+
+            for (const auto& p : table.getMap())
+            {
+                const auto key = p.first.view();
+                lua_pushlstring(L, key.data(), key.size());
+                pushValue(reinterpret_cast<SL::State>(L), p.second, [&](const SL::Table& nested)
+                {
+                    // A table owned by this key only can't have been pushed before
+                    if (p.second.data.use_count() == 1) return push(nested);
+
+                    if (!shared)
+                    {
+                        // Below everything pushed so far, which is only reached relative to the top
+                        lua_newtable(L);
+                        lua_insert(L, base);
+                        shared = base;
+                    }
+                    if (lua_rawgetp(L, shared, &nested) == LUA_TTABLE) return;
+                    lua_pop(L, 1);
+                    push(nested, true);
+                });
+                lua_rawset(L, -3);
+            }
+        }
+    };
+}
+
 /* Table */
 
 Table::Table(const Table::Map& map) :
@@ -64,25 +403,99 @@ Table::Table(State L)
     fromStack(L);
 }
 
+Table::Table(const Table& table) :
+    dictionary(table.dictionary)
+{   }
+
+Table::Table(Table&& table) :
+    dictionary(std::move(table.dictionary)),
+    _dirty(std::move(table._dirty)),
+    _tracked(table._tracked),
+    _bound(table._bound),
+    _ref(table._ref)
+{
+    // The bound Lua table comes along, so do the nested tables reporting to it
+    if (_tracked)
+        for (const auto& p : dictionary)
+            if (p.second.type == LUA_TTABLE)
+            {
+                auto& child = view<SL::Table>(p.second.data.get());
+                if (child._parent == &table) child._parent = this;
+            }
+
+    table.dictionary.clear();
+    table._dirty.clear();
+    table._tracked = false;
+    table._bound = nullptr;
+}
+
+Table::~Table()
+{
+    // Nested tables can be shared with copies of this table, which outlive it
+    if (_tracked)
+        for (const auto& p : dictionary) _detach(p.second);
+    if (_bound) luaL_unref(reinterpret_cast<lua_State*>(_bound), LUA_REGISTRYINDEX, _ref);
+}
+
+Table& Table::operator=(const Table& table)
+{
+    if (this != &table) _replace(table.dictionary);
+    return *this;
+}
+
+Table& Table::operator=(Table&& table)
+{
+    if (this == &table) return *this;
+
+    // Whatever Lua table the nested tables were synced into, it isn't under this one
+    for (const auto& p : table.dictionary)
+        if (p.second.type == LUA_TTABLE)
+        {
+            auto& child = view<SL::Table>(p.second.data.get());
+            if (child._parent == &table) child._parent = nullptr;
+        }
+
+    _replace(std::move(table.dictionary));
+    table.dictionary.clear();
+    table._dirty.clear();
+    return *this;
+}
+
+bool Table::Key::find(Atom& atom) const
+{
+    if (_atom)
+    {
+        atom = *_atom;
+        return true;
+    }
+    return Atom::find(_name, atom);
+}
+
 const Table::Data& 
-Table::getRaw(const std::string& name) const
+Table::getRaw(Key name) const
 {
-    SL_ASSERT(dictionary.count(name), "Error requesting raw data \"" << name << "\"");
-    return dictionary.at(name);
+    const auto it = _find(name);
+    SL_ASSERT(it != dictionary.end(), "Error requesting raw data \"" << name.view() << "\"");
+    return it->second;
 }
 
 template<typename T>
 void 
 Table::each(std::function<void(uint32_t, T&)> lambda)
 {
-    uint32_t i = 1;
-    while (hasValue(std::to_string(i)))
+    for (uint32_t i = 1; ; i++)
     {
-        auto& val = get<T>(std::to_string(i));
-        lambda(i++, val);
+        Atom key;
+        if (!Atom::find(std::to_string(i), key)) break;
+        const auto it = dictionary.find(key);
+        if (it == dictionary.end()) break;
+        _mark(it->first);
+        lambda(i, view<T>(it->second.data.get()));
     }
 }
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, SL::Number&)>);
+template SL_SYMBOL void Table::each(std::function<void(uint32_t, int64_t&)>);
+template SL_SYMBOL void Table::each(std::function<void(uint32_t, double&)>);
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, SL::String&)>);
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, SL::Boolean&)>);
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, SL::Function&)>);
@@ -93,14 +506,18 @@ template<typename T>
 void 
 Table::each(std::function<void(uint32_t, const T&)> lambda) const
 {
-    uint32_t i = 1;
-    while (hasValue(std::to_string(i)))
+    for (uint32_t i = 1; ; i++)
     {
-        const auto& val = get<T>(std::to_string(i));
-        lambda(i++, val);
+        Atom key;
+        if (!Atom::find(std::to_string(i), key)) break;
+        const auto it = dictionary.find(key);
+        if (it == dictionary.end()) break;
+        lambda(i, view<T>(it->second.data.get()));
     }
 }
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, const SL::Number&)>) const;
+template SL_SYMBOL void Table::each(std::function<void(uint32_t, const int64_t&)>) const;
+template SL_SYMBOL void Table::each(std::function<void(uint32_t, const double&)>) const;
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, const SL::String&)>) const;
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, const SL::Boolean&)>) const;
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, const SL::Function&)>) const;
@@ -108,35 +525,39 @@ template SL_SYMBOL void Table::each(std::function<void(uint32_t, const SL::Table
 template SL_SYMBOL void Table::each(std::function<void(uint32_t, void* const&)>) const;
 
 template<typename T>
-void Table::try_get(const std::string& name, std::function<void(T&)> lambda, std::optional<std::function<void()>> if_not)
+void Table::try_get(Key name, std::function<void(T&)> lambda, std::optional<std::function<void()>> if_not)
 {
     if (hasValue(name)) lambda(get<T>(name));
     else { if (if_not.has_value()) if_not.value()(); }
 }
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(SL::Number&)>, std::optional<std::function<void()>>);
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(SL::String&)>, std::optional<std::function<void()>>);
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(SL::Boolean&)>, std::optional<std::function<void()>>);
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(SL::Function&)>, std::optional<std::function<void()>>);
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(SL::Table&)>, std::optional<std::function<void()>>);
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(void*&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(SL::Number&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(int64_t&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(double&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(SL::String&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(SL::Boolean&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(SL::Function&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(SL::Table&)>, std::optional<std::function<void()>>);
+template SL_SYMBOL void Table::try_get(Key, std::function<void(void*&)>, std::optional<std::function<void()>>);
 
 template<typename T>
-void Table::try_get(const std::string& name, std::function<void(const T&)> lambda, std::optional<std::function<void()>> if_not) const
+void Table::try_get(Key name, std::function<void(const T&)> lambda, std::optional<std::function<void()>> if_not) const
 {
     if (hasValue(name)) lambda(get<T>(name));
     else { if (if_not.has_value()) if_not.value()(); }
 }
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(const SL::Number&)>, std::optional<std::function<void()>>) const;
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(const SL::String&)>, std::optional<std::function<void()>>) const;
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(const SL::Boolean&)>, std::optional<std::function<void()>>) const;
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(const SL::Function&)>, std::optional<std::function<void()>>) const;
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(const SL::Table&)>, std::optional<std::function<void()>>) const;
-template SL_SYMBOL void Table::try_get(const std::string&, std::function<void(void* const&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(const SL::Number&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(const int64_t&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(const double&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(const SL::String&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(const SL::Boolean&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(const SL::Function&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(const SL::Table&)>, std::optional<std::function<void()>>) const;
+template SL_SYMBOL void Table::try_get(Key, std::function<void(void* const&)>, std::optional<std::function<void()>>) const;
 
 void
 Table::fromTable(const Table& table)
 {
-    dictionary = table.dictionary;
+    if (this != &table) _replace(table.dictionary);
 }
 
 void 
@@ -149,26 +570,31 @@ void
 Table::superimpose(const Map& map)
 {
     for (const auto& p : map)
-        dictionary.insert(p);
+        if (dictionary.insert(p).second) _mark(p.first);
 }
 
-bool Table::hasValue(const std::string& name) const
+bool Table::hasValue(Key name) const
 {
-    return dictionary.count(name);
+    return _find(name) != dictionary.end();
 }
 
 template<typename T>
-T& Table::get(const std::string& name)
+T& Table::get(Key name)
 {
-    SL_ASSERT(dictionary.count(name), "Dictionary doesn't have key");
-    return *static_cast<T*>(dictionary.at(name).data.get());
+    const auto it = _find(name);
+    SL_ASSERT(it != dictionary.end(), "Dictionary doesn't have key");
+    // The reference may be written through
+    _mark(it->first);
+    return view<T>(it->second.data.get());
 }
-template SL_SYMBOL SL::Number&   Table::get(const std::string&);
-template SL_SYMBOL SL::String&   Table::get(const std::string&);
-template SL_SYMBOL SL::Boolean&  Table::get(const std::string&);
-template SL_SYMBOL SL::Function& Table::get(const std::string&);
-template SL_SYMBOL SL::Table&    Table::get(const std::string&);
-template SL_SYMBOL void**&        Table::get(const std::string&);
+template SL_SYMBOL SL::Number&   Table::get(Key);
+template SL_SYMBOL int64_t&      Table::get(Key);
+template SL_SYMBOL double&       Table::get(Key);
+template SL_SYMBOL SL::String&   Table::get(Key);
+template SL_SYMBOL SL::Boolean&  Table::get(Key);
+template SL_SYMBOL SL::Function& Table::get(Key);
+template SL_SYMBOL SL::Table&    Table::get(Key);
+template SL_SYMBOL void**&        Table::get(Key);
 
 template<typename T>
 std::vector<T> Table::get() const
@@ -181,6 +607,8 @@ std::vector<T> Table::get() const
     return r;
 }
 template SL_SYMBOL std::vector<SL::Number>    Table::get<SL::Number>() const;
+template SL_SYMBOL std::vector<int64_t>       Table::get<int64_t>() const;
+template SL_SYMBOL std::vector<double>        Table::get<double>() const;
 template SL_SYMBOL std::vector<SL::String>    Table::get<SL::String>() const;
 template SL_SYMBOL std::vector<SL::Boolean>   Table::get<SL::Boolean>() const;
 template SL_SYMBOL std::vector<SL::Function>  Table::get<SL::Function>() const;
@@ -188,32 +616,37 @@ template SL_SYMBOL std::vector<SL::Table>     Table::get<SL::Table>() const;
 template SL_SYMBOL std::vector<void**>        Table::get<void**>() const;
 
 template<typename T>
-const T& Table::get(const std::string& name) const
+const T& Table::get(Key name) const
 {
-    SL_ASSERT(dictionary.count(name), "Dictionary doesn't have key");
-    return *static_cast<T*>(dictionary.at(name).data.get());
+    const auto it = _find(name);
+    SL_ASSERT(it != dictionary.end(), "Dictionary doesn't have key");
+    return view<T>(it->second.data.get());
 }
-template SL_SYMBOL const SL::Number&   Table::get(const std::string&) const;
-template SL_SYMBOL const SL::String&   Table::get(const std::string&) const;
-template SL_SYMBOL const SL::Boolean&  Table::get(const std::string&) const;
-template SL_SYMBOL const SL::Function& Table::get(const std::string&) const;
-template SL_SYMBOL const SL::Table&    Table::get(const std::string&) const;
-template SL_SYMBOL void** const&        Table::get(const std::string&) const;
+template SL_SYMBOL const SL::Number&   Table::get(Key) const;
+template SL_SYMBOL const int64_t&      Table::get(Key) const;
+template SL_SYMBOL const double&       Table::get(Key) const;
+template SL_SYMBOL const SL::String&   Table::get(Key) const;
+template SL_SYMBOL const SL::Boolean&  Table::get(Key) const;
+template SL_SYMBOL const SL::Function& Table::get(Key) const;
+template SL_SYMBOL const SL::Table&    Table::get(Key) const;
+template SL_SYMBOL void** const&        Table::get(Key) const;
 
 template<typename T>
-void Table::set(const std::string& name, const T& value)
+void Table::set(Atom name, const T& value)
 {
-    dictionary.insert(std::pair(name, Table::Data::fromValue(value)));
+    _assign(name, Table::Data::fromValue(value));
 }
-template SL_SYMBOL void Table::set(const std::string&, const SL::Number&);
-template SL_SYMBOL void Table::set(const std::string&, const SL::String&);
-template SL_SYMBOL void Table::set(const std::string&, const SL::Boolean&);
-template SL_SYMBOL void Table::set(const std::string&, const SL::Function&);
-template SL_SYMBOL void Table::set(const std::string&, const SL::Table&);
+template SL_SYMBOL void Table::set(Atom, const SL::Number&);
+template SL_SYMBOL void Table::set(Atom, const int64_t&);
+template SL_SYMBOL void Table::set(Atom, const double&);
+template SL_SYMBOL void Table::set(Atom, const SL::String&);
+template SL_SYMBOL void Table::set(Atom, const SL::Boolean&);
+template SL_SYMBOL void Table::set(Atom, const SL::Function&);
+template SL_SYMBOL void Table::set(Atom, const SL::Table&);
 
-void Table::set(const std::string& name, void* value)
+void Table::set(Atom name, void* value)
 {
-    dictionary.insert(std::pair(name, Table::Data::fromValue(value)));
+    _assign(name, Table::Data::fromValue(value));
 }
 
 const Table::Map&
@@ -223,66 +656,258 @@ Table::getMap() const
 void
 Table::toStack(State L) const
 {
-    using namespace CompileTime;
+    SL_STACK_CHECK(L, 1);
+    if (_bound && _bound == L) return _pushBound();
+
+    Writer writer{ STATE, lua_gettop(STATE) + 1 };
+    writer.push(*this);
+    if (writer.shared) lua_remove(STATE, writer.shared);
+}
+
+bool
+Table::fromStack(State L, const Limits& limits, CompileTime::TypeError* error)
+{
+    SL_STACK_CHECK(L, -1);
+    Reader reader(STATE, limits);
+    reader.tables.emplace(lua_topointer(STATE, -1), nullptr);
+
+    Map map;
+    const bool read = reader.read(map, 1);
+    lua_pop(STATE, 1);
+
+    if (!read)
+    {
+        if (error) *error = std::move(reader.error);
+        return false;
+    }
+
+    for (auto& p : map)
+    {
+        const auto res = dictionary.insert(std::move(p));
+        if (res.second) _mark(res.first->first);
+    }
+    return true;
+}
+
+void Table::bind(State L)
+{
+    unbind();
+
+    _parent = nullptr;
+    _push(L);
+    _ref = luaL_ref(STATE, LUA_REGISTRYINDEX);
+    _bound = L;
+}
+
+void Table::unbind()
+{
+    if (_bound) luaL_unref(reinterpret_cast<lua_State*>(_bound), LUA_REGISTRYINDEX, _ref);
+    _bound = nullptr;
+    _untrack();
+}
+
+bool Table::bound() const
+{
+    return _bound;
+}
+
+void Table::sync()
+{
+    if (!_bound) return;
+    _pushBound();
+    lua_pop(reinterpret_cast<lua_State*>(_bound), 1);
+}
 
-    lua_newtable(STATE);
+// A key given as a string that was never interned isn't in any table
+Table::Map::const_iterator Table::_find(Key name) const
+{
+    Atom atom;
+    return name.find(atom) ? dictionary.find(atom) : dictionary.end();
+}
 
+void Table::_assign(Atom name, Data data)
+{
+    const auto it = dictionary.find(name);
+    if (it == dictionary.end()) dictionary.emplace(name, std::move(data));
+    else
+    {
+        _detach(it->second);
+        it->second = std::move(data);
+    }
+    _mark(name);
+}
+
+void Table::_replace(Map map)
+{
+    // Keys that are gone are synced as nil
     for (const auto& p : dictionary)
     {
-        lua_pushstring(STATE, p.first.c_str());
+        _detach(p.second);
+        _mark(p.first);
+    }
 
-        switch (p.second.type)
-        {
-        case LUA_TNUMBER:  TypeMap<SL::Number> ::push(L, get<SL::Number> (p.first)); break;
-        case LUA_TSTRING:  TypeMap<SL::String> ::push(L, get<SL::String> (p.first)); break;
-        case LUA_TBOOLEAN: TypeMap<SL::Boolean>::push(L, get<SL::Boolean>(p.first)); break;
-        case LUA_TTABLE:
+    dictionary = std::move(map);
+    for (const auto& p : dictionary) _mark(p.first);
+}
+
+void Table::_mark(Atom name) const
+{
+    if (!_tracked) return;
+
+    // Once a key is dirty the tables above already know about it
+    if (_dirty.insert(name).second && _parent) _parent->_mark(_key);
+}
+
+void Table::_detach(const Data& data) const
+{
+    if (data.type != LUA_TTABLE) return;
+
+    auto& child = view<SL::Table>(data.data.get());
+    if (child._parent == this) child._parent = nullptr;
+}
+
+void Table::_untrack() const
+{
+    if (!_tracked) return;
+
+    _tracked = false;
+    _dirty.clear();
+    for (const auto& p : dictionary)
+        if (p.second.type == LUA_TTABLE)
         {
-            const auto& table = get<SL::Table>(p.first);
-            table.toStack(L);
-            break;
-        }
-        case LUA_TFUNCTION: TypeMap<SL::Function>::push(L, get<SL::Function>(p.first)); break;
-        default: TypeMap<void*>::push(L, get<void*>(p.first)); break; // Worried about this... everywhere else needs void** so why does void* work?
+            auto& child = view<SL::Table>(p.second.data.get());
+            if (child._parent == this)
+            {
+                child._parent = nullptr;
+                child._untrack();
+            }
         }
+}
+
+void Table::_push(State L) const
+{
+    lua_createtable(STATE, 0, static_cast<int>(dictionary.size()));
+    _tracked = true;
+    _dirty.clear();
 
-        lua_settable(STATE, -3);
+    for (const auto& p : dictionary)
+    {
+        const auto key = p.first.view();
+        lua_pushlstring(STATE, key.data(), key.size());
+        pushValue(L, p.second, [&](const Table& table)
+        {
+            table._parent = this;
+            table._key = p.first;
+            table._push(L);
+        });
+        lua_rawset(STATE, -3);
     }
 }
 
-void
-Table::fromStack(State L)
+void Table::_sync(State L) const
 {
-    lua_pushnil(STATE);
-    while (lua_next(STATE, -2) != 0)
+    for (const auto& key : _dirty)
     {
-        const auto key = [&]()
+        const auto name = key.view();
+        lua_pushlstring(STATE, name.data(), name.size());
+
+        const auto it = dictionary.find(key);
+        if (it == dictionary.end()) lua_pushnil(STATE);
+        else if (it->second.type == LUA_TTABLE)
         {
-            switch (lua_type(STATE, -2))
+            const auto& table = view<SL::Table>(it->second.data.get());
+
+            // Still the table that was pushed under this key, only its changes are written
+            lua_pushvalue(STATE, -1);
+            lua_rawget(STATE, -3);
+            if (table._tracked && table._parent == this && lua_istable(STATE, -1))
             {
-            case LUA_TSTRING: return std::string(lua_tostring(STATE, -2));
-            case LUA_TNUMBER: return std::to_string((int)lua_tonumber(STATE, -2));
-            default: SL_ASSERT(false, "Lua type mismatch");
+                table._sync(L);
+                lua_pop(STATE, 2);
+                continue;
             }
-        }();
-        
-        std::shared_ptr<void> value;
+            lua_pop(STATE, 1);
+
+            table._parent = this;
+            table._key = key;
+            table._push(L);
+        }
+        else pushValue(L, it->second, [](const Table&) { });
+
+        lua_rawset(STATE, -3);
+    }
+    _dirty.clear();
+}
+
+void Table::_pushBound() const
+{
+    const auto L = _bound;
+    lua_rawgeti(STATE, LUA_REGISTRYINDEX, _ref);
+    _sync(L);
+}
+
+namespace
+{
+    template<typename T>
+    void append(std::string& out, const T& value)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
 
-        const auto count = lua_gettop(STATE);
-        const auto type = lua_type(STATE, -1);
-        switch(type)
+    void append(std::string& out, std::string_view string)
+    {
+        append(out, static_cast<uint32_t>(string.size()));
+        out.append(string);
+    }
+}
+
+void Table::encode(std::string& out) const
+{
+    // Sorted by key so the encoding doesn't depend on the hash map's order
+    std::vector<const Map::value_type*> entries;
+    entries.reserve(dictionary.size());
+    for (const auto& p : dictionary) entries.push_back(&p);
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first.view() < b->first.view(); });
+
+    out += 't';
+    append(out, static_cast<uint32_t>(entries.size()));
+    for (const auto* p : entries)
+    {
+        append(out, p->first.view());
+
+        const auto* data = p->second.data.get();
+        switch (p->second.type)
         {
-        case LUA_TNUMBER:   value = Data::emplace(static_cast<SL::Number>(lua_tonumber(STATE, -1))); break;
-        case LUA_TSTRING:   value = Data::emplace(SL::String(lua_tostring(STATE, -1)));              break;
-        case LUA_TBOOLEAN:  value = Data::emplace(lua_toboolean(STATE, -1));                          break;
-        case LUA_TUSERDATA: value = Data::emplace(lua_touserdata(STATE, -1));                         break;
-        case LUA_TTABLE:    value = Data::emplace(Table(STATE));                                      break;
+        case LUA_TNUMBER:
+            static_cast<const Numeric*>(data)->visit([&out](auto value)
+            {
+                out += std::is_same_v<decltype(value), int64_t> ? 'i' : 'd';
+                append(out, value);
+            });
+            break;
+        case LUA_TSTRING:
+            out += 's';
+            append(out, std::string_view(*static_cast<const SL::String*>(data)));
+            break;
+        case LUA_TBOOLEAN:
+            out += *static_cast<const SL::Boolean*>(data) ? 'T' : 'F';
+            break;
+        case LUA_TTABLE:
+            static_cast<const Table*>(data)->encode(out);
+            break;
+        case LUA_TFUNCTION:
+            out += 'f';
+            append(out, *static_cast<const SL::Function*>(data));
+            break;
+        default:
+            out += 'u';
+            append(out, *static_cast<void* const*>(data));
+            append(out, p->second.tag);
+            break;
         }
-        
-        dictionary.insert(std::pair(key, Data{ value, type }));
-        if (count == lua_gettop(STATE)) lua_pop(STATE, 1);
     }
-    lua_pop(STATE, 1);
 }
 
 std::string Table::toString(uint32_t indent) const
@@ -308,8 +933,8 @@ std::string Table::toString(uint32_t indent) const
         }
         else if (p.second.type == TypeMap<SL::Number>::LuaType)
         {
-            const SL::Number* value = reinterpret_cast<SL::Number*>(p.second.data.get());
-            ss << indent_string << p.first << " = " << *value << "";
+            ss << indent_string << p.first << " = ";
+            static_cast<const Numeric*>(p.second.data.get())->visit([&ss](auto value) { ss << value; });
         }
         else if (p.second.type == TypeMap<SL::Boolean>::LuaType)
         {
@@ -329,4 +954,176 @@ std::string Table::toString(uint32_t indent) const
     return ss.str();
 }
 
+std::optional<Table> Table::fromJson(std::string_view json, std::string* error)
+{
+    // Containers being read are kept on a stack, and each value waits in `value` until the
+    // container holding it takes it. Finished tables are moved into their parent, not copied
+    struct Builder
+    {
+        struct Frame
+        {
+            Table   table;
+            Atom    key;
+            int64_t count = 0;
+        };
+
+        std::vector<Frame> frames;
+        Data value;
+        std::string error;
+
+        bool set(std::shared_ptr<void> data, int type)
+        {
+            value = Data{ std::move(data), type };
+            return true;
+        }
+
+        bool null()                     { return set(nullptr, LUA_TNIL); }
+        bool boolean(bool v)            { return set(Data::emplace<SL::Boolean>(v), LUA_TBOOLEAN); }
+        bool integer(int64_t v)         { return set(Data::emplace(v), LUA_TNUMBER); }
+        bool number(double v)           { return set(Data::emplace(v), LUA_TNUMBER); }
+        bool string(std::string_view s) { return set(std::make_shared<SL::String>(s), LUA_TSTRING); }
+        bool key(std::string_view s)    { return intern(s, frames.back().key); }
+
+        bool intern(std::string_view s, Atom& atom)
+        {
+            if (Atom::intern(s, atom)) return true;
+            error = "too many distinct keys";
+            return false;
+        }
+
+        std::size_t begin()
+        {
+            frames.emplace_back();
+            return frames.size();
+        }
+
+        bool add(Atom key)
+        {
+            if (value.type != LUA_TNIL) frames.back().table.dictionary.insert_or_assign(key, std::move(value));
+            return true;
+        }
+
+        bool end()
+        {
+            auto* table = new Table(std::move(frames.back().table));
+            frames.pop_back();
+            return set(std::shared_ptr<void>(table, [](void* p) { delete static_cast<Table*>(p); }), LUA_TTABLE);
+        }
+
+        std::size_t beginArray()      { return begin(); }
+        bool element(std::size_t)
+        {
+            Atom key;
+            return intern(std::to_string(++frames.back().count), key) && add(key);
+        }
+
+        bool endArray(std::size_t)    { return end(); }
+        std::size_t beginObject()     { return begin(); }
+        bool member(std::size_t)      { return add(frames.back().key); }
+        bool endObject(std::size_t)   { return end(); }
+    };
+
+    detail::json::Parser parser(json);
+    Builder builder;
+    if (!parser.parse(builder))
+    {
+        if (error) *error = parser.error.empty() ? std::move(builder.error) : std::move(parser.error);
+        return std::nullopt;
+    }
+
+    if (builder.value.type != LUA_TTABLE)
+    {
+        if (error) *error = "the document is not an object or an array";
+        return std::nullopt;
+    }
+    return std::move(*static_cast<Table*>(builder.value.data.get()));
+}
+
+void Table::toJson(std::string& out) const
+{
+    using namespace detail::json;
+
+    const auto value = [&out](const Data& data)
+    {
+        const auto* p = data.data.get();
+        switch (data.type)
+        {
+        case LUA_TNUMBER:
+            static_cast<const Numeric*>(p)->visit([&out](auto value)
+            {
+                if constexpr (std::is_same_v<decltype(value), int64_t>) writeInteger(out, value);
+                else if (!writeNumber(out, value)) out += "null";
+            });
+            break;
+        case LUA_TSTRING:  writeString(out, *static_cast<const SL::String*>(p));        break;
+        case LUA_TBOOLEAN: out += *static_cast<const SL::Boolean*>(p) ? "true" : "false"; break;
+        case LUA_TTABLE:   static_cast<const Table*>(p)->toJson(out);                    break;
+        default:           out += "null";                                                break;
+        }
+    };
+
+    // An array when every key is a distinct index from 1 to n, placed in order as they're checked
+    std::vector<const Data*> elements(dictionary.size());
+    bool array = !dictionary.empty();
+    for (const auto& [key, data] : dictionary)
+    {
+        const auto name = key.view();
+        std::size_t index = 0;
+        const auto res = std::from_chars(name.data(), name.data() + name.size(), index);
+        if (res.ec != std::errc() || res.ptr != name.data() + name.size() || name[0] == '0' || index == 0 || index > elements.size())
+        {
+            array = false;
+            break;
+        }
+        elements[index - 1] = &data;
+    }
+
+    if (array)
+    {
+        out += '[';
+        for (std::size_t i = 0; i < elements.size(); i++)
+        {
+            if (i) out += ',';
+            value(*elements[i]);
+        }
+        out += ']';
+        return;
+    }
+
+    out += '{';
+    bool first = true;
+    for (const auto& [key, data] : dictionary)
+    {
+        if (!first) out += ',';
+        first = false;
+
+        writeString(out, key.view());
+        out += ':';
+        value(data);
+    }
+    out += '}';
+}
+
+std::string Table::toJson() const
+{
+    std::string out;
+    toJson(out);
+    return out;
+}
+
+namespace detail
+{
+    bool __number(const Table::Data& data, int64_t& integer, double& real)
+    {
+        bool is_integer = false;
+        static_cast<const Numeric*>(data.data.get())->visit([&](auto value)
+        {
+            is_integer = std::is_same_v<decltype(value), int64_t>;
+            if constexpr (std::is_same_v<decltype(value), int64_t>) integer = value;
+            else real = value;
+        });
+        return is_integer;
+    }
+}
+
 } // SL
@@ -0,0 +1,233 @@
+#include <SL/Lua/Trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct Event
+    {
+        uint64_t time;     // Nanoseconds since the epoch of steady_clock
+        char     name[39];
+        char     phase;    // B, E or i, as in the trace-event format
+    };
+
+    // Written by its thread only, read by Trace::write. Trace::start doesn't touch the heads,
+    // it bumps the generation and each thread starts its buffer over on its next event
+    struct Buffer
+    {
+        Buffer(std::size_t capacity, uint32_t thread) :
+            events(std::make_unique<Event[]>(capacity)),
+            mask(capacity - 1),
+            head(0),
+            generation(0),
+            thread(thread),
+            exited(false)
+        {   }
+
+        std::unique_ptr<Event[]> events;
+        const std::size_t        mask;
+        std::atomic<uint64_t>    head;
+        std::atomic<uint64_t>    generation;
+        const uint32_t           thread;
+        bool                     exited; // Guarded by buffers_mutex
+    };
+
+    std::atomic<bool>        recording{ false };
+    std::atomic<std::size_t> capacity{ 65536 };
+    std::atomic<uint64_t>    generation{ 1 };
+
+    std::mutex                           buffers_mutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    uint32_t                             threads = 0; // Guarded by buffers_mutex
+
+    void release(Buffer* buffer);
+
+    // Unregisters the buffer when its thread exits. A buffer holding events of the current
+    // recording is kept for Trace::write until the next Trace::start, the others are freed
+    struct Registration
+    {
+        Buffer* buffer = nullptr;
+        ~Registration() { if (buffer) release(buffer); }
+    };
+
+    thread_local Registration current;
+
+    void release(Buffer* buffer)
+    {
+        std::lock_guard lock(buffers_mutex);
+        if (buffer->generation.load(std::memory_order_relaxed) == generation.load(std::memory_order_relaxed)) buffer->exited = true;
+        else buffers.erase(std::find_if(buffers.begin(), buffers.end(), [buffer](const auto& b) { return b.get() == buffer; }));
+    }
+
+    Buffer& buffer()
+    {
+        if (current.buffer) return *current.buffer;
+
+        std::size_t size = 2;
+        while (size < capacity.load(std::memory_order_relaxed)) size <<= 1;
+
+        std::lock_guard lock(buffers_mutex);
+        buffers.push_back(std::make_unique<Buffer>(size, ++threads));
+        current.buffer = buffers.back().get();
+        return *current.buffer;
+    }
+
+    void record(char phase, std::string_view name)
+    {
+        auto& b = buffer();
+        auto head = b.head.load(std::memory_order_relaxed);
+
+        // The first event since Trace::start, Trace::write reads the head once it sees the generation
+        const auto now = generation.load(std::memory_order_acquire);
+        if (b.generation.load(std::memory_order_relaxed) != now)
+        {
+            head = 0;
+            b.head.store(0, std::memory_order_relaxed);
+            b.generation.store(now, std::memory_order_release);
+        }
+
+        auto& event = b.events[head & b.mask];
+        event.time  = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        event.phase = phase;
+
+        const auto size = std::min(name.size(), sizeof(event.name) - 1);
+        std::memcpy(event.name, name.data(), size);
+        event.name[size] = '\0';
+
+        b.head.store(head + 1, std::memory_order_release);
+    }
+
+    // Events of an earlier recording are dropped
+    uint64_t recorded(const Buffer& b)
+    {
+        if (b.generation.load(std::memory_order_acquire) != generation.load(std::memory_order_relaxed)) return 0;
+        return b.head.load(std::memory_order_acquire);
+    }
+
+    void escape(std::ostream& out, const char* name)
+    {
+        for (; *name; name++)
+        {
+            const auto c = static_cast<unsigned char>(*name);
+            if (c == '"' || c == '\\') out << '\\' << *name;
+            else if (c < 0x20) out << ' ';
+            else out << *name;
+        }
+    }
+}
+
+namespace SL
+{
+
+void Trace::start(std::size_t events)
+{
+    capacity.store(events, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(buffers_mutex);
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const auto& b) { return b->exited; }), buffers.end());
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    ::recording.store(true, std::memory_order_release);
+}
+
+void Trace::stop()
+{
+    ::recording.store(false, std::memory_order_release);
+}
+
+bool Trace::recording()
+{
+    return ::recording.load(std::memory_order_relaxed);
+}
+
+bool Trace::instrumented()
+{
+#ifdef SL_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Trace::_begin_library(std::string_view name)
+{
+    return instrumented() && begin(name);
+}
+
+bool Trace::begin(std::string_view name)
+{
+    if (!::recording.load(std::memory_order_relaxed)) return false;
+    record('B', name);
+    return true;
+}
+
+void Trace::end()
+{
+    record('E', { });
+}
+
+void Trace::instant(std::string_view name)
+{
+    if (::recording.load(std::memory_order_relaxed)) record('i', name);
+}
+
+void Trace::write(std::ostream& out)
+{
+    std::lock_guard lock(buffers_mutex);
+
+    uint64_t origin = UINT64_MAX;
+    for (const auto& b : buffers)
+    {
+        const auto head = recorded(*b);
+        const auto first = head > b->mask + 1 ? head - (b->mask + 1) : 0;
+        if (first < head) origin = std::min(origin, b->events[first & b->mask].time);
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool comma = false;
+    for (const auto& b : buffers)
+    {
+        const auto head = recorded(*b);
+        const auto first = head > b->mask + 1 ? head - (b->mask + 1) : 0;
+        for (auto i = first; i < head; i++)
+        {
+            const auto& event = b->events[i & b->mask];
+            if (comma) out << ',';
+            comma = true;
+
+            // Microseconds with the nanoseconds kept as decimals
+            const auto ns = event.time - origin;
+            out << "\n{\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << b->thread
+                << ",\"ts\":" << ns / 1000 << '.' << static_cast<char>('0' + ns / 100 % 10)
+                << static_cast<char>('0' + ns / 10 % 10) << static_cast<char>('0' + ns % 10);
+            if (event.phase != 'E')
+            {
+                out << ",\"name\":\"";
+                escape(out, event.name);
+                out << '"';
+            }
+            if (event.phase == 'i') out << ",\"s\":\"t\"";
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool Trace::write(const std::filesystem::path& filename)
+{
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out) return false;
+
+    write(out);
+    return static_cast<bool>(out);
+}
+
+} // SL
@@ -1,17 +1,121 @@
 #include <SL/Lua/TypeMap.hpp>
+#include <SL/Lua/Reflect.hpp>
+#include <SL/Lua/Trace.hpp>
 
 #include "Lua.cpp"
 
+#include <atomic>
+
 namespace SL
 {
 namespace CompileTime
-{    
-    int TypeMap<void*>::LuaType = LUA_TUSERDATA;
+{
+namespace
+{
+    // On 64-bit targets user-space addresses leave the upper 16 bits clear, which is
+    // where the type tag of a light userdata goes. Elsewhere pointers are pushed as is
+    // and the tag can't be checked.
+    constexpr bool TagPointers = sizeof(void*) == 8;
+    constexpr int  TagShift    = 48;
+    constexpr auto AddressMask = (uint64_t(1) << TagShift) - 1;
+
+    uint16_t tagOf(const void* ptr)
+    {
+        if constexpr (!TagPointers) return 0;
+        else return static_cast<uint16_t>(reinterpret_cast<uint64_t>(ptr) >> TagShift);
+    }
+
+    void* untag(void* ptr)
+    {
+        if constexpr (!TagPointers) return ptr;
+        else return reinterpret_cast<void*>(reinterpret_cast<uint64_t>(ptr) & AddressMask);
+    }
+
+    // Pointers already using the upper bits (heaps tagged by the hardware, like ARM's
+    // TBI and MTE, or 5-level paging) are pushed in a full userdata with their tag instead
+    constexpr const char* BoxName = "SL.pointer";
+
+    struct Box
+    {
+        void*    ptr;
+        uint16_t tag;
+    };
+
+    const Box* boxAt(lua_State* L, int index)
+    {
+        return static_cast<const Box*>(luaL_testudata(L, index, BoxName));
+    }
+}
+
+namespace detail
+{
+    uint16_t __nextTypeTag()
+    {
+        // Tag 0 is left for untagged pointers
+        static std::atomic<uint16_t> next(1);
+        const auto tag = next.fetch_add(1, std::memory_order_relaxed);
+        SL_ASSERT(tag, "Ran out of type tags");
+        return tag;
+    }
+
+    void __pushTagged(State L, void* ptr, uint16_t tag)
+    {
+        if constexpr (TagPointers)
+        {
+            if (tagOf(ptr))
+            {
+                auto* box = static_cast<Box*>(lua_newuserdatauv(STATE, sizeof(Box), 0));
+                *box = Box{ ptr, tag };
+                luaL_newmetatable(STATE, BoxName);
+                lua_setmetatable(STATE, -2);
+                return;
+            }
+            ptr = reinterpret_cast<void*>(reinterpret_cast<uint64_t>(ptr) | (uint64_t(tag) << TagShift));
+        }
+        lua_pushlightuserdata(STATE, ptr);
+    }
+
+    bool __isTagged(State L, uint16_t tag)
+    {
+        if (!lua_islightuserdata(STATE, -1))
+        {
+            const auto* box = boxAt(STATE, -1);
+            return box && box->tag == tag;
+        }
+        return !TagPointers || tagOf(lua_touserdata(STATE, -1)) == tag;
+    }
+
+    void* __toTagged(State L)
+    {
+        if (!lua_islightuserdata(STATE, -1)) return boxAt(STATE, -1)->ptr;
+        return untag(lua_touserdata(STATE, -1));
+    }
+
+    // Any userdata, with the tag of a typed pointer split from its address
+    void* __toPointer(State L, uint16_t& tag)
+    {
+        if (!lua_islightuserdata(STATE, -1))
+        {
+            const auto* box = boxAt(STATE, -1);
+            tag = box ? box->tag : 0;
+            return box ? box->ptr : lua_touserdata(STATE, -1);
+        }
+
+        void* ptr = lua_touserdata(STATE, -1);
+        tag = tagOf(ptr);
+        return untag(ptr);
+    }
+}
+
+    int TypeMap<void*>::LuaType = LUA_TLIGHTUSERDATA;
     template<> int TypeMap<SL::Number>::LuaType   = LUA_TNUMBER;
     template<> int TypeMap<SL::String>::LuaType   = LUA_TSTRING;
     template<> int TypeMap<SL::Function>::LuaType = LUA_TFUNCTION;
     template<> int TypeMap<SL::Boolean>::LuaType  = LUA_TBOOLEAN;
-    template<> int TypeMap<SL::Table>::LuaType    = LUA_TTABLE;
+    int TypeMap<SL::Table>::LuaType               = LUA_TTABLE;
+    template<> int TypeMap<int64_t>::LuaType      = LUA_TNUMBER;
+    template<> int TypeMap<int32_t>::LuaType      = LUA_TNUMBER;
+    template<> int TypeMap<double>::LuaType       = LUA_TNUMBER;
     
     bool
     TypeMap<void*>::check(State L)
@@ -22,14 +126,19 @@ namespace CompileTime
     void 
     TypeMap<void*>::push(State L, void* val)
     {
-        auto* ptr = lua_newuserdata(reinterpret_cast<lua_State*>(L), sizeof(void*));
-        *reinterpret_cast<void**>(ptr) = val;
+        lua_pushlightuserdata(STATE, val);
     }
 
     void* 
     TypeMap<void*>::construct(State L)
     {
-        return *reinterpret_cast<void**>(lua_touserdata(reinterpret_cast<lua_State*>(L), -1));
+        // Full userdata is owned by Lua, its address is the value
+        if (!lua_islightuserdata(STATE, -1))
+        {
+            const auto* box = boxAt(STATE, -1);
+            return box ? box->ptr : lua_touserdata(STATE, -1);
+        }
+        return untag(lua_touserdata(STATE, -1));
     }
 
     template<>
@@ -54,6 +163,76 @@ namespace CompileTime
     }
 
 
+    template<>
+    bool 
+    TypeMap<int64_t>::check(State L)
+    {
+        int is_integer;
+        lua_tointegerx(STATE, -1, &is_integer);
+        return is_integer;
+    }
+
+    template<>
+    void
+    TypeMap<int64_t>::push(State L, const int64_t& number)
+    {
+        lua_pushinteger(STATE, static_cast<lua_Integer>(number));
+    }
+
+    template<>
+    int64_t 
+    TypeMap<int64_t>::construct(State L)
+    {
+        return static_cast<int64_t>(lua_tointegerx(STATE, -1, nullptr));
+    }
+
+
+    template<>
+    bool 
+    TypeMap<int32_t>::check(State L)
+    {
+        int is_integer;
+        const auto value = lua_tointegerx(STATE, -1, &is_integer);
+        return is_integer && value >= INT32_MIN && value <= INT32_MAX;
+    }
+
+    template<>
+    void
+    TypeMap<int32_t>::push(State L, const int32_t& number)
+    {
+        lua_pushinteger(STATE, static_cast<lua_Integer>(number));
+    }
+
+    template<>
+    int32_t 
+    TypeMap<int32_t>::construct(State L)
+    {
+        return static_cast<int32_t>(lua_tointegerx(STATE, -1, nullptr));
+    }
+
+
+    template<>
+    bool 
+    TypeMap<double>::check(State L)
+    {
+        return lua_isnumber(STATE, -1);
+    }
+
+    template<>
+    void
+    TypeMap<double>::push(State L, const double& number)
+    {
+        lua_pushnumber(STATE, static_cast<lua_Number>(number));
+    }
+
+    template<>
+    double 
+    TypeMap<double>::construct(State L)
+    {
+        return static_cast<double>(lua_tonumber(STATE, -1));
+    }
+
+
     template<>
     bool 
     TypeMap<SL::String>::check(State L)
@@ -120,26 +299,42 @@ namespace CompileTime
     }
 
     
-    template<>
     void
     TypeMap<SL::Table>::push(State L, const Table& val)
     {
+        SL_TRACE_SCOPE("Table::toStack");
         val.toStack(L);
     }
 
-    template<>
     SL::Table
     TypeMap<SL::Table>::construct(State L)
     {
+        SL_TRACE_SCOPE("Table::fromStack");
         return SL::Table(L);
     }
     
-    template<>
     bool
     TypeMap<SL::Table>::check(State L)
     {
         return lua_istable(reinterpret_cast<lua_State*>(L), -1);
     }
 
+    bool
+    TypeMap<SL::Table>::take(State L, SL::Table& value, TypeError& error)
+    {
+        if (!lua_istable(STATE, -1))
+        {
+            error = TypeError{ {}, detail::__mismatch(L, LUA_TTABLE) };
+            lua_pop(STATE, 1);
+            return false;
+        }
+
+        SL_TRACE_SCOPE("Table::fromStack");
+        SL::Table table;
+        if (!table.fromStack(L, SL::Table::Limits(), &error)) return false;
+        value = std::move(table);
+        return true;
+    }
+
 }
 }
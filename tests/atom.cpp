@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <thread>
+#include <vector>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(Atom, Interning)
+{
+    const SL::Atom a("name"), b(std::string("name")), c(std::string_view("value"));
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a.view(), "name");
+    EXPECT_EQ(c.str(), "value");
+    EXPECT_EQ(SL::Atom().view(), "");
+
+    SL::Atom found;
+    EXPECT_TRUE(SL::Atom::find("name", found));
+    EXPECT_EQ(found, a);
+    EXPECT_FALSE(SL::Atom::find("never interned", found));
+}
+
+TEST(Atom, Literal)
+{
+    const auto& first = SL_ATOM("literal");
+    EXPECT_EQ(first, SL::Atom("literal"));
+
+    const auto before = SL::Atom::report();
+    for (int i = 0; i < 100; i++) EXPECT_EQ(SL::Atom("literal"), first);
+    EXPECT_EQ(SL::Atom::report().count, before.count);
+    EXPECT_GT(before.bytes, 0u);
+}
+
+TEST(Atom, TableKeys)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/test_a.lua");
+    EXPECT_TRUE(runtime);
+
+    auto res = runtime.getGlobal<SL::Table>("TestTable");
+    EXPECT_TRUE(res);
+
+    const auto& table = *res;
+    EXPECT_EQ(table.get<SL::String>(SL_ATOM("name")), "Test");
+    EXPECT_EQ(table.get<SL::String>(std::string_view("name")), "Test");
+    EXPECT_TRUE(table.hasValue(std::string("sub")));
+    EXPECT_FALSE(table.hasValue("missing"));
+
+    const auto back = runtime.template runFunction<SL::Table>("Identity", SL::Table(table));
+    EXPECT_TRUE(back);
+    EXPECT_FLOAT_EQ(std::get<0>(*back).get<SL::Table>("sub").get<SL::Number>("number"), 4.5f);
+}
+
+TEST(Atom, ConcurrentInterning)
+{
+    constexpr int Threads = 4;
+    constexpr int Keys    = 1000;
+
+    std::vector<std::vector<SL::Atom>> atoms(Threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; t++)
+        threads.emplace_back([&atoms, t]()
+        {
+            for (int i = 0; i < Keys; i++) atoms[t].emplace_back("concurrent_" + std::to_string(i));
+        });
+    for (auto& thread : threads) thread.join();
+
+    for (int i = 0; i < Keys; i++)
+    {
+        for (int t = 1; t < Threads; t++) EXPECT_EQ(atoms[t][i], atoms[0][i]);
+        EXPECT_EQ(atoms[0][i].view(), "concurrent_" + std::to_string(i));
+    }
+}
+
+// Reading a key that no table has only looks the string up
+TEST(Atom, LookupsDontIntern)
+{
+    SL::Table table;
+    table.set("present", int64_t(1));
+
+    SL::Atom found;
+    const auto before = SL::Atom::report();
+    for (int i = 0; i < 1000; i++)
+    {
+        const auto key = "absent_key_" + std::to_string(i);
+        EXPECT_FALSE(table.hasValue(key));
+        EXPECT_FALSE(table.hasValue(key.c_str()));
+        EXPECT_FALSE(SL::Atom::find(key, found));
+    }
+    EXPECT_EQ(SL::Atom::report().count, before.count);
+
+    EXPECT_TRUE(table.hasValue(std::string("present")));
+    EXPECT_EQ(table.get<int64_t>(std::string_view("present")), 1);
+}
+
+TEST(Atom, DataKeysAreFreed)
+{
+    constexpr int Rounds = 10;
+    constexpr int Keys   = 5000;
+
+    const auto before = SL::Atom::report();
+    for (int r = 0; r < Rounds; r++)
+    {
+        std::string json = "{";
+        for (int i = 0; i < Keys; i++)
+            json += (i ? ",\"" : "\"") + std::to_string(r) + "_key_" + std::to_string(i) + "\":1";
+        json += "}";
+
+        const auto table = SL::Table::fromJson(json);
+        ASSERT_TRUE(table);
+        EXPECT_EQ(table->get<SL::Number>(std::to_string(r) + "_key_0"), 1.0);
+    }
+
+    // Only the last batch can still be waiting to be freed
+    EXPECT_LT(SL::Atom::report().count, before.count + Keys);
+
+    const SL::Atom pinned = SL::Atom::pin("pinned_key");
+    EXPECT_EQ(SL::Atom("pinned_key"), pinned);
+}
+
+TEST(Atom, CStringKeysAreFreed)
+{
+    constexpr int Keys = 20000;
+
+    // Keys built at runtime are counted even when handed over as a const char*
+    const auto before = SL::Atom::report();
+    for (int i = 0; i < Keys; i++)
+    {
+        const std::string key = "c_string_key_" + std::to_string(i);
+        const SL::Atom atom(key.c_str());
+        EXPECT_EQ(atom.view(), key);
+    }
+    EXPECT_LT(SL::Atom::report().count, before.count + Keys);
+
+    const SL::Atom literal("c_string_literal");
+    EXPECT_EQ(SL::Atom::pin("c_string_literal"), literal);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    std::filesystem::path bufferPath(const char* name)
+    {
+        return std::filesystem::temp_directory_path() / name;
+    }
+
+    template<typename T>
+    void append(std::string& out, T value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // "HEAD", then values at 5, 9, 13, 21 and 25, then a tail
+    std::filesystem::path writeBinary()
+    {
+        std::string bytes = "HEAD";
+        append<uint32_t>(bytes, 0x01020304);
+        append<int32_t>(bytes, -42);
+        append<double>(bytes, 2.5);
+        bytes += { '\x40', '\x20', '\x00', '\x00' }; // 2.5f, big endian
+        append<uint64_t>(bytes, 1ull << 40);
+        bytes += "tail!";
+
+        const auto path = bufferPath("sl-buffer-test.bin");
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+        return path;
+    }
+}
+
+TEST(Buffer, Slices)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Buffer>(LUA_FILE_DIR "/buffer.lua");
+    ASSERT_TRUE(lua);
+
+    const auto path = writeBinary();
+    const auto res = lua.runFunction<SL::String>("Slices", path.string());
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_EQ(std::get<0>(*res), "37|HEAD|tail!|||EA");
+
+    std::filesystem::remove(path);
+}
+
+TEST(Buffer, Reads)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Buffer>(LUA_FILE_DIR "/buffer.lua");
+
+    const auto path = writeBinary();
+    const auto res = lua.runFunction<int64_t, int64_t, int64_t, int64_t, int64_t, double, double, int64_t>("Reads", path.string());
+    ASSERT_TRUE(res) << res.error().message();
+
+    const auto [u8, u16, u16be, u32, i32, f64, f32be, u64] = *res;
+    EXPECT_EQ(u8, 0x04);
+    EXPECT_EQ(u16, 0x0304);
+    EXPECT_EQ(u16be, 0x0403);
+    EXPECT_EQ(u32, 0x01020304);
+    EXPECT_EQ(i32, -42);
+    EXPECT_EQ(f64, 2.5);
+    EXPECT_EQ(f32be, 2.5);
+    EXPECT_EQ(u64, int64_t(1) << 40);
+
+    const auto range = lua.runFunction<bool>("OutOfRange", path.string());
+    ASSERT_TRUE(range);
+    EXPECT_FALSE(std::get<0>(*range));
+
+    const auto missing = lua.runFunction<bool>("Missing", bufferPath("sl-buffer-missing.bin").string());
+    ASSERT_TRUE(missing);
+    EXPECT_TRUE(std::get<0>(*missing));
+
+    std::filesystem::remove(path);
+}
+
+TEST(Buffer, Search)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Buffer>(LUA_FILE_DIR "/buffer.lua");
+
+    const auto search = [&](const std::string& text, const std::string& needle, int64_t init)
+    {
+        const auto res = lua.runFunction<int64_t, int64_t, int64_t>("Search", text, needle, init);
+        EXPECT_TRUE(res);
+        return *res;
+    };
+
+    // Long enough for the vectorized search, with near misses
+    const std::string text = std::string(40, 'a') + "abcab" + std::string(30, 'b') + "abcabd" + "xyz";
+    EXPECT_EQ(search(text, "abcabd", 1), std::make_tuple(int64_t(76), int64_t(81), int64_t(1)));
+    EXPECT_EQ(search(text, "ab", 1), std::make_tuple(int64_t(41), int64_t(42), int64_t(4)));
+    EXPECT_EQ(search(text, "ab", 42), std::make_tuple(int64_t(44), int64_t(45), int64_t(4)));
+    EXPECT_EQ(search(text, "xyz", -3), std::make_tuple(int64_t(82), int64_t(84), int64_t(1)));
+    EXPECT_EQ(search(text, "zz", 1), std::make_tuple(int64_t(0), int64_t(0), int64_t(0)));
+    EXPECT_EQ(search("short", "shorter", 1), std::make_tuple(int64_t(0), int64_t(0), int64_t(0)));
+}
+
+TEST(Buffer, Iterators)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Buffer>(LUA_FILE_DIR "/buffer.lua");
+
+    const auto lines = [&](const std::string& text) { return std::get<0>(*lua.runFunction<SL::String>("Lines", text)); };
+    EXPECT_EQ(lines("a\nbb\r\n\nc"), "[a][bb][][c]");
+    EXPECT_EQ(lines("a\n"), "[a]");
+    EXPECT_EQ(lines(""), "");
+
+    const auto split = [&](const std::string& text, const std::string& delimiter) { return std::get<0>(*lua.runFunction<SL::String>("Split", text, delimiter)); };
+    EXPECT_EQ(split("a,b,,c", ","), "[a][b][][c]");
+    EXPECT_EQ(split("a::b::", "::"), "[a][b][]");
+    EXPECT_EQ(split("", ","), "[]");
+}
+
+TEST(Buffer, View)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Buffer>(LUA_FILE_DIR "/buffer.lua");
+
+    // Lines of "<n>,<digit>", the owner is released once Lua collects the views
+    auto text = std::make_shared<std::string>();
+    int64_t expected = 0;
+    for (int i = 0; i < 200000; i++)
+    {
+        *text += std::to_string(i) + "," + std::to_string(i % 10) + "\n";
+        expected += i % 10;
+    }
+
+    SL::Lib::Buffer::View view{ text->data(), text->size(), text };
+    {
+        const auto res = lua.runFunction<int64_t, double>("SumColumn", view);
+        ASSERT_TRUE(res) << res.error().message();
+        EXPECT_EQ(std::get<0>(*res), expected);
+
+        // Several MB of text, walked with a small heap
+        EXPECT_LT(std::get<1>(*res), 2048.0);
+    }
+
+    const auto size = lua.runFunction<int64_t>("Size", view);
+    ASSERT_TRUE(size);
+    EXPECT_EQ(std::get<0>(*size), static_cast<int64_t>(text->size()));
+
+    // The metatable, and with it __gc, is hidden from scripts
+    const auto metatable = lua.runFunction<SL::String>("Metatable", view);
+    ASSERT_TRUE(metatable) << metatable.error().message();
+    EXPECT_EQ(std::get<0>(*metatable), "buffer");
+
+    view = {};
+    lua.runFunction<>("collectgarbage");
+    EXPECT_EQ(text.use_count(), 1);
+}
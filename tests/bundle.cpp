@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <fstream>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    std::filesystem::path bundlePath(const char* name)
+    {
+        return std::filesystem::temp_directory_path() / name;
+    }
+
+    void expectRuns(const SL::Bundle& bundle)
+    {
+        auto runtime = SL::Runtime::fromBundle(bundle, "main");
+        ASSERT_TRUE(runtime);
+
+        {
+            const auto res = runtime.getGlobal<SL::String>("Greeting");
+            ASSERT_TRUE(res);
+            EXPECT_EQ(*res, "HI!");
+        }
+        {
+            const auto res = runtime.runFunction<int64_t>("Add", int64_t(2), int64_t(3));
+            ASSERT_TRUE(res);
+            EXPECT_EQ(std::get<0>(*res), 5);
+        }
+        {
+            const auto res = runtime.runFunction<SL::Boolean, SL::String>("RequireMissing");
+            ASSERT_TRUE(res);
+            EXPECT_FALSE(std::get<0>(*res));
+            EXPECT_NE(std::get<1>(*res).find("no module 'missing' in bundle"), std::string::npos);
+        }
+    }
+}
+
+TEST(Bundle, Pack)
+{
+    for (const bool precompile : { true, false })
+    {
+        const auto path = bundlePath(precompile ? "sl_test_compiled.slb" : "sl_test_source.slb");
+        ASSERT_TRUE(SL::Bundle::pack(LUA_FILE_DIR "/bundle", path, precompile));
+
+        const auto bundle = SL::Bundle::open(path);
+        ASSERT_TRUE(bundle);
+        EXPECT_EQ(bundle->size(), 3);
+
+        std::string_view chunk;
+        EXPECT_TRUE(bundle->find("util", chunk));
+        EXPECT_TRUE(bundle->find("util.strings", chunk));
+        EXPECT_FALSE(bundle->find("util.init", chunk));
+        // Precompiled chunks start with the escape character of the Lua signature
+        EXPECT_EQ(chunk[0] == '\x1b', precompile);
+
+        expectRuns(*bundle);
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(Bundle, View)
+{
+    const auto path = bundlePath("sl_test_view.slb");
+    ASSERT_TRUE(SL::Bundle::pack(LUA_FILE_DIR "/bundle", path));
+
+    std::ifstream file(path, std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::filesystem::remove(path);
+
+    const auto bundle = SL::Bundle::view(data.data(), data.size());
+    ASSERT_TRUE(bundle);
+    expectRuns(*bundle);
+
+    EXPECT_FALSE(SL::Bundle::view(data.data(), 8));
+    EXPECT_FALSE(SL::Bundle::view("not a bundle", 12));
+}
+
+TEST(Bundle, Mount)
+{
+    const auto path = bundlePath("sl_test_mount.slb");
+    ASSERT_TRUE(SL::Bundle::pack(LUA_FILE_DIR "/bundle", path));
+    auto bundle = SL::Bundle::open(path);
+    ASSERT_TRUE(bundle);
+
+    auto runtime = SL::Runtime::fromBuffer("function Shout(s) return require('util.strings').shout(s) end", "inline");
+    ASSERT_TRUE(runtime);
+    runtime.mount(*bundle);
+
+    // The runtime keeps the mapping once the bundle is moved and destroyed
+    {
+        const auto moved = std::move(*bundle);
+        EXPECT_GT(moved.size(), 0u);
+    }
+
+    const auto res = runtime.runFunction<SL::String>("Shout", SL::String("hey"));
+    ASSERT_TRUE(res);
+    EXPECT_EQ(std::get<0>(*res), "HEY!");
+    std::filesystem::remove(path);
+}
+
+TEST(Bundle, Errors)
+{
+    {
+        const auto res = SL::Bundle::open(bundlePath("sl_test_missing.slb"));
+        ASSERT_FALSE(res);
+        EXPECT_EQ(res.error().code(), SL::Bundle::ErrorCode::FileError);
+    }
+    {
+        const auto bundle = SL::Bundle::view(nullptr, 0);
+        EXPECT_FALSE(bundle);
+    }
+    {
+        auto runtime = SL::Runtime::fromBuffer("this is not lua", "broken");
+        EXPECT_FALSE(runtime);
+    }
+}
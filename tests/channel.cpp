@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <thread>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(Channel, BetweenRuntimes)
+{
+    auto sender = SL::Runtime::create<SL::Lib::Channel, SL::Lib::Buffer>(LUA_FILE_DIR "/channel.lua");
+    auto receiver = SL::Runtime::create<SL::Lib::Channel, SL::Lib::Buffer>(LUA_FILE_DIR "/channel.lua");
+    ASSERT_TRUE(sender);
+    ASSERT_TRUE(receiver);
+
+    // Held here so the named channel outlives the sender's
+    const auto channel = SL::Channel::open("test.between", 8);
+
+    const auto sent = sender.runFunction<int64_t>("Send", std::string("test.between"));
+    ASSERT_TRUE(sent) << sent.error().message();
+    EXPECT_EQ(std::get<0>(*sent), 8);
+
+    const auto res = receiver.runFunction<int64_t, SL::String, int64_t, double, bool>("Recv", std::string("test.between"));
+    ASSERT_TRUE(res) << res.error().message();
+
+    const auto [integer, string, table, real, empty] = *res;
+    EXPECT_EQ(integer, 42);
+    EXPECT_EQ(string, "text");
+    EXPECT_EQ(table, 14);
+    EXPECT_EQ(real, 2.5);
+    EXPECT_FALSE(empty);
+}
+
+TEST(Channel, Cpp)
+{
+    SL::Channel channel(4);
+    EXPECT_EQ(channel.capacity(), 4);
+
+    SL::Table table;
+    table.set("name", SL::String("sl"));
+    table.set("count", int64_t(3));
+
+    EXPECT_TRUE(channel.try_send(int64_t(7)));
+    EXPECT_TRUE(channel.try_send(std::string("hello")));
+    EXPECT_TRUE(channel.try_send(table));
+    EXPECT_TRUE(channel.try_send(true));
+
+    const auto full = channel.try_send(1.5);
+    ASSERT_FALSE(full);
+    EXPECT_EQ(full.error().code(), SL::Channel::ErrorCode::Full);
+
+    const auto integer = channel.try_recv<int64_t>();
+    ASSERT_TRUE(integer);
+    EXPECT_EQ(*integer, 7);
+
+    const auto string = channel.try_recv<std::string>();
+    ASSERT_TRUE(string);
+    EXPECT_EQ(*string, "hello");
+
+    const auto received = channel.try_recv<SL::Table>();
+    ASSERT_TRUE(received);
+    EXPECT_EQ(received->get<SL::String>("name"), "sl");
+    EXPECT_EQ(received->get<int64_t>("count"), 3);
+
+    // The value is taken even if it doesn't match
+    const auto mismatch = channel.try_recv<SL::String>();
+    ASSERT_FALSE(mismatch);
+    EXPECT_EQ(mismatch.error().code(), SL::Channel::ErrorCode::TypeMismatch);
+
+    const auto empty = channel.try_recv<int64_t>();
+    ASSERT_FALSE(empty);
+    EXPECT_EQ(empty.error().code(), SL::Channel::ErrorCode::Empty);
+
+    EXPECT_TRUE(channel.try_send(int64_t(1)));
+    channel.close();
+    EXPECT_EQ(channel.try_send(int64_t(2)).error().code(), SL::Channel::ErrorCode::Closed);
+
+    const auto left = channel.recv<int64_t>();
+    ASSERT_TRUE(left);
+    EXPECT_EQ(*left, 1);
+    EXPECT_EQ(channel.recv<int64_t>().error().code(), SL::Channel::ErrorCode::Closed);
+}
+
+TEST(Channel, Lua)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Channel, SL::Lib::Buffer>(LUA_FILE_DIR "/channel.lua");
+
+    auto channel = std::make_shared<SL::Channel>(16);
+    const auto filled = lua.runFunction<int64_t>("Fill", channel);
+    ASSERT_TRUE(filled) << filled.error().message();
+    EXPECT_EQ(std::get<0>(*filled), 16);
+    EXPECT_EQ(*channel->try_recv<int64_t>(), 0);
+
+    // The metatable, and with it __gc, is hidden from scripts
+    const auto metatable = lua.runFunction<SL::String>("Metatable", channel);
+    ASSERT_TRUE(metatable) << metatable.error().message();
+    EXPECT_EQ(std::get<0>(*metatable), "channel");
+
+    // Buffers are handed over with their owner, the bytes are never copied
+    auto echo = std::make_shared<SL::Channel>(2);
+    auto bytes = std::make_shared<std::string>("shared bytes");
+    EXPECT_TRUE(echo->try_send(SL::Lib::Buffer::View{ bytes->data(), bytes->size(), bytes }));
+
+    const auto res = lua.runFunction<SL::String>("Echo", echo);
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_EQ(std::get<0>(*res), "shared bytes");
+
+    const auto back = echo->try_recv<SL::Lib::Buffer::View>();
+    ASSERT_TRUE(back) << back.error().message();
+    EXPECT_EQ(back->data, bytes->data());
+    EXPECT_EQ(back->size, bytes->size());
+
+    const auto coroutines = lua.runFunction<SL::String>("Coroutines");
+    ASSERT_TRUE(coroutines) << coroutines.error().message();
+    EXPECT_EQ(std::get<0>(*coroutines), "s1,s2,r1,r2,s3,s4,r3,r4,s5,r5,closed");
+}
+
+TEST(Channel, Threads)
+{
+    constexpr int Producers = 3, Consumers = 3, PerProducer = 20000;
+
+    // Small enough that both sides block
+    const auto channel = SL::Channel::open("test.threads", 64);
+
+    std::vector<std::thread> producers, consumers;
+    std::vector<std::pair<int64_t, int64_t>> results(Consumers);
+    for (int c = 0; c < Consumers; c++)
+        consumers.emplace_back([&results, c]()
+        {
+            auto lua = SL::Runtime::create<SL::Lib::Channel, SL::Lib::Buffer>(LUA_FILE_DIR "/channel.lua");
+            const auto res = lua.runFunction<int64_t, int64_t>("Consume", std::string("test.threads"));
+            if (res) results[c] = { std::get<0>(*res), std::get<1>(*res) };
+        });
+    for (int p = 0; p < Producers; p++)
+        producers.emplace_back([p]()
+        {
+            auto lua = SL::Runtime::create<SL::Lib::Channel, SL::Lib::Buffer>(LUA_FILE_DIR "/channel.lua");
+            lua.runFunction<>("Produce", std::string("test.threads"), int64_t(p * PerProducer + 1), int64_t((p + 1) * PerProducer));
+        });
+
+    for (auto& t : producers) t.join();
+    channel->close();
+    for (auto& t : consumers) t.join();
+
+    int64_t sum = 0, count = 0;
+    for (const auto& [s, c] : results)
+    {
+        sum += s;
+        count += c;
+    }
+
+    constexpr int64_t Total = Producers * PerProducer;
+    EXPECT_EQ(count, Total);
+    EXPECT_EQ(sum, Total * (Total + 1) / 2);
+}
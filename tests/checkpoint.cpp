@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <atomic>
+#include <thread>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    void expectClean(SL::Runtime& runtime)
+    {
+        const auto res = runtime.template runFunction<SL::Boolean, int64_t, int64_t, SL::String, SL::Boolean>("Peek");
+        ASSERT_TRUE(res);
+        const auto [ no_scratch, requests, limit, print, no_module ] = *res;
+        EXPECT_TRUE(no_scratch);
+        EXPECT_EQ(requests, 0);
+        EXPECT_EQ(limit, 3);
+        EXPECT_EQ(print, "function");
+        EXPECT_TRUE(no_module);
+    }
+}
+
+TEST(Checkpoint, Reset)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/checkpoint.lua");
+    ASSERT_TRUE(runtime);
+    runtime.checkpoint();
+
+    for (int i = 0; i < 3; i++)
+    {
+        const auto res = runtime.template runFunction<int64_t>("Handle", int64_t(10));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), 1);
+
+        runtime.reset();
+        expectClean(runtime);
+    }
+}
+
+TEST(Checkpoint, SetGlobalAfterCheckpoint)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/checkpoint.lua");
+    ASSERT_TRUE(runtime);
+
+    runtime.setGlobal<int64_t>("Requests", 5);
+    runtime.checkpoint();
+
+    runtime.setGlobal<int64_t>("Requests", 7);
+    runtime.setGlobal<SL::String>("Added", "value");
+    runtime.reset();
+
+    EXPECT_EQ(*runtime.getGlobal<int64_t>("Requests"), 5);
+    EXPECT_FALSE(runtime.getGlobal<SL::String>("Added"));
+}
+
+TEST(Checkpoint, Pool)
+{
+    SL::RuntimePool pool([]() { return SL::Runtime(LUA_FILE_DIR "/checkpoint.lua"); }, 2);
+    EXPECT_EQ(pool.idle(), 2);
+
+    {
+        auto a = pool.acquire();
+        auto b = pool.acquire();
+        auto c = pool.acquire();
+        EXPECT_EQ(pool.idle(), 0);
+
+        EXPECT_TRUE(a->runFunction<int64_t>("Handle", int64_t(1)));
+        EXPECT_TRUE(c->runFunction<int64_t>("Handle", int64_t(1)));
+    }
+    EXPECT_EQ(pool.idle(), 3);
+
+    for (int i = 0; i < 3; i++) expectClean(*pool.acquire());
+}
+
+TEST(Checkpoint, PoolThreads)
+{
+    SL::RuntimePool pool([]() { return SL::Runtime(LUA_FILE_DIR "/checkpoint.lua"); });
+
+    std::vector<std::thread> threads;
+    std::atomic<int> failures = 0;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&]()
+        {
+            for (int i = 0; i < 50; i++)
+            {
+                auto runtime = pool.acquire();
+                const auto res = runtime->runFunction<int64_t>("Handle", int64_t(i));
+                if (!res || std::get<0>(*res) != 1) failures++;
+            }
+        });
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(failures, 0);
+    EXPECT_LE(pool.idle(), 4);
+}
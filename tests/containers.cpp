@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+using Weights = std::unordered_map<SL::String, SL::Number>;
+
+TEST(Containers, Sequences)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/containers.lua");
+    EXPECT_TRUE(runtime);
+
+    const auto names = runtime.getGlobal<std::vector<SL::String>>("Names");
+    ASSERT_TRUE(names);
+    EXPECT_EQ(*names, (std::vector<SL::String>{ "ada", "grace", "linus" }));
+
+    const auto point = runtime.getGlobal<std::array<SL::Number, 2>>("Point");
+    ASSERT_TRUE(point);
+    EXPECT_FLOAT_EQ((*point)[1], 4.f);
+
+    const auto record = runtime.getGlobal<std::tuple<SL::String, SL::Number, SL::Boolean>>("Record");
+    ASSERT_TRUE(record);
+    EXPECT_EQ(std::get<0>(*record), "id");
+    EXPECT_TRUE(std::get<2>(*record));
+
+    const auto swapped = runtime.template runFunction<std::pair<SL::Number, SL::String>>("Swap", std::pair<SL::String, SL::Number>{ "a", 1.f });
+    ASSERT_TRUE(swapped);
+    EXPECT_FLOAT_EQ(std::get<0>(*swapped).first, 1.f);
+    EXPECT_EQ(std::get<0>(*swapped).second, "a");
+}
+
+TEST(Containers, Maps)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/containers.lua");
+    EXPECT_TRUE(runtime);
+
+    const auto weights = runtime.getGlobal<Weights>("Weights");
+    ASSERT_TRUE(weights);
+    EXPECT_EQ(weights->size(), 2u);
+    EXPECT_FLOAT_EQ(weights->at("iron"), 7.5f);
+
+    const auto ordered = runtime.getGlobal<std::map<SL::Number, SL::String>>("Ordered");
+    ASSERT_TRUE(ordered);
+    EXPECT_EQ(ordered->rbegin()->second, "ten");
+
+    Weights pushed;
+    for (int i = 0; i < 100; i++) pushed["key" + std::to_string(i)] = static_cast<SL::Number>(i);
+    const auto count = runtime.template runFunction<SL::Number>("Count", pushed);
+    ASSERT_TRUE(count);
+    EXPECT_FLOAT_EQ(std::get<0>(*count), 100.f);
+}
+
+TEST(Containers, Variants)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/containers.lua");
+    EXPECT_TRUE(runtime);
+
+    using Value = std::variant<SL::Number, SL::String, std::vector<SL::Number>>;
+    const auto mixed = runtime.getGlobal<std::vector<Value>>("Mixed");
+    ASSERT_TRUE(mixed);
+    ASSERT_EQ(mixed->size(), 3u);
+    EXPECT_EQ((*mixed)[0].index(), 0u);
+    EXPECT_EQ(std::get<SL::String>((*mixed)[1]), "two");
+    EXPECT_EQ(std::get<std::vector<SL::Number>>((*mixed)[2]).size(), 1u);
+
+    const auto wrong = runtime.getGlobal<std::variant<SL::Number, SL::Boolean>>("Names");
+    EXPECT_FALSE(wrong);
+    EXPECT_EQ(wrong.error().message(), "expected number or boolean, got table");
+}
+
+TEST(Containers, Errors)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/containers.lua");
+    EXPECT_TRUE(runtime);
+
+    const auto weights = runtime.getGlobal<Weights>("BadWeights");
+    EXPECT_FALSE(weights);
+    EXPECT_EQ(weights.error().message(), "wood: expected number, got string");
+
+    const auto point = runtime.getGlobal<std::array<SL::Number, 2>>("ShortPoint");
+    EXPECT_FALSE(point);
+    EXPECT_EQ(point.error().message(), "expected 2 elements, got 1");
+
+    // Nothing is left behind on the stack by failed reads
+    for (int i = 0; i < 1000; i++) EXPECT_FALSE(runtime.getGlobal<Weights>("BadWeights"));
+    EXPECT_TRUE(runtime.getGlobal<std::vector<SL::String>>("Names"));
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+// The scripts of tests/lua-files/bundle are embedded by sl_embed_scripts
+TEST(Embedded, Registry)
+{
+    EXPECT_EQ(SL::Embedded::count(), 3);
+
+    std::string_view chunk;
+    ASSERT_TRUE(SL::Embedded::find("util.strings", chunk));
+    EXPECT_EQ(chunk[0], '\x1b');
+    EXPECT_TRUE(SL::Embedded::find("util", chunk));
+    EXPECT_FALSE(SL::Embedded::find("util.init", chunk));
+}
+
+TEST(Embedded, Run)
+{
+    auto runtime = SL::Runtime::fromEmbedded("main");
+    ASSERT_TRUE(runtime);
+
+    {
+        const auto res = runtime.getGlobal<SL::String>("Greeting");
+        ASSERT_TRUE(res);
+        EXPECT_EQ(*res, "HI!");
+    }
+    {
+        const auto res = runtime.runFunction<int64_t>("Add", int64_t(2), int64_t(3));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), 5);
+    }
+    {
+        const auto res = runtime.runFunction<SL::Boolean, SL::String>("RequireMissing");
+        ASSERT_TRUE(res);
+        EXPECT_FALSE(std::get<0>(*res));
+        EXPECT_NE(std::get<1>(*res).find("no embedded module 'missing'"), std::string::npos);
+    }
+
+    EXPECT_FALSE(SL::Runtime::fromEmbedded("missing"));
+}
+
+TEST(Embedded, Compile)
+{
+    std::string bytecode, error;
+    EXPECT_TRUE(SL::Embedded::compile("return 1", "=inline", bytecode, error));
+    EXPECT_EQ(bytecode[0], '\x1b');
+
+    EXPECT_FALSE(SL::Embedded::compile("return return", "=inline", bytecode, error));
+    EXPECT_NE(error.find("inline"), std::string::npos);
+}
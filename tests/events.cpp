@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <thread>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(Events, Dispatch)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/events.lua");
+    EXPECT_TRUE(runtime);
+    EXPECT_TRUE(runtime.enableEvents());
+    EXPECT_TRUE(runtime.runFunction<>("Subscribe"));
+
+    auto& events = runtime.events();
+    EXPECT_TRUE(events.push("add", 2.f));
+    EXPECT_TRUE(events.push("tag", "a", true));
+    EXPECT_TRUE(events.push("add", 3));
+    EXPECT_TRUE(events.push("tag", std::string("b"), false));
+    EXPECT_TRUE(events.push("tag", "c", true));
+    EXPECT_TRUE(events.push("unhandled"));
+
+    const auto res = runtime.dispatchEvents();
+    EXPECT_TRUE(res);
+    EXPECT_EQ(*res, 6);
+
+    // Both the per-event and the batch handler of "add" ran
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Total"), 10.f);
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Batches"), 1.f);
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Hits"), 3.f);
+    EXPECT_EQ(*runtime.getGlobal<SL::String>("Order"), "ac");
+
+    const auto empty = runtime.dispatchEvents();
+    EXPECT_TRUE(empty);
+    EXPECT_EQ(*empty, 0);
+}
+
+TEST(Events, Unsubscribe)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/events.lua");
+    EXPECT_TRUE(runtime.enableEvents());
+    EXPECT_TRUE(runtime.runFunction<>("Subscribe"));
+
+    const auto res = runtime.runFunction<SL::Boolean>("Unsubscribe");
+    EXPECT_TRUE(res);
+    EXPECT_TRUE(std::get<0>(*res));
+
+    runtime.events().push("tag", "a", true);
+    EXPECT_TRUE(runtime.dispatchEvents());
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Hits"), 0.f);
+}
+
+TEST(Events, HandlerError)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/events.lua");
+    EXPECT_TRUE(runtime.enableEvents());
+    EXPECT_TRUE(runtime.runFunction<>("Fail"));
+
+    EXPECT_TRUE(runtime.runFunction<>("Subscribe"));
+
+    // The events after the failing handler are still delivered
+    runtime.events().push("fail");
+    runtime.events().push("add", 1.f);
+    runtime.events().push("fail");
+    const auto res = runtime.dispatchEvents();
+    EXPECT_FALSE(res);
+    EXPECT_EQ(res.error().code(), SL::Runtime::ErrorCode::FunctionError);
+    EXPECT_NE(res.error().message().find("handler failed"), std::string::npos);
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Total"), 2.f);
+}
+
+TEST(Events, ConcurrentProducers)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/events.lua");
+    EXPECT_TRUE(runtime.enableEvents(1 << 14));
+    EXPECT_TRUE(runtime.runFunction<>("Subscribe"));
+
+    constexpr int Threads = 4, PerThread = 1000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < Threads; t++)
+        producers.emplace_back([&]()
+        {
+            for (int i = 0; i < PerThread; i++) runtime.events().push("add", 1.f);
+        });
+    for (auto& p : producers) p.join();
+
+    const auto res = runtime.dispatchEvents();
+    EXPECT_TRUE(res);
+    EXPECT_EQ(*res, Threads * PerThread);
+    EXPECT_EQ(runtime.events().dropped(), 0);
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Total"), static_cast<float>(2 * Threads * PerThread));
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Batches"), 1.f);
+}
+
+// Events of a type with fewer arguments than others don't see the arguments of earlier ones
+TEST(Events, BatchMissingArgs)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/events.lua");
+    EXPECT_TRUE(runtime.enableEvents());
+    EXPECT_TRUE(runtime.runFunction<>("SubscribePairs"));
+
+    auto& events = runtime.events();
+    EXPECT_TRUE(events.push("pair", 1, 2));
+    EXPECT_TRUE(events.push("pair", 3, 4));
+    EXPECT_TRUE(events.push("pair", 5, 6));
+    EXPECT_TRUE(runtime.dispatchEvents());
+    EXPECT_EQ(*runtime.getGlobal<SL::String>("Pairs"), "1.0:2.0 3.0:4.0 5.0:6.0 ");
+
+    EXPECT_TRUE(runtime.setGlobal<SL::String>("Pairs", ""));
+    EXPECT_TRUE(events.push("pair", 7));
+    EXPECT_TRUE(events.push("pair", 8, 9));
+    EXPECT_TRUE(events.push("pair", 10));
+    EXPECT_TRUE(runtime.dispatchEvents());
+    EXPECT_EQ(*runtime.getGlobal<SL::String>("Pairs"), "7.0:nil 8.0:9.0 10.0:nil ");
+
+    // A smaller batch doesn't see the rows of the larger one before it
+    EXPECT_TRUE(events.push("pair", 11, 12));
+    EXPECT_TRUE(runtime.dispatchEvents());
+    EXPECT_EQ(*runtime.getGlobal<int64_t>("PairRows"), 1);
+}
+
+// More batched types than the stack a C function starts with has room for their columns
+TEST(Events, ManyBatchedTypes)
+{
+    constexpr int64_t Types = 16;
+
+    SL::Runtime runtime(LUA_FILE_DIR "/events.lua");
+    EXPECT_TRUE(runtime.enableEvents());
+    EXPECT_TRUE(runtime.runFunction<>("SubscribeMany", Types));
+
+    auto& events = runtime.events();
+    for (int64_t t = 1; t <= Types; t++)
+        EXPECT_TRUE(events.push("many" + std::to_string(t), t, t, t, t));
+
+    const auto res = runtime.dispatchEvents();
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_EQ(*res, static_cast<std::size_t>(Types));
+
+    // Each event counted by both of its handlers
+    EXPECT_FLOAT_EQ(*runtime.getGlobal<SL::Number>("Sum"), static_cast<float>(2 * 4 * Types * (Types + 1) / 2));
+}
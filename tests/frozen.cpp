@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <thread>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    SL::Table items()
+    {
+        SL::Table stats;
+        stats.set("damage", int64_t(12));
+        stats.set("speed", 1.5);
+
+        SL::Table list;
+        list.set("1", int64_t(10));
+        list.set("2", int64_t(20));
+        list.set("3", int64_t(30));
+
+        SL::Table table;
+        table.set("name", SL::String("sword"));
+        table.set("flag", true);
+        table.set("stats", stats);
+        table.set("list", list);
+        return table;
+    }
+}
+
+TEST(Frozen, Cpp)
+{
+    const SL::FrozenTable frozen(items());
+    EXPECT_EQ(frozen.count(), 4);
+    EXPECT_EQ(frozen.size(), 0);
+    EXPECT_TRUE(frozen.has("name"));
+    EXPECT_FALSE(frozen.has("missing"));
+
+    EXPECT_EQ(frozen.get<std::string_view>("name"), "sword");
+    EXPECT_EQ(frozen.get<bool>("flag"), true);
+    EXPECT_FALSE(frozen.get<int64_t>("name"));
+
+    const auto stats = frozen.get<SL::FrozenTable>("stats");
+    ASSERT_TRUE(stats);
+    EXPECT_EQ(stats->get<int64_t>("damage"), 12);
+    EXPECT_EQ(stats->get<double>("speed"), 1.5);
+    EXPECT_EQ(*stats, *frozen.get<SL::FrozenTable>("stats"));
+
+    const auto list = frozen.get<SL::FrozenTable>("list");
+    ASSERT_TRUE(list);
+    EXPECT_EQ(list->size(), 3);
+    EXPECT_EQ(list->get<int64_t>(std::size_t(2)), 20);
+    EXPECT_EQ(list->get<int64_t>("3"), 30);
+    EXPECT_FALSE(list->get<int64_t>(std::size_t(4)));
+
+    EXPECT_GT(frozen.bytes(), 0);
+    EXPECT_EQ(SL::FrozenTable().count(), 0);
+}
+
+TEST(Frozen, Lua)
+{
+    auto lua = SL::Runtime(LUA_FILE_DIR "/frozen.lua");
+    ASSERT_TRUE(lua);
+    ASSERT_TRUE(lua.setGlobal("Items", SL::FrozenTable(items())));
+
+    const auto read = lua.runFunction<SL::String, int64_t, double, int64_t, int64_t, bool>("Read");
+    ASSERT_TRUE(read) << read.error().message();
+    const auto [name, damage, speed, length, second, flag] = *read;
+    EXPECT_EQ(name, "sword");
+    EXPECT_EQ(damage, 12);
+    EXPECT_EQ(speed, 1.5);
+    EXPECT_EQ(length, 3);
+    EXPECT_EQ(second, 20);
+    EXPECT_TRUE(flag);
+
+    const auto walk = lua.runFunction<SL::String, int64_t>("Walk");
+    ASSERT_TRUE(walk) << walk.error().message();
+    EXPECT_EQ(std::get<0>(*walk), "1=10,2=20,3=30");
+    EXPECT_EQ(std::get<1>(*walk), 4);
+
+    const auto same = lua.runFunction<bool, bool, bool>("Same");
+    ASSERT_TRUE(same) << same.error().message();
+    EXPECT_EQ(*same, std::make_tuple(true, true, true));
+
+    const auto write = lua.runFunction<bool, SL::String>("Write");
+    ASSERT_TRUE(write) << write.error().message();
+    EXPECT_FALSE(std::get<0>(*write));
+    EXPECT_NE(std::get<1>(*write).find("frozen"), std::string::npos);
+
+    // Nested tables go back to C++ and into Lua as handles too
+    const auto root = lua.getGlobal<SL::FrozenTable>("Items");
+    ASSERT_TRUE(root);
+    const auto nested = lua.runFunction<int64_t>("Nested", *root->get<SL::FrozenTable>("stats"));
+    ASSERT_TRUE(nested) << nested.error().message();
+    EXPECT_EQ(std::get<0>(*nested), 12);
+}
+
+// Functions read from Lua aren't kept, freezing leaves them out
+TEST(Frozen, FromLuaWithFunctions)
+{
+    auto lua = SL::Runtime(LUA_FILE_DIR "/frozen.lua");
+    ASSERT_TRUE(lua);
+
+    const auto mixed = lua.getGlobal<SL::Table>("Mixed");
+    ASSERT_TRUE(mixed);
+
+    const SL::FrozenTable frozen(*mixed);
+    EXPECT_EQ(frozen.count(), 2);
+    EXPECT_EQ(frozen.get<int64_t>("x"), 1);
+    EXPECT_FALSE(frozen.has("f"));
+
+    const auto nested = frozen.get<SL::FrozenTable>("nested");
+    ASSERT_TRUE(nested);
+    EXPECT_EQ(nested->count(), 1);
+    EXPECT_EQ(nested->get<int64_t>("y"), 2);
+}
+
+// A table under several keys is frozen once, and every key leads to the same node
+TEST(Frozen, Aliased)
+{
+    auto lua = SL::Runtime(LUA_FILE_DIR "/frozen.lua");
+    ASSERT_TRUE(lua);
+
+    const auto aliased = lua.getGlobal<SL::Table>("Aliased");
+    ASSERT_TRUE(aliased);
+
+    const SL::FrozenTable frozen(*aliased);
+    const auto from = frozen.get<SL::FrozenTable>("from");
+    const auto path = frozen.get<SL::FrozenTable>("path");
+    ASSERT_TRUE(from);
+    ASSERT_TRUE(path);
+    EXPECT_EQ(from->get<int64_t>("x"), 3);
+    EXPECT_EQ(*from, *frozen.get<SL::FrozenTable>("to"));
+    EXPECT_EQ(*from, *path->get<SL::FrozenTable>(std::size_t(1)));
+    EXPECT_EQ(*from, *path->get<SL::FrozenTable>(std::size_t(2)));
+}
+
+TEST(Frozen, Shared)
+{
+    const SL::FrozenTable frozen(items());
+
+    std::vector<SL::Runtime> runtimes;
+    for (int i = 0; i < 4; i++)
+    {
+        runtimes.push_back(SL::Runtime(LUA_FILE_DIR "/frozen.lua"));
+        ASSERT_TRUE(runtimes.back());
+        ASSERT_TRUE(runtimes.back().setGlobal("Items", frozen));
+    }
+
+    // Every state reads the same entries, from its own thread
+    std::vector<std::thread> threads;
+    std::vector<int64_t> totals(runtimes.size());
+    for (std::size_t i = 0; i < runtimes.size(); i++)
+        threads.emplace_back([&, i]()
+        {
+            const auto res = runtimes[i].runFunction<int64_t>("Sum", int64_t(2000));
+            totals[i] = res ? std::get<0>(*res) : -1;
+        });
+    for (auto& thread : threads) thread.join();
+
+    for (const auto total : totals) EXPECT_EQ(total, 2000 * (60 + 12));
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(Json, Decode)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Json>(LUA_FILE_DIR "/json.lua");
+    ASSERT_TRUE(lua);
+
+    const auto res = lua.runFunction<SL::String, SL::String, int64_t, bool, bool, SL::String, SL::String, SL::String>("Decode", std::string(
+        R"( { "name": "sl", "list": [1, 2, "three", null], "nested": { "flag": true },
+              "nothing": null, "real": 1.0, "escaped": "tab\there \"q\" \u00e9 \ud83d\ude00 \/" } )"));
+    ASSERT_TRUE(res) << res.error().message();
+
+    const auto [name, third, length, flag, nothing, integer, real, escaped] = *res;
+    EXPECT_EQ(name, "sl");
+    EXPECT_EQ(third, "three");
+    EXPECT_EQ(length, 4);
+    EXPECT_TRUE(flag);
+    EXPECT_TRUE(nothing);
+    EXPECT_EQ(integer, "integer");
+    EXPECT_EQ(real, "float");
+    EXPECT_EQ(escaped, "tab\there \"q\" \xc3\xa9 \xf0\x9f\x98\x80 /");
+}
+
+TEST(Json, Encode)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Json>(LUA_FILE_DIR "/json.lua");
+
+    const auto res = lua.runFunction<SL::String>("Encode");
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_EQ(std::get<0>(*res), R"([1,2.5,3.0,"a\"b\n\u0001",true,{"x":null},{},-0.125])");
+
+    const auto round = lua.runFunction<SL::String>("RoundTrip", std::string(R"([ 1e3, -7, 123456789012345, 0.1, "", [[]], {"a":[false]} ])"));
+    ASSERT_TRUE(round) << round.error().message();
+    EXPECT_EQ(std::get<0>(*round), R"([1000.0,-7,123456789012345,0.1,"",[{}],{"a":[false]}])");
+
+    // Digits beyond the 15 that always survive are only written when needed
+    const auto digits = lua.runFunction<SL::String>("RoundTrip", std::string("[0.30000000000000004, 0.3, 1e300, 5e-324]"));
+    ASSERT_TRUE(digits) << digits.error().message();
+    EXPECT_EQ(std::get<0>(*digits), "[0.30000000000000004,0.3,1e+300,4.94065645841247e-324]");
+
+    // Tables with holes or keys other than 1..n are objects
+    const auto mixed = lua.runFunction<SL::String, SL::String>("Mixed");
+    ASSERT_TRUE(mixed) << mixed.error().message();
+    EXPECT_EQ(std::get<1>(*mixed), R"({"10":"x"})");
+    EXPECT_EQ(std::get<0>(*mixed).front(), '{');
+}
+
+TEST(Json, Errors)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Json>(LUA_FILE_DIR "/json.lua");
+
+    const auto invalid = [&](const std::string& document)
+    {
+        const auto res = lua.runFunction<bool, SL::String>("Invalid", document);
+        EXPECT_TRUE(res) << res.error().message();
+        EXPECT_FALSE(std::get<0>(*res));
+        return std::get<1>(*res);
+    };
+
+    EXPECT_NE(invalid("[1, 2,]").find("unexpected character at position 7"), std::string::npos);
+    EXPECT_NE(invalid("{\"a\" 1}").find("expected ':' at position 6"), std::string::npos);
+    EXPECT_NE(invalid("[1] x").find("trailing"), std::string::npos);
+    EXPECT_NE(invalid("\"abc").find("unterminated string"), std::string::npos);
+    EXPECT_NE(invalid("\"\\x\"").find("invalid escape"), std::string::npos);
+    EXPECT_NE(invalid("01").find("trailing"), std::string::npos);
+    EXPECT_NE(invalid(std::string(1000, '[') + std::string(1000, ']')).find("nested too deep"), std::string::npos);
+
+    const auto encode = [&](const std::string& kind)
+    {
+        const auto res = lua.runFunction<bool, SL::String>("EncodeError", kind);
+        EXPECT_TRUE(res) << res.error().message();
+        EXPECT_FALSE(std::get<0>(*res));
+        return std::get<1>(*res);
+    };
+
+    EXPECT_NE(encode("function").find("function"), std::string::npos);
+    EXPECT_NE(encode("nan").find("NaN"), std::string::npos);
+    EXPECT_NE(encode("key").find("boolean"), std::string::npos);
+    EXPECT_NE(encode("cycle").find("nested"), std::string::npos);
+
+    // The state is still usable after errors
+    const auto res = lua.runFunction<SL::String>("Encode");
+    EXPECT_TRUE(res);
+}
+
+TEST(Json, Large)
+{
+    auto lua = SL::Runtime::create<SL::Lib::Json>(LUA_FILE_DIR "/json.lua");
+
+    const auto res = lua.runFunction<int64_t, int64_t, SL::String, int64_t>("Large", 1000);
+    ASSERT_TRUE(res) << res.error().message();
+
+    const auto [length, last, name, sum] = *res;
+    EXPECT_EQ(length, 1000);
+    EXPECT_EQ(last, 1000);
+    EXPECT_EQ(name, "item1000");
+    EXPECT_EQ(sum, 1000 * 1001 / 2);
+}
+
+TEST(Json, Table)
+{
+    std::string error;
+    const auto table = SL::Table::fromJson(R"({ "name": "sl", "list": [10, 2.5, null, "x"], "flag": false, "skip": null })", &error);
+    ASSERT_TRUE(table) << error;
+
+    EXPECT_EQ(table->get<SL::String>("name"), "sl");
+    EXPECT_FALSE(table->get<SL::Boolean>("flag"));
+    EXPECT_FALSE(table->hasValue("skip"));
+
+    const auto& list = table->get<SL::Table>("list");
+    EXPECT_EQ(list.get<int64_t>("1"), 10);
+    EXPECT_EQ(list.get<double>("2"), 2.5);
+    EXPECT_FALSE(list.hasValue("3"));
+    EXPECT_EQ(list.get<SL::String>("4"), "x");
+
+    auto array = SL::Table::fromJson(R"([1, [true, "a\"b"], {"k": -0.5}])");
+    ASSERT_TRUE(array);
+    EXPECT_EQ(array->toJson(), R"([1,[true,"a\"b"],{"k":-0.5}])");
+
+    // The table reads back the same through Lua
+    auto lua = SL::Runtime::create<SL::Lib::Json>(LUA_FILE_DIR "/json.lua");
+    const auto res = lua.runFunction<SL::String>("RoundTrip", array->toJson());
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_EQ(std::get<0>(*res), array->toJson());
+
+    EXPECT_FALSE(SL::Table::fromJson("42", &error));
+    EXPECT_NE(error.find("not an object or an array"), std::string::npos);
+    EXPECT_FALSE(SL::Table::fromJson("{\"a\": }", &error));
+    EXPECT_NE(error.find("position 7"), std::string::npos);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+struct MathLib : SL::Lib::Base
+{
+    MathLib() : Base("math", Functions)
+    {   }
+
+    static int scale(SL::State state)
+    {
+        const auto [ x ] = extractArgs<SL::Number>(state);
+        SL::CompileTime::TypeMap<SL::Number>::push(state, x * 3.f);
+        return 1;
+    }
+
+    static constexpr SL::Lib::Reg Functions[] = {
+        { "scale", scale },
+        { nullptr, nullptr }
+    };
+};
+
+struct CounterLib : SL::Lib::Base
+{
+    CounterLib(int64_t& count) : Base("Counter", Functions), _count(count)
+    {   }
+
+    int pushUpvalues(SL::State state) const override
+    {
+        SL::CompileTime::TypeMap<int64_t*>::push(state, &_count);
+        return 1;
+    }
+
+    static int increment(SL::State state)
+    {
+        (*upvalue<int64_t*>(state, 1))++;
+        return 0;
+    }
+
+    static int get(SL::State state)
+    {
+        SL::CompileTime::TypeMap<int64_t>::push(state, *upvalue<int64_t*>(state, 1));
+        return 1;
+    }
+
+    static constexpr SL::Lib::Reg Functions[] = {
+        { "increment", increment },
+        { "get",       get },
+        { nullptr,     nullptr }
+    };
+
+private:
+    int64_t& _count;
+};
+
+TEST(Libraries, FunctionTable)
+{
+    // Merged into the standard math table rather than replacing it
+    auto runtime = SL::Runtime::create<MathLib>(LUA_FILE_DIR "/libraries.lua");
+    EXPECT_TRUE(runtime);
+
+    {
+        const auto res = runtime.template runFunction<SL::Number>("Scale", 2.f);
+        ASSERT_TRUE(res);
+        EXPECT_FLOAT_EQ(std::get<0>(*res), 6.f);
+    }
+    {
+        const auto res = runtime.template runFunction<SL::Boolean>("HasFunction", SL::String("math"), SL::String("floor"));
+        ASSERT_TRUE(res);
+        EXPECT_TRUE(std::get<0>(*res));
+    }
+}
+
+TEST(Libraries, SharedUpvalues)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/libraries.lua");
+    EXPECT_TRUE(runtime);
+
+    int64_t count = 0;
+    CounterLib lib(count);
+    EXPECT_EQ(lib.count(), 2);
+    EXPECT_TRUE(runtime.registerLibrary(lib));
+
+    // The existing table keeps its fields
+    const auto res = runtime.template runFunction<int64_t>("Count", int64_t(5));
+    ASSERT_TRUE(res);
+    EXPECT_EQ(std::get<0>(*res), 15);
+    EXPECT_EQ(count, 5);
+}
+
+TEST(Libraries, MapLibrary)
+{
+    struct MapLib : SL::Lib::Base
+    {
+        MapLib() : Base("Mapped", { { "scale", MathLib::scale }, { "get", CounterLib::get } })
+        {   }
+    };
+
+    auto runtime = SL::Runtime::create<MapLib>(LUA_FILE_DIR "/libraries.lua");
+    EXPECT_TRUE(runtime);
+
+    MapLib lib;
+    EXPECT_EQ(lib.count(), 2);
+    EXPECT_EQ(lib.functions()[2].name, nullptr);
+
+    const auto res = runtime.template runFunction<SL::Boolean>("HasFunction", SL::String("Mapped"), SL::String("scale"));
+    ASSERT_TRUE(res);
+    EXPECT_TRUE(std::get<0>(*res));
+}
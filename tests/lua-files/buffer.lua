@@ -0,0 +1,67 @@
+function Slices(path)
+    local buf = assert(buffer.open(path))
+    local header = buf:sub(1, 4)
+    local results = {
+        #buf,
+        header:tostring(),
+        buf:sub(-5):tostring(),
+        buf:sub(10, 5):tostring(),
+        buf:sub(100):tostring(),
+        tostring(header:sub(2, 3))
+    }
+    return table.concat(results, "|")
+end
+
+function Reads(path)
+    local buf = assert(buffer.open(path))
+    return buf:u8(5), buf:u16(5), buf:u16(5, "big"), buf:u32(5), buf:i32(9), buf:f64(13), buf:f32(21, "big"), buf:u64(25)
+end
+
+function OutOfRange(path)
+    local buf = assert(buffer.open(path))
+    return pcall(buf.u32, buf, #buf - 2)
+end
+
+function Search(text, needle, init)
+    local buf = buffer.from(text)
+    local s, e = buf:find(needle, init)
+    return s or 0, e or 0, buf:count(needle)
+end
+
+function Lines(text)
+    local out = {}
+    for line in buffer.from(text):lines() do out[#out + 1] = "[" .. line:tostring() .. "]" end
+    return table.concat(out)
+end
+
+function Split(text, delimiter)
+    local out = {}
+    for field in buffer.from(text):split(delimiter) do out[#out + 1] = "[" .. field:tostring() .. "]" end
+    return table.concat(out)
+end
+
+function Missing(path)
+    local buf, message = buffer.open(path)
+    return buf == nil and message ~= nil
+end
+
+-- Sums the second column of a csv, returns the sum and the peak Lua heap in KB
+function SumColumn(buf)
+    collectgarbage()
+    local sum, peak = 0, 0
+    for line in buf:lines() do
+        local comma = line:find(",")
+        sum = sum + line:u8(comma + 1) - 48
+        local kb = collectgarbage("count")
+        if kb > peak then peak = kb end
+    end
+    return sum, peak
+end
+
+function Size(buf)
+    return #buf
+end
+
+function Metatable(buf)
+    return getmetatable(buf)
+end
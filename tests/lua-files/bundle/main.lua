@@ -0,0 +1,13 @@
+local strings = require("util.strings")
+local util = require("util")
+
+Greeting = strings.shout("hi")
+
+function Add(a, b)
+    return util.add(a, b)
+end
+
+function RequireMissing()
+    local ok, message = pcall(require, "missing")
+    return ok, message
+end
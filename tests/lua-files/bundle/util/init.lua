@@ -0,0 +1,7 @@
+local util = {}
+
+function util.add(a, b)
+    return a + b
+end
+
+return util
@@ -0,0 +1,7 @@
+local strings = {}
+
+function strings.shout(s)
+    return string.upper(s) .. "!"
+end
+
+return strings
@@ -0,0 +1,83 @@
+function Send(name)
+    local ch = channel.open(name)
+    assert(ch:try_send(42))
+    assert(ch:try_send("text"))
+    assert(ch:try_send({ a = 1, list = { 1, 2, 3 }, nested = { flag = true } }))
+    assert(ch:try_send(2.5))
+    return ch:capacity()
+end
+
+function Recv(name)
+    local ch = channel.open(name)
+    local _, i = ch:try_recv()
+    local _, s = ch:try_recv()
+    local _, t = ch:try_recv()
+    local _, d = ch:try_recv()
+    local empty = ch:try_recv()
+    return i, s, t.a + #t.list + (t.nested.flag and 10 or 0), d, empty
+end
+
+function Fill(ch)
+    local count = 0
+    while ch:try_send(count) do count = count + 1 end
+    return count
+end
+
+function Metatable(ch)
+    return getmetatable(ch)
+end
+
+-- Sends back what it receives, buffers keep their bytes
+function Echo(ch)
+    local _, value = ch:recv()
+    ch:send(value)
+    return tostring(value)
+end
+
+function Coroutines()
+    local ch = channel.new(2)
+    local log = {}
+    local producer = coroutine.wrap(function()
+        for i = 1, 5 do
+            ch:send(i)
+            log[#log + 1] = "s" .. i
+        end
+        ch:close()
+    end)
+    local consumer = coroutine.wrap(function()
+        while true do
+            local ok, v = ch:recv()
+            if not ok then
+                log[#log + 1] = "closed"
+                return
+            end
+            log[#log + 1] = "r" .. v
+        end
+    end)
+
+    consumer()
+    producer()
+    consumer()
+    producer()
+    consumer()
+    producer()
+    consumer()
+    return table.concat(log, ",")
+end
+
+function Produce(name, from, to)
+    local ch = channel.open(name)
+    for i = from, to do ch:send(i) end
+end
+
+function Consume(name)
+    local ch = channel.open(name)
+    local sum, count = 0, 0
+    while true do
+        local ok, v = ch:recv()
+        if not ok then break end
+        sum = sum + v
+        count = count + 1
+    end
+    return sum, count
+end
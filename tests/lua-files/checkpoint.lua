@@ -0,0 +1,15 @@
+Config = { limit = 3 }
+Requests = 0
+
+function Handle(n)
+    Requests = Requests + 1
+    Scratch = n
+    Config = { limit = n }
+    print = nil
+    package.loaded.scratch = {}
+    return Requests
+end
+
+function Peek()
+    return Scratch == nil, Requests, Config.limit, type(print), package.loaded.scratch == nil
+end
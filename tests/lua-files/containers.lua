@@ -0,0 +1,18 @@
+Names = { "ada", "grace", "linus" }
+Weights = { iron = 7.5, wood = 0.5 }
+Ordered = { [1] = "one", [2] = "two", [10] = "ten" }
+Point = { 3, 4 }
+Record = { "id", 12, true }
+Mixed = { 1, "two", { 3 } }
+BadWeights = { iron = 7.5, wood = "light" }
+ShortPoint = { 1 }
+
+function Count(t)
+    local n = 0
+    for _ in pairs(t) do n = n + 1 end
+    return n
+end
+
+function Swap(pair)
+    return { pair[2], pair[1] }
+end
@@ -0,0 +1,60 @@
+Total = 0
+Hits = 0
+Order = ""
+Batches = 0
+
+function Subscribe()
+    Events.subscribe("add", function(value)
+        Total = Total + value
+    end)
+
+    Events.subscribe("tag", function(name, flag)
+        if flag then Order = Order .. name end
+    end)
+
+    Events.subscribe("tag", Count)
+
+    Events.subscribeBatch("add", function(n, values)
+        Batches = Batches + 1
+        for i = 1, n do
+            Total = Total + values[i]
+        end
+    end)
+end
+
+function Count()
+    Hits = Hits + 1
+end
+
+function Unsubscribe()
+    return Events.unsubscribe("tag", Count)
+end
+
+function Fail()
+    Events.subscribe("fail", function()
+        error("handler failed")
+    end)
+end
+
+function SubscribePairs()
+    Pairs = ""
+    Events.subscribeBatch("pair", function(n, xs, ys)
+        PairRows = #xs
+        for i = 1, n do
+            Pairs = Pairs .. tostring(xs[i]) .. ":" .. tostring(ys[i]) .. " "
+        end
+    end)
+end
+
+-- Every type has a batch handler, so each one keeps its columns on the stack while dispatching
+function SubscribeMany(types)
+    Sum = 0
+    for t = 1, types do
+        Events.subscribe("many" .. t, function(a, b, c, d)
+            Sum = Sum + a + b + c + d
+        end)
+        Events.subscribeBatch("many" .. t, function(n, as, bs, cs, ds)
+            for i = 1, n do Sum = Sum + as[i] + bs[i] + cs[i] + ds[i] end
+        end)
+    end
+end
@@ -0,0 +1,38 @@
+function Read()
+    return Items.name, Items.stats.damage, Items.stats.speed, #Items.list, Items.list[2], Items.flag
+end
+
+-- Keys of the array part come first, in order
+function Walk()
+    local order, keys = {}, 0
+    for k, v in pairs(Items.list) do order[#order + 1] = tostring(k) .. "=" .. tostring(v) end
+    for k in pairs(Items) do keys = keys + 1 end
+    return table.concat(order, ","), keys
+end
+
+function Same()
+    return Items.stats == Items.stats and Items.stats ~= Items.list, Items.missing == nil, Items[10] == nil
+end
+
+function Write()
+    local ok, err = pcall(function() Items.name = "other" end)
+    return ok, err
+end
+
+function Nested(items)
+    return items.damage
+end
+
+function Sum(rounds)
+    local total = 0
+    for _ = 1, rounds do
+        for i = 1, #Items.list do total = total + Items.list[i] end
+        total = total + Items.stats.damage
+    end
+    return total
+end
+
+Mixed = { x = 1, f = function() end, nested = { g = print, y = 2 } }
+
+local point = { x = 3 }
+Aliased = { from = point, to = point, path = { point, point } }
@@ -0,0 +1,49 @@
+function Decode(s)
+    local v = json.decode(s)
+    return v.name, v.list[3], #v.list, v.nested.flag, v.nothing == json.null, math.type(v.list[1]), math.type(v.real), v.escaped
+end
+
+function Encode()
+    return json.encode({ 1, 2.5, 3.0, "a\"b\n\1", true, { x = json.null }, {}, -0.125 })
+end
+
+function RoundTrip(s)
+    return json.encode(json.decode(s))
+end
+
+function Invalid(s)
+    local ok, err = pcall(json.decode, s)
+    return ok, tostring(err)
+end
+
+function EncodeError(kind)
+    local value
+    if kind == "function" then value = { f = print }
+    elseif kind == "nan" then value = { 0 / 0 }
+    elseif kind == "key" then value = { [true] = 1 }
+    else
+        value = {}
+        value.self = value
+    end
+
+    local ok, err = pcall(json.encode, value)
+    return ok, tostring(err)
+end
+
+-- Larger than a batch of elements on the stack
+function Large(n)
+    local list, object = {}, {}
+    for i = 1, n do
+        list[i] = { i = i, name = "item" .. i }
+        object["k" .. i] = i
+    end
+
+    local back = json.decode(json.encode({ list = list, object = object }))
+    local sum = 0
+    for k, v in pairs(back.object) do sum = sum + v end
+    return #back.list, back.list[n].i, back.list[n].name, sum
+end
+
+function Mixed()
+    return json.encode({ [1] = "a", [2] = "b", [4] = "d" }), json.encode({ [10] = "x" })
+end
@@ -0,0 +1,18 @@
+Counter = {
+    start = 10
+}
+
+function Scale(x)
+    return math.scale(x)
+end
+
+function Count(n)
+    for i = 1, n do
+        Counter.increment()
+    end
+    return Counter.get() + Counter.start
+end
+
+function HasFunction(table, name)
+    return type(_G[table][name]) == "function"
+end
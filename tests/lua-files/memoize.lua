@@ -0,0 +1,29 @@
+Calls = 0
+Bonus = 1
+
+function Score(a, b)
+    Calls = Calls + 1
+    return a * 10 + b + Bonus
+end
+
+function Weight(t)
+    Calls = Calls + 1
+    return t.a + t.b * 2
+end
+
+function Sum(values)
+    Calls = Calls + 1
+    local sum = 0
+    for _, v in ipairs(values) do sum = sum + v end
+    return sum
+end
+
+function GetCalls() return Calls end
+function SetBonus(value) Bonus = value end
+
+function Redefine()
+    Score = function(a, b)
+        Calls = Calls + 1
+        return a + b
+    end
+end
@@ -0,0 +1,17 @@
+Entity = {
+    id = 1099511627777,
+    health = 100,
+    speed = 2.5
+}
+
+function NextId(id)
+    return id + 1
+end
+
+function Mask(flags, bit)
+    return flags | (1 << bit)
+end
+
+function TypeOf(t, key)
+    return math.type(t[key])
+end
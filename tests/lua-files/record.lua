@@ -0,0 +1,16 @@
+Log = {}
+Scale = 1
+
+function Add(name, value, options)
+    local entry = name .. "=" .. value * Scale
+    if options then entry = entry .. "@" .. options.unit .. options.position.x end
+    Log[#Log + 1] = entry
+end
+
+function Fail()
+    error("failed")
+end
+
+function Describe()
+    return table.concat(Log, ",")
+end
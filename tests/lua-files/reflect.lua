@@ -0,0 +1,38 @@
+Unit = {
+    name = "archer",
+    position = { x = 1.5, y = -2 },
+    tags = { "ranged", "cheap" },
+    path = { { x = 0, y = 0 }, { x = 1, y = 1 } },
+    speed = 3
+}
+
+Resting = {
+    name = "farmer",
+    position = { x = 0, y = 0 },
+    tags = { },
+    path = { }
+}
+
+BadField = {
+    name = "broken",
+    position = { x = 1, y = "up" },
+    tags = { },
+    path = { }
+}
+
+BadElement = {
+    name = "broken",
+    position = { x = 1, y = 2 },
+    tags = { },
+    path = { { x = 0, y = 0 }, { x = 1 } }
+}
+
+function Describe(unit)
+    return unit.name .. " at " .. unit.position.x .. "," .. unit.position.y .. " with " .. #unit.tags .. " tags"
+end
+
+function Move(unit, dx)
+    unit.position.x = unit.position.x + dx
+    unit.speed = nil
+    return unit
+end
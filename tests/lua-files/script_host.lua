@@ -0,0 +1,52 @@
+Count = 0
+
+function Increment(n)
+    Count = Count + n
+    return Count
+end
+
+function Shout(s)
+    return string.upper(s) .. "!"
+end
+
+function Leak()
+    _G.LeakedThroughG = true
+    LeakedGlobal = true
+end
+
+function HasLeaked()
+    return LeakedThroughG ~= nil or LeakedGlobal ~= nil
+end
+
+function Scale(x)
+    return host.scale(x)
+end
+
+-- Each attempt to change a shared library, none of them may succeed
+function Tamper()
+    local attempts = {
+        function() string.upper = function() return "tampered" end end,
+        function() table.insert = nil end,
+        function() rawset(string, "upper", nil) end,
+        function() setmetatable(_ENV, nil) end,
+        function() package.loaded.string.upper = nil end,
+        function() require("string").upper = nil end,
+        function() load("string.upper = nil")() end,
+        function() getmetatable("").__index.upper = nil end,
+    }
+
+    local changed = 0
+    for _, attempt in ipairs(attempts) do
+        if pcall(attempt) then changed = changed + 1 end
+    end
+
+    -- Shadowing a library stays local to the script
+    string = { upper = function() return "mine" end }
+    return changed, getmetatable(_ENV) == false and debug == nil
+end
+
+function Libraries()
+    local count = 0
+    for _ in pairs(table) do count = count + 1 end
+    return count, #package.searchers, tostring(string.format("%d", 3))
+end
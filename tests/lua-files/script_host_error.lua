@@ -0,0 +1 @@
+error("failed while loading")
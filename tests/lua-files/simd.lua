@@ -0,0 +1,62 @@
+function Elementwise(kind)
+    local a = simd.from({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 }, kind)
+    local b = simd.from({ 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 }, kind)
+    local dst = simd.new(#a, kind)
+
+    simd.add(dst, a, b)
+    for i = 1, #dst do
+        if dst[i] ~= 12 then return false end
+    end
+
+    simd.mul(dst, a, b)
+    if dst[1] ~= 11 or dst[6] ~= 36 then return false end
+
+    simd.fma(dst, a, b, a)
+    if dst[2] ~= 22 or dst[11] ~= 22 then return false end
+
+    simd.lerp(dst, a, b, 0.5)
+    for i = 1, #dst do
+        if dst[i] ~= 6 then return false end
+    end
+
+    simd.clamp(dst, a, 3, 8)
+    return dst[1] == 3 and dst[5] == 5 and dst[11] == 8
+end
+
+function Reduce(kind, op)
+    local a = simd.new(37, kind)
+    for i = 1, #a do a[i] = i end
+
+    simd.axpy(2, a, a)
+    if op == "dot" then return simd.dot(a, a) end
+    return simd[op](a)
+end
+
+function ReduceEmpty()
+    local empty = simd.from({})
+    return simd.min(empty) == nil and simd.max(empty) == nil and simd.sum(empty) == 0
+end
+
+function Permute()
+    local src = simd.from({ 10, 20, 30, 40 })
+    local idx = simd.from({ 4, 1, 3, 2 })
+    local dst = simd.new(4)
+
+    simd.gather(dst, src, idx)
+    if dst[1] ~= 40 or dst[2] ~= 10 then return false end
+
+    simd.scatter(dst, src, idx)
+    local t = dst:totable()
+    return t[1] == 20 and t[2] == 40 and t[3] == 30 and t[4] == 10
+end
+
+function Mismatch()
+    return pcall(simd.add, simd.new(2), simd.new(3), simd.new(2))
+end
+
+-- The byte size of the buffer would wrap around
+function TooLarge()
+    local ok, err = pcall(simd.new, 2^62, "f64")
+    local ok_max = pcall(simd.new, math.maxinteger, "f32")
+    return ok or ok_max, err
+end
@@ -0,0 +1,27 @@
+Config = { name = "soak", sizes = { 1, 2, 3 }, nested = { depth = { value = 1 } } }
+
+function Add(a, b)
+    return a + b
+end
+
+function Name()
+    return "not a number"
+end
+
+function Fail()
+    error("failing on purpose")
+end
+
+function Many()
+    return 1, 2, 3
+end
+
+function CallLib(t)
+    Stack.bump()
+    return Stack.sum(t, 2)
+end
+
+function Collect()
+    collectgarbage("collect")
+    collectgarbage("collect")
+end
@@ -0,0 +1,23 @@
+function Arith(a, b)
+    return a * b + 1
+end
+
+function HasGlobal(name)
+    return rawget(_G, name) ~= nil
+end
+
+function Floor(x)
+    return math.floor(x)
+end
+
+function RequireType()
+    return type(require)
+end
+
+function RequireTable()
+    return require("table").concat({ "a", "b" }, ",")
+end
+
+function Upper(s)
+    return s:upper()
+end
@@ -0,0 +1,50 @@
+function Append()
+    local sb = strbuf.new(16)
+    sb:append("a", 1, "b", 2.5):append():append("-", -7)
+    return sb:tostring(), #sb
+end
+
+function Appendf()
+    local sb = strbuf.new()
+    sb:appendf("%d|%5.2f|%-4s|%x|%c|%%|%s|%g|%03i", 42, 3.14159, "ab", 255, 65, true, 1e20, 7)
+    return tostring(sb)
+end
+
+function RepJoin()
+    local sb = strbuf.new()
+    sb:rep("ab", 3, ","):append(";"):rep("x", 0):join({ "p", 1, "q", 2 }, "/"):append(";"):join({ "a", "b", "c", "d" }, "", 2, 3)
+    return sb:tostring()
+end
+
+function Clear()
+    local sb = strbuf.new():append("abc")
+    sb:clear():reserve(1024):append("d")
+    return sb:tostring()
+end
+
+function Errors(kind)
+    local sb = strbuf.new()
+    local ok, err
+    if kind == "append" then ok, err = pcall(sb.append, sb, "a", {})
+    elseif kind == "format" then ok, err = pcall(sb.appendf, sb, "%q", "a")
+    elseif kind == "argument" then ok, err = pcall(sb.appendf, sb, "%d", "x")
+    elseif kind == "new" then ok, err = pcall(strbuf.new, 2^62)
+    elseif kind == "reserve" then ok, err = pcall(sb.reserve, sb, 2^60)
+    elseif kind == "rep" then ok, err = pcall(sb.rep, sb, "abcdefgh", 2^58)
+    else ok, err = pcall(sb.join, sb, { "a", true }) end
+    return ok, tostring(err)
+end
+
+function Metatable()
+    return getmetatable(strbuf.new())
+end
+
+function Report(rows)
+    local sb = strbuf.new()
+    for i = 1, rows do sb:appendf("row %d: %s\n", i, "ok") end
+    return sb
+end
+
+function Length(sb)
+    return #sb, sb:tostring()
+end
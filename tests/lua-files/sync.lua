@@ -0,0 +1,24 @@
+function Remember()
+    Seen = World
+    SeenPlayer = World.player
+end
+
+function Same()
+    return Seen == World, SeenPlayer == World.player
+end
+
+function Read(key)
+    return World[key]
+end
+
+function ReadPlayer(key)
+    return World.player[key]
+end
+
+function Write(key, value)
+    World[key] = value
+end
+
+function Missing(key)
+    return World[key] == nil
+end
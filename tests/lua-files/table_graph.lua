@@ -0,0 +1,52 @@
+function Shared()
+    local leaf = { value = 1 }
+    return { a = leaf, b = leaf, list = { leaf, leaf } }
+end
+
+-- Every level holds the next one twice, 2^depth paths lead to the last
+function Diamond(depth)
+    local node = { value = depth }
+    for i = depth - 1, 1, -1 do node = { left = node, right = node, value = i } end
+    return node
+end
+
+-- The number of levels whose two keys are the same table
+function CountShared(node)
+    local count = 0
+    while node.left do
+        if rawequal(node.left, node.right) then count = count + 1 end
+        node = node.left
+    end
+    return count
+end
+
+function Leaves(t)
+    return rawequal(t.a.leaf, t.b.leaf), t.a.leaf.value
+end
+
+function Cycle()
+    local t = { name = "root", child = { list = {} } }
+    t.child.list[2] = t
+    t.child.list[1] = true
+    return t
+end
+
+function Deep(depth)
+    local t = {}
+    for _ = 1, depth do t = { next = t } end
+    return t
+end
+
+function ReadDeep(depth)
+    return Graph.read(Deep(depth))
+end
+
+function WithFunctions()
+    return { x = 1, f = function() end, co = coroutine.create(function() end), nested = { g = print, y = 2 } }
+end
+
+function Count(t)
+    local count = 0
+    for _ in pairs(t) do count = count + 1 end
+    return count
+end
@@ -14,4 +14,25 @@ end
 function TestLib(obj)
     obj.value = obj:addToValue(2.0)
     return obj
-end
\ No newline at end of file
+end
+
+function Identity(value)
+    return value
+end
+
+function Wrap(value)
+    return { ptr = value }
+end
+
+function Unwrap(table)
+    return table.ptr
+end
+
+function Consume(value)
+    LastValue = value
+end
+
+function MemoryKB()
+    collectgarbage("stop")
+    return collectgarbage("count")
+end
@@ -0,0 +1,5 @@
+function Outer(value)
+    local doubled = Trace.double(value)
+    collectgarbage()
+    return doubled
+end
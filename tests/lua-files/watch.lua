@@ -0,0 +1,20 @@
+Volume = 0.5
+Name = "hero"
+Settings = { fov = 90, quality = "high" }
+
+function SetVolume(value) Volume = value end
+function SetName(value) Name = value end
+function SetFov(value) Settings.fov = value end
+function ReplaceSettings(fov) Settings = { fov = fov, quality = "low" } end
+function SetOther(value) Other = value end
+
+function ReadVolume() return Volume end
+function ReadFov() return Settings.fov end
+
+function CountSettings()
+    local n = 0
+    for _ in pairs(Settings) do n = n + 1 end
+    return n
+end
+
+function Floor(value) return math.floor(value) end
@@ -91,4 +91,100 @@ TEST(LuaFile, RunCppLib)
     const auto res = runtime.template runFunction<SL::Table>("TestLib", table);
     EXPECT_TRUE(res);
     EXPECT_FLOAT_EQ(std::get<0>(*res).get<SL::Number>("value"), 4.f);
-}
\ No newline at end of file
+}
+
+struct Entity { int id; };
+struct Component { };
+
+TEST(LuaFile, TaggedPointers)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/test_a.lua");
+    EXPECT_TRUE(runtime);
+
+    Entity entity{ 7 };
+    {
+        const auto res = runtime.template runFunction<Entity*>("Identity", &entity);
+        EXPECT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), &entity);
+    }
+    {
+        const auto res = runtime.template runFunction<Component*>("Identity", &entity);
+        EXPECT_FALSE(res);
+        EXPECT_EQ(res.error().code(), SL::Runtime::ErrorCode::TypeMismatch);
+    }
+    {
+        const auto res = runtime.template runFunction<void*>("Identity", &entity);
+        EXPECT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), static_cast<void*>(&entity));
+    }
+}
+
+// Pointers with their upper bits set, like those of heaps tagged by the hardware, keep working
+TEST(LuaFile, TaggedHeapPointers)
+{
+    if constexpr (sizeof(void*) != 8) GTEST_SKIP();
+
+    SL::Runtime runtime(LUA_FILE_DIR "/test_a.lua");
+    EXPECT_TRUE(runtime);
+
+    Entity entity{ 7 };
+    auto* tagged = reinterpret_cast<Entity*>(reinterpret_cast<uintptr_t>(&entity) | (uintptr_t(0xb4) << 56));
+    {
+        const auto res = runtime.template runFunction<Entity*>("Identity", tagged);
+        EXPECT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), tagged);
+    }
+    {
+        const auto res = runtime.template runFunction<Component*>("Identity", tagged);
+        EXPECT_FALSE(res);
+        EXPECT_EQ(res.error().code(), SL::Runtime::ErrorCode::TypeMismatch);
+    }
+    {
+        const auto res = runtime.template runFunction<void*>("Identity", tagged);
+        EXPECT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), static_cast<void*>(tagged));
+    }
+}
+
+// Read into a table, pointers are handed to C++ untagged and reach Lua again with their tag
+TEST(LuaFile, TaggedPointersInTables)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/test_a.lua");
+    EXPECT_TRUE(runtime);
+
+    Entity entity{ 7 };
+    Entity* pointers[] = { &entity, &entity };
+    if constexpr (sizeof(void*) == 8)
+        pointers[1] = reinterpret_cast<Entity*>(reinterpret_cast<uintptr_t>(&entity) | (uintptr_t(0xb4) << 56));
+
+    for (auto* pointer : pointers)
+    {
+        const auto wrapped = runtime.template runFunction<SL::Table>("Wrap", pointer);
+        ASSERT_TRUE(wrapped);
+        const auto& table = std::get<0>(*wrapped);
+        EXPECT_EQ(static_cast<void*>(table.get<void**>("ptr")), static_cast<void*>(pointer));
+        if (pointer == &entity)
+        {
+            EXPECT_EQ(reinterpret_cast<Entity*>(table.get<void**>("ptr"))->id, 7);
+        }
+
+        const auto res = runtime.template runFunction<Entity*>("Unwrap", table);
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), pointer);
+        EXPECT_FALSE(runtime.template runFunction<Component*>("Unwrap", table));
+    }
+}
+
+TEST(LuaFile, PointersDontAllocate)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/test_a.lua");
+    EXPECT_TRUE(runtime);
+
+    Entity entity{ 7 };
+    const auto before = runtime.template runFunction<SL::Number>("MemoryKB");
+    for (int i = 0; i < 1000; i++) EXPECT_TRUE(runtime.template runFunction<>("Consume", &entity));
+    const auto after = runtime.template runFunction<SL::Number>("MemoryKB");
+
+    EXPECT_TRUE(before && after);
+    EXPECT_FLOAT_EQ(std::get<0>(*before), std::get<0>(*after));
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <vector>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    int64_t calls(SL::Runtime& runtime)
+    {
+        return std::get<0>(runtime.runFunction<int64_t>("GetCalls").value());
+    }
+
+    int64_t score(SL::Runtime& runtime, int64_t a, int64_t b)
+    {
+        return std::get<0>(runtime.runFunction<int64_t>("Score", a, b).value());
+    }
+}
+
+TEST(Memoize, Hits)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/memoize.lua");
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.memoize("Score"));
+
+    EXPECT_EQ(score(runtime, 1, 2), 13);
+    EXPECT_EQ(score(runtime, 1, 2), 13);
+    EXPECT_EQ(score(runtime, 2, 1), 22);
+    EXPECT_EQ(calls(runtime), 2);
+
+    const auto stats = runtime.memoStats("Score");
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_NEAR(stats.hitRate(), 1.0 / 3.0, 1e-9);
+
+    // Integers and floats are different arguments to Lua
+    EXPECT_EQ(std::get<0>(runtime.runFunction<int64_t>("Score", 1.0, int64_t(2)).value()), 13);
+    EXPECT_EQ(calls(runtime), 3);
+}
+
+TEST(Memoize, LeastRecentlyUsed)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/memoize.lua");
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.memoize("Score", 2));
+
+    score(runtime, 1, 0);
+    score(runtime, 2, 0);
+    score(runtime, 1, 0);
+    score(runtime, 3, 0); // Evicts (2, 0)
+    EXPECT_EQ(calls(runtime), 3);
+
+    score(runtime, 1, 0);
+    EXPECT_EQ(calls(runtime), 3);
+    score(runtime, 2, 0);
+    EXPECT_EQ(calls(runtime), 4);
+    EXPECT_EQ(runtime.memoStats("Score").size, 2u);
+}
+
+TEST(Memoize, Tables)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/memoize.lua");
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.memoize("Weight"));
+
+    SL::Table first;
+    first.set("a", int64_t(1));
+    first.set("b", int64_t(2));
+
+    SL::Table second;
+    second.set("b", int64_t(2));
+    second.set("a", int64_t(1));
+
+    EXPECT_EQ(std::get<0>(runtime.runFunction<int64_t>("Weight", first).value()), 5);
+    EXPECT_EQ(std::get<0>(runtime.runFunction<int64_t>("Weight", second).value()), 5);
+    EXPECT_EQ(calls(runtime), 1);
+
+    second.set("b", int64_t(3));
+    EXPECT_EQ(std::get<0>(runtime.runFunction<int64_t>("Weight", second).value()), 7);
+    EXPECT_EQ(calls(runtime), 2);
+}
+
+TEST(Memoize, OtherArguments)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/memoize.lua");
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.memoize("Sum"));
+
+    const std::vector<int64_t> values = { 1, 2, 3 };
+    EXPECT_EQ(std::get<0>(runtime.runFunction<int64_t>("Sum", values).value()), 6);
+    EXPECT_EQ(std::get<0>(runtime.runFunction<int64_t>("Sum", values).value()), 6);
+    EXPECT_EQ(calls(runtime), 2);
+    EXPECT_EQ(runtime.memoStats("Sum").size, 0u);
+}
+
+TEST(Memoize, Invalidation)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/memoize.lua");
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.watch<int64_t>("Bonus", [](int64_t) { }));
+    runtime.checkpoint();
+    ASSERT_TRUE(runtime.memoize("Score"));
+
+    EXPECT_EQ(score(runtime, 1, 2), 13);
+    ASSERT_TRUE(runtime.runFunction<>("SetBonus", int64_t(5)));
+    EXPECT_EQ(score(runtime, 1, 2), 17);
+
+    runtime.reset();
+    EXPECT_EQ(runtime.memoStats("Score").size, 0u);
+    EXPECT_EQ(score(runtime, 1, 2), 13);
+}
+
+// Results belong to the function the global held when they were cached
+TEST(Memoize, Reassigned)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/memoize.lua");
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.memoize("Score"));
+
+    EXPECT_EQ(score(runtime, 1, 2), 13);
+    EXPECT_EQ(score(runtime, 1, 2), 13);
+    EXPECT_EQ(calls(runtime), 1);
+
+    ASSERT_TRUE(runtime.runFunction<>("Redefine"));
+    EXPECT_EQ(score(runtime, 1, 2), 3);
+    EXPECT_EQ(score(runtime, 1, 2), 3);
+    EXPECT_EQ(calls(runtime), 2);
+    EXPECT_EQ(runtime.memoStats("Score").size, 1u);
+}
+
+TEST(Memoize, Errors)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/memoize.lua");
+    ASSERT_TRUE(runtime);
+
+    const auto res = runtime.memoize("Bonus");
+    ASSERT_FALSE(res);
+    EXPECT_EQ(res.error().code(), SL::Runtime::ErrorCode::NotFunction);
+
+    ASSERT_TRUE(runtime.memoize("Score"));
+    ASSERT_TRUE(runtime.memoize("Score", 0));
+    score(runtime, 1, 2);
+    score(runtime, 1, 2);
+    EXPECT_EQ(calls(runtime), 2);
+    EXPECT_EQ(runtime.memoStats("Score").misses, 0u);
+}
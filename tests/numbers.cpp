@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(Numbers, Integers)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/numbers.lua");
+    EXPECT_TRUE(runtime);
+
+    const int64_t id = (int64_t(1) << 40) + 1;
+    {
+        const auto res = runtime.template runFunction<int64_t>("NextId", id);
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), id + 1);
+    }
+    {
+        const auto res = runtime.template runFunction<int64_t>("Mask", int64_t(1), int32_t(62));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), (int64_t(1) << 62) | 1);
+    }
+    {
+        // Doesn't fit in 32 bits
+        const auto res = runtime.template runFunction<int32_t>("NextId", id);
+        EXPECT_FALSE(res);
+    }
+    {
+        const auto res = runtime.template runFunction<double>("NextId", 0.25);
+        ASSERT_TRUE(res);
+        EXPECT_DOUBLE_EQ(std::get<0>(*res), 1.25);
+    }
+}
+
+TEST(Numbers, TableStorage)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/numbers.lua");
+    EXPECT_TRUE(runtime);
+
+    const auto res = runtime.getGlobal<SL::Table>("Entity");
+    ASSERT_TRUE(res);
+
+    SL::Table entity = *res;
+    EXPECT_EQ(entity.get<int64_t>("id"), (int64_t(1) << 40) + 1);
+    EXPECT_FLOAT_EQ(entity.get<SL::Number>("health"), 100.f);
+    EXPECT_DOUBLE_EQ(entity.get<double>("speed"), 2.5);
+
+    {
+        const auto type = runtime.template runFunction<SL::String>("TypeOf", entity, SL::String("id"));
+        ASSERT_TRUE(type);
+        EXPECT_EQ(std::get<0>(*type), "integer");
+    }
+
+    // Writing through a view is what gets pushed back
+    entity.get<SL::Number>("health") = 50.5f;
+    entity.get<int64_t>("speed") = 3;
+
+    // and is read back through the other views
+    EXPECT_DOUBLE_EQ(entity.get<double>("health"), 50.5);
+    EXPECT_EQ(entity.get<int64_t>("health"), 50);
+    EXPECT_DOUBLE_EQ(entity.get<double>("speed"), 3.0);
+    EXPECT_FLOAT_EQ(entity.get<SL::Number>("speed"), 3.f);
+    {
+        const auto type = runtime.template runFunction<SL::String>("TypeOf", entity, SL::String("health"));
+        ASSERT_TRUE(type);
+        EXPECT_EQ(std::get<0>(*type), "float");
+    }
+    {
+        const auto type = runtime.template runFunction<SL::String>("TypeOf", entity, SL::String("speed"));
+        ASSERT_TRUE(type);
+        EXPECT_EQ(std::get<0>(*type), "integer");
+    }
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    std::filesystem::path recordingPath(const char* name)
+    {
+        return std::filesystem::temp_directory_path() / name;
+    }
+
+    std::string describe(SL::Runtime& runtime)
+    {
+        return std::get<0>(runtime.runFunction<SL::String>("Describe").value());
+    }
+}
+
+TEST(Record, RoundTrip)
+{
+    const auto path = recordingPath("sl-record-test.slr");
+
+    SL::Table position;
+    position.set("x", int64_t(4));
+
+    SL::Table options;
+    options.set("unit", SL::String("m"));
+    options.set("position", position);
+
+    SL::Runtime runtime(LUA_FILE_DIR "/record.lua");
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.record(path));
+
+    ASSERT_TRUE(runtime.setGlobal<int64_t>("Scale", 2));
+    ASSERT_TRUE(runtime.runFunction<>("Add", SL::String("a"), int64_t(3), options));
+    ASSERT_TRUE(runtime.runFunction<>("Add", SL::String("b"), 1.5));
+    EXPECT_FALSE(runtime.runFunction<>("Fail"));
+    runtime.stopRecording();
+
+    // Not recorded
+    ASSERT_TRUE(runtime.runFunction<>("Add", SL::String("c"), int64_t(1)));
+    EXPECT_EQ(describe(runtime), "a=6@m4,b=3.0,c=2");
+
+    const auto recording = SL::Recording::open(path);
+    ASSERT_TRUE(recording) << recording.error().message();
+    EXPECT_EQ(recording->names(), (std::vector<std::string>{ "Scale", "Add", "Fail" }));
+
+    const auto& entries = recording->entries();
+    ASSERT_EQ(entries.size(), 4u);
+    EXPECT_EQ(entries[0].kind, SL::Recording::Kind::SetGlobal);
+    EXPECT_EQ(entries[1].kind, SL::Recording::Kind::Call);
+    EXPECT_EQ(entries[1].name, 1u);
+    EXPECT_EQ(entries[1].args, 3u);
+    EXPECT_EQ(entries[2].args, 2u);
+    EXPECT_EQ(entries[3].args, 0u);
+    for (std::size_t i = 1; i < entries.size(); i++) EXPECT_GE(entries[i].time, entries[i - 1].time);
+
+    SL::Runtime other(LUA_FILE_DIR "/record.lua");
+    ASSERT_TRUE(other);
+
+    const auto replay = other.replay(*recording);
+    EXPECT_EQ(replay.durations.size(), 4u);
+    EXPECT_EQ(replay.errors, 1u);
+    EXPECT_EQ(describe(other), "a=6@m4,b=3.0");
+    EXPECT_EQ(*other.getGlobal<int64_t>("Scale"), 2);
+
+    std::filesystem::remove(path);
+}
+
+TEST(Record, Invalid)
+{
+    {
+        const auto recording = SL::Recording::open(recordingPath("sl-record-missing.slr"));
+        ASSERT_FALSE(recording);
+        EXPECT_EQ(recording.error().code(), SL::Recording::ErrorCode::FileError);
+    }
+
+    const auto path = recordingPath("sl-record-invalid.slr");
+    {
+        SL::Runtime runtime(LUA_FILE_DIR "/record.lua");
+        ASSERT_TRUE(runtime.record(path));
+        ASSERT_TRUE(runtime.runFunction<>("Add", SL::String("a"), int64_t(3)));
+    }
+
+    // Cut in the middle of the last value
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 1);
+    {
+        const auto recording = SL::Recording::open(path);
+        ASSERT_FALSE(recording);
+        EXPECT_EQ(recording.error().code(), SL::Recording::ErrorCode::InvalidRecording);
+    }
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a recording";
+    {
+        const auto recording = SL::Recording::open(path);
+        ASSERT_FALSE(recording);
+        EXPECT_EQ(recording.error().code(), SL::Recording::ErrorCode::InvalidRecording);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+struct Vec
+{
+    SL::Number x, y;
+};
+
+struct Unit
+{
+    SL::String name;
+    Vec position;
+    std::vector<SL::String> tags;
+    std::vector<Vec> path;
+    std::optional<SL::Number> speed;
+};
+
+SL_REFLECT(Vec, x, y)
+SL_REFLECT(Unit, name, position, tags, path, speed)
+
+TEST(Reflect, Decode)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/reflect.lua");
+    EXPECT_TRUE(runtime);
+
+    const auto res = runtime.getGlobal<Unit>("Unit");
+    ASSERT_TRUE(res);
+    EXPECT_EQ(res->name, "archer");
+    EXPECT_FLOAT_EQ(res->position.x, 1.5f);
+    EXPECT_FLOAT_EQ(res->position.y, -2.f);
+    EXPECT_EQ(res->tags, (std::vector<SL::String>{ "ranged", "cheap" }));
+    ASSERT_EQ(res->path.size(), 2u);
+    EXPECT_FLOAT_EQ(res->path[1].y, 1.f);
+    ASSERT_TRUE(res->speed);
+    EXPECT_FLOAT_EQ(*res->speed, 3.f);
+
+    const auto resting = runtime.getGlobal<Unit>("Resting");
+    ASSERT_TRUE(resting);
+    EXPECT_TRUE(resting->tags.empty());
+    EXPECT_FALSE(resting->speed);
+}
+
+TEST(Reflect, FieldErrors)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/reflect.lua");
+    EXPECT_TRUE(runtime);
+
+    {
+        const auto res = runtime.getGlobal<Unit>("BadField");
+        EXPECT_FALSE(res);
+        EXPECT_EQ(res.error().code(), SL::Runtime::ErrorCode::TypeMismatch);
+        EXPECT_EQ(res.error().message(), "position.y: expected number, got string");
+    }
+    {
+        const auto res = runtime.getGlobal<Unit>("BadElement");
+        EXPECT_FALSE(res);
+        EXPECT_EQ(res.error().message(), "path[2].y: expected number, got nil");
+    }
+    {
+        const auto res = runtime.getGlobal<Unit>("Missing");
+        EXPECT_FALSE(res);
+        EXPECT_EQ(res.error().message(), "expected table, got nil");
+    }
+}
+
+TEST(Reflect, RoundTrip)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/reflect.lua");
+    EXPECT_TRUE(runtime);
+
+    Unit unit{ "knight", { 2, 3 }, { "melee" }, { }, 1.f };
+    {
+        const auto res = runtime.template runFunction<SL::String>("Describe", unit);
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), "knight at 2.0,3.0 with 1 tags");
+    }
+    {
+        const auto res = runtime.template runFunction<Unit>("Move", unit, 4.f);
+        ASSERT_TRUE(res);
+        EXPECT_FLOAT_EQ(std::get<0>(*res).position.x, 6.f);
+        EXPECT_FALSE(std::get<0>(*res).speed);
+        EXPECT_EQ(std::get<0>(*res).tags, unit.tags);
+    }
+
+    EXPECT_TRUE(runtime.setGlobal("Stored", unit));
+    const auto stored = runtime.getGlobal<Unit>("Stored");
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(stored->name, "knight");
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(ScriptHost, Isolated)
+{
+    SL::ScriptHost host;
+
+    const auto a = host.load(LUA_FILE_DIR "/script_host.lua");
+    const auto b = host.load(LUA_FILE_DIR "/script_host.lua");
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+    EXPECT_EQ(host.scripts(), 2);
+
+    {
+        const auto res = host.template runFunction<int64_t>(*a, "Increment", int64_t(3));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), 3);
+    }
+    {
+        const auto res = host.template getGlobal<int64_t>(*b, "Count");
+        ASSERT_TRUE(res);
+        EXPECT_EQ(*res, 0);
+    }
+
+    EXPECT_TRUE(host.template runFunction<>(*a, "Leak"));
+    {
+        const auto res = host.template runFunction<SL::Boolean>(*a, "HasLeaked");
+        ASSERT_TRUE(res);
+        EXPECT_TRUE(std::get<0>(*res));
+    }
+    {
+        const auto res = host.template runFunction<SL::Boolean>(*b, "HasLeaked");
+        ASSERT_TRUE(res);
+        EXPECT_FALSE(std::get<0>(*res));
+    }
+}
+
+TEST(ScriptHost, SharedLibraries)
+{
+    SL::ScriptHost host;
+
+    const auto script = host.load(LUA_FILE_DIR "/script_host.lua");
+    ASSERT_TRUE(script);
+
+    const auto res = host.template runFunction<SL::String>(*script, "Shout", SL::String("hi"));
+    ASSERT_TRUE(res);
+    EXPECT_EQ(std::get<0>(*res), "HI!");
+
+    // Not defined by the script, read from the shared globals
+    EXPECT_TRUE(host.template getGlobal<SL::Table>(*script, "string"));
+    EXPECT_TRUE(host.template getGlobal<SL::Function>(*script, "print"));
+}
+
+struct HostLib : SL::Lib::Base
+{
+    HostLib() : Base("host", Functions)
+    {   }
+
+    static int scale(SL::State state)
+    {
+        const auto [ x ] = extractArgs<SL::Number>(state);
+        SL::CompileTime::TypeMap<SL::Number>::push(state, x * 2.f);
+        return 1;
+    }
+
+    static constexpr SL::Lib::Reg Functions[] = {
+        { "scale", scale },
+        { nullptr, nullptr }
+    };
+};
+
+TEST(ScriptHost, Globals)
+{
+    SL::ScriptHost host;
+
+    HostLib lib;
+    EXPECT_TRUE(host.registerLibrary(lib));
+
+    const auto a = host.load(LUA_FILE_DIR "/script_host.lua");
+    const auto b = host.load(LUA_FILE_DIR "/script_host.lua");
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+
+    EXPECT_TRUE(host.setGlobal<int64_t>(*a, "Count", 10));
+    {
+        const auto res = host.template runFunction<int64_t>(*a, "Increment", int64_t(1));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), 11);
+    }
+    {
+        const auto res = host.template runFunction<SL::Number>(*b, "Scale", 4.f);
+        ASSERT_TRUE(res);
+        EXPECT_FLOAT_EQ(std::get<0>(*res), 8.f);
+    }
+    {
+        const auto res = host.template runFunction<>(*b, "Count");
+        ASSERT_FALSE(res);
+        EXPECT_EQ(res.error().code(), SL::ScriptHost::ErrorCode::NotFunction);
+    }
+}
+
+TEST(ScriptHost, LoadErrors)
+{
+    SL::ScriptHost host;
+
+    {
+        const auto res = host.load(LUA_FILE_DIR "/does_not_exist.lua");
+        ASSERT_FALSE(res);
+        EXPECT_EQ(res.error().code(), SL::ScriptHost::ErrorCode::LoadError);
+    }
+    {
+        const auto res = host.load(LUA_FILE_DIR "/script_host_error.lua");
+        ASSERT_FALSE(res);
+        EXPECT_NE(res.error().message().find("failed while loading"), std::string::npos);
+    }
+    EXPECT_EQ(host.scripts(), 0);
+}
+
+TEST(ScriptHost, Unload)
+{
+    SL::ScriptHost host;
+    host.collect();
+    const auto empty = host.memory();
+
+    std::vector<SL::ScriptHost::Script> scripts;
+    for (int i = 0; i < 100; i++)
+    {
+        const auto res = host.load(LUA_FILE_DIR "/script_host.lua");
+        ASSERT_TRUE(res);
+        scripts.push_back(*res);
+    }
+
+    host.collect();
+    const auto loaded = host.memory();
+    EXPECT_GT(loaded, empty);
+
+    for (const auto& script : scripts) host.unload(script);
+    host.collect();
+    EXPECT_EQ(host.scripts(), 0);
+    EXPECT_LT(host.memory() - empty, (loaded - empty) / 10);
+}
+
+TEST(ScriptHost, ReadOnlyLibraries)
+{
+    SL::ScriptHost host;
+
+    const auto a = host.load(LUA_FILE_DIR "/script_host.lua");
+    const auto b = host.load(LUA_FILE_DIR "/script_host.lua");
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+
+    {
+        const auto res = host.template runFunction<int64_t, SL::Boolean>(*a, "Tamper");
+        ASSERT_TRUE(res) << res.error().message();
+        EXPECT_EQ(std::get<0>(*res), 0);
+        EXPECT_TRUE(std::get<1>(*res));
+    }
+    {
+        const auto res = host.template runFunction<SL::String>(*a, "Shout", SL::String("hi"));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), "mine!");
+    }
+    {
+        const auto res = host.template runFunction<SL::String>(*b, "Shout", SL::String("hi"));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), "HI!");
+    }
+
+    // Still readable and iterable through the proxies
+    const auto res = host.template runFunction<int64_t, int64_t, SL::String>(*b, "Libraries");
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_GT(std::get<0>(*res), 5);
+    EXPECT_EQ(std::get<1>(*res), 4);
+    EXPECT_EQ(std::get<2>(*res), "3");
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(Simd, Elementwise)
+{
+    auto runtime = SL::Runtime::create<SL::Lib::Simd>(LUA_FILE_DIR "/simd.lua");
+    EXPECT_TRUE(runtime);
+
+    for (const auto* kind : { "f32", "f64" })
+    {
+        const auto res = runtime.runFunction<SL::Boolean>("Elementwise", SL::String(kind));
+        EXPECT_TRUE(res);
+        EXPECT_TRUE(std::get<0>(*res)) << kind;
+    }
+}
+
+TEST(Simd, Reductions)
+{
+    auto runtime = SL::Runtime::create<SL::Lib::Simd>(LUA_FILE_DIR "/simd.lua");
+
+    const auto reduce = [&](const char* kind, const char* op)
+    {
+        const auto res = runtime.runFunction<SL::Number>("Reduce", SL::String(kind), SL::String(op));
+        EXPECT_TRUE(res);
+        return std::get<0>(*res);
+    };
+
+    // a[i] = 3i for i in 1..37
+    for (const auto* kind : { "f32", "f64" })
+    {
+        EXPECT_FLOAT_EQ(reduce(kind, "sum"), 3.f * 37 * 38 / 2);
+        EXPECT_FLOAT_EQ(reduce(kind, "dot"), 9.f * 37 * 38 * 75 / 6);
+        EXPECT_FLOAT_EQ(reduce(kind, "min"), 3.f);
+        EXPECT_FLOAT_EQ(reduce(kind, "max"), 111.f);
+    }
+
+    const auto empty = runtime.runFunction<SL::Boolean>("ReduceEmpty");
+    EXPECT_TRUE(empty);
+    EXPECT_TRUE(std::get<0>(*empty));
+}
+
+TEST(Simd, Permute)
+{
+    auto runtime = SL::Runtime::create<SL::Lib::Simd>(LUA_FILE_DIR "/simd.lua");
+
+    const auto res = runtime.runFunction<SL::Boolean>("Permute");
+    EXPECT_TRUE(res);
+    EXPECT_TRUE(std::get<0>(*res));
+}
+
+TEST(Simd, SizeMismatch)
+{
+    auto runtime = SL::Runtime::create<SL::Lib::Simd>(LUA_FILE_DIR "/simd.lua");
+
+    const auto res = runtime.runFunction<SL::Boolean>("Mismatch");
+    EXPECT_TRUE(res);
+    EXPECT_FALSE(std::get<0>(*res));
+    EXPECT_NE(std::string(SL::Lib::Simd::isa()), "");
+}
+
+TEST(Simd, TooLarge)
+{
+    auto runtime = SL::Runtime::create<SL::Lib::Simd>(LUA_FILE_DIR "/simd.lua");
+
+    const auto res = runtime.runFunction<SL::Boolean, SL::String>("TooLarge");
+    ASSERT_TRUE(res);
+    EXPECT_FALSE(std::get<0>(*res));
+    EXPECT_NE(std::get<1>(*res).find("buffer too large"), std::string::npos);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    int64_t bumps = 0;
+
+    struct StackLib : SL::Lib::Base
+    {
+        StackLib() : Base("Stack", Functions)
+        {   }
+
+        int pushUpvalues(SL::State state) const override
+        {
+            SL::CompileTime::TypeMap<int64_t*>::push(state, &bumps);
+            return 1;
+        }
+
+        static int sum(SL::State state)
+        {
+            const auto [ table, scale ] = extractArgs<SL::Table, int64_t>(state);
+
+            const auto& values = table.get<SL::Table>("values");
+
+            int64_t total = 0;
+            for (int64_t i = 1; values.hasValue(std::to_string(i)); i++) total += values.get<int64_t>(std::to_string(i));
+
+            SL::CompileTime::TypeMap<int64_t>::push(state, total * scale);
+            return 1;
+        }
+
+        static int bump(SL::State state)
+        {
+            (*upvalue<int64_t*>(state, 1))++;
+            return 0;
+        }
+
+        static constexpr SL::Lib::Reg Functions[] = {
+            { "sum",  sum },
+            { "bump", bump },
+            { nullptr, nullptr }
+        };
+    };
+}
+
+TEST(Stack, ErrorPaths)
+{
+    auto lua = SL::Runtime::create<StackLib>(LUA_FILE_DIR "/stack.lua");
+    ASSERT_TRUE(lua);
+    EXPECT_EQ(lua.stackSize(), 0u);
+
+    EXPECT_FALSE(lua.runFunction<int64_t>("Name"));
+    EXPECT_FALSE(lua.runFunction<>("Missing"));
+    EXPECT_FALSE(lua.runFunction<>("Fail"));
+    EXPECT_FALSE(lua.getGlobal<int64_t>("Config"));
+    EXPECT_FALSE(lua.getGlobal<SL::Function>("Config"));
+    EXPECT_TRUE(lua.getGlobal<SL::Function>("Add"));
+    EXPECT_EQ(lua.stackSize(), 0u);
+
+    // Replacing a global that isn't a table
+    ASSERT_TRUE(lua.setGlobal("Extra", false));
+    ASSERT_TRUE(lua.registerFunction("Extra", "sum", StackLib::sum));
+    EXPECT_EQ(lua.stackSize(), 0u);
+}
+
+// A million mixed calls, succeeding and failing, leave the stack empty and the heap flat
+TEST(Stack, Soak)
+{
+    auto lua = SL::Runtime::create<StackLib>(LUA_FILE_DIR "/stack.lua");
+    ASSERT_TRUE(lua);
+
+    SL::Table values;
+    for (int64_t i = 1; i <= 4; i++) values.set(std::to_string(i), i);
+
+    SL::Table table;
+    table.set("values", values);
+
+    constexpr int Rounds = 100000;
+    std::size_t baseline = 0;
+    for (int i = 0; i < Rounds; i++)
+    {
+        const auto add = lua.runFunction<int64_t>("Add", int64_t(i), int64_t(1));
+        ASSERT_TRUE(add && std::get<0>(*add) == i + 1);
+
+        ASSERT_FALSE(lua.runFunction<int64_t>("Name"));
+        ASSERT_FALSE(lua.runFunction<>("Missing"));
+        ASSERT_FALSE(lua.runFunction<>("Fail"));
+        ASSERT_TRUE((lua.runFunction<int64_t, int64_t, int64_t>("Many")));
+
+        const auto lib = lua.runFunction<int64_t>("CallLib", table);
+        ASSERT_TRUE(lib && std::get<0>(*lib) == 20);
+
+        ASSERT_TRUE(lua.getGlobal<SL::Table>("Config"));
+        ASSERT_FALSE(lua.getGlobal<int64_t>("Config"));
+        ASSERT_TRUE(lua.getGlobal<SL::Function>("Add"));
+        ASSERT_TRUE(lua.setGlobal("Value", int64_t(i)));
+
+        ASSERT_EQ(lua.stackSize(), 0u) << "after round " << i;
+
+        if (i == Rounds / 10)
+        {
+            ASSERT_TRUE(lua.runFunction<>("Collect"));
+            baseline = lua.memory();
+        }
+    }
+
+    ASSERT_TRUE(lua.runFunction<>("Collect"));
+    EXPECT_LE(lua.memory(), baseline + 16 * 1024);
+    EXPECT_EQ(bumps, Rounds);
+}
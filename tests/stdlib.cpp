@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    bool hasGlobal(SL::Runtime& runtime, const char* name)
+    {
+        const auto res = runtime.runFunction<SL::Boolean>("HasGlobal", SL::String(name));
+        EXPECT_TRUE(res);
+        return res && std::get<0>(*res);
+    }
+}
+
+TEST(StdLib, All)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/stdlib.lua");
+    ASSERT_TRUE(runtime);
+
+    EXPECT_TRUE(hasGlobal(runtime, "io"));
+    EXPECT_TRUE(hasGlobal(runtime, "debug"));
+    EXPECT_TRUE(hasGlobal(runtime, "math"));
+}
+
+TEST(StdLib, Selected)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/stdlib.lua", { SL::StdLib::Base | SL::StdLib::Math });
+    ASSERT_TRUE(runtime);
+
+    EXPECT_TRUE(hasGlobal(runtime, "math"));
+    EXPECT_FALSE(hasGlobal(runtime, "io"));
+    EXPECT_FALSE(hasGlobal(runtime, "string"));
+    EXPECT_FALSE(hasGlobal(runtime, "require"));
+
+    const auto res = runtime.runFunction<int64_t>("Floor", 2.5);
+    ASSERT_TRUE(res);
+    EXPECT_EQ(std::get<0>(*res), 2);
+
+    EXPECT_FALSE(runtime.runFunction<SL::String>("Upper", SL::String("a")));
+}
+
+TEST(StdLib, Lazy)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/stdlib.lua", { SL::StdLib::All, true });
+    ASSERT_TRUE(runtime);
+
+    EXPECT_FALSE(hasGlobal(runtime, "math"));
+    EXPECT_FALSE(hasGlobal(runtime, "io"));
+    EXPECT_TRUE(hasGlobal(runtime, "string"));
+
+    {
+        const auto res = runtime.runFunction<int64_t>("Floor", 2.5);
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), 2);
+    }
+    EXPECT_TRUE(hasGlobal(runtime, "math"));
+    EXPECT_FALSE(hasGlobal(runtime, "io"));
+
+    {
+        const auto res = runtime.runFunction<SL::String>("RequireType");
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), "function");
+    }
+    {
+        const auto res = runtime.runFunction<SL::String>("Upper", SL::String("a"));
+        ASSERT_TRUE(res);
+        EXPECT_EQ(std::get<0>(*res), "A");
+    }
+}
+
+TEST(StdLib, LazyRequire)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/stdlib.lua", { SL::StdLib::All, true });
+    ASSERT_TRUE(runtime);
+
+    // Found through package.preload before the script reads the global
+    EXPECT_FALSE(hasGlobal(runtime, "table"));
+    const auto res = runtime.runFunction<SL::String>("RequireTable");
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_EQ(std::get<0>(*res), "a,b");
+    EXPECT_TRUE(hasGlobal(runtime, "table"));
+}
+
+TEST(StdLib, LazyAfterReset)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/stdlib.lua", { SL::StdLib::Base | SL::StdLib::Math, true });
+    ASSERT_TRUE(runtime);
+    runtime.checkpoint();
+
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_FALSE(hasGlobal(runtime, "math"));
+        EXPECT_TRUE(runtime.runFunction<int64_t>("Floor", 1.5));
+        EXPECT_TRUE(hasGlobal(runtime, "math"));
+        runtime.reset();
+    }
+}
+
+TEST(StdLib, Memory)
+{
+    SL::Runtime all(LUA_FILE_DIR "/stdlib.lua");
+    SL::Runtime base(LUA_FILE_DIR "/stdlib.lua", { SL::StdLib::Base });
+    SL::Runtime lazy(LUA_FILE_DIR "/stdlib.lua", { SL::StdLib::All, true });
+
+    EXPECT_LT(base.memory(), all.memory() / 2);
+    EXPECT_LT(lazy.memory(), all.memory());
+}
+
+TEST(StdLib, OpenedBeforeScript)
+{
+    auto runtime = SL::Runtime::fromBuffer("Version = string.format('%d.%d', 5, 4)", "version");
+    ASSERT_TRUE(runtime);
+    EXPECT_EQ(*runtime.getGlobal<SL::String>("Version"), "5.4");
+
+    auto lazy = SL::Runtime::fromBuffer("Root = math.sqrt(16)", "root", { SL::StdLib::All, true });
+    ASSERT_TRUE(lazy);
+    EXPECT_EQ(*lazy.getGlobal<double>("Root"), 4.0);
+}
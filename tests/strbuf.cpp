@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(StrBuf, Append)
+{
+    auto lua = SL::Runtime::create<SL::Lib::StrBuf>(LUA_FILE_DIR "/strbuf.lua");
+    ASSERT_TRUE(lua);
+
+    const auto res = lua.runFunction<SL::String, int64_t>("Append");
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_EQ(std::get<0>(*res), "a1b2.5--7");
+    EXPECT_EQ(std::get<1>(*res), 9);
+
+    const auto format = lua.runFunction<SL::String>("Appendf");
+    ASSERT_TRUE(format) << format.error().message();
+    EXPECT_EQ(std::get<0>(*format), "42| 3.14|ab  |ff|A|%|true|1e+20|007");
+
+    const auto join = lua.runFunction<SL::String>("RepJoin");
+    ASSERT_TRUE(join) << join.error().message();
+    EXPECT_EQ(std::get<0>(*join), "ab,ab,ab;p/1/q/2;bc");
+
+    const auto clear = lua.runFunction<SL::String>("Clear");
+    ASSERT_TRUE(clear) << clear.error().message();
+    EXPECT_EQ(std::get<0>(*clear), "d");
+}
+
+TEST(StrBuf, Errors)
+{
+    auto lua = SL::Runtime::create<SL::Lib::StrBuf>(LUA_FILE_DIR "/strbuf.lua");
+
+    const auto error = [&](const std::string& kind)
+    {
+        const auto res = lua.runFunction<bool, SL::String>("Errors", kind);
+        EXPECT_TRUE(res) << res.error().message();
+        EXPECT_FALSE(std::get<0>(*res));
+        return std::get<1>(*res);
+    };
+
+    EXPECT_NE(error("append").find("string expected"), std::string::npos);
+    EXPECT_NE(error("format").find("invalid conversion '%q'"), std::string::npos);
+    EXPECT_NE(error("argument").find("number expected"), std::string::npos);
+    EXPECT_NE(error("join").find("invalid value (at index 2)"), std::string::npos);
+
+    // Sizes the allocator can't serve are Lua errors, not C++ exceptions
+    EXPECT_NE(error("new").find("not enough memory"), std::string::npos);
+    EXPECT_NE(error("reserve").find("not enough memory"), std::string::npos);
+    EXPECT_NE(error("rep").find("not enough memory"), std::string::npos);
+
+    // The metatable, and with it __gc, is hidden from scripts
+    const auto metatable = lua.runFunction<SL::String>("Metatable");
+    ASSERT_TRUE(metatable) << metatable.error().message();
+    EXPECT_EQ(std::get<0>(*metatable), "strbuf");
+}
+
+TEST(StrBuf, View)
+{
+    auto lua = SL::Runtime::create<SL::Lib::StrBuf>(LUA_FILE_DIR "/strbuf.lua");
+
+    const auto res = lua.runFunction<SL::Lib::StrBuf::View>("Report", int64_t(1000));
+    ASSERT_TRUE(res) << res.error().message();
+
+    // Read in place, and still valid once Lua has collected the buffer
+    const auto view = std::get<0>(*res);
+    lua.runFunction<>("collectgarbage");
+    EXPECT_EQ(view.text.substr(0, 11), "row 1: ok\nr");
+    EXPECT_EQ(view.text.size(), view.owner->size());
+    EXPECT_EQ(view.text.data(), view.owner->data());
+    EXPECT_EQ(view.text.substr(view.text.size() - 13), "row 1000: ok\n");
+
+    // Pushed back as a new buffer holding a copy
+    const auto back = lua.runFunction<int64_t, SL::String>("Length", SL::Lib::StrBuf::View{ "abc", nullptr });
+    ASSERT_TRUE(back) << back.error().message();
+    EXPECT_EQ(std::get<0>(*back), 3);
+    EXPECT_EQ(std::get<1>(*back), "abc");
+}
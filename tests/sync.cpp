@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <memory>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    SL::Table world()
+    {
+        SL::Table player;
+        player.set("hp", int64_t(10));
+        player.set("name", SL::String("hero"));
+
+        SL::Table table;
+        table.set("tick", int64_t(0));
+        table.set("weather", SL::String("rain"));
+        table.set("player", player);
+        return table;
+    }
+
+    template<typename T>
+    T read(SL::Runtime& runtime, const char* function, const char* key)
+    {
+        const auto res = runtime.template runFunction<T>(function, SL::String(key));
+        EXPECT_TRUE(res);
+        return std::get<0>(*res);
+    }
+}
+
+TEST(Sync, SameTableEveryTick)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/sync.lua");
+    ASSERT_TRUE(runtime);
+
+    auto table = world();
+    runtime.bind(table);
+    EXPECT_TRUE(table.bound());
+
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+    ASSERT_TRUE(runtime.runFunction<>("Remember"));
+
+    auto& player = table.get<SL::Table>("player");
+    for (int64_t tick = 1; tick <= 3; tick++)
+    {
+        table.set("tick", tick);
+        player.set("hp", 10 - tick);
+        ASSERT_TRUE(runtime.setGlobal("World", table));
+
+        EXPECT_EQ(read<int64_t>(runtime, "Read", "tick"), tick);
+        EXPECT_EQ(read<int64_t>(runtime, "ReadPlayer", "hp"), 10 - tick);
+
+        const auto same = runtime.runFunction<SL::Boolean, SL::Boolean>("Same");
+        ASSERT_TRUE(same);
+        EXPECT_TRUE(std::get<0>(*same));
+        EXPECT_TRUE(std::get<1>(*same));
+    }
+}
+
+TEST(Sync, OnlyChangedKeys)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/sync.lua");
+    ASSERT_TRUE(runtime);
+
+    auto table = world();
+    runtime.bind(table);
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+
+    // Lua's write survives until C++ changes the same key
+    ASSERT_TRUE(runtime.runFunction<>("Write", SL::String("weather"), SL::String("sun")));
+    table.set("tick", int64_t(1));
+    table.sync();
+    EXPECT_EQ(read<SL::String>(runtime, "Read", "weather"), "sun");
+
+    table.set("weather", SL::String("snow"));
+    table.sync();
+    EXPECT_EQ(read<SL::String>(runtime, "Read", "weather"), "snow");
+
+    // Written through a reference
+    table.get<int64_t>("tick") = 7;
+    table.sync();
+    EXPECT_EQ(read<int64_t>(runtime, "Read", "tick"), 7);
+}
+
+TEST(Sync, ReplacedAndRemovedKeys)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/sync.lua");
+    ASSERT_TRUE(runtime);
+
+    auto table = world();
+    runtime.bind(table);
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+    ASSERT_TRUE(runtime.runFunction<>("Remember"));
+
+    SL::Table player;
+    player.set("hp", int64_t(99));
+    table.set("player", player);
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+    EXPECT_EQ(read<int64_t>(runtime, "ReadPlayer", "hp"), 99);
+
+    // The replacement is tracked like the original
+    table.get<SL::Table>("player").set("hp", int64_t(98));
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+    EXPECT_EQ(read<int64_t>(runtime, "ReadPlayer", "hp"), 98);
+
+    SL::Table smaller;
+    smaller.set("tick", int64_t(5));
+    smaller.set("player", player);
+    table = smaller;
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+    EXPECT_EQ(read<int64_t>(runtime, "Read", "tick"), 5);
+    EXPECT_TRUE(std::get<0>(*runtime.runFunction<SL::Boolean>("Missing", SL::String("weather"))));
+}
+
+TEST(Sync, SurvivesReset)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/sync.lua");
+    ASSERT_TRUE(runtime);
+    runtime.checkpoint();
+
+    auto table = world();
+    runtime.bind(table);
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+
+    runtime.reset();
+    table.set("tick", int64_t(3));
+    ASSERT_TRUE(runtime.setGlobal("World", table));
+    EXPECT_EQ(read<int64_t>(runtime, "Read", "tick"), 3);
+    EXPECT_EQ(read<int64_t>(runtime, "ReadPlayer", "hp"), 10);
+}
+
+TEST(Sync, Unbound)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/sync.lua");
+    ASSERT_TRUE(runtime);
+
+    auto table = world();
+    runtime.bind(table);
+    table.unbind();
+    EXPECT_FALSE(table.bound());
+
+    // Set overwrites, bound or not, and a copy of a bound table is a plain table
+    table.set("tick", int64_t(4));
+    EXPECT_EQ(table.get<int64_t>("tick"), 4);
+
+    runtime.bind(table);
+    SL::Table copy = table;
+    EXPECT_FALSE(copy.bound());
+    ASSERT_TRUE(runtime.setGlobal("World", copy));
+    ASSERT_TRUE(runtime.runFunction<>("Remember"));
+    ASSERT_TRUE(runtime.setGlobal("World", copy));
+
+    const auto same = runtime.runFunction<SL::Boolean, SL::Boolean>("Same");
+    ASSERT_TRUE(same);
+    EXPECT_FALSE(std::get<0>(*same));
+}
+
+TEST(Sync, BindAcrossReset)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/sync.lua");
+    ASSERT_TRUE(runtime);
+    runtime.checkpoint();
+
+    auto first = std::make_unique<SL::Table>(world());
+    first->set("tick", int64_t(11));
+    runtime.bind(*first);
+    runtime.reset();
+
+    auto second = world();
+    second.set("tick", int64_t(22));
+    runtime.bind(second);
+
+    // Freeing the reference of the first table must not free the one of the second
+    first.reset();
+    auto third = world();
+    third.set("tick", int64_t(33));
+    runtime.bind(third);
+
+    ASSERT_TRUE(runtime.setGlobal("World", third));
+    EXPECT_EQ(read<int64_t>(runtime, "Read", "tick"), 33);
+    ASSERT_TRUE(runtime.setGlobal("World", second));
+    EXPECT_EQ(read<int64_t>(runtime, "Read", "tick"), 22);
+}
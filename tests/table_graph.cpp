@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <chrono>
+#include <string>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    // Reads its argument into a table holding one key already, which a failed read keeps
+    struct Limited
+    {
+        static inline SL::Table::Limits limits;
+
+        static int read(SL::State L)
+        {
+            SL::Table table;
+            table.set("kept", true);
+
+            SL::CompileTime::TypeError error;
+            if (table.fromStack(L, limits, &error)) SL::CompileTime::TypeMap<SL::String>::push(L, std::to_string(table.getMap().size()) + " keys");
+            else if (table.getMap().size() != 1) SL::CompileTime::TypeMap<SL::String>::push(L, "changed");
+            else SL::CompileTime::TypeMap<SL::String>::push(L, error.what());
+            return 1;
+        }
+    };
+}
+
+TEST(TableGraph, SharedFromLua)
+{
+    SL::Runtime lua(LUA_FILE_DIR "/table_graph.lua");
+    ASSERT_TRUE(lua);
+
+    const auto res = lua.runFunction<SL::Table>("Shared");
+    ASSERT_TRUE(res) << res.error().message();
+
+    const auto& table = std::get<0>(*res);
+    const auto& a = table.get<SL::Table>("a");
+    EXPECT_EQ(&a, &table.get<SL::Table>("b"));
+    EXPECT_EQ(&a, &table.get<SL::Table>("list").get<SL::Table>("1"));
+    EXPECT_EQ(a.get<int64_t>("value"), 1);
+}
+
+// Read once per distinct table, 2^60 paths would never finish
+TEST(TableGraph, Diamond)
+{
+    SL::Runtime lua(LUA_FILE_DIR "/table_graph.lua");
+    ASSERT_TRUE(lua);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto res = lua.runFunction<SL::Table>("Diamond", int64_t(60));
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+    const auto& root = std::get<0>(*res);
+    EXPECT_EQ(&root.get<SL::Table>("left"), &root.get<SL::Table>("right"));
+
+    // And pushed back once per distinct table as well
+    const auto count = lua.runFunction<int64_t>("CountShared", root);
+    ASSERT_TRUE(count) << count.error().message();
+    EXPECT_EQ(std::get<0>(*count), 59);
+}
+
+TEST(TableGraph, SharedToLua)
+{
+    SL::Runtime lua(LUA_FILE_DIR "/table_graph.lua");
+    ASSERT_TRUE(lua);
+
+    SL::Table leaf;
+    leaf.set("value", int64_t(7));
+
+    SL::Table inner;
+    inner.set("leaf", leaf);
+
+    // Both copies share the nested table of inner
+    SL::Table table;
+    table.set("a", inner);
+    table.set("b", inner);
+
+    const auto res = lua.runFunction<bool, int64_t>("Leaves", table);
+    ASSERT_TRUE(res) << res.error().message();
+    EXPECT_TRUE(std::get<0>(*res));
+    EXPECT_EQ(std::get<1>(*res), 7);
+}
+
+TEST(TableGraph, Cycle)
+{
+    SL::Runtime lua(LUA_FILE_DIR "/table_graph.lua");
+    ASSERT_TRUE(lua);
+
+    const auto res = lua.runFunction<SL::Table>("Cycle");
+    ASSERT_FALSE(res);
+    EXPECT_NE(res.error().message().find("child.list[2]: table holds itself"), std::string::npos) << res.error().message();
+}
+
+TEST(TableGraph, Limits)
+{
+    SL::Runtime lua(LUA_FILE_DIR "/table_graph.lua");
+    ASSERT_TRUE(lua);
+
+    const auto deep = lua.runFunction<SL::Table>("Deep", int64_t(1000));
+    ASSERT_FALSE(deep);
+    EXPECT_NE(deep.error().message().find("nested deeper than 512 levels"), std::string::npos) << deep.error().message();
+
+    ASSERT_TRUE(lua.registerFunction("Graph", "read", Limited::read));
+
+    const auto read = [&](int64_t depth)
+    {
+        const auto res = lua.runFunction<SL::String>("ReadDeep", depth);
+        EXPECT_TRUE(res) << res.error().message();
+        return res ? std::get<0>(*res) : SL::String();
+    };
+
+    Limited::limits = SL::Table::Limits();
+    Limited::limits.depth = 3;
+    EXPECT_EQ(read(3), "next.next.next: tables nested deeper than 3 levels");
+    EXPECT_EQ(read(2), "2 keys");
+
+    Limited::limits = SL::Table::Limits();
+    Limited::limits.entries = 2;
+    EXPECT_EQ(read(5), "next.next: more than 2 entries");
+}
+
+TEST(TableGraph, FunctionsLeftOut)
+{
+    SL::Runtime lua(LUA_FILE_DIR "/table_graph.lua");
+    ASSERT_TRUE(lua);
+
+    const auto res = lua.runFunction<SL::Table>("WithFunctions");
+    ASSERT_TRUE(res) << res.error().message();
+
+    const auto& table = std::get<0>(*res);
+    EXPECT_EQ(table.getMap().size(), 2u);
+    EXPECT_FALSE(table.hasValue("f"));
+    EXPECT_FALSE(table.hasValue("co"));
+    EXPECT_EQ(table.get<int64_t>("x"), 1);
+    EXPECT_EQ(table.get<SL::Table>("nested").getMap().size(), 1u);
+    EXPECT_NE(table.toJson().find("{\"y\":2}"), std::string::npos);
+
+    const auto count = lua.runFunction<int64_t>("Count", table);
+    ASSERT_TRUE(count) << count.error().message();
+    EXPECT_EQ(std::get<0>(*count), 2);
+}
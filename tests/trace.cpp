@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+namespace
+{
+    std::string written()
+    {
+        std::stringstream ss;
+        SL::Trace::write(ss);
+        return ss.str();
+    }
+
+    std::size_t count(const std::string& text, const std::string& pattern)
+    {
+        std::size_t n = 0;
+        for (auto i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1)) n++;
+        return n;
+    }
+}
+
+TEST(Trace, Scopes)
+{
+    SL::Trace::start();
+    {
+        SL::Trace::Scope outer("outer");
+        SL::Trace::Scope inner("inner \"quoted\"");
+        SL::Trace::instant("mark");
+    }
+    SL::Trace::stop();
+
+    // Not recorded once stopped
+    {
+        SL::Trace::Scope ignored("ignored");
+    }
+
+    const auto json = written();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\""), 0u);
+    EXPECT_EQ(count(json, "\"ph\":\"B\""), 2u);
+    EXPECT_EQ(count(json, "\"ph\":\"E\""), 2u);
+    EXPECT_EQ(count(json, "\"ph\":\"i\""), 1u);
+    EXPECT_LT(json.find("\"outer\""), json.find("\"inner \\\"quoted\\\"\""));
+    EXPECT_EQ(json.find("ignored"), std::string::npos);
+}
+
+TEST(Trace, Threads)
+{
+    SL::Trace::start(4);
+    SL::Trace::instant("main");
+
+    // A new thread gets a buffer of the new capacity and keeps its latest events
+    std::thread worker([]()
+    {
+        for (int i = 0; i < 10; i++) SL::Trace::instant("worker " + std::to_string(i));
+    });
+    worker.join();
+    SL::Trace::stop();
+
+    const auto json = written();
+    EXPECT_NE(json.find("\"main\""), std::string::npos);
+    EXPECT_EQ(json.find("\"worker 5\""), std::string::npos);
+    for (int i = 6; i < 10; i++) EXPECT_NE(json.find("\"worker " + std::to_string(i) + "\""), std::string::npos);
+    EXPECT_EQ(count(json, "\"ph\":\"i\""), 5u);
+
+    // The next recording drops the events of the exited thread along with its buffer
+    SL::Trace::start();
+    SL::Trace::instant("again");
+    SL::Trace::stop();
+
+    const auto next = written();
+    EXPECT_NE(next.find("\"again\""), std::string::npos);
+    EXPECT_EQ(next.find("\"worker"), std::string::npos);
+    EXPECT_EQ(count(next, "\"ph\":\"i\""), 1u);
+}
+
+namespace
+{
+    struct TraceLib : SL::Lib::Base
+    {
+        static int twice(SL::State L)
+        {
+            const auto [ value ] = extractArgs<int64_t>(L);
+            SL::CompileTime::TypeMap<int64_t>::push(L, value * 2);
+            return 1;
+        }
+
+        static constexpr SL::Lib::Reg Functions[] = {
+            { "double", twice },
+            { nullptr, nullptr }
+        };
+
+        TraceLib() : Base("Trace", Functions) { }
+    };
+}
+
+TEST(Trace, Crossings)
+{
+    if (!SL::Trace::instrumented()) GTEST_SKIP() << "Built without SL_TRACE";
+
+    SL::Trace::start();
+    auto runtime = SL::Runtime::create<TraceLib>(LUA_FILE_DIR "/trace.lua");
+    ASSERT_TRUE(runtime);
+
+    const auto res = runtime.runFunction<int64_t>("Outer", int64_t(21));
+    ASSERT_TRUE(res);
+    EXPECT_EQ(std::get<0>(*res), 42);
+    SL::Trace::stop();
+
+    const auto json = written();
+    const auto load  = json.find("\"load trace.lua\"");
+    const auto outer = json.find("\"Outer\"");
+    const auto inner = json.find("\"Trace.double\"");
+    EXPECT_NE(load, std::string::npos);
+    EXPECT_NE(outer, std::string::npos);
+    EXPECT_NE(inner, std::string::npos);
+    EXPECT_LT(load, outer);
+    EXPECT_LT(outer, inner);
+    EXPECT_NE(json.find("\"Lua GC cycle\""), std::string::npos);
+    EXPECT_EQ(count(json, "\"ph\":\"B\""), count(json, "\"ph\":\"E\""));
+}
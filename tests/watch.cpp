@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <SL/Lua.hpp>
+
+#ifndef LUA_FILE_DIR
+#define LUA_FILE_DIR "."
+#endif
+
+TEST(Watch, Globals)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/watch.lua");
+    ASSERT_TRUE(runtime);
+
+    SL::Number volume = 0;
+    int calls = 0;
+    ASSERT_TRUE(runtime.watch<SL::Number>("Volume", [&](SL::Number value) { volume = value; calls++; }));
+
+    EXPECT_EQ(*runtime.dispatchWatches(), 0u);
+
+    // Several writes in a tick are one callback with the last value
+    ASSERT_TRUE(runtime.runFunction<>("SetVolume", SL::Number(0.8f)));
+    ASSERT_TRUE(runtime.runFunction<>("SetVolume", SL::Number(0.7f)));
+    ASSERT_TRUE(runtime.runFunction<>("SetOther", SL::Number(1.f)));
+    const auto res = runtime.dispatchWatches();
+    ASSERT_TRUE(res);
+    EXPECT_EQ(*res, 1u);
+    EXPECT_EQ(calls, 1);
+    EXPECT_FLOAT_EQ(volume, 0.7f);
+
+    const auto read = runtime.runFunction<SL::Number>("ReadVolume");
+    ASSERT_TRUE(read);
+    EXPECT_FLOAT_EQ(std::get<0>(*read), 0.7f);
+
+    const auto global = runtime.getGlobal<SL::Number>("Volume");
+    ASSERT_TRUE(global);
+    EXPECT_FLOAT_EQ(*global, 0.7f);
+
+    // Assigned from C++ as well
+    ASSERT_TRUE(runtime.setGlobal("Volume", SL::Number(0.1f)));
+    EXPECT_EQ(*runtime.dispatchWatches(), 1u);
+    EXPECT_FLOAT_EQ(volume, 0.1f);
+    EXPECT_EQ(*runtime.dispatchWatches(), 0u);
+}
+
+TEST(Watch, Mismatch)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/watch.lua");
+    ASSERT_TRUE(runtime);
+
+    int calls = 0;
+    ASSERT_TRUE(runtime.watch<SL::Number>("Name", [&](SL::Number) { calls++; }));
+
+    ASSERT_TRUE(runtime.runFunction<>("SetName", SL::String("villain")));
+    const auto res = runtime.dispatchWatches();
+    ASSERT_TRUE(res);
+    EXPECT_EQ(*res, 0u);
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(Watch, Fields)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/watch.lua");
+    ASSERT_TRUE(runtime);
+
+    int64_t fov = 0;
+    ASSERT_TRUE(runtime.watch<SL::Table>("Settings", [&](const SL::Table& table) { fov = table.get<int64_t>("fov"); }, true));
+
+    ASSERT_TRUE(runtime.runFunction<>("SetFov", int64_t(100)));
+    EXPECT_EQ(*runtime.dispatchWatches(), 1u);
+    EXPECT_EQ(fov, 100);
+
+    // The proxy still reads and iterates like the table
+    EXPECT_EQ(std::get<0>(*runtime.runFunction<int64_t>("ReadFov")), 100);
+    EXPECT_EQ(std::get<0>(*runtime.runFunction<int64_t>("CountSettings")), 2);
+
+    const auto settings = runtime.getGlobal<SL::Table>("Settings");
+    ASSERT_TRUE(settings);
+    EXPECT_EQ(settings->get<SL::String>("quality"), "high");
+
+    // A replacement table is watched too
+    ASSERT_TRUE(runtime.runFunction<>("ReplaceSettings", int64_t(60)));
+    EXPECT_EQ(*runtime.dispatchWatches(), 1u);
+    EXPECT_EQ(fov, 60);
+
+    ASSERT_TRUE(runtime.runFunction<>("SetFov", int64_t(70)));
+    EXPECT_EQ(*runtime.dispatchWatches(), 1u);
+    EXPECT_EQ(fov, 70);
+}
+
+TEST(Watch, LazyLibraries)
+{
+    SL::Runtime::Options options;
+    options.lazy = true;
+
+    SL::Runtime runtime(LUA_FILE_DIR "/watch.lua", options);
+    ASSERT_TRUE(runtime);
+    ASSERT_TRUE(runtime.watch<SL::Number>("Volume", [](SL::Number) { }));
+
+    const auto res = runtime.runFunction<int64_t>("Floor", SL::Number(2.5f));
+    ASSERT_TRUE(res);
+    EXPECT_EQ(std::get<0>(*res), 2);
+}
+
+TEST(Watch, Reset)
+{
+    SL::Runtime runtime(LUA_FILE_DIR "/watch.lua");
+    ASSERT_TRUE(runtime);
+
+    int calls = 0;
+    ASSERT_TRUE(runtime.watch<SL::Number>("Volume", [&](SL::Number) { calls++; }));
+    runtime.checkpoint();
+
+    ASSERT_TRUE(runtime.runFunction<>("SetVolume", SL::Number(0.9f)));
+    runtime.reset();
+
+    EXPECT_EQ(*runtime.dispatchWatches(), 0u);
+    EXPECT_FLOAT_EQ(std::get<0>(*runtime.runFunction<SL::Number>("ReadVolume")), 0.5f);
+
+    ASSERT_TRUE(runtime.runFunction<>("SetVolume", SL::Number(0.2f)));
+    EXPECT_EQ(*runtime.dispatchWatches(), 1u);
+    EXPECT_EQ(calls, 1);
+}
@@ -0,0 +1,23 @@
+#include <SL/Lua/Bundle.hpp>
+
+#include <cstring>
+#include <iostream>
+
+// Packs a directory of Lua modules into a bundle
+//   sl-bundle <directory> <output> [--source]
+int main(int argc, char** argv)
+{
+    if (argc < 3 || (argc == 4 && std::strcmp(argv[3], "--source") != 0) || argc > 4)
+    {
+        std::cerr << "usage: sl-bundle <directory> <output> [--source]\n";
+        return 2;
+    }
+
+    const auto res = SL::Bundle::pack(argv[1], argv[2], argc == 3);
+    if (!res)
+    {
+        std::cerr << "sl-bundle: " << res.error().message() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <SL/Lua/Embedded.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Compiles Lua scripts to bytecode and writes a translation unit registering them with
+// SL::Embedded, used by the sl_embed_scripts CMake function
+//   sl-embed <output.cpp> <name>=<script.lua>...
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: sl-embed <output.cpp> <name>=<script.lua>...\n";
+        return 2;
+    }
+
+    std::ostringstream chunks, scripts;
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const auto split = arg.find('=');
+        if (split == std::string::npos || split == 0)
+        {
+            std::cerr << "sl-embed: expected <name>=<script.lua>, got " << arg << "\n";
+            return 2;
+        }
+        const auto name = arg.substr(0, split);
+        const auto path = arg.substr(split + 1);
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "sl-embed: could not read " << path << "\n";
+            return 1;
+        }
+        const std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        std::string bytecode, error;
+        if (!SL::Embedded::compile(source, "@" + name, bytecode, error))
+        {
+            std::cerr << "sl-embed: " << error << "\n";
+            return 1;
+        }
+
+        chunks << "    constexpr unsigned char Chunk" << i - 2 << "[] = {";
+        for (std::size_t b = 0; b < bytecode.size(); b++)
+            chunks << (b % 16 ? " " : "\n        ") << static_cast<int>(static_cast<unsigned char>(bytecode[b])) << ",";
+        chunks << "\n    };\n\n";
+
+        scripts << "        { \"" << name << "\", Chunk" << i - 2 << ", sizeof(Chunk" << i - 2 << ") },\n";
+    }
+
+    std::ostringstream out;
+    out << "// Generated by sl-embed, do not edit\n"
+        << "#include <SL/Lua/Embedded.hpp>\n\n"
+        << "namespace\n{\n"
+        << chunks.str()
+        << "    const SL::Embedded::Script Scripts[] = {\n" << scripts.str() << "    };\n\n"
+        << "    const SL::Embedded::Registration Registered(Scripts, sizeof(Scripts) / sizeof(Scripts[0]));\n"
+        << "}\n";
+
+    // Left untouched when nothing changed, so dependents aren't rebuilt
+    {
+        std::ifstream existing(argv[1], std::ios::binary);
+        const std::string current((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+        if (existing && current == out.str()) return 0;
+    }
+
+    std::ofstream output(argv[1], std::ios::binary | std::ios::trunc);
+    output << out.str();
+    if (!output)
+    {
+        std::cerr << "sl-embed: could not write " << argv[1] << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <SL/Lua.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Latencies of one function or global
+    struct Stats
+    {
+        std::vector<uint64_t> recorded;
+        std::vector<uint64_t> replayed;
+    };
+
+    double percentile(std::vector<uint64_t>& durations, double p)
+    {
+        if (durations.empty()) return 0.0;
+
+        const auto n = static_cast<std::size_t>(p * static_cast<double>(durations.size() - 1) + 0.5);
+        std::nth_element(durations.begin(), durations.begin() + static_cast<std::ptrdiff_t>(n), durations.end());
+        return static_cast<double>(durations[n]) / 1000.0;
+    }
+}
+
+// Replays the calls recorded with SL::Runtime::record against a script, and reports the
+// throughput and the latencies of each function, in microseconds. The script is loaded
+// with the standard libraries and SL::Lib::Simd
+//   sl-replay <script.lua> <recording> [--repeat <n>]
+int main(int argc, char** argv)
+{
+    int repeat = 1;
+    if (argc == 5 && std::strcmp(argv[3], "--repeat") == 0) repeat = std::atoi(argv[4]);
+    if ((argc != 3 && argc != 5) || repeat < 1)
+    {
+        std::cerr << "usage: sl-replay <script.lua> <recording> [--repeat <n>]\n";
+        return 2;
+    }
+
+    const auto recording = SL::Recording::open(argv[2]);
+    if (!recording)
+    {
+        std::cerr << "sl-replay: " << recording.error().message() << "\n";
+        return 1;
+    }
+
+    auto runtime = SL::Runtime::create<SL::Lib::Simd>(argv[1]);
+    if (!runtime)
+    {
+        std::cerr << "sl-replay: could not load " << argv[1] << "\n";
+        return 1;
+    }
+
+    const auto& names   = recording->names();
+    const auto& entries = recording->entries();
+
+    std::vector<Stats> stats(names.size());
+    for (const auto& entry : entries) stats[entry.name].recorded.push_back(entry.duration);
+
+    uint64_t total = 0;
+    std::size_t errors = 0;
+    for (int i = 0; i < repeat; i++)
+    {
+        const auto replay = runtime.replay(*recording);
+        for (std::size_t e = 0; e < entries.size(); e++) stats[entries[e].name].replayed.push_back(replay.durations[e]);
+        total  += replay.total;
+        errors += replay.errors;
+    }
+
+    const auto calls = entries.size() * static_cast<std::size_t>(repeat);
+    std::printf("%zu calls in %.3f ms, %.0f calls/s, %zu errors\n\n",
+        calls, static_cast<double>(total) / 1e6, total ? static_cast<double>(calls) * 1e9 / static_cast<double>(total) : 0.0, errors);
+
+    std::printf("%-24s %8s %10s %10s %10s %10s %10s\n", "name", "calls", "rec p50", "p50", "p90", "p99", "max");
+    for (std::size_t n = 0; n < names.size(); n++)
+    {
+        auto& s = stats[n];
+        if (s.replayed.empty()) continue;
+
+        std::printf("%-24s %8zu %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+            names[n].c_str(), s.replayed.size(), percentile(s.recorded, 0.5),
+            percentile(s.replayed, 0.5), percentile(s.replayed, 0.9), percentile(s.replayed, 0.99), percentile(s.replayed, 1.0));
+    }
+    return errors ? 1 : 0;
+}